@@ -33,6 +33,9 @@
 #include <stdexcept>
 #include <type_traits>
 
+// NURBS API
+#include "Span.hxx"
+
 #define CONTAINER_DEFAULT_ALLOC_SZ 8 /**< Default allocation size for the container */
 
 namespace delamo
@@ -92,6 +95,20 @@ namespace delamo
 			std::copy(ptr_elem, ptr_elem + ptr_elem_size, this->_pElem);
 		}
 
+		/**
+		 * @brief Creates a container by copying the elements of a view.
+		 *
+		 * The container owns the copied elements; the viewed memory is not touched.
+		 * @param elems view of the elements
+		 */
+		explicit List(Span<const T> elems)
+		{
+			this->_mSize = elems.size();
+			this->_mSpace = this->_mSize;
+			this->_pElem = (this->_mSize > 0) ? new T[this->_mSize] : nullptr;
+			std::copy(elems.begin(), elems.end(), this->_pElem);
+		}
+
 	  /** WARNING DANGEROUS: Create a list that shadows 
               a preexisting array... only applicable if T is a pointer type */
 	      List(T first_elem, size_type num_elems)
@@ -237,6 +254,26 @@ namespace delamo
 			return this->_pElem;
 		}
 
+		/**
+		 * @brief Returns a non-owning view of the elements.
+		 *
+		 * The view is invalidated when the container reallocates its memory.
+		 * @return view of the elements
+		 */
+		Span<T> view()
+		{
+			return Span<T>(this->_pElem, this->_mSize);
+		}
+
+		/**
+		 * @brief Returns a non-owning read-only view of the elements.
+		 * @return view of the elements (const)
+		 */
+		Span<const T> view() const
+		{
+			return Span<const T>(this->_pElem, this->_mSize);
+		}
+
 		/**
 		 * @brief Returns the size of the container, a.k.a. number of elements stored inside.
 		 * @return number of elements stored inside the container
@@ -385,6 +422,17 @@ namespace delamo
 			}
 		}
 
+		/**
+		* @brief Adds the elements of a view at the end by copying them to the container.
+		* @param elems view of the elements to be added
+		*/
+		void push_back(Span<const T> elems)
+		{
+			this->reserve(this->_mSize + elems.size());
+			std::copy(elems.begin(), elems.end(), this->_pElem + this->_mSize);
+			this->_mSize += elems.size();
+		}
+
 		/**
 		 * @brief Adds the input element at the end by copying it to the container.
 		 *
@@ -35,6 +35,7 @@
 // Include template classes
 #include "PointVector.hxx"
 #include "ContainerList.hxx"
+#include "Span.hxx"
 
 
 namespace delamo
@@ -191,6 +192,26 @@ namespace delamo
 			}
 		}
 
+		/**
+		* @brief Sets the control points from a view.
+		* @param ctrlpts 1D control point array, size must be ctrlpts_u_len * ctrlpts_v_len
+		* @param ctrlpts_u_len number of control points in the u-dimension
+		* @param ctrlpts_v_len number of control points in the v-dimension
+		* @return FALSE if any errors, TRUE otherwise
+		*/
+		bool ctrlpts(Span<const TPoint3<T>> ctrlpts, int ctrlpts_u_len, int ctrlpts_v_len)
+		{
+			if ((int)ctrlpts.size() != ctrlpts_u_len * ctrlpts_v_len)
+			{
+				std::cerr << "NURBS ERROR: Size of the control points array must be equal to u-length times v-length" << std::endl;
+				return false;
+			}
+
+			// The pointer array overload only reads from the input array
+			this->ctrlpts(const_cast<TPoint3<T>*>(ctrlpts.data()), ctrlpts_u_len, ctrlpts_v_len);
+			return true;
+		}
+
 		/**
 		* @brief Returns the control points as an 1D array.
 		* @return the control points
@@ -273,6 +294,23 @@ namespace delamo
 			this->normalize(knotvector, num_knotvector, this->_pKnotVector_U);
 		}
 
+		/**
+		* @brief Sets the knot vector u from a view.
+		* @param knotvector view of the knot vector
+		*/
+		void knotvector_u(Span<const T> knotvector)
+		{
+			// Check if the pointer is empty. If not, empty it.
+			if (this->_pKnotVector_U != nullptr)
+			{
+				delete[] this->_pKnotVector_U;
+				this->_pKnotVector_U = nullptr;
+			}
+			this->_mNumKnotVector_U = (int)knotvector.size();
+			this->_pKnotVector_U = new T[this->_mNumKnotVector_U];
+			this->normalize(knotvector.data(), this->_mNumKnotVector_U, this->_pKnotVector_U);
+		}
+
 		/**
 		* @brief Returns the knot vector u.
 		* @return the knot vector pointer array
@@ -328,6 +366,23 @@ namespace delamo
 			this->normalize(knotvector, num_knotvector, this->_pKnotVector_V);
 		}
 
+		/**
+		* @brief Sets the knot vector v from a view.
+		* @param knotvector view of the knot vector
+		*/
+		void knotvector_v(Span<const T> knotvector)
+		{
+			// Check if the pointer is empty. If not, empty it.
+			if (this->_pKnotVector_V != nullptr)
+			{
+				delete[] this->_pKnotVector_V;
+				this->_pKnotVector_V = nullptr;
+			}
+			this->_mNumKnotVector_V = (int)knotvector.size();
+			this->_pKnotVector_V = new T[this->_mNumKnotVector_V];
+			this->normalize(knotvector.data(), this->_mNumKnotVector_V, this->_pKnotVector_V);
+		}
+
 		/**
 		* @brief Returns the knot vector V.
 		* @return the knot vector pointer array
@@ -393,6 +448,17 @@ namespace delamo
 			return true;
 		}
 
+		/**
+		* @brief Sets the weights vector from a view.
+		* @param weights view of the weights vector
+		* @return FALSE if any errors, TRUE otherwise
+		*/
+		bool weights(Span<const T> weights)
+		{
+			// The pointer array overload only reads from the input array
+			return this->weights(const_cast<T*>(weights.data()), (int)weights.size());
+		}
+
 		/**
 		* @brief Returns the weights vector.
 		* @return the weights vector
@@ -1407,7 +1473,7 @@ namespace delamo
 		* @param knot_vector_in_size size of the input knot vector (INPUT)
 		* @param knot_vector_out normalized knot vector (OUTPUT)
 		*/
-		void normalize(T* knot_vector_in, int knot_vector_in_size, T* knot_vector_out)
+		void normalize(const T* knot_vector_in, int knot_vector_in_size, T* knot_vector_out)
 		{
 			// If the pointer array length is zero, do not normalize!
 			if (knot_vector_in_size == 0)
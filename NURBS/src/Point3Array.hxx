@@ -0,0 +1,753 @@
+// Copyright (c) 2018 by Adarsh Krishnamurthy et. al. and Iowa State University.
+// All rights reserved.
+//
+// Permission to use, copy, modify, and distribute this software and its
+// documentation for non-profit use, without fee, and without written agreement is
+// hereby granted, provided that the above copyright notice and the following
+// two paragraphs appear in all copies of this software.
+//
+// IN NO EVENT SHALL IOWA STATE UNIVERSITY BE LIABLE TO ANY PARTY FOR
+// DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES ARISING OUT
+// OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF IOWA STATE UNIVERSITY
+// HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// IOWA STATE UNIVERSITY SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+// ON AN "AS IS" BASIS, AND IOWA STATE UNIVERSITY HAS NO OBLIGATION TO
+// PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+//
+//
+// Initial version April 20 2018 - Adarsh Krishnamurthy et. al.
+//
+
+#ifndef POINT3ARRAY_HXX
+#define POINT3ARRAY_HXX
+
+// CPP includes
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <new>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+// NURBS API
+#include "PointVector.hxx"
+#include "ContainerList.hxx"
+
+#ifndef POINT3ARRAY_ALIGNMENT
+#define POINT3ARRAY_ALIGNMENT 32 /**< Alignment of the coordinate lanes in bytes (AVX register width) */
+#endif // !POINT3ARRAY_ALIGNMENT
+
+namespace delamo
+{
+	/**
+	 * @brief Structure-of-arrays container for 3D points.
+	 *
+	 * Stores x, y and z coordinates in three separate aligned lanes, so that the loops in the geometric operations
+	 * run over contiguous memory and can be vectorized by the compiler.
+	 */
+	template <typename T>
+	class Point3Array
+	{
+		static_assert(std::is_arithmetic<T>::value, "Point3Array requires an arithmetic value type");
+
+	public:
+		using size_type = unsigned int; /**< Default size type for the container class */
+		using value_type = T; /**< Default value type for the container class */
+
+		/**
+		 * @brief Default constructor.
+		 *
+		 * Creates an empty container.
+		 */
+		Point3Array()
+		{
+			this->init_vars();
+		}
+
+		/**
+		 * @brief Creates a new container with "s" points at the origin.
+		 * @param s number of points inside the container
+		 */
+		explicit Point3Array(size_type s)
+		{
+			this->init_vars();
+			this->resize(s);
+		}
+
+		/**
+		 * @brief Creates a container from an array-of-structures list.
+		 * @param lst list of points
+		 */
+		explicit Point3Array(const List< TPoint3<T> >& lst)
+		{
+			this->init_vars();
+			this->from_list(lst);
+		}
+
+		/**
+		 * @brief Creates a container from the pointer array.
+		 * @param ptr_elem the pointer array
+		 * @param ptr_elem_size size of this pointer array
+		 */
+		explicit Point3Array(const TPoint3<T>* ptr_elem, size_type ptr_elem_size)
+		{
+			this->init_vars();
+			this->assign(ptr_elem, ptr_elem_size);
+		}
+
+		/**
+		 * @brief Copy constructor.
+		 * @param rhs object to be copied
+		 */
+		Point3Array(const Point3Array<T>& rhs)
+		{
+			this->init_vars();
+			this->copy_vars(rhs);
+		}
+
+		/**
+		 * @brief Move constructor.
+		 * @param rhs object to be moved
+		 */
+		Point3Array(Point3Array<T>&& rhs)
+		{
+			this->init_vars();
+			this->move_vars(rhs);
+		}
+
+		/**
+		 * @brief Default destructor.
+		 */
+		~Point3Array()
+		{
+			this->delete_vars();
+		}
+
+		/**
+		 * @brief Copy assignment operator.
+		 * @param rhs object on the right
+		 * @return object on the left
+		 */
+		Point3Array<T>& operator=(const Point3Array<T>& rhs)
+		{
+			if (this != &rhs)
+				this->copy_vars(rhs);
+			return *this;
+		}
+
+		/**
+		 * @brief Move assignment operator.
+		 * @param rhs object on the right
+		 * @return object on the left
+		 */
+		Point3Array<T>& operator=(Point3Array<T>&& rhs)
+		{
+			if (this != &rhs)
+			{
+				this->delete_vars();
+				this->move_vars(rhs);
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Returns the point at the input index.
+		 * @param idx array index
+		 * @return a copy of the point described by the array index
+		 */
+		TPoint3<T> operator[](size_type idx) const
+		{
+			return TPoint3<T>(this->_pX[idx], this->_pY[idx], this->_pZ[idx]);
+		}
+
+		/**
+		 * @brief Returns the point at the input index with bounds checking.
+		 * @param idx array index
+		 * @return a copy of the point described by the array index
+		 */
+		TPoint3<T> at(size_type idx) const
+		{
+			if (idx >= this->_mSize)
+				throw std::out_of_range("Index value exceeds container size");
+			return (*this)[idx];
+		}
+
+		/**
+		 * @brief Sets the point at the input index.
+		 * @param idx array index
+		 * @param pt new point
+		 */
+		void set(size_type idx, const TPoint3<T>& pt)
+		{
+			this->_pX[idx] = pt.x();
+			this->_pY[idx] = pt.y();
+			this->_pZ[idx] = pt.z();
+		}
+
+		/**
+		 * @brief Returns the x-coordinate lane.
+		 * @return pointer to the aligned x-coordinate array
+		 */
+		T* x_data()
+		{
+			return this->_pX;
+		}
+
+		/**
+		 * @brief Returns the x-coordinate lane (const).
+		 * @return pointer to the aligned x-coordinate array
+		 */
+		const T* x_data() const
+		{
+			return this->_pX;
+		}
+
+		/**
+		 * @brief Returns the y-coordinate lane.
+		 * @return pointer to the aligned y-coordinate array
+		 */
+		T* y_data()
+		{
+			return this->_pY;
+		}
+
+		/**
+		 * @brief Returns the y-coordinate lane (const).
+		 * @return pointer to the aligned y-coordinate array
+		 */
+		const T* y_data() const
+		{
+			return this->_pY;
+		}
+
+		/**
+		 * @brief Returns the z-coordinate lane.
+		 * @return pointer to the aligned z-coordinate array
+		 */
+		T* z_data()
+		{
+			return this->_pZ;
+		}
+
+		/**
+		 * @brief Returns the z-coordinate lane (const).
+		 * @return pointer to the aligned z-coordinate array
+		 */
+		const T* z_data() const
+		{
+			return this->_pZ;
+		}
+
+		/**
+		 * @brief Returns the number of points stored inside the container.
+		 * @return number of points
+		 */
+		size_type size() const
+		{
+			return this->_mSize;
+		}
+
+		/**
+		 * @brief Returns the allocated capacity of this container.
+		 * @return number of points that fit without reallocation
+		 */
+		size_type capacity() const
+		{
+			return this->_mSpace;
+		}
+
+		/**
+		 * @brief Checks whether the container is empty or not.
+		 * @return TRUE if empty, FALSE otherwise.
+		 */
+		bool empty() const
+		{
+			return (this->_mSize == 0);
+		}
+
+		/**
+		 * @brief Sets the number of points to zero without releasing the allocated memory.
+		 */
+		void clear()
+		{
+			this->_mSize = 0;
+		}
+
+		/**
+		 * @brief Reserves memory for future push backs.
+		 * @param newalloc number of points to be reserved in the memory
+		 * @return boolean value to check if the reserve is successful or not
+		 */
+		bool reserve(size_type newalloc)
+		{
+			// Never decrease the allocated memory
+			if (newalloc <= this->_mSpace)
+				return false;
+
+			// Each lane starts on an aligned address, so round the lane length up to the alignment
+			size_type lane_len = round_up(newalloc);
+			T* new_x = aligned_new(3 * lane_len);
+			T* new_y = new_x + lane_len;
+			T* new_z = new_y + lane_len;
+
+			// Copy old coordinates into the new lanes
+			if (this->_mSize > 0)
+			{
+				std::copy(this->_pX, this->_pX + this->_mSize, new_x);
+				std::copy(this->_pY, this->_pY + this->_mSize, new_y);
+				std::copy(this->_pZ, this->_pZ + this->_mSize, new_z);
+			}
+
+			aligned_delete(this->_pX);
+			this->_pX = new_x;
+			this->_pY = new_y;
+			this->_pZ = new_z;
+			this->_mSpace = lane_len;
+
+			return true;
+		}
+
+		/**
+		 * @brief Resizes this container.
+		 *
+		 * New points are set to the origin.
+		 * @param newsize number of points inside the container
+		 */
+		void resize(size_type newsize)
+		{
+			this->reserve(newsize);
+			for (size_type i = this->_mSize; i < newsize; i++)
+			{
+				this->_pX[i] = T(0.0);
+				this->_pY[i] = T(0.0);
+				this->_pZ[i] = T(0.0);
+			}
+			this->_mSize = newsize;
+		}
+
+		/**
+		 * @brief Adds the input point at the end.
+		 *
+		 * The capacity is doubled when the container is full.
+		 * @param pt point to be added
+		 */
+		void push_back(const TPoint3<T>& pt)
+		{
+			this->push_back(pt.x(), pt.y(), pt.z());
+		}
+
+		/**
+		 * @brief Adds the input coordinates at the end.
+		 * @param x_value value of the x-coordinate
+		 * @param y_value value of the y-coordinate
+		 * @param z_value value of the z-coordinate
+		 */
+		void push_back(T x_value, T y_value, T z_value)
+		{
+			if (this->_mSize == this->_mSpace)
+				this->reserve((this->_mSpace == 0) ? CONTAINER_DEFAULT_ALLOC_SZ : 2 * this->_mSpace);
+			this->_pX[this->_mSize] = x_value;
+			this->_pY[this->_mSize] = y_value;
+			this->_pZ[this->_mSize] = z_value;
+			this->_mSize++;
+		}
+
+		/**
+		 * @brief Adds the input point at the end.
+		 *
+		 * Alias of push_back()
+		 * @param pt point to be added
+		 */
+		void add(const TPoint3<T>& pt)
+		{
+			this->push_back(pt);
+		}
+
+		/**
+		 * @brief Replaces the contents of the container with the points of the pointer array.
+		 * @param ptr_elem the pointer array
+		 * @param ptr_elem_size size of this pointer array
+		 */
+		void assign(const TPoint3<T>* ptr_elem, size_type ptr_elem_size)
+		{
+			this->_mSize = 0;
+			this->reserve(ptr_elem_size);
+			for (size_type i = 0; i < ptr_elem_size; i++)
+			{
+				this->_pX[i] = ptr_elem[i].x();
+				this->_pY[i] = ptr_elem[i].y();
+				this->_pZ[i] = ptr_elem[i].z();
+			}
+			this->_mSize = ptr_elem_size;
+		}
+
+		/**
+		 * @brief Replaces the contents of the container with the points of an array-of-structures list.
+		 *
+		 * The points are transposed into the lanes in a single pass without any intermediate storage.
+		 * @param lst list of points
+		 */
+		void from_list(const List< TPoint3<T> >& lst)
+		{
+			this->assign(lst.begin(), size_type(lst.end() - lst.begin()));
+		}
+
+		/**
+		 * @brief Writes the points into an array-of-structures pointer array.
+		 * @param ptr_elem the pointer array, must be able to store size() points (OUTPUT)
+		 */
+		void copy_to(TPoint3<T>* ptr_elem) const
+		{
+			for (size_type i = 0; i < this->_mSize; i++)
+			{
+				ptr_elem[i].x(this->_pX[i]);
+				ptr_elem[i].y(this->_pY[i]);
+				ptr_elem[i].z(this->_pZ[i]);
+			}
+		}
+
+		/**
+		 * @brief Appends the points to an array-of-structures list.
+		 * @param lst list of points (OUTPUT)
+		 */
+		void to_list(List< TPoint3<T> >& lst) const
+		{
+			lst.reserve(size_type(lst.end() - lst.begin()) + this->_mSize);
+			for (size_type i = 0; i < this->_mSize; i++)
+				lst.push_back((*this)[i]);
+		}
+
+		/**
+		 * @brief Converts the points to an array-of-structures list.
+		 * @return list of points
+		 */
+		List< TPoint3<T> > to_list() const
+		{
+			List< TPoint3<T> > lst;
+			this->to_list(lst);
+			return lst;
+		}
+
+		/**
+		 * @brief Translates all points by the input offset.
+		 * @param offset translation vector
+		 */
+		void translate(const TPoint3<T>& offset)
+		{
+			const T ox = offset.x(), oy = offset.y(), oz = offset.z();
+			T* px = this->_pX;
+			T* py = this->_pY;
+			T* pz = this->_pZ;
+			for (size_type i = 0; i < this->_mSize; i++)
+				px[i] += ox;
+			for (size_type i = 0; i < this->_mSize; i++)
+				py[i] += oy;
+			for (size_type i = 0; i < this->_mSize; i++)
+				pz[i] += oz;
+		}
+
+		/**
+		 * @brief Translates each point along its own direction.
+		 *
+		 * Computes p[i] = p[i] + dirs[i] * distance, e.g. offsetting the points along their normals.
+		 * @param dirs direction vectors, one per point
+		 * @param distance translation distance
+		 */
+		void translate(const Point3Array<T>& dirs, T distance)
+		{
+			if (dirs.size() != this->_mSize)
+				throw std::invalid_argument("Direction array size does not match the point array size");
+
+			axpy(this->_pX, dirs._pX, distance, this->_mSize);
+			axpy(this->_pY, dirs._pY, distance, this->_mSize);
+			axpy(this->_pZ, dirs._pZ, distance, this->_mSize);
+		}
+
+		/**
+		 * @brief Applies a 3x3 transformation matrix to all points.
+		 * @param mat row-major 3x3 matrix
+		 */
+		void transform(const T mat[9])
+		{
+			T* px = this->_pX;
+			T* py = this->_pY;
+			T* pz = this->_pZ;
+			for (size_type i = 0; i < this->_mSize; i++)
+			{
+				T x = px[i], y = py[i], z = pz[i];
+				px[i] = mat[0] * x + mat[1] * y + mat[2] * z;
+				py[i] = mat[3] * x + mat[4] * y + mat[5] * z;
+				pz[i] = mat[6] * x + mat[7] * y + mat[8] * z;
+			}
+		}
+
+		/**
+		 * @brief Rotates all points around an axis passing through the input origin.
+		 *
+		 * Uses Rodrigues' rotation formula to build the rotation matrix.
+		 * @param origin a point on the rotation axis
+		 * @param axis direction of the rotation axis (normalized internally)
+		 * @param angle rotation angle in radians
+		 */
+		void rotate(const TPoint3<T>& origin, const TPoint3<T>& axis, T angle)
+		{
+			T len = std::sqrt(axis.x() * axis.x() + axis.y() * axis.y() + axis.z() * axis.z());
+			if (len == T(0.0))
+				throw std::invalid_argument("Rotation axis cannot be a zero vector");
+			T ux = axis.x() / len, uy = axis.y() / len, uz = axis.z() / len;
+			T c = std::cos(angle), s = std::sin(angle), t = T(1.0) - c;
+
+			T mat[9];
+			mat[0] = t * ux * ux + c;      mat[1] = t * ux * uy - s * uz; mat[2] = t * ux * uz + s * uy;
+			mat[3] = t * ux * uy + s * uz; mat[4] = t * uy * uy + c;      mat[5] = t * uy * uz - s * ux;
+			mat[6] = t * ux * uz - s * uy; mat[7] = t * uy * uz + s * ux; mat[8] = t * uz * uz + c;
+
+			TPoint3<T> neg_origin(-origin.x(), -origin.y(), -origin.z());
+			this->translate(neg_origin);
+			this->transform(mat);
+			this->translate(origin);
+		}
+
+		/**
+		 * @brief Projects all points orthogonally onto a plane.
+		 * @param origin a point on the plane
+		 * @param normal normal vector of the plane (normalized internally)
+		 */
+		void project_to_plane(const TPoint3<T>& origin, const TPoint3<T>& normal)
+		{
+			T len = std::sqrt(normal.x() * normal.x() + normal.y() * normal.y() + normal.z() * normal.z());
+			if (len == T(0.0))
+				throw std::invalid_argument("Plane normal cannot be a zero vector");
+			const T nx = normal.x() / len, ny = normal.y() / len, nz = normal.z() / len;
+			const T ox = origin.x(), oy = origin.y(), oz = origin.z();
+
+			T* px = this->_pX;
+			T* py = this->_pY;
+			T* pz = this->_pZ;
+			for (size_type i = 0; i < this->_mSize; i++)
+			{
+				T d = (px[i] - ox) * nx + (py[i] - oy) * ny + (pz[i] - oz) * nz;
+				px[i] -= d * nx;
+				py[i] -= d * ny;
+				pz[i] -= d * nz;
+			}
+		}
+
+		/**
+		 * @brief Computes the axis-aligned bounding box of the points.
+		 * @param[out] bbox_min minimum corner of the bounding box
+		 * @param[out] bbox_max maximum corner of the bounding box
+		 * @return FALSE if the container is empty, TRUE otherwise
+		 */
+		bool bounding_box(TPoint3<T>& bbox_min, TPoint3<T>& bbox_max) const
+		{
+			if (this->_mSize == 0)
+				return false;
+
+			T lo, hi;
+			lane_min_max(this->_pX, this->_mSize, lo, hi);
+			bbox_min.x(lo); bbox_max.x(hi);
+			lane_min_max(this->_pY, this->_mSize, lo, hi);
+			bbox_min.y(lo); bbox_max.y(hi);
+			lane_min_max(this->_pZ, this->_mSize, lo, hi);
+			bbox_min.z(lo); bbox_max.z(hi);
+			return true;
+		}
+
+		/**
+		 * @brief Computes the centroid (arithmetic mean) of the points.
+		 * @return centroid of the points, origin if the container is empty
+		 */
+		TPoint3<T> centroid() const
+		{
+			TPoint3<T> retval;
+			if (this->_mSize == 0)
+				return retval;
+
+			retval.x(lane_sum(this->_pX, this->_mSize) / T(this->_mSize));
+			retval.y(lane_sum(this->_pY, this->_mSize) / T(this->_mSize));
+			retval.z(lane_sum(this->_pZ, this->_mSize) / T(this->_mSize));
+			return retval;
+		}
+
+		/**
+		 * @brief Finds the point closest to the input point.
+		 * @param[in] pt query point
+		 * @param[out] dist_sq squared distance to the closest point
+		 * @return index of the closest point, -1 if the container is empty
+		 */
+		int nearest(const TPoint3<T>& pt, T& dist_sq) const
+		{
+			int retval = -1;
+			dist_sq = std::numeric_limits<T>::max();
+
+			const T qx = pt.x(), qy = pt.y(), qz = pt.z();
+			const T* px = this->_pX;
+			const T* py = this->_pY;
+			const T* pz = this->_pZ;
+			for (size_type i = 0; i < this->_mSize; i++)
+			{
+				T dx = px[i] - qx, dy = py[i] - qy, dz = pz[i] - qz;
+				T d = dx * dx + dy * dy + dz * dz;
+				if (d < dist_sq)
+				{
+					dist_sq = d;
+					retval = int(i);
+				}
+			}
+			return retval;
+		}
+
+		/**
+		 * @brief Finds the point closest to the input point.
+		 * @param pt query point
+		 * @return index of the closest point, -1 if the container is empty
+		 */
+		int nearest(const TPoint3<T>& pt) const
+		{
+			T dist_sq;
+			return this->nearest(pt, dist_sq);
+		}
+
+	protected:
+
+		/**
+		 * @brief Initializes the class variables, helper for the constructors.
+		 */
+		void init_vars()
+		{
+			this->_pX = nullptr;
+			this->_pY = nullptr;
+			this->_pZ = nullptr;
+			this->_mSize = 0;
+			this->_mSpace = 0;
+		}
+
+		/**
+		 * @brief Copies the contents of the input object, helper for copy construction and assignment.
+		 * @param rhs object to be copied
+		 */
+		void copy_vars(const Point3Array<T>& rhs)
+		{
+			this->_mSize = 0;
+			this->reserve(rhs._mSize);
+			std::copy(rhs._pX, rhs._pX + rhs._mSize, this->_pX);
+			std::copy(rhs._pY, rhs._pY + rhs._mSize, this->_pY);
+			std::copy(rhs._pZ, rhs._pZ + rhs._mSize, this->_pZ);
+			this->_mSize = rhs._mSize;
+		}
+
+		/**
+		 * @brief Takes over the lanes of the input object, helper for move construction and assignment.
+		 * @param rhs object to be moved
+		 */
+		void move_vars(Point3Array<T>& rhs)
+		{
+			this->_pX = rhs._pX;
+			this->_pY = rhs._pY;
+			this->_pZ = rhs._pZ;
+			this->_mSize = rhs._mSize;
+			this->_mSpace = rhs._mSpace;
+			rhs.init_vars();
+		}
+
+		/**
+		 * @brief Deletes the lanes, helper for the destructor.
+		 */
+		void delete_vars()
+		{
+			aligned_delete(this->_pX);
+			this->init_vars();
+		}
+
+	private:
+
+		/**
+		 * @brief Rounds the lane length up so that the next lane starts on an aligned address.
+		 * @param n number of coordinates in the lane
+		 * @return rounded lane length
+		 */
+		static size_type round_up(size_type n)
+		{
+			const size_type per_block = (POINT3ARRAY_ALIGNMENT / sizeof(T) > 0) ? size_type(POINT3ARRAY_ALIGNMENT / sizeof(T)) : 1;
+			return ((n + per_block - 1) / per_block) * per_block;
+		}
+
+		/**
+		 * @brief Allocates an aligned array.
+		 *
+		 * The offset to the original allocation is stored right before the aligned address.
+		 * @param n number of elements
+		 * @return aligned pointer
+		 */
+		static T* aligned_new(size_type n)
+		{
+			std::size_t bytes = std::size_t(n) * sizeof(T) + POINT3ARRAY_ALIGNMENT + sizeof(void*);
+			void* raw = std::malloc(bytes);
+			if (raw == nullptr)
+				throw std::bad_alloc();
+			std::uintptr_t base = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+			std::uintptr_t aligned = (base + POINT3ARRAY_ALIGNMENT - 1) & ~std::uintptr_t(POINT3ARRAY_ALIGNMENT - 1);
+			reinterpret_cast<void**>(aligned)[-1] = raw;
+			return reinterpret_cast<T*>(aligned);
+		}
+
+		/**
+		 * @brief Frees an array allocated with aligned_new().
+		 * @param ptr aligned pointer
+		 */
+		static void aligned_delete(T* ptr)
+		{
+			if (ptr != nullptr)
+				std::free(reinterpret_cast<void**>(ptr)[-1]);
+		}
+
+		/**
+		 * @brief Computes lane = lane + dir * s.
+		 */
+		static void axpy(T* lane, const T* dir, T s, size_type n)
+		{
+			for (size_type i = 0; i < n; i++)
+				lane[i] += dir[i] * s;
+		}
+
+		/**
+		 * @brief Computes the minimum and the maximum values of a non-empty lane.
+		 */
+		static void lane_min_max(const T* lane, size_type n, T& lo, T& hi)
+		{
+			lo = lane[0];
+			hi = lane[0];
+			for (size_type i = 1; i < n; i++)
+			{
+				lo = (lane[i] < lo) ? lane[i] : lo;
+				hi = (lane[i] > hi) ? lane[i] : hi;
+			}
+		}
+
+		/**
+		 * @brief Computes the sum of a lane.
+		 */
+		static T lane_sum(const T* lane, size_type n)
+		{
+			T retval = T(0.0);
+			for (size_type i = 0; i < n; i++)
+				retval += lane[i];
+			return retval;
+		}
+
+		T* _pX; /**< Aligned x-coordinate lane, owns the allocation of all three lanes */
+		T* _pY; /**< Aligned y-coordinate lane */
+		T* _pZ; /**< Aligned z-coordinate lane */
+		size_type _mSize; /**< Number of points stored inside the container */
+		size_type _mSpace; /**< Capacity of each lane */
+	};
+}
+
+#endif // !POINT3ARRAY_HXX
@@ -0,0 +1,213 @@
+// Copyright (c) 2018 by Adarsh Krishnamurthy et. al. and Iowa State University.
+// All rights reserved.
+//
+// Permission to use, copy, modify, and distribute this software and its
+// documentation for non-profit use, without fee, and without written agreement is
+// hereby granted, provided that the above copyright notice and the following
+// two paragraphs appear in all copies of this software.
+//
+// IN NO EVENT SHALL IOWA STATE UNIVERSITY BE LIABLE TO ANY PARTY FOR
+// DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES ARISING OUT
+// OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF IOWA STATE UNIVERSITY
+// HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// IOWA STATE UNIVERSITY SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+// ON AN "AS IS" BASIS, AND IOWA STATE UNIVERSITY HAS NO OBLIGATION TO
+// PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+//
+//
+// Initial version April 20 2018 - Adarsh Krishnamurthy et. al.
+//
+
+#ifndef SPAN_HXX
+#define SPAN_HXX
+
+// CPP includes
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+namespace delamo
+{
+	// Forward declaration of the owning container
+	template <typename T>
+	class List;
+
+	/**
+	 * @brief Non-owning view of a contiguous array.
+	 *
+	 * A span only stores a pointer and a size, so it can be passed by value without copying the elements.
+	 * The viewed memory must outlive the span. Use Span<const T> for read-only access.
+	 */
+	template <typename T>
+	class Span
+	{
+	public:
+		using size_type = unsigned int; /**< Default size type for the span class */
+		using value_type = typename std::remove_cv<T>::type; /**< Default value type for the span class */
+		using iterator = T*; /**< Iterator type for the span class */
+
+		/**
+		 * @brief Default constructor.
+		 *
+		 * Creates an empty view.
+		 */
+		Span() : _pData(nullptr), _mSize(0)
+		{
+		}
+
+		/**
+		 * @brief Creates a view of the pointer array.
+		 * @param ptr_elem the pointer array
+		 * @param ptr_elem_size size of this pointer array
+		 */
+		Span(T* ptr_elem, size_type ptr_elem_size) : _pData(ptr_elem), _mSize(ptr_elem_size)
+		{
+		}
+
+		/**
+		 * @brief Creates a view of a fixed-size array.
+		 * @param arr the array
+		 */
+		template <std::size_t N>
+		Span(T(&arr)[N]) : _pData(arr), _mSize(size_type(N))
+		{
+		}
+
+		/**
+		 * @brief Creates a view of the elements stored inside a List container.
+		 * @param lst the container
+		 */
+		Span(List<value_type>& lst) : _pData(lst.data()), _mSize(size_type(lst.end() - lst.begin()))
+		{
+		}
+
+		/**
+		 * @brief Creates a read-only view of the elements stored inside a List container.
+		 * @param lst the container
+		 */
+		template <typename U, typename = typename std::enable_if<std::is_const<T>::value && std::is_same<U, value_type>::value>::type>
+		Span(const List<U>& lst) : _pData(lst.begin()), _mSize(size_type(lst.end() - lst.begin()))
+		{
+		}
+
+		/**
+		 * @brief Conversion constructor, e.g. from Span<T> to Span<const T>.
+		 * @param rhs span to be converted
+		 */
+		template <typename U, typename = typename std::enable_if<std::is_convertible<U(*)[], T(*)[]>::value>::type>
+		Span(const Span<U>& rhs) : _pData(rhs.data()), _mSize(rhs.size())
+		{
+		}
+
+		/**
+		 * @brief Subcript operator.
+		 * @param idx array index
+		 * @return the element described by the array index
+		 */
+		T& operator[](size_type idx) const
+		{
+			return this->_pData[idx];
+		}
+
+		/**
+		 * @brief Returns the element at the input index with bounds checking.
+		 * @param idx array index
+		 * @return the element described by the array index
+		 */
+		T& at(size_type idx) const
+		{
+			if (idx >= this->_mSize)
+				throw std::out_of_range("Index value exceeds span size");
+			return this->_pData[idx];
+		}
+
+		/**
+		 * @brief Returns the pointer to the viewed array.
+		 * @return pointer to the first element
+		 */
+		T* data() const
+		{
+			return this->_pData;
+		}
+
+		/**
+		 * @brief Returns the number of elements in the view.
+		 * @return number of elements
+		 */
+		size_type size() const
+		{
+			return this->_mSize;
+		}
+
+		/**
+		 * @brief Checks whether the view is empty or not.
+		 * @return TRUE if empty, FALSE otherwise.
+		 */
+		bool empty() const
+		{
+			return (this->_mSize == 0);
+		}
+
+		/**
+		 * @brief Indicates the start of the viewed array.
+		 * @return the first element of the view
+		 */
+		iterator begin() const
+		{
+			return this->_pData;
+		}
+
+		/**
+		 * @brief Indicates the end of the viewed array.
+		 * @return one past the last element of the view
+		 */
+		iterator end() const
+		{
+			return this->_pData + this->_mSize;
+		}
+
+		/**
+		 * @brief Returns a view of a part of this view.
+		 * @param offset index of the first element
+		 * @param count number of elements
+		 * @return the sub-view
+		 */
+		Span<T> subspan(size_type offset, size_type count) const
+		{
+			if (offset > this->_mSize || count > this->_mSize - offset)
+				throw std::out_of_range("Sub-span exceeds span size");
+			return Span<T>(this->_pData + offset, count);
+		}
+
+		/**
+		 * @brief Returns a view of the first elements of this view.
+		 * @param count number of elements
+		 * @return the sub-view
+		 */
+		Span<T> first(size_type count) const
+		{
+			return this->subspan(0, count);
+		}
+
+		/**
+		 * @brief Returns a view of the last elements of this view.
+		 * @param count number of elements
+		 * @return the sub-view
+		 */
+		Span<T> last(size_type count) const
+		{
+			if (count > this->_mSize)
+				throw std::out_of_range("Sub-span exceeds span size");
+			return Span<T>(this->_pData + (this->_mSize - count), count);
+		}
+
+	private:
+		T* _pData; /**< Pointer to the viewed array, not owned */
+		size_type _mSize; /**< Number of elements in the view */
+	};
+}
+
+#endif // !SPAN_HXX
@@ -98,4 +98,8 @@
 %rename("$ignore", fullname=1) delamo::NURBS<double>::weights();
 %rename("$ignore", fullname=1) delamo::NURBS<double>::weights(List<double>);
 %rename("$ignore", fullname=1) delamo::NURBS<double>::ctrlpts();
+%rename("$ignore", fullname=1) delamo::NURBS<double>::knotvector_u(Span<const double>);
+%rename("$ignore", fullname=1) delamo::NURBS<double>::knotvector_v(Span<const double>);
+%rename("$ignore", fullname=1) delamo::NURBS<double>::weights(Span<const double>);
+%rename("$ignore", fullname=1) delamo::NURBS<double>::ctrlpts(Span<const TPoint3<double>>, int, int);
 %rename("$ignore", fullname=1) delamo::NURBS<double>::ctrlpts(List< TPoint3<double> >);
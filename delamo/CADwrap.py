@@ -92,6 +92,42 @@ class TPoint3dList(CADsupport.TPoint3dList):
 
 
 
+# delamo::List< double >
+class DoubleList(cadmb.DoubleList):
+    last_obj = None
+
+    def __init__(self):
+        super(DoubleList, self).__init__()
+        DoubleList.last_obj = self
+
+
+# delamo::List< int >
+class IntList(cadmb.IntList):
+    last_obj = None
+
+    def __init__(self):
+        super(IntList, self).__init__()
+        IntList.last_obj = self
+
+
+# Interface specification of ModelBuilder::build_laminate()
+class InterfaceSpec(cadmb.InterfaceSpec):
+    last_obj = None
+
+    def __init__(self):
+        super(InterfaceSpec, self).__init__()
+        InterfaceSpec.last_obj = self
+
+
+# Laminate specification of ModelBuilder::build_laminate()
+class LaminateSpec(cadmb.LaminateSpec):
+    last_obj = None
+
+    def __init__(self):
+        super(LaminateSpec, self).__init__()
+        LaminateSpec.last_obj = self
+
+
 # delamo::List< LayerMold >
 class LayerMoldList(cadmb.LayerMoldList):
     last_obj = None
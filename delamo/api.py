@@ -1763,6 +1763,18 @@ def bond_layers(DM,layer1,layer2,defaultBC=delamo.CADwrap.BC_TIE,delamBC=delamo.
     face_adjacency_list = DM.modelbuilder.adjacent_layers(layer1.gk_layer,layer2.gk_layer,gk_delaminationlist,defaultBC,delamBC,delamRingBC) # Imprint faces on both sides, return adjacent layers in face_adjacency_list
     #    pass
 
+    define_bonds(DM,layer1,layer2,face_adjacency_list,CohesiveInteraction=CohesiveInteraction,ContactInteraction=ContactInteraction,master_layer=master_layer,delamo_sourceline=delamo_sourceline,delamo_phase=delamo_phase,delamo_basename=delamo_basename)
+    pass
+
+
+def define_bonds(DM,layer1,layer2,face_adjacency_list,CohesiveInteraction=None,ContactInteraction=None,master_layer=None,delamo_sourceline=None,delamo_phase=None,delamo_basename=None):
+    """Define the finite element interactions between two layers from the face adjacency list of their interface. Parameters:
+* DM: DelamoModeler object
+* layer1: First layer
+* layer2: Second layer
+* face_adjacency_list: Face adjacency list returned by the geometry kernel for layer1 and layer2
+* CohesiveInteraction, ContactInteraction, master_layer, delamo_sourceline, delamo_phase, delamo_basename: see bond_layers()
+"""
     # Can not bond non-existant objects
     ThisContact = LaminaContact(DM=DM,bottomlamina=layer1, toplamina=layer2)
     
@@ -1851,6 +1863,71 @@ def bond_layers(DM,layer1,layer2,defaultBC=delamo.CADwrap.BC_TIE,delamBC=delamo.
     
 
 
+def build_laminate(DM,mold,direction,thicknesses,names,Section,layups,interfaces=None,coordsys=None,CohesiveInteraction=None,ContactInteraction=None):
+    """Create all layers of a laminate with a single geometry kernel call and bond the consecutive layers. Parameters:
+* DM: DelamoModeler object
+* mold: NURBS surface or LayerMold of the first layer
+* direction: delamo.CADwrap.OFFSET_DIRECTION or delamo.CADwrap.ORIG_DIRECTION
+* thicknesses: Thickness of each layer
+* names: Unique name of each layer
+* Section: ABAQUS section of the layers
+* layups: Ply orientation of each layer in degrees
+* interfaces: None to bond all layers with delamo.CADwrap.BC_COHESIVE, or one dictionary per interface with the optional keys
+  defaultBC, delamBC, delamRingBC and delaminationlist, which have the same meaning as the parameters of bond_layers().
+  delamo.CADwrap.BC_COHESIVE_LAYER is not supported, use bond_layers() for cohesive layers.
+* coordsys: Reference coordinate system for layup
+* CohesiveInteraction: The ABAQUS interaction property for any cohesive portions of the bonds
+* ContactInteraction: The ABAQUS interaction property for any contact portions of the bonds
+
+Returns the list of finalized layers.
+"""
+    spec = delamo.CADwrap.LaminateSpec()
+    if isinstance(mold,delamo.CADwrap.cadmb.LayerMold):
+        spec.layer_mold = mold
+        pass
+    else:
+        spec.mold = mold
+        pass
+    spec.direction = direction
+
+    for cnt in range(len(thicknesses)):
+        spec.thickness.add(float(thicknesses[cnt]))
+        spec.names.add(names[cnt])
+        spec.layup.add(int(layups[cnt]))
+        pass
+
+    if interfaces is not None:
+        for interface in interfaces:
+            ispec = delamo.CADwrap.InterfaceSpec()
+            ispec.default_status = interface.get("defaultBC",delamo.CADwrap.BC_COHESIVE)
+            ispec.delam_region_status = interface.get("delamBC",delamo.CADwrap.BC_CONTACT)
+            ispec.delam_ring_status = interface.get("delamRingBC",delamo.CADwrap.BC_NONE)
+            if ispec.default_status == delamo.CADwrap.BC_COHESIVE_LAYER:
+                raise ValueError("build_laminate() does not support cohesive layers, use bond_layers() instead")
+            for delamfilename in interface.get("delaminationlist",[]):
+                ispec.delam_files.add(delamfilename)
+                pass
+            spec.interfaces.add(ispec)
+            pass
+        pass
+
+    # The geometry kernel owns the generated layers, the face adjacency lists are converted to Python lists
+    (gk_layers, face_adjacency_lists) = DM.modelbuilder.build_laminate(spec)
+
+    layers = []
+    for cnt in range(len(gk_layers)):
+        layer = Layer(name=names[cnt],gk_layer=gk_layers[cnt],layupdirection=layups[cnt],LayerSection=Section,coordsys=coordsys)
+        layer.Finalize(DM)
+        layers.append(layer)
+        pass
+
+    for cnt in range(len(face_adjacency_lists)):
+        define_bonds(DM,layers[cnt],layers[cnt+1],face_adjacency_lists[cnt],CohesiveInteraction=CohesiveInteraction,ContactInteraction=ContactInteraction)
+        pass
+
+    return layers
+
+
 def FixedFace_OBSOLETE(self,M,assembly,Step,Faces,name=None): # Faces identified by list of (body, (point,normal))
     cnt=0
     retlist=[]
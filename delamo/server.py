@@ -0,0 +1,434 @@
+""" Persistent model builder server and its client.
+
+Every script run starts a new Python interpreter, imports the SWIG
+module, reads the license and starts the CAD kernel. The server does
+this once and keeps the started ModelBuilder and the loaded molds
+alive, so the clients only send the modeling requests.
+
+The server listens on a Unix domain socket. Each request and each
+response is a single line of JSON:
+
+    {"op": "create_layer", "name": "Layer_1", "mold": {"file": "mold.sat", "index": 0}, "direction": "OFFSET", "thickness": 0.199}
+    {"ok": true, "result": ["Layer_1_LB1"]}
+
+A failed request returns {"ok": false, "error": "<message>"} and
+leaves the server running. The layers created over a connection are
+named by the client and released with their solid bodies when the
+connection is closed, the molds are shared by all connections. A
+mold file modified on disk is loaded again by the next request using
+it, and the previously loaded molds are kept until the layers created
+on them are released.
+
+Each connection is served by its own thread, so an idle client does
+not block the others. The requests are still executed one at a time
+in the order they are received, as the modeling kernel is not
+reentrant.
+"""
+
+import os
+import os.path
+import sys
+import socket
+import json
+import time
+import tempfile
+import threading
+import traceback
+
+try:
+    basestring
+    pass
+except NameError:
+    # python3
+    basestring = str
+    pass
+
+
+def default_socket_path():
+    """ Returns the socket path used when none is given: $DELAMO_SERVER_SOCKET,
+    or a per-user socket in the temporary directory."""
+    if "DELAMO_SERVER_SOCKET" in os.environ:
+        return os.environ["DELAMO_SERVER_SOCKET"]
+    uid = os.getuid() if hasattr(os, "getuid") else 0
+    return os.path.join(tempfile.gettempdir(), "delamo-server-%d.sock" % (uid))
+
+
+def _direction(value):
+    import delamo.CADwrap
+    if value == "ORIG" or value == delamo.CADwrap.ORIG_DIRECTION:
+        return delamo.CADwrap.ORIG_DIRECTION
+    if value == "OFFSET" or value == delamo.CADwrap.OFFSET_DIRECTION:
+        return delamo.CADwrap.OFFSET_DIRECTION
+    raise ValueError("Unknown layer direction: %s" % (str(value)))
+
+
+def _bc_status(value):
+    import delamo.CADwrap
+    if isinstance(value, basestring):
+        # "TIE", "CONTACT", "NONE", "COHESIVE", "COHESIVE_LAYER"
+        if not hasattr(delamo.CADwrap, "BC_" + value):
+            raise ValueError("Unknown boundary condition: %s" % (value))
+        return getattr(delamo.CADwrap, "BC_" + value)
+    return int(value)
+
+
+class ModelBuilderServer(object):
+    """ Owns a started ModelBuilder and executes the requests of the clients."""
+
+    socket_path = None
+    """Path of the Unix domain socket"""
+    modelbuilder = None
+    """delamo.CADwrap.ModelBuilder() object, started once"""
+    molds = None
+    """Dictionary by absolute file name of (file_key, LayerMoldList)"""
+    running = None
+    """False after a shutdown request"""
+    start_time = None
+    """Time when the server is started"""
+    lock = None
+    """Serializes the requests of the connections, the modeling kernel is not reentrant"""
+    connections = None
+    """Dictionary by connection socket of the threads serving them"""
+
+    def __init__(self, socket_path=None, license_key=""):
+        import delamo.CADwrap
+
+        if socket_path is None:
+            socket_path = default_socket_path()
+            pass
+        self.socket_path = socket_path
+        self.modelbuilder = delamo.CADwrap.ModelBuilder(license_key=license_key)
+        self.molds = {}
+        self.running = False
+        self.start_time = time.time()
+        self.lock = threading.Lock()
+        self.connections = {}
+        pass
+
+    def serve_forever(self):
+        """ Accepts the connections until a shutdown request is received."""
+
+        # A stale socket file is left behind if a previous server is killed
+        if os.path.exists(self.socket_path):
+            if ModelBuilderClient.is_running(self.socket_path):
+                raise IOError("Another server is listening on %s" % (self.socket_path))
+            os.remove(self.socket_path)
+            pass
+
+        listener = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        try:
+            # Socket file is created by bind(), only the owner can connect to it from the start
+            old_umask = os.umask(0o177)
+            try:
+                listener.bind(self.socket_path)
+                pass
+            finally:
+                os.umask(old_umask)
+                pass
+            listener.listen(8)
+            # accept() wakes up periodically to notice a shutdown request
+            listener.settimeout(0.5)
+            self.running = True
+            while self.running:
+                try:
+                    (conn, addr) = listener.accept()
+                    pass
+                except socket.timeout:
+                    continue
+                conn.settimeout(None)
+                thread = threading.Thread(target=self.serve_connection, args=(conn,))
+                thread.daemon = True
+                with self.lock:
+                    self.connections[conn] = thread
+                    pass
+                thread.start()
+                pass
+            pass
+        finally:
+            listener.close()
+            if os.path.exists(self.socket_path):
+                os.remove(self.socket_path)
+                pass
+            self.close_connections()
+            pass
+        pass
+
+    def serve_connection(self, conn):
+        """ Thread function serving a single connection."""
+        try:
+            self.handle_connection(conn)
+            pass
+        finally:
+            conn.close()
+            with self.lock:
+                del self.connections[conn]
+                pass
+            pass
+        pass
+
+    def close_connections(self):
+        """ Closes the remaining connections after a shutdown request and waits until their layers are released."""
+        with self.lock:
+            connections = list(self.connections.items())
+            pass
+        for (conn, thread) in connections:
+            try:
+                # Wakes up the thread waiting for the next request
+                conn.shutdown(socket.SHUT_RDWR)
+                pass
+            except socket.error:
+                pass
+            thread.join()
+            pass
+        pass
+
+    def handle_connection(self, conn):
+        """ Executes the requests of a connection until it is closed."""
+        layers = {}  # Layers created over this connection by name
+        layer_molds = {}  # Mold lists used by the layers of this connection by layer name
+        stream = conn.makefile("rb")
+        try:
+            for line in stream:
+                if len(line.strip()) == 0:
+                    continue
+                try:
+                    request = json.loads(line.decode("utf-8"))
+                    if request.get("op") == "ping":
+                        # Answered while the request of another connection is running
+                        response = {"ok": True, "result": self.execute(request, layers, layer_molds)}
+                        pass
+                    else:
+                        with self.lock:
+                            response = {"ok": True, "result": self.execute(request, layers, layer_molds)}
+                            pass
+                        pass
+                    pass
+                except Exception as e:
+                    response = {"ok": False, "error": "%s: %s" % (e.__class__.__name__, str(e))}
+                    traceback.print_exc()
+                    pass
+                conn.sendall((json.dumps(response) + "\n").encode("utf-8"))
+                if not self.running:
+                    break
+                pass
+            pass
+        except socket.error:
+            # Client went away in the middle of a response
+            pass
+        finally:
+            stream.close()
+            with self.lock:
+                self.release_layers(layers, layer_molds)
+                pass
+            pass
+        pass
+
+    def release_layers(self, layers, layer_molds):
+        """ Releases the layers of a connection with their solid bodies, returns the number of released layers.
+A mold list replaced by a reload is dropped once the layers of no connection refer to it.
+The caller holds the request lock."""
+        import delamo.CADwrap
+
+        layer_list = delamo.CADwrap.LayerList()
+        for name in layers:
+            layer_list.add(layers[name])
+            pass
+        num_layers = 0
+        if len(layers) > 0:
+            num_layers = self.modelbuilder.release_layers(layer_list)
+            pass
+        layers.clear()
+        layer_molds.clear()
+        return num_layers
+
+    def load_molds(self, file_name):
+        """ Loads the molds in a file once, reloading them only if the file is modified.
+The previously loaded LayerMoldList stays alive as long as a layer created on its molds refers to it."""
+        import delamo.CADwrap
+
+        file_name = os.path.abspath(file_name)
+        stat = os.stat(file_name)
+        file_key = (stat.st_mtime, stat.st_size)
+        if file_name not in self.molds or self.molds[file_name][0] != file_key:
+            lm_list = delamo.CADwrap.LayerMoldList()
+            self.modelbuilder.load_molds(file_name, lm_list)
+            self.molds[file_name] = (file_key, lm_list)
+            pass
+        return self.molds[file_name][1]
+
+    def execute(self, request, layers, layer_molds):
+        """ Executes a single request.
+ * request: Dictionary decoded from the request line, "op" selects the operation
+ * layers: Dictionary by name of the layers created over the connection
+ * layer_molds: Dictionary by layer name of the LayerMoldList each layer of the connection is created on
+Returns a JSON serializable result."""
+        import delamo.CADwrap
+
+        op = request["op"]
+
+        if op == "ping":
+            return {"pid": os.getpid(), "uptime": time.time() - self.start_time, "molds": len(self.molds)}
+
+        if op == "load_molds":
+            return len(self.load_molds(request["file"]))
+
+        if op == "create_layer":
+            # Names refer to the layers in the later requests, a replaced layer could not be released anymore
+            name = request["name"]
+            if name in layers:
+                raise ValueError("Layer already exists: %s" % (name))
+
+            # Layer is created on a mold, or using a previously created layer as the mold
+            lm_list = None
+            if "mold" in request:
+                lm_list = self.load_molds(request["mold"]["file"])
+                mold = lm_list[request["mold"].get("index", 0)]
+                pass
+            else:
+                mold = layers[request["layer"]]
+                lm_list = layer_molds.get(request["layer"])
+                pass
+            gk_layer = delamo.CADwrap.Layer()
+            self.modelbuilder.create_layer(mold, _direction(request["direction"]), float(request["thickness"]), gk_layer)
+            gk_layer.name(str(name))
+            if "layup" in request:
+                gk_layer.layup(int(request["layup"]))
+                pass
+            layers[name] = gk_layer
+            layer_molds[name] = lm_list
+            return list(gk_layer.bodynames())
+
+        if op == "adjacent_layers":
+            gk_delaminationlist = delamo.CADwrap.StringList()
+            for delamfilename in request.get("delaminations", []):
+                gk_delaminationlist.add(str(delamfilename))
+                pass
+            return self.modelbuilder.adjacent_layers(layers[request["layer1"]],
+                                                     layers[request["layer2"]],
+                                                     gk_delaminationlist,
+                                                     _bc_status(request.get("default_bc", "TIE")),
+                                                     _bc_status(request.get("delam_bc", "CONTACT")),
+                                                     _bc_status(request.get("delam_ring_bc", "NONE")))
+
+        if op == "save":
+            layer_list = delamo.CADwrap.LayerList()
+            for name in request.get("layers", sorted(layers.keys())):
+                layer_list.add(layers[name])
+                pass
+            BodyNameList = delamo.CADwrap.StringList()
+            self.modelbuilder.save(str(request["file"]), layer_list, BodyNameList)
+            return [BodyNameList[cnt] for cnt in range(len(BodyNameList))]
+
+        if op == "release_layers":
+            return self.release_layers(layers, layer_molds)
+
+        if op == "shutdown":
+            self.running = False
+            return None
+
+        raise ValueError("Unknown operation: %s" % (str(op)))
+
+    pass
+
+
+class ModelBuilderClient(object):
+    """ Thin client sending the modeling requests to a ModelBuilderServer.
+The layers are referred to by their names."""
+
+    sock = None
+    """Connected Unix domain socket"""
+    stream = None
+    """File object reading the responses"""
+
+    def __init__(self, socket_path=None, timeout=None):
+        """ Connects to the server.
+ * timeout: Socket timeout in seconds, None waits for the requests as long as they take"""
+        if socket_path is None:
+            socket_path = default_socket_path()
+            pass
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.settimeout(timeout)
+        self.sock.connect(socket_path)
+        self.stream = self.sock.makefile("rb")
+        pass
+
+    @classmethod
+    def is_running(cls, socket_path=None, timeout=5.0):
+        """ Checks whether a server is listening on the socket and answers within the timeout."""
+        try:
+            client = cls(socket_path, timeout=timeout)
+            pass
+        except socket.error:
+            return False
+        try:
+            client.ping()
+            return True
+        except (socket.error, RuntimeError, ValueError):
+            return False
+        finally:
+            client.close()
+            pass
+        pass
+
+    def request(self, op, **kwargs):
+        """ Sends a request and waits for its result. Raises RuntimeError if the request fails."""
+        request = dict(kwargs)
+        request["op"] = op
+        self.sock.sendall((json.dumps(request) + "\n").encode("utf-8"))
+        line = self.stream.readline()
+        if len(line) == 0:
+            raise RuntimeError("Model builder server closed the connection")
+        response = json.loads(line.decode("utf-8"))
+        if not response["ok"]:
+            raise RuntimeError(response["error"])
+        return response["result"]
+
+    def ping(self):
+        return self.request("ping")
+
+    def load_molds(self, file_name):
+        """ Loads the molds in a file on the server, returns the number of molds."""
+        return self.request("load_molds", file=os.path.abspath(file_name))
+
+    def create_layer(self, name, thickness, direction, mold_file=None, mold_index=0, layer=None, layup=None):
+        """ Creates a layer on a mold in a file, or on a previously created layer.
+ * direction: "ORIG" or "OFFSET"
+Returns the body names of the new layer."""
+        kwargs = {"name": name, "thickness": thickness, "direction": direction}
+        if mold_file is not None:
+            kwargs["mold"] = {"file": os.path.abspath(mold_file), "index": mold_index}
+            pass
+        else:
+            kwargs["layer"] = layer
+            pass
+        if layup is not None:
+            kwargs["layup"] = layup
+            pass
+        return self.request("create_layer", **kwargs)
+
+    def bond_layers(self, layer1, layer2, delaminationlist=None, defaultBC="TIE", delamBC="CONTACT", delamRingBC="NONE"):
+        """ Imprints the faces of two adjacent layers, returns the face adjacency list."""
+        delaminations = [os.path.abspath(delamfilename) for delamfilename in (delaminationlist or [])]
+        return self.request("adjacent_layers", layer1=layer1, layer2=layer2, delaminations=delaminations,
+                            default_bc=defaultBC, delam_bc=delamBC, delam_ring_bc=delamRingBC)
+
+    def save(self, file_name, layers=None):
+        """ Saves the layers, all layers of the connection by default, returns the body names in the saved order."""
+        kwargs = {"file": os.path.abspath(file_name)}
+        if layers is not None:
+            kwargs["layers"] = layers
+            pass
+        return self.request("save", **kwargs)
+
+    def release_layers(self):
+        return self.request("release_layers")
+
+    def shutdown(self):
+        return self.request("shutdown")
+
+    def close(self):
+        self.stream.close()
+        self.sock.close()
+        pass
+
+    pass
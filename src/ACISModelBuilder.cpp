@@ -1,10 +1,26 @@
 #include "ACISModelBuilder.h"
 
 
+// Number of started ACISModelBuilder instances, guarded by the kernel lock
+static int acis_kernel_users = 0;
+
+
 void ACISModelBuilder::start()
 {
+	auto lock = this->kernel_lock();
+
 	//this->_pPtNmAlgo = new PNFind_UVseek();
-	this->_pPtNmAlgo = new PNFind_BBox();
+	if (this->_pPtNmAlgo == nullptr)
+		this->_pPtNmAlgo = new PNFind_BBox();
+
+	// Repeated calls of the same instance are not counted
+	if (this->_bStarted)
+		return;
+	this->_bStarted = true;
+
+	// ACIS is started once per process and shared by all instances
+	if (acis_kernel_users++ > 0)
+		return;
 
 	// Disable ACIS Freelisting for memory leak checking
 	if (this->_mDebugMode)
@@ -71,6 +87,20 @@ void ACISModelBuilder::start()
 
 void ACISModelBuilder::stop()
 {
+	auto lock = this->kernel_lock();
+
+	// Cached profiles are deleted with the rest of the ACIS entities
+	this->_mDelamProfileCache.clear();
+
+	// An instance which is not started does not use the kernel
+	if (!this->_bStarted)
+		return;
+	this->_bStarted = false;
+
+	// The other instances still use the kernel, the entities are released when the last instance stops
+	if (--acis_kernel_users > 0)
+		return;
+
 	// Attempt to release all memory allocated by ACIS
 	// @see: Spatial Docs on "Library Initialization and Termination"
 	this->_check_outcome(api_stop_modeller(), __FILE__, __LINE__, __FUNCTION__);
@@ -90,10 +120,10 @@ void ACISModelBuilder::debug_mode(bool flag)
 
 void ACISModelBuilder::is_builder_started()
 {
-	// Directly call the related ACIS function to obtain modeler status
+	// ACIS might be started by another instance, this instance should be started as well
 	int status = is_modeler_started();
 
-	if (!status)
+	if (!status || !this->_bStarted)
 	{
 		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
 			std::cout << "ERROR: Please start the Model Builder before using it!" << std::endl;
@@ -103,6 +133,8 @@ void ACISModelBuilder::is_builder_started()
 
 void ACISModelBuilder::save_cad_model(const char* file_name, delamo::List<Layer *>& layer_list)
 {
+	auto lock = this->kernel_lock();
+
 	// Check if there are any layers to save
 	if (layer_list.size() <= 0)
 	{
@@ -122,6 +154,7 @@ void ACISModelBuilder::save_cad_model(const char* file_name, delamo::List<Layer
 		int numLayerBodies = layer->size();
 		for (int i = 0; i < numLayerBodies; i++)
 		{
+			this->attach_fingerprint((BODY*)bodylist[i]->body(), layer->fingerprint());
 			to_be_saved.add(bodylist[i]->body());
 		}
 		totalLayerBodies += numLayerBodies;
@@ -170,6 +203,188 @@ void ACISModelBuilder::save_cad_model(const char* file_name, delamo::List<Layer
 	fclose(fp);
 }
 
+void ACISModelBuilder::save_cad_shard(const char* file_name, Layer* layer, delamo::Span<LayerBody*> bodies)
+{
+	auto lock = this->kernel_lock();
+
+	// Collect the bodies of the shard to an ACIS list before saving
+	ENTITY_LIST to_be_saved;
+	for (auto lb : bodies)
+	{
+		this->attach_fingerprint((BODY*)lb->body(), layer->fingerprint());
+		to_be_saved.add(lb->body());
+	}
+
+	// Shards use the same header and version as the monolithic SAT file
+	FileInfo info;
+	info.set_product_id(file_name);
+	info.set_units(1.0);
+	this->_check_outcome(api_set_file_info(FileUnits | FileIdent, info), __FILE__, __LINE__, __FUNCTION__);
+	this->_check_outcome(api_save_version(18, 0), __FILE__, __LINE__, __FUNCTION__);
+
+	// Try to create a file handle for writing
+	FILE *fp = fopen(file_name, "w");
+	if (fp == NULL)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Unable to open file for writing!" << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	// Save the CAD data as a SAT file, the file handle is closed before a failure is reported
+	outcome result = api_save_entity_list(fp, true, to_be_saved);
+	bool closed = (fclose(fp) == 0);
+	this->_check_outcome(result, __FILE__, __LINE__, __FUNCTION__);
+	if (!closed)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Unable to write the shard " << file_name << "!" << std::endl;
+		this->error_handler();
+	}
+}
+
+const char* ACISModelBuilder::cad_file_extension()
+{
+	return ".sat";
+}
+
+const char* ACISModelBuilder::cache_format()
+{
+	return "ACIS-SAT-18";
+}
+
+bool ACISModelBuilder::save_cache_body(LayerBody* lb, std::string& blob, delamo::List<DLM_FACEP>& faces)
+{
+	auto lock = this->kernel_lock();
+
+	if (!this->save_sat_body(lb->body(), blob))
+		return false;
+
+	// Face order of the SAT data is the same as the order of api_get_faces()
+	ENTITY_LIST face_list;
+	this->_check_outcome(api_get_faces(lb->body(), face_list), __FILE__, __LINE__, __FUNCTION__);
+	for (int i = 0; i < face_list.count(); i++)
+		faces.add((FACE*)face_list[i]);
+
+	return true;
+}
+
+bool ACISModelBuilder::restore_cache_body(LayerBody* lb, const std::string& blob, delamo::List<DLM_FACEP>& faces)
+{
+	auto lock = this->kernel_lock();
+
+	BODY* restored = this->restore_sat_body(blob);
+	if (restored == NULL)
+		return false;
+
+	// Replace the existing body, the LayerSurface objects are updated with the new faces by the caller
+	if (lb->body() != NULL)
+		this->_check_outcome(api_del_entity(lb->body()), __FILE__, __LINE__, __FUNCTION__);
+	lb->body(restored);
+
+	ENTITY_LIST face_list;
+	this->_check_outcome(api_get_faces(lb->body(), face_list), __FILE__, __LINE__, __FUNCTION__);
+	for (int i = 0; i < face_list.count(); i++)
+		faces.add((FACE*)face_list[i]);
+
+	return true;
+}
+
+bool ACISModelBuilder::save_cache_mold(LayerMold* lm, std::string& blob)
+{
+	auto lock = this->kernel_lock();
+
+	return this->save_sat_body(lm->body(), blob);
+}
+
+bool ACISModelBuilder::restore_cache_mold(LayerMold* lm, const std::string& blob)
+{
+	auto lock = this->kernel_lock();
+
+	BODY* restored = this->restore_sat_body(blob);
+	if (restored == NULL)
+		return false;
+
+	if (lm->body() != NULL)
+		this->_check_outcome(api_del_entity(lm->body()), __FILE__, __LINE__, __FUNCTION__);
+	lm->body(restored);
+	return true;
+}
+
+bool ACISModelBuilder::save_sat_body(BODY* body, std::string& blob)
+{
+	if (body == NULL)
+		return false;
+
+	ENTITY_LIST to_be_saved;
+	to_be_saved.add(body);
+
+	// Use the same header and version as save_cad_model()
+	FileInfo info;
+	info.set_product_id("DeLaMo cache");
+	info.set_units(1.0);
+	this->_check_outcome(api_set_file_info(FileUnits | FileIdent, info), __FILE__, __LINE__, __FUNCTION__);
+	this->_check_outcome(api_save_version(18, 0), __FILE__, __LINE__, __FUNCTION__);
+
+	// Save the body as SAT text to a temporary file and read it back
+	FILE *fp = tmpfile();
+	if (fp == NULL)
+		return false;
+	this->_check_outcome(api_save_entity_list(fp, true, to_be_saved), __FILE__, __LINE__, __FUNCTION__);
+	long blob_size = ftell(fp);
+	rewind(fp);
+	blob.resize(blob_size > 0 ? (size_t)blob_size : 0);
+	bool saved = (blob_size > 0 && fread(&blob[0], 1, blob.size(), fp) == blob.size());
+	fclose(fp);
+	return saved;
+}
+
+BODY* ACISModelBuilder::restore_sat_body(const std::string& blob)
+{
+	FILE *fp = tmpfile();
+	if (fp == NULL)
+		return NULL;
+	bool written = (fwrite(blob.data(), 1, blob.size(), fp) == blob.size());
+	rewind(fp);
+
+	ENTITY_LIST restored;
+	if (written)
+		this->_check_outcome(api_restore_entity_list(fp, true, restored), __FILE__, __LINE__, __FUNCTION__);
+	fclose(fp);
+	if (restored.count() != 1)
+		return NULL;
+	return (BODY*)restored[0];
+}
+
+void ACISModelBuilder::attach_fingerprint(BODY* body, const Fingerprint& fp)
+{
+	if (body == NULL || !fp.valid())
+		return;
+
+	// Replace the attribute attached by a previous save
+	api_remove_generic_named_attribute(body, "DELAMO_FINGERPRINT");
+	this->_check_outcome(api_add_generic_named_attribute(body, "DELAMO_FINGERPRINT", fp.hex().c_str()), __FILE__, __LINE__, __FUNCTION__);
+}
+
+void ACISModelBuilder::release_cache_body(LayerBody* lb)
+{
+	auto lock = this->kernel_lock();
+
+	if (lb->body() != NULL)
+		this->_check_outcome(api_del_entity(lb->body()), __FILE__, __LINE__, __FUNCTION__);
+	lb->body(NULL);
+}
+
+void ACISModelBuilder::release_cache_mold(LayerMold* lm)
+{
+	auto lock = this->kernel_lock();
+
+	if (lm->body() != NULL)
+		this->_check_outcome(api_del_entity(lm->body()), __FILE__, __LINE__, __FUNCTION__);
+	lm->body(NULL);
+}
+
 int ACISModelBuilder::GetTrianglesFromFacetedFace(FACE* face, std::vector<SPAposition>* triVerts)
 {
 	// Find the attribute for facets attached to the face. This is the mesh.
@@ -230,7 +445,9 @@ int ACISModelBuilder::GetTrianglesFromFacetedFace(FACE* face, std::vector<SPApos
 
 
 void ACISModelBuilder::save_layer_stl(const char* file_name, Layer *layer)
-{ 
+{
+	auto lock = this->kernel_lock();
+
 	ENTITY_LIST layerBodies;
 	LayerBody** bodylist = layer->list();
 	int numLayerBodies = layer->size();
@@ -351,6 +568,8 @@ void ACISModelBuilder::save_layer_stl(const char* file_name, Layer *layer)
 
 void ACISModelBuilder::save_layer_surface_stl(const char* file_name, Layer *layer1, Layer *layer2)
 {
+	auto lock = this->kernel_lock();
+
 	ENTITY_LIST layerSurfaces;
 	LayerBody** bodylist = layer1->list();
 	int numLayerBodies = layer1->size();
@@ -483,6 +702,8 @@ void ACISModelBuilder::save_layer_surface_stl(const char* file_name, Layer *laye
 
 void ACISModelBuilder::save_cad_model(const char* file_name, delamo::List<Layer *>& layer_list, delamo::List<MBBody*>& mbbody_list)
 {
+	auto lock = this->kernel_lock();
+
 	// Check if there are any layers to save
 	if (layer_list.size() <= 0 && mbbody_list.size() <= 0)
 	{
@@ -502,6 +723,7 @@ void ACISModelBuilder::save_cad_model(const char* file_name, delamo::List<Layer
 		int numLayerBodies = layer->size();
 		for (int i = 0; i < numLayerBodies; i++)
 		{
+			this->attach_fingerprint((BODY*)bodylist[i]->body(), layer->fingerprint());
 			to_be_saved.add(bodylist[i]->body());
 		}
 		totalLayerBodies += numLayerBodies;
@@ -560,6 +782,8 @@ void ACISModelBuilder::save_cad_model(const char* file_name, delamo::List<Layer
 
 void ACISModelBuilder::load_shell_sat_model(LayerMold  *lm, delamo::List<delamo::TPoint3<double>>& point_list, delamo::List<delamo::TPoint3<double>>& tangent_list, delamo::List<delamo::TPoint3<double>>& normal_list)
 {
+	auto lock = this->kernel_lock();
+
 	ENTITY_LIST face_list;
 	this->_check_outcome(api_get_faces(lm->body(), face_list), __FILE__, __LINE__, __FUNCTION__);
 	// Extract all the loops from the shell mold
@@ -654,6 +878,8 @@ void ACISModelBuilder::load_shell_sat_model(LayerMold  *lm, delamo::List<delamo:
 
 void ACISModelBuilder::load_shell_sat_model(const char* file_name, bool text_mode, delamo::List<delamo::TPoint3<double>>& point_list, delamo::List<delamo::TPoint3<double>>& tangent_list, delamo::List<delamo::TPoint3<double>>& normal_list)
 {
+	auto lock = this->kernel_lock();
+
 	// Try to create a file handle for reading
 	FILE *fp = fopen(file_name, "r");
 	if (fp == NULL)
@@ -701,6 +927,8 @@ void ACISModelBuilder::load_shell_sat_model(const char* file_name, bool text_mod
 
 void ACISModelBuilder::create_shell_cutout_sat(const char* file_name, bool text_mode, delamo::List<LayerMold *>& lm_list)
 {
+	auto lock = this->kernel_lock();
+
 	// Try to create a file handle for reading
 	FILE *fp = fopen(file_name, "r");
 	if (fp == NULL)
@@ -776,6 +1004,8 @@ void ACISModelBuilder::create_shell_cutout_sat(const char* file_name, bool text_
 
 void ACISModelBuilder::load_cad_model(const char* file_name, bool text_mode, delamo::List<LayerMold *>& lm_list)
 {
+	auto lock = this->kernel_lock();
+
 	// Try to create a file handle for reading
 	FILE *fp = fopen(file_name, "r");
 	if (fp == NULL)
@@ -1046,7 +1276,7 @@ void ACISModelBuilder::process_layer(Layer *layer_in, BODY* sheet_body_in, Direc
 	mold_list.add(sheet_body_ent);
 
 	// Generate a LayerBody object
-	LayerBody *layer_body=new LayerBody();
+	LayerBody *layer_body=this->new_layer_body();
 	// Set layer body name
 	std::string body_name = "LB" + std::to_string(layer_in->next_lb_id);
 	layer_body->name(body_name.c_str());
@@ -1107,9 +1337,10 @@ void ACISModelBuilder::process_layer(Layer *layer_in, BODY* sheet_body_in, Direc
 		double vec_angle = radians_to_degrees(angle_between(eval_normal, reference_normal));
 
 		// Update the layer surface
-		LayerSurface *current_layersurface = new LayerSurface();
+		LayerSurface *current_layersurface = this->new_layer_surface();
 		current_layersurface->id(layer_body->next_ls_id);
 		current_layersurface->face(current_face);
+		current_layersurface->topology_tag(this->face_topology_tag(current_face));
 		current_layersurface->point(eval_pos);
 		current_layersurface->normal(eval_normal);
 		current_layersurface->angle(vec_angle);
@@ -1214,7 +1445,7 @@ void ACISModelBuilder::generate_mold(Layer *layer_in)
 		mold_offset = mold_offset_body;
 
 		// Store the offset mold inside the layer
-		LayerMold *layer_mold_offset=new LayerMold();
+		LayerMold *layer_mold_offset=this->new_layer_mold();
 		layer_mold_offset->body(mold_offset);
 		layer_mold_offset->direction(Direction::OFFSET);
 		layer_mold_offset->owner(layer_in);
@@ -1268,7 +1499,7 @@ void ACISModelBuilder::generate_mold(Layer *layer_in)
 		mold_orig = mold_orig_body;
 
 		// Store the orig mold inside the layer
-		LayerMold *layer_mold_orig=new LayerMold();
+		LayerMold *layer_mold_orig=this->new_layer_mold();
 		layer_mold_orig->body(mold_orig);
 		layer_mold_orig->direction(Direction::ORIG);
 		layer_mold_orig->owner(layer_in);
@@ -1277,21 +1508,13 @@ void ACISModelBuilder::generate_mold(Layer *layer_in)
 		// Add orig mold to the LayerBody object
 		layerbody->mold(layer_mold_orig);
 	}
+
+	// Molds are identified by the layer they are generated from
+	this->fingerprint_molds(layer_in);
 }
 
-void ACISModelBuilder::create_layer(delamo::NURBS<double> *nurbs_in, Direction ldir, double thickness, Layer *layer_out)
+void ACISModelBuilder::do_create_layer(delamo::NURBS<double> *nurbs_in, Direction ldir, double thickness, Layer *layer_out)
 {
-	// Check whether ACIS is running or not
-	this->is_builder_started();
-
-	// Check whether thickness is positive or not
-	if (thickness <= 0)
-	{
-		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
-			std::cout << "ERROR: Please provide a positive thickness!" << std::endl;
-		this->error_handler();
-	}
-
 	// Set layer type
 	layer_out->type(LayerType::LAMINA);
 
@@ -1307,52 +1530,10 @@ void ACISModelBuilder::create_layer(delamo::NURBS<double> *nurbs_in, Direction l
 
 	// Create the layer
 	this->process_layer(layer_out, sheet_body, ldir, "LB0");
-
-	// Set a unique layer ID using the BODY element of the first LayerBody
-	//tag_id_type layer_id;
-	//this->_outcome = api_get_entity_id(layer_out.list()->body(), layer_id);
-	//this->get_api_log(__FILE__, __FUNCTION__, __LINE__);
-	//layer_out.id(layer_id);
-	layer_out->id(this->next_layer_id());
-
-	//// Save this layer for testing
-	//delamo::List<Layer> test_list;
-	//test_list.add(layer_out);
-	//this->save_cad_model("Test.SAT", test_list);
-
-	// Generate molds
-	this->generate_mold(layer_out);
-
-	// Update layer surface owners
-	layer_out->update_owners();
 }
 
-void ACISModelBuilder::create_layer(delamo::NURBS<double> *nurbs_surface_in, double thickness, Layer *layer_out)
+void ACISModelBuilder::do_create_layer(Layer *layer_in, Direction ldir, double thickness, Layer *layer_out)
 {
-	this->create_layer(nurbs_surface_in, Direction::OFFSET, thickness, layer_out);
-}
-
-void ACISModelBuilder::create_layer(Layer *layer_in, Direction ldir, double thickness, Layer *layer_out)
-{
-	// Check whether ACIS is running or not
-	this->is_builder_started();
-
-	// Check whether thickness is positive or not
-	if (thickness <= 0)
-	{
-		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
-			std::cout << "ERROR: Please provide a positive thickness!" << std::endl;
-		this->error_handler();
-	}
-
-	// Check the input layer has a body or not
-	if (0 == layer_in->size())
-	{
-		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
-			std::cout << "ERROR: Input layer is empty!" << std::endl;
-		this->error_handler();
-	}
-
 	// Set layer type
 	layer_out->type(LayerType::LAMINA);
 
@@ -1402,38 +1583,12 @@ void ACISModelBuilder::create_layer(Layer *layer_in, Direction ldir, double thic
 			body_cnt++;
 		}
 	}
-
-	// Set a unique layer ID using the BODY element of the first LayerBody
-	layer_out->id(this->next_layer_id());
-
-	// Generate molds
-	this->generate_mold(layer_out);
-
-	// Update layer surface owners
-	layer_out->update_owners();
 }
 
-void ACISModelBuilder::create_layer(LayerMold *mold_in, Direction ldir, double thickness, Layer *layer_out)
+void ACISModelBuilder::do_create_layer(LayerMold *mold_in, Direction ldir, double thickness, Layer *layer_out)
 {
-	// Check whether ACIS is running or not
-	this->is_builder_started();
-
-	// Check whether thickness is positive or not
-	if (thickness <= 0)
-	{
-		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
-			std::cout << "ERROR: Please provide a positive thickness!" << std::endl;
-		this->error_handler();
-	}
-
 	// Retrieve sheet body from input LayerMold
 	BODY* sheet_body = mold_in->body();
-	if (sheet_body == NULL)
-	{
-		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
-			std::cout << "ERROR: Input mold is empty!" << std::endl;
-		this->error_handler();
-	}
 
 	// Set layer type
 	layer_out->type(LayerType::LAMINA);
@@ -1453,31 +1608,32 @@ void ACISModelBuilder::create_layer(LayerMold *mold_in, Direction ldir, double t
 
 	// Create the BODY object and find faces & points
 	this->process_layer(layer_out, sheet_body, ldir, "LB0");
-
-	// Set a unique layer ID using the BODY element of the first LayerBody
-	layer_out->id(this->next_layer_id());
-
-	// Generate molds
-	this->generate_mold(layer_out);
-
-	// Update layer surface owners
-	layer_out->update_owners();
 }
 
-void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset)
+void ACISModelBuilder::do_adjacent_layers(Layer *layer_orig, Layer *layer_offset)
 {
 	// Find pairs before applying any imprint operations
 	this->update_surface_pairs(layer_offset, layer_orig);
 
 	// Imprint layers to each other
+	int skipped_imprints = 0;
 	for (auto& lb_orig : *layer_orig)
 	{
 		for (auto& lb_offset : *layer_offset)
+		{
+			// Bodies which are not touching each other have nothing to imprint
+			if (!this->bodies_overlap(lb_orig, lb_offset))
+			{
+				skipped_imprints++;
+				continue;
+			}
 			this->_check_outcome(api_imprint(lb_orig->body(), lb_offset->body()), __FILE__, __LINE__, __FUNCTION__);
+		}
 	}
+	this->_mSkippedImprints += skipped_imprints;
 
-	// Use an arbitrary reference position
-	SPAposition reference_pos(0, 0, 0);
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO && skipped_imprints > 0)
+		std::cout << "INFO: Skipped " << skipped_imprints << " imprint operations between non-overlapping layer bodies" << std::endl;
 
 	// Use a reference normal according to layer generation direction
 	SPAunit_vector reference_normal(0, 0, 1);
@@ -1497,12 +1653,9 @@ void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset)
 		// Only update the LayerSurface list if we have new faces
 		if (facelist.iteration_count() > lb->size())
 		{
-			// Generate an identity transform for point discovery function
-			SPAtransf current_body_transf;
-			// If the body has a transform, we can use it too
-			TRANSFORM* cb_transfrm = current_body->transform();
-			if (cb_transfrm != NULL)
-				current_body_transf = cb_transfrm->transform();
+			// Container to store the LayerSurface objects of the new faces
+			delamo::List<LayerSurface *> lsc_new;
+			lsc_new.reserve(facelist.iteration_count() - lb->size());
 
 			// Traverse through all faces of the current body
 			FACE* current_face;
@@ -1511,11 +1664,6 @@ void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset)
 				// Check if this face exists in our list
 				int face_idx = lb->face_id(current_face);
 
-				// Find a reference point and a normal
-				SPAunit_vector eval_normal;
-				SPAposition eval_pos;
-				this->_pPtNmAlgo->find_point_normal(current_face, current_body_transf, reference_pos, eval_pos, eval_normal, true);
-
 				// If face exists, then update. Otherwise, add the new face to the LayerSurface list
 				if (face_idx >= 0)
 				{
@@ -1525,22 +1673,27 @@ void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset)
 					{
 						// Update existing LayerSurface
 						face_ls->initial_surface(false);
-						face_ls->point(eval_pos);
-						face_ls->normal(eval_normal);
+
+						// Only the faces changed by imprinting need a new reference point and normal, which are computed on first use
+						unsigned long long topo_tag = this->face_topology_tag(current_face);
+						if (topo_tag != face_ls->topology_tag())
+						{
+							face_ls->topology_tag(topo_tag);
+							face_ls->invalidate(&this->_mEvalPointNormal);
+						}
 					}
 				}
 				else
 				{
-					// Calculate the angle between the reference normal and the face normal
-					double vec_angle = radians_to_degrees(angle_between(eval_normal, reference_normal));
-
-					// Update the layer surface
-					LayerSurface *current_layersurface=new LayerSurface();
-					current_layersurface->id(lb->next_ls_id);
+					// Update the layer surface. Reference point, normal and angle are computed on first use.
+					LayerSurface *current_layersurface=this->new_layer_surface();
+					current_layersurface->id(lb->next_ls_id + lsc_new.size());
 					current_layersurface->face(current_face);
-					current_layersurface->point(eval_pos);
-					current_layersurface->normal(eval_normal);
-					current_layersurface->angle(vec_angle);
+					current_layersurface->topology_tag(this->face_topology_tag(current_face));
+					if (reference_normal.z() > 0)
+						current_layersurface->invalidate(&this->_mEvalOffsetNormal);
+					else
+						current_layersurface->invalidate(&this->_mEvalOrigNormal);
 
 					//this->find_initial_ls_direction(current_layersurface, eval_normal, reference_normal);
 
@@ -1550,10 +1703,13 @@ void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset)
 					// Set owner of the surface
 					current_layersurface->owner(lb);
 
-					// Add the generated layer surface object to the layer body
-					lb->add_surface(current_layersurface);
+					// Collect the generated layer surface object
+					lsc_new.add(current_layersurface);
 				}
 			}
+
+			// Add the generated layer surface objects to the layer body
+			lb->add_surfaces(lsc_new);
 		}
 
 		// Clear face list
@@ -1578,12 +1734,9 @@ void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset)
 		// Only update the LayerSurface list if we have new faces
 		if (facelist.iteration_count() > lb->size())
 		{
-			// Generate an identity transform for point discovery function
-			SPAtransf current_body_transf;
-			// If the body has a transform, we can use it too
-			TRANSFORM* cb_transfrm = current_body->transform();
-			if (cb_transfrm != NULL)
-				current_body_transf = cb_transfrm->transform();
+			// Container to store the LayerSurface objects of the new faces
+			delamo::List<LayerSurface *> lsc_new;
+			lsc_new.reserve(facelist.iteration_count() - lb->size());
 
 			// Traverse through all faces of the current body
 			FACE* current_face;
@@ -1592,11 +1745,6 @@ void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset)
 				// Check if this face exists in our list
 				int face_idx = lb->face_id(current_face);
 
-				// Find a reference point and a normal
-				SPAunit_vector eval_normal;
-				SPAposition eval_pos;
-				this->_pPtNmAlgo->find_point_normal(current_face, current_body_transf, reference_pos, eval_pos, eval_normal, true);
-
 				// If face exists, then update. Otherwise, add the new face to the LayerSurface list
 				if (face_idx >= 0)
 				{
@@ -1606,22 +1754,27 @@ void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset)
 					{
 						// Update existing LayerSurface
 						face_ls->initial_surface(false);
-						face_ls->point(eval_pos);
-						face_ls->normal(eval_normal);
+
+						// Only the faces changed by imprinting need a new reference point and normal, which are computed on first use
+						unsigned long long topo_tag = this->face_topology_tag(current_face);
+						if (topo_tag != face_ls->topology_tag())
+						{
+							face_ls->topology_tag(topo_tag);
+							face_ls->invalidate(&this->_mEvalPointNormal);
+						}
 					}
 				}
 				else
 				{
-					// Calculate the angle between the reference normal and the face normal
-					double vec_angle = radians_to_degrees(angle_between(eval_normal, reference_normal));
-
-					// Update the layer surface
-					LayerSurface *current_layersurface=new LayerSurface();
-					current_layersurface->id(lb->next_ls_id);
+					// Update the layer surface. Reference point, normal and angle are computed on first use.
+					LayerSurface *current_layersurface=this->new_layer_surface();
+					current_layersurface->id(lb->next_ls_id + lsc_new.size());
 					current_layersurface->face(current_face);
-					current_layersurface->point(eval_pos);
-					current_layersurface->normal(eval_normal);
-					current_layersurface->angle(vec_angle);
+					current_layersurface->topology_tag(this->face_topology_tag(current_face));
+					if (reference_normal.z() > 0)
+						current_layersurface->invalidate(&this->_mEvalOffsetNormal);
+					else
+						current_layersurface->invalidate(&this->_mEvalOrigNormal);
 
 					//this->find_initial_ls_direction(current_layersurface, eval_normal, reference_normal);
 
@@ -1631,10 +1784,13 @@ void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset)
 					// Set owner of the surface
 					current_layersurface->owner(lb);
 
-					// Add the generated layer surface object to the layer body
-					lb->add_surface(current_layersurface);
+					// Collect the generated layer surface object
+					lsc_new.add(current_layersurface);
 				}
 			}
+
+			// Add the generated layer surface objects to the layer body
+			lb->add_surfaces(lsc_new);
 		}
 
 		// Clear face list
@@ -1653,21 +1809,14 @@ void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset)
 
 	// New layer surfaces generated by imprinting will be paired here
 	this->update_surface_pairs(layer_offset, layer_orig);
-
-	// Set adjacent pairs
-	layer_offset->bond_pair(Direction::ORIG, layer_orig);
-	layer_orig->bond_pair(Direction::OFFSET, layer_offset);
-
-	if (this->_pInitialLayer == nullptr)
-		this->_pInitialLayer = layer_orig;
 }
 
-void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name)
+void ACISModelBuilder::do_adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name)
 {
 	// Read delamination points
 	delamo::TPoint3<double>* delampts = nullptr;
 	int delampts_size;
-	read_csv_file(file_name, delampts, delampts_size);
+	this->read_delamination_file(file_name, delampts, delampts_size);
 
 	// Check if we were able to load some points from the file
 	if (delampts == nullptr)
@@ -1685,7 +1834,7 @@ void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, c
 				std::cout << "ERROR: The first and the last delamination profile points must be equal. Skipping delamination imprint..." << std::endl;
 
 			// Do layer imprinting without delamination
-			this->adjacent_layers(layer_orig, layer_offset);
+			this->do_adjacent_layers(layer_orig, layer_offset);
 			return;
 		}
 	}
@@ -1705,17 +1854,10 @@ void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, c
 	layer_offset->update_owners();
 
 	// New layer surfaces generated by imprinting will be paired here
-	this->update_surface_pairs(layer_offset, layer_orig);
-
-	// Set adjacent pairs
-	layer_offset->bond_pair(Direction::ORIG, layer_orig);
-	layer_orig->bond_pair(Direction::OFFSET, layer_offset);
-
-	if (this->_pInitialLayer == nullptr)
-		this->_pInitialLayer = layer_orig;
+	this->update_modified_surface_pairs(layer_offset, layer_orig);
 }
 
-void ACISModelBuilder::split_layer(Layer *layer_in, const char* file_name)
+void ACISModelBuilder::do_split_layer(Layer *layer_in, const char* file_name)
 {
 	// Check that the input layer has only 1 layer body
 	if (layer_in->size() != 1)
@@ -1909,7 +2051,7 @@ void ACISModelBuilder::process_split(Layer *layer_in, BODY* tool_body)
 		this->get_body_transf(b, current_body_transf);
 
 		// Create a layer body
-		LayerBody *current_layerbody=new LayerBody();
+		LayerBody *current_layerbody=this->new_layer_body();
 
 		// Set BODY, owner and name of the layer body
 		current_layerbody->body(b);
@@ -1943,7 +2085,7 @@ void ACISModelBuilder::process_split(Layer *layer_in, BODY* tool_body)
 			double vec_angle = radians_to_degrees(angle_between(eval_normal, reference_normal));
 
 			// Update the layer surface
-			LayerSurface *current_layersurface=new LayerSurface();
+			LayerSurface *current_layersurface=this->new_layer_surface();
 			current_layersurface->id(current_layerbody->next_ls_id);
 			current_layersurface->face(current_face);
 			current_layersurface->point(eval_pos);
@@ -2006,7 +2148,7 @@ void ACISModelBuilder::_check_outcome(const outcome& api_retval, const char* fil
 	//init_warnings();
 }
 
-void ACISModelBuilder::create_hat_stiffener(Layer *layer_orig, Layer *stiffener, const char* file_name, double radius)
+void ACISModelBuilder::do_create_hat_stiffener(Layer *layer_orig, Layer *stiffener, const char* file_name, double radius)
 {
 	// Rounded layers
 	if (radius != 0)
@@ -2081,7 +2223,7 @@ void ACISModelBuilder::create_hat_stiffener(Layer *layer_orig, Layer *stiffener,
 	this->_check_outcome(api_convert_to_spline(wire_body, &convertOptions, NULL), __FILE__, __LINE__, __FUNCTION__);
 
 	// We know add we have one single layer body object for the stiffener
-	LayerBody *stiffener_lb=new LayerBody();
+	LayerBody *stiffener_lb=this->new_layer_body();
 	stiffener_lb->name("SB0");
 	stiffener_lb->body(wire_body);
 	stiffener_lb->owner(stiffener);
@@ -2111,7 +2253,7 @@ void ACISModelBuilder::create_hat_stiffener(Layer *layer_orig, Layer *stiffener,
 		double vec_angle = radians_to_degrees(angle_between(eval_normal, ref_normal));
 
 		// Create LayerSurface
-		LayerSurface *stiffener_ls=new LayerSurface();
+		LayerSurface *stiffener_ls=this->new_layer_surface();
 		stiffener_ls->id(stiffener_lb->next_ls_id);
 		stiffener_ls->face(f);
 		stiffener_ls->point(eval_pos);
@@ -2179,73 +2321,260 @@ void ACISModelBuilder::update_surface_pairs(Layer *layer1, Layer *layer2)
 	if (LayerType::STIFFENER == layer1->type() || LayerType::STIFFENER == layer2->type())
 		layer_is_stiffener = true;
 
+	/*
+	 * Build the broad-phase index for the 2nd input layer
+	 */
+	SurfacePairIndex layer2_index;
+	this->build_surface_index(layer2, layer2_index);
+	delamo::List<LayerSurface*> candidates;
+
 	/*
 	 * Start finding surface pairs
 	 */
 
 	for (auto& layer1_lb : *layer1) // START L1 LB
 	{
-		// Get the BODY element of the layer
-		BODY* layer1_lb_body = layer1_lb->body();
-
 		// Generate an identity transform for point discovery function
 		SPAtransf layer1_lb_transf;
 
 		// If the body has a transform, we must use it
-		TRANSFORM* layer1_transfrm = layer1_lb_body->transform();
-		if (layer1_transfrm != NULL)
-		{
-			layer1_lb_transf = layer1_transfrm->transform();
-		}
+		this->get_body_transf(layer1_lb->body(), layer1_lb_transf);
 
 		for (auto& layer1_ls : *layer1_lb) // START L1 LS
 		{
-			for (auto& layer2_lb : *layer2) // START L2 LB
+			// Only check the surfaces which could contain the point of the layer1 surface
+			layer2_index.query(layer1_ls, candidates);
+
+			for (auto& layer2_ls : candidates) // START L2 LS
 			{
-				for (auto& layer2_ls : *layer2_lb) // START L2 LS
+				// Check if we have matching surfaces
+				if (this->check_surface_pair(layer1_ls, layer1_lb_transf, layer2_ls))
 				{
-					// Check that the faces in consideration are touching to each other
-					if (antiparallel(layer1_ls->normal(), layer2_ls->normal(), this->tolerance()) && (abs(layer1_ls->point_coords().z() - layer2_ls->point_coords().z()) < this->tolerance()))
-					{
-						// Parametric position for initial guessing of the position
-						FACE* face_in = layer2_ls->face();
-						surface* surf_in = face_in->geometry()->trans_surface(get_owner_transf(face_in), face_in->sense());
-						SPAinterval u_range = surf_in->param_range_u();
-						SPAinterval v_range = surf_in->param_range_v();
-						SPApar_pos test_uv_guess(this->_u_pos * u_range.length() + u_range.start_pt(), this->_v_pos * v_range.length() + v_range.start_pt());
-						// A variable to store the api_point_in_face() result
-						point_face_containment cont_answer;
-						// Use the cache
-						logical use_cache = TRUE;
-
-						// Check that layer2 face contains the point which is on layer1 face
-						this->_check_outcome(api_point_in_face(layer1_ls->point(), layer2_ls->face(), layer1_lb_transf, cont_answer, test_uv_guess, use_cache), __FILE__, __LINE__, __FUNCTION__);
-
-						// Check if we have matching surfaces
-						if (point_inside_face == cont_answer/* || point_boundary_face == cont_answer*/)
-						{
-							// We have a match!
-							layer2_ls->pair(layer1_ls);
-							layer1_ls->pair(layer2_ls);
-							// Pairing with stiffener
-							layer2_ls->stiffener_paired(layer_is_stiffener);
-							layer1_ls->stiffener_paired(layer_is_stiffener);
-						}
-					}
+					// We have a match!
+					layer2_ls->pair(layer1_ls);
+					layer1_ls->pair(layer2_ls);
+					// Pairing with stiffener
+					layer2_ls->stiffener_paired(layer_is_stiffener);
+					layer1_ls->stiffener_paired(layer_is_stiffener);
+				}
+			} // END L2 LS
+		} // END L1 LS
+	} // END L1 LB
 
-					// A dirty fix for fixing stiffener paired surface flags. As a result, it works!
-					if (layer_is_stiffener)
-					{
-						if (layer1_ls->pair() == NULL)
-							layer1_ls->stiffener_paired(false);
-						if (layer2_ls->pair() == NULL)
-							layer2_ls->stiffener_paired(false);
-					}
+	// A dirty fix for fixing stiffener paired surface flags. As a result, it works!
+	// All surfaces are paired now, so the modified flags can be cleared too.
+	for (auto& layer1_lb : *layer1)
+	{
+		for (auto& layer1_ls : *layer1_lb)
+		{
+			if (layer_is_stiffener && layer1_ls->pair() == NULL)
+				layer1_ls->stiffener_paired(false);
+			layer1_ls->modified(false);
+		}
+	}
+	for (auto& layer2_lb : *layer2)
+	{
+		for (auto& layer2_ls : *layer2_lb)
+		{
+			if (layer_is_stiffener && layer2_ls->pair() == NULL)
+				layer2_ls->stiffener_paired(false);
+			layer2_ls->modified(false);
+		}
+	}
+}
+
+void ACISModelBuilder::update_modified_surface_pairs(Layer *layer1, Layer *layer2)
+{
+	/*
+	 * Find the surfaces created or modified since the last pairing
+	 */
+
+	std::unordered_set<LayerSurface*> modified_ls;
+	for (auto& layer1_lb : *layer1)
+	{
+		for (auto& layer1_ls : *layer1_lb)
+		{
+			if (layer1_ls->is_modified())
+				modified_ls.insert(layer1_ls);
+		}
+	}
+	for (auto& layer2_lb : *layer2)
+	{
+		for (auto& layer2_ls : *layer2_lb)
+		{
+			if (layer2_ls->is_modified())
+				modified_ls.insert(layer2_ls);
+		}
+	}
+
+	// Existing pairs are still valid
+	if (modified_ls.empty())
+		return;
+
+	/*
+	 * Collect the surfaces to be paired again. These are the modified surfaces and their old pairs.
+	 */
+
+	std::unordered_set<LayerSurface*> repair_ls;
+	SurfacePairIndex layer2_repair_index;
+	layer2_repair_index.tolerance(this->tolerance());
+	for (auto& layer1_lb : *layer1)
+	{
+		for (auto& layer1_ls : *layer1_lb)
+		{
+			if (modified_ls.count(layer1_ls) || modified_ls.count(layer1_ls->pair()))
+				repair_ls.insert(layer1_ls);
+		}
+	}
+	for (auto& layer2_lb : *layer2)
+	{
+		SPAtransf lb_transf;
+		this->get_body_transf(layer2_lb->body(), lb_transf);
 
-				} // END L2 LS
-			} // END L2 LB
+		for (auto& layer2_ls : *layer2_lb)
+		{
+			if (modified_ls.count(layer2_ls) || modified_ls.count(layer2_ls->pair()))
+			{
+				repair_ls.insert(layer2_ls);
+
+				SPAbox face_box = get_face_box(layer2_ls->face(), &lb_transf);
+				delamo::TPoint3<double> bbox_min(face_box.low().x(), face_box.low().y(), face_box.low().z());
+				delamo::TPoint3<double> bbox_max(face_box.high().x(), face_box.high().y(), face_box.high().z());
+				layer2_repair_index.add(layer2_ls, bbox_min, bbox_max);
+			}
+		}
+	}
+
+	// Clear the surface pairs which will be computed again
+	for (auto& ls : repair_ls)
+		ls->pair_clear();
+
+	/*
+	 * Set stiffener special condition
+	 */
+	bool layer_is_stiffener = false;
+	if (LayerType::STIFFENER == layer1->type() || LayerType::STIFFENER == layer2->type())
+		layer_is_stiffener = true;
+
+	/*
+	 * Find the new surface pairs. The surfaces to be paired again are checked against all surfaces of the 2nd layer,
+	 * and the remaining surfaces of the 1st layer are only checked against the surfaces to be paired again.
+	 */
+
+	SurfacePairIndex layer2_index;
+	this->build_surface_index(layer2, layer2_index);
+	delamo::List<LayerSurface*> candidates;
+
+	// A clean surface paired again leaves its old partner without a pair instead of an asymmetric pair. The old partner
+	// is handled with the surfaces paired again, e.g. for the stiffener flags.
+	auto release_old_pair = [&repair_ls](LayerSurface* ls, LayerSurface* new_pair) {
+		LayerSurface* old_pair = ls->pair();
+		if (old_pair == nullptr || old_pair == new_pair || old_pair->pair() != ls)
+			return;
+		old_pair->pair_clear();
+		repair_ls.insert(old_pair);
+	};
+
+	for (auto& layer1_lb : *layer1) // START L1 LB
+	{
+		SPAtransf layer1_lb_transf;
+		this->get_body_transf(layer1_lb->body(), layer1_lb_transf);
+
+		for (auto& layer1_ls : *layer1_lb) // START L1 LS
+		{
+			if (repair_ls.count(layer1_ls))
+				layer2_index.query(layer1_ls, candidates);
+			else
+				layer2_repair_index.query(layer1_ls, candidates);
+
+			for (auto& layer2_ls : candidates) // START L2 LS
+			{
+				if (this->check_surface_pair(layer1_ls, layer1_lb_transf, layer2_ls))
+				{
+					release_old_pair(layer1_ls, layer2_ls);
+					release_old_pair(layer2_ls, layer1_ls);
+					layer2_ls->pair(layer1_ls);
+					layer1_ls->pair(layer2_ls);
+					layer2_ls->stiffener_paired(layer_is_stiffener);
+					layer1_ls->stiffener_paired(layer_is_stiffener);
+				}
+			} // END L2 LS
 		} // END L1 LS
 	} // END L1 LB
+
+	// Fix stiffener paired surface flags as in update_surface_pairs()
+	for (auto& ls : repair_ls)
+	{
+		if (layer_is_stiffener && ls->pair() == NULL)
+			ls->stiffener_paired(false);
+	}
+	for (auto& ls : modified_ls)
+		ls->modified(false);
+}
+
+bool ACISModelBuilder::check_surface_pair(LayerSurface* layer1_ls, SPAtransf& layer1_lb_transf, LayerSurface* layer2_ls)
+{
+	// Check that the faces in consideration are touching to each other
+	if (!antiparallel(layer1_ls->normal(), layer2_ls->normal(), this->tolerance()) || !(abs(layer1_ls->point_coords().z() - layer2_ls->point_coords().z()) < this->tolerance()))
+		return false;
+
+	// Parametric position for initial guessing of the position
+	FACE* face_in = layer2_ls->face();
+	surface* surf_in = face_in->geometry()->trans_surface(get_owner_transf(face_in), face_in->sense());
+	SPAinterval u_range = surf_in->param_range_u();
+	SPAinterval v_range = surf_in->param_range_v();
+	SPApar_pos test_uv_guess(this->_u_pos * u_range.length() + u_range.start_pt(), this->_v_pos * v_range.length() + v_range.start_pt());
+	// A variable to store the api_point_in_face() result
+	point_face_containment cont_answer;
+	// Use the cache
+	logical use_cache = TRUE;
+
+	// Check that layer2 face contains the point which is on layer1 face
+	this->_check_outcome(api_point_in_face(layer1_ls->point(), layer2_ls->face(), layer1_lb_transf, cont_answer, test_uv_guess, use_cache), __FILE__, __LINE__, __FUNCTION__);
+
+	return (point_inside_face == cont_answer/* || point_boundary_face == cont_answer*/);
+}
+
+void ACISModelBuilder::build_surface_index(Layer *layer_in, SurfacePairIndex& index)
+{
+	// Bounding boxes are expanded with the model tolerance
+	index.tolerance(this->tolerance());
+
+	for (auto& lb : *layer_in)
+	{
+		// Get body transformation matrix
+		SPAtransf lb_transf;
+		this->get_body_transf(lb->body(), lb_transf);
+
+		for (auto& ls : *lb)
+		{
+			SPAbox face_box = get_face_box(ls->face(), &lb_transf);
+			delamo::TPoint3<double> bbox_min(face_box.low().x(), face_box.low().y(), face_box.low().z());
+			delamo::TPoint3<double> bbox_max(face_box.high().x(), face_box.high().y(), face_box.high().z());
+			index.add(ls, bbox_min, bbox_max);
+		}
+	}
+}
+
+void ACISModelBuilder::build_face_bvh(Layer** layer_list, int layer_list_size, FaceBVH& bvh)
+{
+	for (int i = 0; i < layer_list_size; i++)
+	{
+		for (auto& lb : *layer_list[i])
+		{
+			// Get body transformation matrix
+			SPAtransf lb_transf;
+			this->get_body_transf(lb->body(), lb_transf);
+
+			for (auto& ls : *lb)
+			{
+				SPAbox face_box = get_face_box(ls->face(), &lb_transf);
+				delamo::TPoint3<double> bbox_min(face_box.low().x(), face_box.low().y(), face_box.low().z());
+				delamo::TPoint3<double> bbox_max(face_box.high().x(), face_box.high().y(), face_box.high().z());
+				bvh.add(ls, lb, bbox_min, bbox_max);
+			}
+		}
+	}
 }
 
 void ACISModelBuilder::imprint_delamination(LayerSurface* layersurface_in, Direction surf_direction, BODY* profile_out, BODY* profile_in, BODY* profile_in_par, delamo::List<LayerSurface *>& lsc_new)
@@ -2305,7 +2634,7 @@ void ACISModelBuilder::imprint_delamination(LayerSurface* layersurface_in, Direc
 	SPAposition face_refin = layersurface_in->point();
 
 	// Create inner delamination outline as a face in parametric space
-	FACE* ref_delam_inner;
+	delamo::List<FACE*> ref_delam_inner;
 	this->generate_delam_ref_face(profile_in_par, ref_delam_inner);
 
 	DelaminationType delam_type;
@@ -2376,7 +2705,7 @@ void ACISModelBuilder::imprint_delamination(LayerSurface* layersurface_in, Direc
 				double vec_angle = radians_to_degrees(angle_between(ref_normal, face_refnormal));
 
 				// Generate a new layer surface
-				LayerSurface *ls_new = new LayerSurface();
+				LayerSurface *ls_new = this->new_layer_surface();
 				ls_new->id(current_lb->next_ls_id);
 				ls_new->face(f);
 				ls_new->point(face_refpt);
@@ -2514,7 +2843,7 @@ void ACISModelBuilder::generate_stiffened_mold(Layer *lamina, Layer *stiffener)
 	BODY* stitched_body = (BODY*)output_bodies.first();
 
 	// Create a new mold for the stiffened layer
-	LayerMold *new_mold=new LayerMold();
+	LayerMold *new_mold=this->new_layer_mold();
 	new_mold->body(stitched_body);
 	new_mold->direction(Direction::OFFSET);
 	new_mold->owner(lamina);
@@ -2545,11 +2874,14 @@ void ACISModelBuilder::generate_stiffened_mold(Layer *lamina, Layer *stiffener)
 		{
 			lamina->add_mold(lm_new);
 		}
+		this->fingerprint_molds(lamina);
 	}
 }
 
 void ACISModelBuilder::find_closest_points(Layer** layer_list, int layer_list_size, delamo::TPoint3<double> point_in, delamo::TPoint3<double>*& point_list, delamo::TPoint3<double>*& normal_list, char**& name_list, int& list_size)
 {
+	auto lock = this->kernel_lock();
+
 	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
 	{
 		std::cout << "WARNING: This function is not implemented yet!" << std::endl;
@@ -2560,6 +2892,8 @@ void ACISModelBuilder::find_closest_points(Layer** layer_list, int layer_list_si
 
 void ACISModelBuilder::find_closest_face_to_point(Layer *layer_in, delamo::TPoint3<double> point_in, delamo::TPoint3<double>& point_out, delamo::TPoint3<double>& normal_out, char*& name_out)
 {
+	auto lock = this->kernel_lock();
+
 	// Find the closest face
 	double distance_min = std::numeric_limits<int>::max();
 	SPAposition in_point(point_in.x(), point_in.y(), point_in.z());
@@ -2592,67 +2926,242 @@ void ACISModelBuilder::find_closest_face_to_point(Layer *layer_in, delamo::TPoin
 	}
 }
 
-void ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer* layer_offset, delamo::List<std::string>& file_names)
+void ACISModelBuilder::find_closest_faces_to_points(Layer** layer_list, int layer_list_size, delamo::TPoint3<double>* points_in, int points_in_size, delamo::TPoint3<double>*& point_list, delamo::TPoint3<double>*& normal_list, char**& name_list, int& list_size)
+{
+	auto lock = this->kernel_lock();
+
+	// Build the hierarchy once for all query points
+	FaceBVH bvh;
+	this->build_face_bvh(layer_list, layer_list_size, bvh);
+
+	// Find the closest faces
+	FaceDistance face_distance(this);
+	delamo::List<FaceBVH::Result> results;
+	bvh.nearest(delamo::Span<const delamo::TPoint3<double>>(points_in, points_in_size), face_distance, results, this->query_threads());
+
+	// Initialize the return arrays
+	list_size = points_in_size;
+	point_list = new delamo::TPoint3<double>[list_size];
+	normal_list = new delamo::TPoint3<double>[list_size];
+	name_list = new char*[list_size];
+
+	for (int i = 0; i < list_size; i++)
+	{
+		if (results[i].surface == nullptr)
+		{
+			if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+				std::cout << "ERROR: Cannot find a face close to the query point (" << points_in[i].x() << ", " << points_in[i].y() << ", " << points_in[i].z() << ")" << std::endl;
+			this->error_handler();
+			name_list[i] = strdup("");
+			continue;
+		}
+
+		// Find face normal at the closest point
+		SPAposition closest_pos(results[i].point.x(), results[i].point.y(), results[i].point.z());
+		SPAunit_vector face_normal = sg_get_face_normal(results[i].surface->face(), closest_pos);
+
+		// Add the closest point, normal and body name to the relevant list
+		point_list[i] = results[i].point;
+		normal_list[i] = delamo::TPoint3<double>(face_normal.x(), face_normal.y(), face_normal.z());
+		name_list[i] = strdup(results[i].body->name());
+	}
+}
+
+void ACISModelBuilder::do_adjacent_layers(Layer *layer_orig, Layer* layer_offset, delamo::List<std::string>& file_names)
 {
 	// Update surface pairs before processing delamination
 	this->update_surface_pairs(layer_offset, layer_orig);
 
+	// Imprint the delamination profiles which do not overlap each other together
+	if (this->batch_delaminations())
+	{
+		this->process_delamination_batch(layer_orig, layer_offset, file_names);
+	}
+	else
+	{
+		for (auto file_name : file_names)
+		{
+			// Read delamination points
+			delamo::TPoint3<double>* delampts = nullptr;
+			int delampts_size;
+			this->read_delamination_file(file_name.c_str(), delampts, delampts_size);
+
+			// Check if we were able to load some points from the file
+			if (delampts == nullptr)
+			{
+				if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+					std::cout << "ERROR: There is a problem processing delamination profile. Please check your input file: " << std::string(file_name) << std::endl;
+				this->error_handler();
+			}
+			else
+			{
+				// Check if the last and the first delamination profile points are equal
+				if (delampts[0] != delampts[delampts_size - 1])
+				{
+					if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+						std::cout << "ERROR: The first and the last delamination profile points must be equal. Skipping delamination imprint..." << std::endl;
+					continue;
+				}
+			}
+
+			// Process delamination
+			this->process_delamination(layer_orig, layer_offset, delampts, delampts_size);
+
+			// Delete delamination points
+			delete[] delampts;
+			delampts = nullptr;
+
+			// Update layer surface owners after imprinting operation
+			layer_orig->update_owners();
+			layer_offset->update_owners();
+
+			// New layer surfaces generated by imprinting will be paired here
+			this->update_modified_surface_pairs(layer_offset, layer_orig);
+		}
+	}
+}
+
+void ACISModelBuilder::process_delamination(Layer *layer_orig, Layer *layer_offset, delamo::TPoint3<double>* delampts, int delampts_size)
+{
+	// Check if the orig layer has 1 mold with a single face on its offset direction
+	FACE* ref_mold = this->find_delam_ref_face(layer_orig);
+	if (ref_mold == NULL)
+		return;
+
+	// Generate delamination profiles, only once for all faces of the interface
+	BODY* inner_profile; BODY* inner_profile_parametric;  BODY* outer_profile; BODY* outer_profile_parametric;
+	this->get_delamination_profiles(ref_mold, delampts, delampts_size, outer_profile, inner_profile, outer_profile_parametric, inner_profile_parametric);
+
+	// Imprint delamination shape to both layers
+	this->imprint_delamination_profiles(layer_orig, layer_offset, outer_profile, inner_profile, inner_profile_parametric, true);
+
+	// Delamination profiles are not required after imprinting
+	this->clear_delamination_profiles();
+}
+
+void ACISModelBuilder::process_delamination_batch(Layer *layer_orig, Layer *layer_offset, delamo::List<std::string>& file_names)
+{
+	// Read all delamination outlines up front
+	std::vector< delamo::List< delamo::TPoint3<double> > > outlines;
 	for (auto file_name : file_names)
 	{
-		// Read delamination points
-		delamo::TPoint3<double>* delampts = nullptr;
-		int delampts_size;
-		read_csv_file(file_name.c_str(), delampts, delampts_size);
+		delamo::List< delamo::TPoint3<double> > delampts;
+		this->read_delamination_file(file_name.c_str(), delampts);
 
 		// Check if we were able to load some points from the file
-		if (delampts == nullptr)
+		if (delampts.size() == 0)
 		{
 			if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
 				std::cout << "ERROR: There is a problem processing delamination profile. Please check your input file: " << std::string(file_name) << std::endl;
 			this->error_handler();
 		}
-		else
+
+		// Check if the last and the first delamination profile points are equal
+		if (delampts[0] != delampts[delampts.size() - 1])
+		{
+			if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+				std::cout << "ERROR: The first and the last delamination profile points must be equal. Skipping delamination imprint..." << std::endl;
+			continue;
+		}
+
+		outlines.push_back(delampts);
+	}
+
+	if (outlines.empty())
+		return;
+
+	// Check if the orig layer has 1 mold with a single face on its offset direction
+	FACE* ref_mold = this->find_delam_ref_face(layer_orig);
+	if (ref_mold == NULL)
+		return;
+
+	// Find the bounding boxes of the outlines in the parametric space of the reference face
+	surface* ref_surf = ref_mold->geometry()->trans_surface(get_owner_transf(ref_mold), ref_mold->sense());
+	SPAinterval u_range = ref_surf->param_range_u();
+	SPAinterval v_range = ref_surf->param_range_v();
+	delamo::List< delamo::TPoint3<double> > bbox_min;
+	delamo::List< delamo::TPoint3<double> > bbox_max;
+	for (auto& delampts : outlines)
+	{
+		delamo::TPoint3<double> pp_min(std::numeric_limits<double>::max());
+		delamo::TPoint3<double> pp_max(-std::numeric_limits<double>::max());
+		for (auto& pt : delampts)
 		{
-			// Check if the last and the first delamination profile points are equal
-			if (delampts[0] != delampts[delampts_size - 1])
+			// Scale parametric positions into [0, 1] interval as in generate_delamination_profiles()
+			SPApar_pos temp = ref_surf->param(SPAposition(pt.x(), pt.y(), pt.z()));
+			delamo::TPoint3<double> pp(temp.u / u_range.length(), temp.v / v_range.length(), 0.0);
+			for (int axis = 0; axis < 2; axis++)
 			{
-				if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
-					std::cout << "ERROR: The first and the last delamination profile points must be equal. Skipping delamination imprint..." << std::endl;
+				pp_min[axis] = std::min(pp_min[axis], pp[axis]);
+				pp_max[axis] = std::max(pp_max[axis], pp[axis]);
+			}
+		}
+		pp_min.z(0.0); pp_max.z(0.0);
+		bbox_min.add(pp_min);
+		bbox_max.add(pp_max);
+	}
+
+	// Outlines in the same group do not overlap each other, so they can be imprinted together
+	delamo::List<int> group_ids;
+	int num_groups = group_disjoint_regions(bbox_min, bbox_max, this->tolerance(), group_ids);
+
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO)
+		std::cout << "INFO: Imprinting " << outlines.size() << " delamination profiles in " << num_groups << " batches" << std::endl;
+
+	for (int group = 0; group < num_groups; group++)
+	{
+		// Combine the profiles of the group into single tool bodies
+		BODY* outer_profile = NULL; BODY* inner_profile = NULL; BODY* outer_profile_parametric = NULL; BODY* inner_profile_parametric = NULL;
+		for (int i = 0; i < (int)outlines.size(); i++)
+		{
+			if (group_ids[i] != group)
 				continue;
+
+			BODY* outer; BODY* inner; BODY* outer_pp; BODY* inner_pp;
+			this->generate_delamination_profiles(ref_mold, outlines[i].data(), (int)outlines[i].size(), outer, inner, outer_pp, inner_pp);
+
+			if (outer_profile == NULL)
+			{
+				outer_profile = outer;
+				inner_profile = inner;
+				outer_profile_parametric = outer_pp;
+				inner_profile_parametric = inner_pp;
+			}
+			else
+			{
+				this->_check_outcome(api_combine_body(outer, outer_profile), __FILE__, __LINE__, __FUNCTION__);
+				this->_check_outcome(api_combine_body(inner, inner_profile), __FILE__, __LINE__, __FUNCTION__);
+				this->_check_outcome(api_combine_body(outer_pp, outer_profile_parametric), __FILE__, __LINE__, __FUNCTION__);
+				this->_check_outcome(api_combine_body(inner_pp, inner_profile_parametric), __FILE__, __LINE__, __FUNCTION__);
 			}
 		}
 
-		// Process delamination
-		this->process_delamination(layer_orig, layer_offset, delampts, delampts_size);
+		// Imprint the whole group without pairing the surfaces after each imprinting couple
+		this->imprint_delamination_profiles(layer_orig, layer_offset, outer_profile, inner_profile, inner_profile_parametric, false);
 
-		// Delete delamination points
-		delete[] delampts;
-		delampts = nullptr;
+		// Delete the combined profiles
+		this->_check_outcome(api_del_entity(outer_profile), __FILE__, __LINE__, __FUNCTION__);
+		this->_check_outcome(api_del_entity(inner_profile), __FILE__, __LINE__, __FUNCTION__);
+		this->_check_outcome(api_del_entity(outer_profile_parametric), __FILE__, __LINE__, __FUNCTION__);
+		this->_check_outcome(api_del_entity(inner_profile_parametric), __FILE__, __LINE__, __FUNCTION__);
 
 		// Update layer surface owners after imprinting operation
 		layer_orig->update_owners();
 		layer_offset->update_owners();
 
-		// New layer surfaces generated by imprinting will be paired here
-		this->update_surface_pairs(layer_offset, layer_orig);
+		// Pair the new layer surfaces once per group, the next group uses these pairs
+		this->update_modified_surface_pairs(layer_offset, layer_orig);
 	}
-
-	// Set adjacent pairs
-	layer_offset->bond_pair(Direction::ORIG, layer_orig);
-	layer_orig->bond_pair(Direction::OFFSET, layer_offset);
-
-	if (this->_pInitialLayer == nullptr)
-		this->_pInitialLayer = layer_orig;
 }
 
-void ACISModelBuilder::process_delamination(Layer *layer_orig, Layer *layer_offset, delamo::TPoint3<double>* delampts, int delampts_size)
+FACE* ACISModelBuilder::find_delam_ref_face(Layer *layer_orig)
 {
 	// Check if the orig layer has 1 mold with a single face on its offset direction
 	LayerMold* delam_profile_ref_mold = layer_orig->delam_profile_ref();
 	if (delam_profile_ref_mold == nullptr)
 	{
 		std::cout << "ERROR: Cannot find a reference face for delamination profile generation. Please check your input layers. Aborting delamination imprinting!" << std::endl;
-		return;
+		return NULL;
 	}
 
 	BODY* ref_mold_sb = delam_profile_ref_mold->body();
@@ -2663,7 +3172,7 @@ void ACISModelBuilder::process_delamination(Layer *layer_orig, Layer *layer_offs
 	if (face_list.iteration_count() > 1)
 	{
 		std::cout << "ERROR: Reference mold has multiple faces. Aborting delamination imprinting!" << std::endl;
-		return;
+		return NULL;
 	}
 	else
 	{
@@ -2673,9 +3182,14 @@ void ACISModelBuilder::process_delamination(Layer *layer_orig, Layer *layer_offs
 	if (ref_mold == NULL)
 	{
 		std::cout << "ERROR: Please check your input layers and verify that they have correct molds. Aborting delamination imprinting!" << std::endl;
-		return;
+		return NULL;
 	}
 
+	return ref_mold;
+}
+
+void ACISModelBuilder::imprint_delamination_profiles(Layer *layer_orig, Layer *layer_offset, BODY* outer_profile, BODY* inner_profile, BODY* inner_profile_parametric, bool pair_each_couple)
+{
 	// Imprint delamination shape to both layers
 	for (auto& lb_orig : *layer_orig) // START LB LOOP
 	{
@@ -2688,10 +3202,6 @@ void ACISModelBuilder::process_delamination(Layer *layer_orig, Layer *layer_offs
 			if (Direction::OFFSET == ls_orig->direction() && DelaminationType::COHESIVE == ls_orig->delam_type())
 			//if (Direction::OFFSET == ls_orig.direction() && DelaminationType::COHESIVE == ls_orig.delam_type() && !ls_orig.is_stiffener_paired())
 			{
-				// Generate delamination profiles
-				BODY* inner_profile; BODY* inner_profile_parametric;  BODY* outer_profile; BODY* outer_profile_parametric;
-				this->generate_delamination_profiles(ref_mold, delampts, delampts_size, outer_profile, inner_profile, outer_profile_parametric, inner_profile_parametric);
-
 				// Imprint delamination outlines
 				this->imprint_delamination(ls_orig, Direction::OFFSET, outer_profile, inner_profile, inner_profile_parametric, lsc_new_orig);
 
@@ -2705,35 +3215,25 @@ void ACISModelBuilder::process_delamination(Layer *layer_orig, Layer *layer_offs
 					delamo::List<LayerSurface *> lsc_new_offset;
 					this->imprint_delamination(ls_offset, Direction::ORIG, outer_profile, inner_profile, inner_profile_parametric, lsc_new_offset);
 
-					if (lsc_new_offset.size() > 0)
-					{
-						for (auto ls_new : lsc_new_offset)
-						{
-							lb_offset->add_surface(ls_new);
-						}
-					}
+					// Add new faces to the layer body
+					lb_offset->add_surfaces(lsc_new_offset);
 					lsc_new_offset.clear();
 				}
 
-				// Update surface pairs after each imprinting couple
-				this->update_surface_pairs(layer_orig, layer_offset);
+				// Update surface pairs of the new and modified surfaces after each imprinting couple
+				if (pair_each_couple)
+					this->update_modified_surface_pairs(layer_orig, layer_offset);
 			}
 		} // END LS LOOP
 
-		  // Add new faces to the layer body
-		if (lsc_new_orig.size() > 0)
-		{
-			for (auto ls_new : lsc_new_orig)
-			{
-				lb_orig->add_surface(ls_new);
-			}
-		}
+		// Add new faces to the layer body
+		lb_orig->add_surfaces(lsc_new_orig);
 		lsc_new_orig.clear();
 
 	} // END LB LOOP
 }
 
-void ACISModelBuilder::generate_delam_ref_face(BODY* delam_wire, FACE*& delam_face_inner)
+void ACISModelBuilder::generate_delam_ref_face(BODY* delam_wire, delamo::List<FACE*>& delam_faces_inner)
 {
 	// Create a planar face in parametric space defined with the interval [0, 1]
 	SPAposition ref_point(0.0, 0.0, 0.0); SPAvector ref_normal(0.0, 0.0, 1.0);
@@ -2753,16 +3253,19 @@ void ACISModelBuilder::generate_delam_ref_face(BODY* delam_wire, FACE*& delam_fa
 	ENTITY_LIST covered_faces;
 	this->_check_outcome(api_cover_wires(delam_wire_copy, *ref_face_surf, covered_faces), __FILE__, __LINE__, __FUNCTION__);
 
+	// Each closed wire of the input body generates a separate face
 	int num_covered_faces = covered_faces.iteration_count();
-	if (num_covered_faces != 1)
+	if (num_covered_faces < 1)
 	{
 		// @TODO: This part needs a little bit more testing and brushing
 		std::cout << "There is a problem with the wire covering operation!" << std::endl;
 	}
-	delam_face_inner = (FACE*)covered_faces[0];
+	delam_faces_inner.clear();
+	for (int i = 0; i < num_covered_faces; i++)
+		delam_faces_inner.add((FACE*)covered_faces[i]);
 }
 
-void ACISModelBuilder::find_delam_bc(FACE* face_in, SPAtransf& transf_in, SPAposition& ref_point, SPAposition& ref_cohesive_zone, FACE* ref_contact_zone, DelaminationType& delam_type)
+void ACISModelBuilder::find_delam_bc(FACE* face_in, SPAtransf& transf_in, SPAposition& ref_point, SPAposition& ref_cohesive_zone, delamo::List<FACE*>& ref_contact_zones, DelaminationType& delam_type)
 {
 	// Set up some required variables for face-point containment API
 	surface* surf_in = face_in->geometry()->trans_surface(get_owner_transf(face_in), face_in->sense());
@@ -2790,13 +3293,16 @@ void ACISModelBuilder::find_delam_bc(FACE* face_in, SPAtransf& transf_in, SPApos
 	// Apply type conversion to parametric reference point
 	SPAposition ref_point_pp_conv(ref_point_pp.u / u_range.length(), ref_point_pp.v / v_range.length(), 0.0);
 
-	// Please note that contact zone reference face is in parametric space
+	// Please note that contact zone reference faces are in parametric space
 	SPAtransf identity_transf;
-	this->_check_outcome(api_point_in_face(ref_point_pp_conv, ref_contact_zone, identity_transf, cont_answer, test_uv_guess, use_cache), __FILE__, __LINE__, __FUNCTION__);
-	if (cont_answer == point_inside_face)
+	for (auto& ref_contact_zone : ref_contact_zones)
 	{
-		delam_type = DelaminationType::CONTACT;
-		return;
+		this->_check_outcome(api_point_in_face(ref_point_pp_conv, ref_contact_zone, identity_transf, cont_answer, test_uv_guess, use_cache), __FILE__, __LINE__, __FUNCTION__);
+		if (cont_answer == point_inside_face)
+		{
+			delam_type = DelaminationType::CONTACT;
+			return;
+		}
 	}
 
 	// So, the reference point must be inside the no model zone
@@ -2976,6 +3482,105 @@ void ACISModelBuilder::find_initial_ls_direction(Layer *layer_in, ENTITY_LIST& m
 	}
 }
 
+bool ACISModelBuilder::bodies_overlap(LayerBody* lb1, LayerBody* lb2)
+{
+	delamo::TPoint3<double> bbox_min[2];
+	delamo::TPoint3<double> bbox_max[2];
+	LayerBody* lb_list[2] = { lb1, lb2 };
+
+	for (int i = 0; i < 2; i++)
+	{
+		// Compute the bounding box only if it is not cached
+		if (!lb_list[i]->bounding_box(bbox_min[i], bbox_max[i]))
+		{
+			SPAposition box_low;
+			SPAposition box_high;
+			this->_check_outcome(api_get_entity_box(lb_list[i]->body(), box_low, box_high), __FILE__, __LINE__, __FUNCTION__);
+			bbox_min[i] = delamo::TPoint3<double>(box_low.x(), box_low.y(), box_low.z());
+			bbox_max[i] = delamo::TPoint3<double>(box_high.x(), box_high.y(), box_high.z());
+			lb_list[i]->bounding_box(bbox_min[i], bbox_max[i]);
+		}
+	}
+
+	// Touching bodies have overlapping boxes within the tolerance value
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (bbox_min[0][axis] > bbox_max[1][axis] + this->tolerance() || bbox_min[1][axis] > bbox_max[0][axis] + this->tolerance())
+			return false;
+	}
+	return true;
+}
+
+unsigned long long ACISModelBuilder::face_topology_tag(FACE* face_in)
+{
+	// Hash of the loop and edge structure. Imprinting adds new edges to the split faces.
+	FingerprintBuilder tag;
+	for (LOOP* lp = face_in->loop(); lp != NULL; lp = lp->next())
+	{
+		COEDGE* start = lp->start();
+		COEDGE* ce = start;
+		while (ce != NULL)
+		{
+			tag.add((unsigned long long)(size_t)ce->edge());
+			ce = ce->next();
+			if (ce == start)
+				break;
+		}
+		// Separate the loops
+		tag.add(-1);
+	}
+
+	return tag.value().hash();
+}
+
+ACISModelBuilder::PointNormalEvaluator::PointNormalEvaluator(ACISModelBuilder* builder, double reference_normal_z, bool update_angle)
+{
+	this->_pBuilder = builder;
+	this->_mReferenceNormalZ = reference_normal_z;
+	this->_bUpdateAngle = update_angle;
+}
+
+void ACISModelBuilder::PointNormalEvaluator::evaluate(LayerSurface* ls)
+{
+	auto lock = this->_pBuilder->kernel_lock();
+
+	// Generate an identity transform for point discovery function
+	SPAtransf current_body_transf;
+	if (ls->owner() != nullptr)
+		this->_pBuilder->get_body_transf(ls->owner()->body(), current_body_transf);
+
+	// Find a reference point and a normal using an arbitrary reference position
+	SPAposition reference_pos(0, 0, 0);
+	SPAunit_vector eval_normal;
+	SPAposition eval_pos;
+	this->_pBuilder->_pPtNmAlgo->find_point_normal(ls->face(), current_body_transf, reference_pos, eval_pos, eval_normal, true);
+
+	ls->point(eval_pos);
+	ls->normal(eval_normal);
+
+	// Calculate the angle between the reference normal and the face normal
+	if (this->_bUpdateAngle)
+	{
+		SPAunit_vector reference_normal(0, 0, this->_mReferenceNormalZ);
+		ls->angle(radians_to_degrees(angle_between(eval_normal, reference_normal)));
+	}
+}
+
+ACISModelBuilder::FaceDistance::FaceDistance(ACISModelBuilder* builder)
+{
+	this->_pBuilder = builder;
+}
+
+double ACISModelBuilder::FaceDistance::distance(LayerSurface* ls, const delamo::TPoint3<double>& pt, delamo::TPoint3<double>& closest)
+{
+	SPAposition in_point(pt.x(), pt.y(), pt.z());
+	SPAposition closest_pos;
+	double distance;
+	this->_pBuilder->_check_outcome(api_entity_point_distance(ls->face(), in_point, closest_pos, distance), __FILE__, __LINE__, __FUNCTION__);
+	closest = delamo::TPoint3<double>(closest_pos.x(), closest_pos.y(), closest_pos.z());
+	return distance;
+}
+
 void ACISModelBuilder::get_body_transf(BODY* body_in, SPAtransf& transf_out)
 {
 	TRANSFORM* cb_transfrm = body_in->transform();
@@ -2987,6 +3592,8 @@ void ACISModelBuilder::get_body_transf(BODY* body_in, SPAtransf& transf_out)
 
 void ACISModelBuilder::parpos_csv_to_pos(const char* csv_in, Layer *ref_layer, Direction ref_dir, const char* csv_out)
 {
+	auto lock = this->kernel_lock();
+
 	if (ref_layer->size() > 1)
 	{
 		std::cout << "MULTI LB: This layer has already been altered by some damage-incorporation method!" << std::endl;
@@ -3203,6 +3810,39 @@ void ACISModelBuilder::generate_delamination_profiles(FACE* face_in, delamo::TPo
 	inner_parpos.clear();
 }
 
+void ACISModelBuilder::get_delamination_profiles(FACE* face_in, delamo::TPoint3<double>* delampts, int delampts_size, BODY*& profile_out, BODY*& profile_in, BODY*& profile_out_par, BODY*& profile_in_par)
+{
+	DelamProfileKey key;
+	key.ref_face = face_in;
+	key.outline_hash = point_array_hash(delamo::Span<const delamo::TPoint3<double>>(delampts, delampts_size));
+	key.offset = this->offset_distance();
+
+	auto profile_it = this->_mDelamProfileCache.find(key);
+	if (profile_it == this->_mDelamProfileCache.end())
+	{
+		DelamProfiles profiles;
+		this->generate_delamination_profiles(face_in, delampts, delampts_size, profiles.outer, profiles.inner, profiles.outer_pp, profiles.inner_pp);
+		profile_it = this->_mDelamProfileCache.insert(std::make_pair(key, profiles)).first;
+	}
+
+	profile_out = profile_it->second.outer;
+	profile_in = profile_it->second.inner;
+	profile_out_par = profile_it->second.outer_pp;
+	profile_in_par = profile_it->second.inner_pp;
+}
+
+void ACISModelBuilder::clear_delamination_profiles()
+{
+	for (auto& profile_it : this->_mDelamProfileCache)
+	{
+		this->_check_outcome(api_del_entity(profile_it.second.outer), __FILE__, __LINE__, __FUNCTION__);
+		this->_check_outcome(api_del_entity(profile_it.second.inner), __FILE__, __LINE__, __FUNCTION__);
+		this->_check_outcome(api_del_entity(profile_it.second.outer_pp), __FILE__, __LINE__, __FUNCTION__);
+		this->_check_outcome(api_del_entity(profile_it.second.inner_pp), __FILE__, __LINE__, __FUNCTION__);
+	}
+	this->_mDelamProfileCache.clear();
+}
+
 LayerSurface* ACISModelBuilder::find_closest_side(Layer *layer_in, delamo::TPoint3<double>& point_in)
 {
 	// Convert input point to SPAposition
@@ -3244,26 +3884,27 @@ LayerSurface* ACISModelBuilder::find_closest_side(Layer *layer_in, delamo::TPoin
 
 void ACISModelBuilder::translate_shell_edge_points(delamo::List<delamo::TPoint3<double>>& edge_point_list, delamo::List<delamo::TPoint3<double>>& edge_normal_list, double thickness, delamo::List<delamo::TPoint3<double>>& layer_point_list)
 {
-	for (unsigned int edgeNum = 0; edgeNum < edge_point_list.size(); edgeNum++)
+	if (edge_point_list.size() != edge_normal_list.size())
 	{
-		delamo::TPoint3<double> point = edge_point_list[edgeNum];
-		delamo::TPoint3<double> normal = edge_normal_list[edgeNum];
-		double translated_x = point.x() + normal.x() * thickness;
-		double translated_y = point.y() + normal.y() * thickness;
-		double translated_z = point.z() + normal.z() * thickness;
-
-		// Add normal to return list
-		delamo::TPoint3<double> translated_point;
-		translated_point.set_x(translated_x);
-		translated_point.set_y(translated_y);
-		translated_point.set_z(translated_z);
-		layer_point_list.add(translated_point);
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: The number of shell edge points and normals do not match!" << std::endl;
+		this->error_handler();
 	}
+
+	// Offset all points along their normals in one pass over the coordinate lanes
+	delamo::Point3Array<double> points(edge_point_list);
+	delamo::Point3Array<double> normals(edge_normal_list);
+	points.translate(normals, thickness);
+
+	// Add translated points to return list
+	points.to_list(layer_point_list);
 }
 
 
 void ACISModelBuilder::find_side_faces(Layer *layer_in, delamo::List<delamo::TPoint3<double>>& side_point_list, delamo::List<delamo::TPoint3<double>>& point_out, delamo::List<delamo::TPoint3<double>>& normal_out)
 {
+	auto lock = this->kernel_lock();
+
 
 	for (unsigned int sideNum = 0; sideNum < side_point_list.size(); sideNum++)
 	{
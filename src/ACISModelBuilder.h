@@ -5,6 +5,8 @@
 #include "ACIS.h"
 #include "PNFind_UVseek.h"
 #include "PNFind_BBox.h"
+#include "SurfacePairIndex.h"
+#include "FaceBVH.h"
 
 
 struct LSDistanceRel { LayerSurface* ls; double dist; };
@@ -28,7 +30,7 @@ public:
 	/**
 	 * \brief Default destructor
 	 */
-	~ACISModelBuilder() {};
+	virtual ~ACISModelBuilder() {};
 
 	/**
 	 * \brief Starts the ACIS modeler
@@ -41,22 +43,107 @@ public:
 	void stop();
 
 	/**
-	 * \brief Creates a new layer from a NURBS surface
+	 * \brief Finds the closest points and normal at this points for the input layers to use with SIMULIA Abaqus FEA
 	 *
-	 * \param[in] nurbs_surface_in input NURBS surface to be used as a mold for the new layer
-	 * \param[in] ldir the layer direction in which the mold will be offset
-	 * \param[in] thickness the layer thickness
-	 * \param[out] layer_out new layer generated from the input NURBS surface
+	 * The function initializes the point and normal list pointer array, but leaves the memory deallocation to the the user.
+	 *
+	 * \note
+	 * This function has a typemap which converts the special objects to native Python lists. The function and the return signature change to
+	 *	>> point_list, normal_list, name_list = acis.find_closest_points([list of layers], [x, y, z]);
+	 *
+	 * \param[in] layer_list list of layers
+	 * \param[in] layer_list_size size of the layer list
+	 * \param[in] point_in reference point
+	 * \param[out] point_list list of points
+	 * \param[out] normal_list list of normals
+	 * \param[out] name_list list of layer body names
+	 * \param[out] list_size size of the point and normal lists
+	 */
+	void find_closest_points(Layer** layer_list, int layer_list_size, delamo::TPoint3<double> point_in, delamo::TPoint3<double>*& point_list, delamo::TPoint3<double>*& normal_list, char**& name_list, int& list_size);
+	using ModelBuilder::find_closest_points; /**< Keeps the container overload visible */
+
+	/**
+	 * \brief Finds the closest point and normal at this point for the input layer to use with SIMULIA Abaqus FEA
+	 *
+	 * \note
+	 * This function has a typemap which converts the special objects to native Python lists. The function and the return signature change to
+	 *	>> point, normal, name = acis.find_closest_face_to_point(layer_in, [x, y, z]);
+	 *
+	 * \param[in] layer_in input layer
+	 * \param[in] point_in reference point
+	 * \param[out] point_out evaluated point
+	 * \param[out] normal_out evaluated normal
+	 * \param[out] name_out name of the layer body
+	 */
+	void find_closest_face_to_point(Layer *layer_in, delamo::TPoint3<double> point_in, delamo::TPoint3<double>& point_out, delamo::TPoint3<double>& normal_out, char*& name_out);
+
+	/**
+	 * \brief Finds the closest points and normals on the faces of the input layers for a batch of query points
+	 *
+	 * A bounding volume hierarchy is built over all faces of the input layers once and it is reused for all query points.
+	 * The function initializes the point, normal and name list pointer arrays, but leaves the memory deallocation to the user.
+	 *
+	 * \note
+	 * This function has a typemap which converts the special objects to native Python lists. The function and the return signature change to
+	 *	>> point_list, normal_list, name_list = acis.find_closest_faces_to_points([list of layers], [[x1, y1, z1], [x2, y2, z2], ...]);
+	 *
+	 * \param[in] layer_list list of layers
+	 * \param[in] layer_list_size size of the layer list
+	 * \param[in] points_in list of query points
+	 * \param[in] points_in_size size of the query point list
+	 * \param[out] point_list list of the closest points, one for each query point
+	 * \param[out] normal_list list of the face normals at the closest points
+	 * \param[out] name_list list of layer body names
+	 * \param[out] list_size size of the point, normal and name lists
+	 */
+	void find_closest_faces_to_points(Layer** layer_list, int layer_list_size, delamo::TPoint3<double>* points_in, int points_in_size, delamo::TPoint3<double>*& point_list, delamo::TPoint3<double>*& normal_list, char**& name_list, int& list_size);
+	using ModelBuilder::find_closest_faces_to_points; /**< Keeps the container overload visible */
+
+	/**
+	 * \brief Converts input 2D parametric positions into 3D positions
+	 *
+	 * This function reads parametric positions from a CSV file, evaluates using the input layer's corresponding surface and outputs the evaluated 3D positions as a CSV file.
+	 * \param[in] csv_in file name of the input CSV file containing the parametric positions
+	 * \param[in] ref_layer reference layer for evaluation of parametric positions
+	 * \param[in] ref_dir direction of the reference surface in the layer
+	 * \param[in] csv_out file name of the output CSV file containing the evaluated 3D positions
 	 */
-	void create_layer(delamo::NURBS<double> *nurbs_surface_in, Direction ldir, double thickness, Layer *layer_out);
+	void parpos_csv_to_pos(const char* csv_in, Layer *ref_layer, Direction ref_dir, const char* csv_out);
+
+	/**
+	* \brief Saves the layer as a text STL file
+	* \param file_name name of the STL file to be saved
+	* \param layer layer to be saved in the file
+	*/
+	void save_layer_stl(const char* file_name, Layer *layer);
+
+	/**
+	* \brief Saves the boundary between layer1 and layer2 as a text STL file. Should be called AFTER adjacent_layers()/bond_layers()
+	* \param file_name name of the STL file to be saved
+	* \param layer1  First layer 
+	* \param layer2  Second layer
+	*/
+	void save_layer_surface_stl(const char* file_name, Layer *layer1, Layer *layer2);
+
+	/**
+	 * \brief Controls CAD kernel's internal debugging facilities
+	 *
+	 * Not intented to be used in the production environment.
+	 * \param[in] flag enable or disable internal debugging facilities
+	 */
+	void debug_mode(bool flag);
+
+protected:
 
 	/**
-	 * \brief Creates a new layer from a NURBS surface in the OFFSET direction
+	 * \brief Creates a new layer from a NURBS surface
+	 *
 	 * \param[in] nurbs_surface_in input NURBS surface to be used as a mold for the new layer
+	 * \param[in] ldir the layer direction in which the mold will be offset
 	 * \param[in] thickness the layer thickness
 	 * \param[out] layer_out new layer generated from the input NURBS surface
 	 */
-	void create_layer(delamo::NURBS<double> *nurbs_surface_in, double thickness, Layer *layer_out);
+	void do_create_layer(delamo::NURBS<double> *nurbs_surface_in, Direction ldir, double thickness, Layer *layer_out);
 
 	/**
 	 * \brief Creates a new layer using previously generated layers as a mold
@@ -66,7 +153,7 @@ public:
 	 * \param[in] thickness the layer thickness
 	 * \param[out] layer_out the new layer
 	 */
-	void create_layer(Layer *layer_in, Direction ldir, double thickness, Layer *layer_out);
+	void do_create_layer(Layer *layer_in, Direction ldir, double thickness, Layer *layer_out);
 
 	/**
 	 * \brief Creates a new layer from a LayerMold object
@@ -75,7 +162,7 @@ public:
 	 * \param[in] thickness layer thickness
 	 * \param[out] layer_out the new layer
 	 */
-	void create_layer(LayerMold *mold_in, Direction ldir, double thickness, Layer *layer_out);
+	void do_create_layer(LayerMold *mold_in, Direction ldir, double thickness, Layer *layer_out);
 
 	/**
 	 * \brief Imprints the the adjacent faces of the input layers to each other
@@ -83,7 +170,7 @@ public:
 	 * \param layer_orig layer on the ORIG side
 	 * \param layer_offset layer on the OFFSET side
 	 */
-	void adjacent_layers(Layer *layer_orig, Layer *layer_offset);
+	void do_adjacent_layers(Layer *layer_orig, Layer *layer_offset);
 
 	/**
 	 * \brief Imprints delamination profile to the input layers
@@ -92,7 +179,7 @@ public:
 	 * \param layer_offset layer on the OFFSET side
 	 * \param file_name CSV file containing the outer delamination profile
 	 */
-	void adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name);
+	void do_adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name);
 
 	/**
 	 * \brief Imprints multiple delamination profiles to the input layers
@@ -101,41 +188,7 @@ public:
 	 * \param layer_offset layer on the OFFSET side
 	 * \param file_names a list of CSV files containing the outer delamination profile
 	 */
-	void adjacent_layers(Layer *layer_orig, Layer *layer_offset, delamo::List< std::string >& file_names);
-
-	/**
-	 * \brief Finds the closest points and normal at this points for the input layers to use with SIMULIA Abaqus FEA
-	 *
-	 * The function initializes the point and normal list pointer array, but leaves the memory deallocation to the the user.
-	 *
-	 * \note
-	 * This function has a typemap which converts the special objects to native Python lists. The function and the return signature change to
-	 *	>> point_list, normal_list, name_list = acis.find_closest_points([list of layers], [x, y, z]);
-	 *
-	 * \param[in] layer_list list of layers
-	 * \param[in] layer_list_size size of the layer list
-	 * \param[in] point_in reference point
-	 * \param[out] point_list list of points
-	 * \param[out] normal_list list of normals
-	 * \param[out] name_list list of layer body names
-	 * \param[out] list_size size of the point and normal lists
-	 */
-	void find_closest_points(Layer** layer_list, int layer_list_size, delamo::TPoint3<double> point_in, delamo::TPoint3<double>*& point_list, delamo::TPoint3<double>*& normal_list, char**& name_list, int& list_size);
-
-	/**
-	 * \brief Finds the closest point and normal at this point for the input layer to use with SIMULIA Abaqus FEA
-	 *
-	 * \note
-	 * This function has a typemap which converts the special objects to native Python lists. The function and the return signature change to
-	 *	>> point, normal, name = acis.find_closest_face_to_point(layer_in, [x, y, z]);
-	 *
-	 * \param[in] layer_in input layer
-	 * \param[in] point_in reference point
-	 * \param[out] point_out evaluated point
-	 * \param[out] normal_out evaluated normal
-	 * \param[out] name_out name of the layer body
-	 */
-	void find_closest_face_to_point(Layer *layer_in, delamo::TPoint3<double> point_in, delamo::TPoint3<double>& point_out, delamo::TPoint3<double>& normal_out, char*& name_out);
+	void do_adjacent_layers(Layer *layer_orig, Layer *layer_offset, delamo::List< std::string >& file_names);
 
 	/**
 	 * \brief Splits the layer using the points included in the input file
@@ -145,7 +198,7 @@ public:
 	 * \param layer_in layer to be split
 	 * \param file_name file which contains the points for wire generation
 	 */
-	void split_layer(Layer *layer_in, const char* file_name);
+	void do_split_layer(Layer *layer_in, const char* file_name);
 
 	/**
 	 * \brief Generates a hat stiffener
@@ -154,43 +207,62 @@ public:
 	 * \param[in] file_name file containing the stiffener outline
 	 * \param[in] radius blending radius
 	 */
-	void create_hat_stiffener(Layer *layer_orig, Layer *stiffener, const char* file_name, double radius = 0);
+	void do_create_hat_stiffener(Layer *layer_orig, Layer *stiffener, const char* file_name, double radius);
 
 	/**
-	 * \brief Converts input 2D parametric positions into 3D positions
+	 * \brief Returns the name and version of the format of the cached bodies
+	 * \return format name
+	 */
+	const char* cache_format();
+
+	/**
+	 * \brief Serializes a body for the cache as SAT data
+	 * \param[in] lb input LayerBody
+	 * \param[out] blob SAT data of the body
+	 * \param[out] faces faces of the body in the order they are restored
+	 * \return false if the body cannot be saved
+	 */
+	bool save_cache_body(LayerBody* lb, std::string& blob, delamo::List<DLM_FACEP>& faces);
+
+	/**
+	 * \brief Replaces the body of a LayerBody with the body restored from SAT data
 	 *
-	 * This function reads parametric positions from a CSV file, evaluates using the input layer's corresponding surface and outputs the evaluated 3D positions as a CSV file.
-	 * \param[in] csv_in file name of the input CSV file containing the parametric positions
-	 * \param[in] ref_layer reference layer for evaluation of parametric positions
-	 * \param[in] ref_dir direction of the reference surface in the layer
-	 * \param[in] csv_out file name of the output CSV file containing the evaluated 3D positions
+	 * The existing body is deleted. All faces are new ACIS entities, so the LayerSurface objects of the body get new
+	 * handle generations.
+	 * \param[in] lb LayerBody to be updated
+	 * \param[in] blob SAT data of the body
+	 * \param[out] faces faces of the restored body
+	 * \return false if the body cannot be restored
 	 */
-	void parpos_csv_to_pos(const char* csv_in, Layer *ref_layer, Direction ref_dir, const char* csv_out);
+	bool restore_cache_body(LayerBody* lb, const std::string& blob, delamo::List<DLM_FACEP>& faces);
 
 	/**
-	* \brief Saves the layer as a text STL file
-	* \param file_name name of the STL file to be saved
-	* \param layer layer to be saved in the file
-	*/
-	void save_layer_stl(const char* file_name, Layer *layer);
+	 * \brief Deletes the ACIS body of a LayerBody removed by a rebuild
+	 * \param[in] lb input LayerBody
+	 */
+	void release_cache_body(LayerBody* lb);
 
 	/**
-	* \brief Saves the boundary between layer1 and layer2 as a text STL file. Should be called AFTER adjacent_layers()/bond_layers()
-	* \param file_name name of the STL file to be saved
-	* \param layer1  First layer 
-	* \param layer2  Second layer
-	*/
-	void save_layer_surface_stl(const char* file_name, Layer *layer1, Layer *layer2);
+	 * \brief Serializes the ACIS body of a mold as SAT text for a checkpoint
+	 * \param[in] lm input LayerMold
+	 * \param[out] blob SAT data of the body
+	 * \return false if the LayerMold has no body
+	 */
+	bool save_cache_mold(LayerMold* lm, std::string& blob);
 
 	/**
-	 * \brief Controls CAD kernel's internal debugging facilities
-	 *
-	 * Not intented to be used in the production environment.
-	 * \param[in] flag enable or disable internal debugging facilities
+	 * \brief Replaces the ACIS body of a mold with a body saved by save_cache_mold()
+	 * \param[in] lm LayerMold to be updated
+	 * \param[in] blob SAT data of the body
+	 * \return false if the body cannot be restored
 	 */
-	void debug_mode(bool flag);
+	bool restore_cache_mold(LayerMold* lm, const std::string& blob);
 
-protected:
+	/**
+	 * \brief Deletes the ACIS body of a mold which is deleted with its layer
+	 * \param[in] lm input LayerMold
+	 */
+	void release_cache_mold(LayerMold* lm);
 
 	/**
 	 * \brief Converts a NURBS surface to a face
@@ -261,6 +333,35 @@ protected:
 	 */
 	void process_delamination(Layer *layer_orig, Layer *layer_offset, delamo::TPoint3<double>* delampts, int delampts_size);
 
+	/**
+	 * \brief Internal function for imprinting multiple delamination outlines in batches
+	 * The outlines are grouped so that the outlines in the same group do not overlap in the parametric space of the
+	 * reference face. Each group is imprinted with single combined profile bodies and the surfaces are paired once per group.
+	 *
+	 * \param layer_orig layer on the original side
+	 * \param layer_offset layer on the offset side
+	 * \param file_names list of CSV files containing the outer delamination profiles
+	 */
+	void process_delamination_batch(Layer *layer_orig, Layer *layer_offset, delamo::List<std::string>& file_names);
+
+	/**
+	 * \brief Finds the reference face for delamination profile generation
+	 * \param layer_orig layer on the original side
+	 * \return reference face, NULL if the layer does not have a valid reference mold
+	 */
+	FACE* find_delam_ref_face(Layer *layer_orig);
+
+	/**
+	 * \brief Imprints the delamination profiles to all cohesive faces between the input layers
+	 * \param layer_orig layer on the original side
+	 * \param layer_offset layer on the offset side
+	 * \param outer_profile outer delamination profile in 3D space
+	 * \param inner_profile inner delamination profile in 3D space
+	 * \param inner_profile_pp inner delamination profile in parametric space
+	 * \param pair_each_couple TRUE updates the surface pairs after imprinting each face couple
+	 */
+	void imprint_delamination_profiles(Layer *layer_orig, Layer *layer_offset, BODY* outer_profile, BODY* inner_profile, BODY* inner_profile_pp, bool pair_each_couple);
+
 	/**
 	 * \brief Imprints delamination and updates LayerSurface object
 	 * \param[in] layersurface_in input LayerSurface
@@ -276,9 +377,9 @@ protected:
 	 * IMPORTANT: This function is a part of boundary condition evaluation evaluation functionality and creates the output face in parametric space.
 	 *
 	 * /param[in] delam_wirebody wire body of the inner delamination profile in parametric space
-	 * /param[out] delam_face_inner wire covered face representing the inner delamination profile in parametric space
+	 * /param[out] delam_faces_inner wire covered faces representing the inner delamination profiles in parametric space
 	 */
-	void generate_delam_ref_face(BODY* delam_wirebody, FACE*& delam_face_inner);
+	void generate_delam_ref_face(BODY* delam_wirebody, delamo::List<FACE*>& delam_faces_inner);
 
 	/**
 	 * \brief Finds boundary conditions on the delaminated FACE
@@ -286,10 +387,10 @@ protected:
 	 * \param[in] transf_in face transformation (should be the same as body transformation)
 	 * \param[in] ref_point arbitrary reference point for testing
 	 * \param[in] ref_cohesive_zone cohesive zone reference
-	 * \param[in] ref_contact_zone contact zone reference
+	 * \param[in] ref_contact_zones contact zone references, one face for each delamination
 	 * \param[out] delam_type delamination type
 	 */
-	void find_delam_bc(FACE* face_in, SPAtransf& transf_in, SPAposition& ref_point, SPAposition& ref_cohesive_zone, FACE* ref_contact_zone, DelaminationType& delam_type);
+	void find_delam_bc(FACE* face_in, SPAtransf& transf_in, SPAposition& ref_point, SPAposition& ref_cohesive_zone, delamo::List<FACE*>& ref_contact_zones, DelaminationType& delam_type);
 
 	/**
 	* \brief Generates inner and outer delamination profiles
@@ -303,6 +404,26 @@ protected:
 	*/
 	void generate_delamination_profiles(FACE* ref_face, delamo::TPoint3<double>* delampts, int delampts_size, BODY*& outer_profile, BODY*& inner_profile, BODY*& outer_profile_pp, BODY*& inner_profile_pp);
 
+	/**
+	* \brief Gets the inner and outer delamination profiles from the profile cache
+	* The profiles are generated only if the cache does not contain the profiles for the reference face, delamination points
+	* and the offset distance. The returned profiles are owned by the cache.
+	*
+	* \param[in] ref_face reference face for generating profiles
+	* \param[in] delampts list of delamination edge points
+	* \param[in] delampts_size size of the delamination edge points list
+	* \param[out] outer_profile outer delamination profile in 3D space
+	* \param[out] inner_profile inner delamination profile in 3D space
+	* \param[out] outer_profile_pp outer delamination profile in parametric space
+	* \param[out] inner_profile_pp inner delamination profile in parametric space
+	*/
+	void get_delamination_profiles(FACE* ref_face, delamo::TPoint3<double>* delampts, int delampts_size, BODY*& outer_profile, BODY*& inner_profile, BODY*& outer_profile_pp, BODY*& inner_profile_pp);
+
+	/**
+	* \brief Deletes all delamination profiles stored in the profile cache
+	*/
+	void clear_delamination_profiles();
+
 	/**
 	 * \brief Internal function for processing split layers
 	 * \param[in/out] layer_in input layer
@@ -338,6 +459,39 @@ protected:
 	 */
 	void update_surface_pairs(Layer *layer1, Layer *layer2);
 
+	/**
+	 * \brief Updates surface pairs of the surfaces created or modified since the last pairing
+	 *
+	 * The modified surfaces and their old pairs are paired again, all other surface pairs are kept.
+	 * \param layer1 input layer 1
+	 * \param layer2 input layer 2
+	 */
+	void update_modified_surface_pairs(Layer *layer1, Layer *layer2);
+
+	/**
+	 * \brief Checks whether the point of the 1st surface is inside the facing 2nd surface
+	 * \param layer1_ls surface of the input layer 1
+	 * \param layer1_lb_transf transformation of the body containing the 1st surface
+	 * \param layer2_ls surface of the input layer 2
+	 * \return TRUE if the surfaces are a pair, otherwise FALSE
+	 */
+	bool check_surface_pair(LayerSurface* layer1_ls, SPAtransf& layer1_lb_transf, LayerSurface* layer2_ls);
+
+	/**
+	 * \brief Adds all surfaces of the input layer to the surface pair index
+	 * \param[in] layer_in input layer
+	 * \param[out] index surface pair index
+	 */
+	void build_surface_index(Layer *layer_in, SurfacePairIndex& index);
+
+	/**
+	 * \brief Adds all faces of the input layers to the bounding volume hierarchy
+	 * \param[in] layer_list list of layers
+	 * \param[in] layer_list_size size of the layer list
+	 * \param[out] bvh bounding volume hierarchy
+	 */
+	void build_face_bvh(Layer** layer_list, int layer_list_size, FaceBVH& bvh);
+
 	/**
 	 * \brief Checks whether ACIS is running or not
 	 */
@@ -362,6 +516,21 @@ protected:
 	*/
 	void save_cad_model(const char* file_name, delamo::List<Layer*>& layer_list, delamo::List<MBBody*>& mbbody_list);
 
+	/**
+	 * \brief Saves the bodies of a layer to a SAT file with their fingerprints
+	 *
+	 * \param file_name name of the shard file
+	 * \param layer layer of the bodies
+	 * \param bodies layer bodies to be saved in the file
+	 */
+	void save_cad_shard(const char* file_name, Layer* layer, delamo::Span<LayerBody*> bodies);
+
+	/**
+	 * \brief Returns the extension of the SAT files
+	 * \return file extension
+	 */
+	const char* cad_file_extension();
+
 	/**
 	 * \brief Loads the CAD model from a file
 	 *
@@ -427,6 +596,23 @@ protected:
 	 */
 	void get_body_transf(BODY* body_in, SPAtransf& transf_out);
 
+	/**
+	 * \brief Computes a tag which changes when the loops or the edges of the face change
+	 * \param face_in input FACE object
+	 * \return topology tag of the face
+	 */
+	unsigned long long face_topology_tag(FACE* face_in);
+
+	/**
+	 * \brief Checks whether the bounding boxes of the input layer bodies overlap within the tolerance value
+	 * The bounding boxes are cached in the LayerBody objects.
+	 *
+	 * \param lb1 input layer body 1
+	 * \param lb2 input layer body 2
+	 * \return TRUE if the bounding boxes overlap, otherwise FALSE
+	 */
+	bool bodies_overlap(LayerBody* lb1, LayerBody* lb2);
+
 	/**
 	 * \brief Finds the closest side face w.r.t. the given point
 	 * \param layer_in input layer
@@ -435,10 +621,89 @@ protected:
 	 */
 	LayerSurface* find_closest_side(Layer *layer_in, delamo::TPoint3<double>& point_in);
 
+	/**
+	 * \brief Saves a body as SAT text in memory
+	 * \param[in] body input body
+	 * \param[out] blob SAT data of the body
+	 * \return false if the body cannot be saved
+	 */
+	bool save_sat_body(BODY* body, std::string& blob);
+
+	/**
+	 * \brief Restores a body saved by save_sat_body()
+	 * \param blob SAT data of the body
+	 * \return restored body, NULL if the data is not valid
+	 */
+	BODY* restore_sat_body(const std::string& blob);
+
+	/**
+	 * \brief Attaches a fingerprint to a body as a named attribute, so that it is saved to the SAT files
+	 * \param body input body
+	 * \param fp fingerprint of the layer of the body
+	 */
+	void attach_fingerprint(BODY* body, const Fingerprint& fp);
+
 private:
 	const double _u_pos = 0.05; /**< Initial surface point evaluation location in the parametric domain (u-direction) */
 	const double _v_pos = 0.05; /**< Initial surface point evaluation location in the parametric domain (v-direction) */
 	double _blending_radius = 0.0; /**< Radius for creating blended faces during stitching (fillet radius for stiffened layers) */
+	bool _bStarted = false; /**< TRUE if this instance is counted as a user of the shared ACIS kernel */
+
+	// Computes the deferred reference points and normals of the LayerSurface objects
+	class PointNormalEvaluator : public LayerSurfaceEvaluator
+	{
+	public:
+		PointNormalEvaluator(ACISModelBuilder* builder, double reference_normal_z, bool update_angle);
+		void evaluate(LayerSurface* ls);
+
+	private:
+		ACISModelBuilder* _pBuilder; /**< Model builder which owns the point-normal find algorithm */
+		double _mReferenceNormalZ; /**< z-component of the reference normal used for computing the surface angle */
+		bool _bUpdateAngle; /**< Flag to compute the surface angle */
+	};
+
+	PointNormalEvaluator _mEvalPointNormal = PointNormalEvaluator(this, 1.0, false); /**< Updates point and normal only */
+	PointNormalEvaluator _mEvalOffsetNormal = PointNormalEvaluator(this, 1.0, true); /**< Updates point, normal and angle w.r.t. +z */
+	PointNormalEvaluator _mEvalOrigNormal = PointNormalEvaluator(this, -1.0, true); /**< Updates point, normal and angle w.r.t. -z */
+
+	// Computes the exact point-face distances for the FaceBVH queries (not thread-safe, as the ACIS API calls are not re-entrant)
+	class FaceDistance : public FaceDistanceEvaluator
+	{
+	public:
+		explicit FaceDistance(ACISModelBuilder* builder);
+		double distance(LayerSurface* ls, const delamo::TPoint3<double>& pt, delamo::TPoint3<double>& closest);
+
+	private:
+		ACISModelBuilder* _pBuilder; /**< Model builder used for checking the API outcomes */
+	};
+
+	// Key of the delamination profile cache
+	struct DelamProfileKey
+	{
+		FACE* ref_face; /**< Reference face for generating profiles */
+		unsigned long long outline_hash; /**< Hash of the delamination edge points */
+		double offset; /**< Offset distance between the outer and inner profiles */
+
+		bool operator<(const DelamProfileKey& rhs) const
+		{
+			if (ref_face != rhs.ref_face)
+				return ref_face < rhs.ref_face;
+			if (outline_hash != rhs.outline_hash)
+				return outline_hash < rhs.outline_hash;
+			return offset < rhs.offset;
+		}
+	};
+
+	// Delamination profiles generated by generate_delamination_profiles()
+	struct DelamProfiles
+	{
+		BODY* outer; /**< Outer delamination profile in 3D space */
+		BODY* inner; /**< Inner delamination profile in 3D space */
+		BODY* outer_pp; /**< Outer delamination profile in parametric space */
+		BODY* inner_pp; /**< Inner delamination profile in parametric space */
+	};
+
+	std::map<DelamProfileKey, DelamProfiles> _mDelamProfileCache; /**< Delamination profiles reused for all faces of an interface */
 
 	/**
 	 * \brief Checks ACIS API outcome and logs it if there are any errors
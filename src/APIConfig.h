@@ -22,6 +22,8 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <cmath>
 #include <cstring>
 #include <memory>
@@ -36,10 +38,16 @@
 #include "NURBS.hxx"
 #include "PointVector.hxx"
 #include "ContainerList.hxx"
+#include "Point3Array.hxx"
+#include "Span.hxx"
 
 // ACIS includes
 #ifdef ACISOBJ
 #include "ACIS.h"
+#else
+// The kernel objects are opaque to the data model, so plain pointers are enough without a solid modeling kernel
+typedef void* DLM_BODYP;
+typedef void* DLM_FACEP;
 #endif
 
 // Convenience macros for declaring SWIG collections, with correspondingly named typedefs
@@ -225,4 +233,79 @@ struct FaceAdjacency
 	DelaminationType bcType; /**< Type of the boundary condition between Layer 1 and Layer 2 */
 };
 
+// Delamination outlines and boundary conditions between two consecutive plies of a laminate
+struct InterfaceSpec
+{
+	// Ctor
+	InterfaceSpec()
+	{
+		default_status = is_cohesive;
+		delam_region_status = is_contact;
+		delam_ring_status = is_none;
+	}
+
+	delamo::List<std::string> delam_files; /**< Delamination outline files, empty for a fully bonded interface */
+	BCStatus default_status; /**< Boundary condition outside the delamination outlines */
+	BCStatus delam_region_status; /**< Boundary condition inside the delamination outlines */
+	BCStatus delam_ring_status; /**< Boundary condition of the rings around the delamination outlines */
+};
+
+class LayerMold;
+
+// Complete layup of a laminate to be generated by a single ModelBuilder::build_laminate() call
+struct LaminateSpec
+{
+	// Ctor
+	LaminateSpec()
+	{
+		mold = nullptr;
+		layer_mold = nullptr;
+		direction = OFFSET;
+	}
+
+	delamo::NURBS<double>* mold; /**< Mold surface of the first ply */
+	LayerMold* layer_mold; /**< Mold of the first ply, used if the NURBS mold is not set */
+	Direction direction; /**< Offsetting direction of the plies */
+	delamo::List<double> thickness; /**< Ply thicknesses, also defines the number of plies */
+	delamo::List<int> layup; /**< Fiber orientation angles of the plies, empty for all zero */
+	delamo::List<std::string> names; /**< Ply names, empty for Layer_1, Layer_2, ... */
+	delamo::List<InterfaceSpec> interfaces; /**< Interfaces between the consecutive plies, empty for bonded interfaces */
+};
+
+// Stable reference to a LayerSurface which can be stored instead of a pointer
+struct SurfaceHandle
+{
+	// Ctor
+	SurfaceHandle()
+	{
+		layer_id = -1;
+		body_id = -1;
+		surface_id = -1;
+		slot = -1;
+		generation = 0;
+	}
+
+	// Checks if the handle refers to a surface
+	bool is_null() const
+	{
+		return slot < 0;
+	}
+
+	bool operator==(const SurfaceHandle& rhs) const
+	{
+		return slot == rhs.slot && generation == rhs.generation;
+	}
+
+	bool operator!=(const SurfaceHandle& rhs) const
+	{
+		return !(*this == rhs);
+	}
+
+	int layer_id; /**< ID of the Layer which owns the surface */
+	int body_id; /**< ID of the LayerBody which owns the surface */
+	int surface_id; /**< ID of the LayerSurface */
+	int slot; /**< Index of the surface in the handle table of the ModelBuilder */
+	unsigned int generation; /**< Generation of the surface, changes when the face is split or imprinted */
+};
+
 #endif // !APICONFIG_H
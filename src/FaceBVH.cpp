@@ -0,0 +1,226 @@
+#include "FaceBVH.h"
+#include <thread>
+
+
+FaceBVH::FaceBVH()
+{
+	this->_bDirty = true;
+}
+
+FaceBVH::~FaceBVH()
+{
+	this->clear();
+}
+
+void FaceBVH::clear()
+{
+	this->_mEntries.clear();
+	this->_mNodes.clear();
+	this->_bDirty = true;
+}
+
+void FaceBVH::add(LayerSurface* ls, LayerBody* lb, const delamo::TPoint3<double>& bbox_min, const delamo::TPoint3<double>& bbox_max)
+{
+	Entry e;
+	e.surface = ls;
+	e.body = lb;
+	e.bbox_min = bbox_min;
+	e.bbox_max = bbox_max;
+	e.center = (bbox_min + bbox_max) * 0.5;
+	this->_mEntries.push_back(e);
+	this->_bDirty = true;
+}
+
+bool FaceBVH::nearest(const delamo::TPoint3<double>& pt, FaceDistanceEvaluator& evaluator, Result& result)
+{
+	if (this->_bDirty)
+		this->build();
+
+	return this->query(pt, evaluator, result);
+}
+
+void FaceBVH::nearest(delamo::Span<const delamo::TPoint3<double>> pts, FaceDistanceEvaluator& evaluator, delamo::List<Result>& results, int num_threads)
+{
+	// Build the hierarchy once for the whole batch, queries don't modify it
+	if (this->_bDirty)
+		this->build();
+
+	int num_pts = (int) pts.size();
+	results = delamo::List<Result>(num_pts, Result());
+
+	// Fall back to serial evaluation if the evaluator cannot be shared between the threads
+	if (!evaluator.thread_safe())
+		num_threads = 1;
+	num_threads = std::max(1, std::min(num_threads, num_pts));
+
+	if (num_threads == 1)
+	{
+		for (int i = 0; i < num_pts; i++)
+			this->query(pts[i], evaluator, results[i]);
+		return;
+	}
+
+	// Each thread processes a contiguous block of the query points and writes its own results
+	std::vector<std::thread> workers;
+	int block_size = (num_pts + num_threads - 1) / num_threads;
+	for (int t = 0; t < num_threads; t++)
+	{
+		int first = t * block_size;
+		int last = std::min(first + block_size, num_pts);
+		workers.push_back(std::thread([this, &pts, &evaluator, &results, first, last]()
+		{
+			for (int i = first; i < last; i++)
+				this->query(pts[i], evaluator, results[i]);
+		}));
+	}
+	for (auto& w : workers)
+		w.join();
+}
+
+int FaceBVH::size()
+{
+	return (int) this->_mEntries.size();
+}
+
+void FaceBVH::build()
+{
+	this->_mNodes.clear();
+	if (!this->_mEntries.empty())
+	{
+		// A binary tree with one entry per leaf has at most 2n-1 nodes
+		this->_mNodes.reserve(2 * this->_mEntries.size());
+		this->build_node(0, (int) this->_mEntries.size());
+	}
+	this->_bDirty = false;
+}
+
+int FaceBVH::build_node(int first, int count)
+{
+	int node_idx = (int) this->_mNodes.size();
+	this->_mNodes.push_back(Node());
+
+	// Compute the node bounding box and the bounds of the entry centers
+	delamo::TPoint3<double> bbox_min(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+	delamo::TPoint3<double> bbox_max = bbox_min * -1.0;
+	delamo::TPoint3<double> center_min = bbox_min;
+	delamo::TPoint3<double> center_max = bbox_max;
+	for (int i = first; i < first + count; i++)
+	{
+		const Entry& e = this->_mEntries[i];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			bbox_min[axis] = std::min(bbox_min[axis], e.bbox_min[axis]);
+			bbox_max[axis] = std::max(bbox_max[axis], e.bbox_max[axis]);
+			center_min[axis] = std::min(center_min[axis], e.center[axis]);
+			center_max[axis] = std::max(center_max[axis], e.center[axis]);
+		}
+	}
+
+	Node& node = this->_mNodes[node_idx];
+	node.bbox_min = bbox_min;
+	node.bbox_max = bbox_max;
+	node.left = -1;
+	node.right = -1;
+	node.first = first;
+	node.count = count;
+
+	if (count <= FACEBVH_LEAF_SIZE)
+		return node_idx;
+
+	// Split the entries at the median center along the largest axis
+	int split_axis = 0;
+	for (int axis = 1; axis < 3; axis++)
+	{
+		if (center_max[axis] - center_min[axis] > center_max[split_axis] - center_min[split_axis])
+			split_axis = axis;
+	}
+	int half = count / 2;
+	std::nth_element(this->_mEntries.begin() + first, this->_mEntries.begin() + first + half, this->_mEntries.begin() + first + count,
+		[split_axis](const Entry& a, const Entry& b) { return a.center[split_axis] < b.center[split_axis]; });
+
+	// Child construction may reallocate the node list, so don't hold a reference to the node
+	int left = this->build_node(first, half);
+	int right = this->build_node(first + half, count - half);
+	this->_mNodes[node_idx].left = left;
+	this->_mNodes[node_idx].right = right;
+	this->_mNodes[node_idx].count = 0;
+
+	return node_idx;
+}
+
+bool FaceBVH::query(const delamo::TPoint3<double>& pt, FaceDistanceEvaluator& evaluator, Result& result) const
+{
+	result.surface = nullptr;
+	result.body = nullptr;
+	result.distance = std::numeric_limits<double>::max();
+
+	if (this->_mNodes.empty())
+		return false;
+
+	double best_sq = std::numeric_limits<double>::max();
+	std::vector<int> stack;
+	stack.push_back(0);
+	while (!stack.empty())
+	{
+		const Node& node = this->_mNodes[stack.back()];
+		stack.pop_back();
+
+		// Skip the nodes which cannot contain a closer surface
+		if (box_distance_sq(pt, node.bbox_min, node.bbox_max) >= best_sq)
+			continue;
+
+		if (node.count > 0)
+		{
+			for (int i = node.first; i < node.first + node.count; i++)
+			{
+				const Entry& e = this->_mEntries[i];
+				if (box_distance_sq(pt, e.bbox_min, e.bbox_max) >= best_sq)
+					continue;
+
+				delamo::TPoint3<double> closest;
+				double distance = evaluator.distance(e.surface, pt, closest);
+				if (distance < result.distance)
+				{
+					result.surface = e.surface;
+					result.body = e.body;
+					result.point = closest;
+					result.distance = distance;
+					best_sq = distance * distance;
+				}
+			}
+		}
+		else
+		{
+			// Push the farther child first, so that the closer one is visited first
+			double dist_left = box_distance_sq(pt, this->_mNodes[node.left].bbox_min, this->_mNodes[node.left].bbox_max);
+			double dist_right = box_distance_sq(pt, this->_mNodes[node.right].bbox_min, this->_mNodes[node.right].bbox_max);
+			if (dist_left < dist_right)
+			{
+				stack.push_back(node.right);
+				stack.push_back(node.left);
+			}
+			else
+			{
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+	}
+
+	return result.surface != nullptr;
+}
+
+double FaceBVH::box_distance_sq(const delamo::TPoint3<double>& pt, const delamo::TPoint3<double>& bbox_min, const delamo::TPoint3<double>& bbox_max)
+{
+	double dist_sq = 0.0;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		double d = 0.0;
+		if (pt[axis] < bbox_min[axis])
+			d = bbox_min[axis] - pt[axis];
+		else if (pt[axis] > bbox_max[axis])
+			d = pt[axis] - bbox_max[axis];
+		dist_sq += d * d;
+	}
+	return dist_sq;
+}
@@ -0,0 +1,147 @@
+#ifndef FACEBVH_H
+#define FACEBVH_H
+
+#include "APIConfig.h"
+#include "LayerSurface.h"
+#include "LayerBody.h"
+// Export file is generated by CMake's GenerateExportHeader module
+#include "modelbuilder_export.h"
+
+
+// Maximum number of surfaces stored in a leaf node
+#define FACEBVH_LEAF_SIZE 4
+
+/**
+ * \brief Abstract class for computing the exact distance between a point and a surface.
+ *
+ * The bounding volume hierarchy only knows the bounding boxes of the surfaces, so the exact distance computation is
+ * delegated to the solid modeling kernel through this class.
+ */
+class MODELBUILDER_EXPORT FaceDistanceEvaluator
+{
+public:
+	virtual ~FaceDistanceEvaluator() {}
+
+	/**
+	 * \brief Computes the distance between the input point and the surface.
+	 * \param[in] ls input surface
+	 * \param[in] pt query point
+	 * \param[out] closest closest point on the surface
+	 * \return distance between the query point and the closest point
+	 */
+	virtual double distance(LayerSurface* ls, const delamo::TPoint3<double>& pt, delamo::TPoint3<double>& closest) = 0;
+
+	/**
+	 * \brief Returns whether distance() can be called from multiple threads at the same time.
+	 * \return TRUE if the evaluator is thread-safe, otherwise FALSE
+	 */
+	virtual bool thread_safe() { return false; }
+};
+
+/**
+ * \brief Bounding volume hierarchy for finding the closest surfaces to a set of query points.
+ *
+ * The surfaces are added with their bounding boxes and the hierarchy is built once during the first query, so that
+ * a batch of queries reuses it. A query visits the nodes in the order of their distance to the query point and skips
+ * the nodes which are farther than the closest surface found so far.
+ */
+class MODELBUILDER_EXPORT FaceBVH
+{
+public:
+
+	/**
+	 * \brief Result of a closest surface query.
+	 */
+	struct Result
+	{
+		LayerSurface* surface; /**< Closest surface, nullptr if the hierarchy is empty */
+		LayerBody* body; /**< LayerBody which owns the closest surface */
+		delamo::TPoint3<double> point; /**< Closest point on the surface */
+		double distance; /**< Distance between the query point and the closest point */
+	};
+
+	/**
+	 * \brief Default constructor.
+	 */
+	FaceBVH();
+
+	/**
+	 * \brief Default destructor.
+	 */
+	~FaceBVH();
+
+	/**
+	 * \brief Removes all surfaces from the hierarchy.
+	 */
+	void clear();
+
+	/**
+	 * \brief Adds a surface to the hierarchy.
+	 *
+	 * The hierarchy is rebuilt during the next query.
+	 * \param ls LayerSurface to be added
+	 * \param lb LayerBody which owns the surface
+	 * \param bbox_min minimum corner of the surface bounding box
+	 * \param bbox_max maximum corner of the surface bounding box
+	 */
+	void add(LayerSurface* ls, LayerBody* lb, const delamo::TPoint3<double>& bbox_min, const delamo::TPoint3<double>& bbox_max);
+
+	/**
+	 * \brief Finds the closest surface to the query point.
+	 * \param[in] pt query point
+	 * \param[in] evaluator exact distance evaluator
+	 * \param[out] result closest surface
+	 * \return TRUE if a surface is found, otherwise FALSE
+	 */
+	bool nearest(const delamo::TPoint3<double>& pt, FaceDistanceEvaluator& evaluator, Result& result);
+
+	/**
+	 * \brief Finds the closest surfaces to a batch of query points.
+	 *
+	 * The queries are distributed over the threads only if the evaluator is thread-safe.
+	 * \param[in] pts query points
+	 * \param[in] evaluator exact distance evaluator
+	 * \param[out] results closest surfaces in the order of the query points
+	 * \param[in] num_threads number of threads
+	 */
+	void nearest(delamo::Span<const delamo::TPoint3<double>> pts, FaceDistanceEvaluator& evaluator, delamo::List<Result>& results, int num_threads = 1);
+
+	/**
+	 * \brief Gets the number of surfaces in the hierarchy.
+	 * \return number of surfaces
+	 */
+	int size();
+
+private:
+	// Surface stored in the hierarchy
+	struct Entry
+	{
+		LayerSurface* surface; /**< Indexed surface */
+		LayerBody* body; /**< Owner of the indexed surface */
+		delamo::TPoint3<double> bbox_min; /**< Minimum corner of the bounding box */
+		delamo::TPoint3<double> bbox_max; /**< Maximum corner of the bounding box */
+		delamo::TPoint3<double> center; /**< Center of the bounding box */
+	};
+
+	// Node of the hierarchy
+	struct Node
+	{
+		delamo::TPoint3<double> bbox_min; /**< Minimum corner of the node bounding box */
+		delamo::TPoint3<double> bbox_max; /**< Maximum corner of the node bounding box */
+		int left; /**< Index of the left child node */
+		int right; /**< Index of the right child node */
+		int first; /**< Index of the first entry of a leaf node */
+		int count; /**< Number of entries of a leaf node, zero for inner nodes */
+	};
+
+	bool _bDirty; /**< TRUE if the hierarchy needs to be rebuilt */
+	std::vector<Entry> _mEntries; /**< Surfaces in the hierarchy, sorted by the leaf nodes after build */
+	std::vector<Node> _mNodes; /**< Nodes of the hierarchy, the first one is the root */
+
+	void build();
+	int build_node(int first, int count);
+	bool query(const delamo::TPoint3<double>& pt, FaceDistanceEvaluator& evaluator, Result& result) const;
+	static double box_distance_sq(const delamo::TPoint3<double>& pt, const delamo::TPoint3<double>& bbox_min, const delamo::TPoint3<double>& bbox_max);
+};
+
+#endif // !FACEBVH_H
@@ -0,0 +1,186 @@
+#include "Fingerprint.h"
+
+
+// 128-bit FNV-1a constants, the prime is 2^88 + 2^8 + 0x3B
+static const unsigned long long FNV128_OFFSET_BASIS_HI = 0x6C62272E07BB0142ULL;
+static const unsigned long long FNV128_OFFSET_BASIS_LO = 0x62B821756295C58DULL;
+static const unsigned long long FNV128_PRIME_LO = 0x13BULL;
+static const int FNV128_PRIME_SHIFT = 88 - 64;
+
+
+Fingerprint::Fingerprint()
+{
+	this->_mHi = 0;
+	this->_mLo = 0;
+}
+
+Fingerprint::Fingerprint(unsigned long long hi, unsigned long long lo)
+{
+	this->_mHi = hi;
+	this->_mLo = lo;
+}
+
+unsigned long long Fingerprint::hi() const
+{
+	return this->_mHi;
+}
+
+unsigned long long Fingerprint::lo() const
+{
+	return this->_mLo;
+}
+
+bool Fingerprint::valid() const
+{
+	return this->_mHi != 0 || this->_mLo != 0;
+}
+
+unsigned long long Fingerprint::hash() const
+{
+	return this->_mHi ^ this->_mLo;
+}
+
+std::string Fingerprint::hex() const
+{
+	std::ostringstream str;
+	str << std::hex << std::setfill('0') << std::setw(16) << this->_mHi << std::setw(16) << this->_mLo;
+	return str.str();
+}
+
+bool Fingerprint::operator==(const Fingerprint& rhs) const
+{
+	return this->_mHi == rhs._mHi && this->_mLo == rhs._mLo;
+}
+
+bool Fingerprint::operator!=(const Fingerprint& rhs) const
+{
+	return !(*this == rhs);
+}
+
+
+FingerprintBuilder::FingerprintBuilder()
+{
+	this->_mHi = FNV128_OFFSET_BASIS_HI;
+	this->_mLo = FNV128_OFFSET_BASIS_LO;
+}
+
+void FingerprintBuilder::add(const void* data, size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; i++)
+	{
+		this->_mLo ^= bytes[i];
+
+		// Multiply the 128-bit hash by the prime using 32-bit limbs, so no compiler specific 128-bit type is needed
+		unsigned long long lo_lo = (this->_mLo & 0xFFFFFFFFULL) * FNV128_PRIME_LO;
+		unsigned long long lo_hi = (this->_mLo >> 32) * FNV128_PRIME_LO;
+		unsigned long long mid = (lo_lo >> 32) + (lo_hi & 0xFFFFFFFFULL);
+		unsigned long long carry = (lo_hi >> 32) + (mid >> 32);
+		unsigned long long hi = this->_mHi * FNV128_PRIME_LO + carry + (this->_mLo << FNV128_PRIME_SHIFT);
+		this->_mLo = (mid << 32) | (lo_lo & 0xFFFFFFFFULL);
+		this->_mHi = hi;
+	}
+}
+
+void FingerprintBuilder::add(int value)
+{
+	this->add((unsigned long long)(long long)value);
+}
+
+void FingerprintBuilder::add(unsigned long long value)
+{
+	unsigned char bytes[8];
+	for (int i = 0; i < 8; i++)
+		bytes[i] = (unsigned char)(value >> (8 * i));
+	this->add(bytes, sizeof(bytes));
+}
+
+void FingerprintBuilder::add(double value)
+{
+	// Both zeros should generate the same fingerprint
+	if (value == 0.0)
+		value = 0.0;
+	unsigned long long bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	this->add(bits);
+}
+
+void FingerprintBuilder::add(double value, double quantum)
+{
+	double steps = value / quantum;
+	if (!std::isfinite(steps) || std::fabs(steps) >= 9.0e18)
+	{
+		this->add(value);
+		return;
+	}
+	this->add((unsigned long long)std::llround(steps));
+}
+
+void FingerprintBuilder::add(const char* str)
+{
+	int len = (str == nullptr) ? 0 : (int)std::strlen(str);
+	this->add(len);
+	this->add(str, len);
+}
+
+void FingerprintBuilder::add(const Fingerprint& fp)
+{
+	this->add(fp.hi());
+	this->add(fp.lo());
+}
+
+void FingerprintBuilder::add(delamo::NURBS<double>* nurbs, double quantum)
+{
+	this->add(nurbs->degree_u());
+	this->add(nurbs->degree_v());
+
+	// Knots are parametric values, they are not affected by the modeling tolerance
+	this->add(nurbs->knotvector_u_len());
+	for (int i = 0; i < nurbs->knotvector_u_len(); i++)
+		this->add(nurbs->knotvector_u()[i]);
+	this->add(nurbs->knotvector_v_len());
+	for (int i = 0; i < nurbs->knotvector_v_len(); i++)
+		this->add(nurbs->knotvector_v()[i]);
+
+	// Weights are optional
+	double* weights = nurbs->weights();
+	this->add((weights == nullptr) ? 0 : 1);
+	if (weights != nullptr)
+	{
+		for (int i = 0; i < nurbs->ctrlpts_len(); i++)
+			this->add(weights[i]);
+	}
+
+	this->add(nurbs->ctrlpts_u_len());
+	this->add(nurbs->ctrlpts_v_len());
+	delamo::TPoint3<double>* ctrlpts = nurbs->ctrlpts();
+	for (int i = 0; i < nurbs->ctrlpts_len(); i++)
+	{
+		this->add(ctrlpts[i].x(), quantum);
+		this->add(ctrlpts[i].y(), quantum);
+		this->add(ctrlpts[i].z(), quantum);
+	}
+}
+
+bool FingerprintBuilder::add_file(const char* file_name)
+{
+	std::ifstream input(file_name, std::ios::in | std::ios::binary);
+	if (!input.is_open())
+		return false;
+
+	char buffer[4096];
+	while (input)
+	{
+		input.read(buffer, sizeof(buffer));
+		this->add(buffer, (size_t)input.gcount());
+	}
+	return true;
+}
+
+Fingerprint FingerprintBuilder::value() const
+{
+	// Null fingerprint is reserved for the objects which are not fingerprinted
+	if (this->_mHi == 0 && this->_mLo == 0)
+		return Fingerprint(0, 1);
+	return Fingerprint(this->_mHi, this->_mLo);
+}
@@ -0,0 +1,165 @@
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+#include "APIConfig.h"
+// Export file is generated by CMake's GenerateExportHeader module
+#include "modelbuilder_export.h"
+
+
+/**
+ * \brief 128-bit identifier of a geometric object.
+ *
+ * Two objects with the same fingerprint are generated from the same inputs by the same sequence of operations, so
+ * their geometries are identical. The values do not depend on the platform or on the run.
+ */
+class MODELBUILDER_EXPORT Fingerprint
+{
+public:
+
+	/**
+	 * \brief Default constructor, creates the null fingerprint.
+	 */
+	Fingerprint();
+
+	/**
+	 * \brief Creates a fingerprint from its halves.
+	 * \param hi upper 64 bits
+	 * \param lo lower 64 bits
+	 */
+	Fingerprint(unsigned long long hi, unsigned long long lo);
+
+	/**
+	 * \brief Gets the upper 64 bits.
+	 * \return upper half of the fingerprint
+	 */
+	unsigned long long hi() const;
+
+	/**
+	 * \brief Gets the lower 64 bits.
+	 * \return lower half of the fingerprint
+	 */
+	unsigned long long lo() const;
+
+	/**
+	 * \brief Checks whether the fingerprint is computed.
+	 * \return true if the fingerprint is not null
+	 */
+	bool valid() const;
+
+	/**
+	 * \brief Folds the fingerprint to 64 bits, e.g. for hash tables and file names.
+	 * \return XOR of the halves
+	 */
+	unsigned long long hash() const;
+
+	/**
+	 * \brief Converts the fingerprint to 32 hexadecimal digits.
+	 * \return fingerprint string
+	 */
+	std::string hex() const;
+
+	/**
+	 * \brief Equality operator.
+	 * \param rhs fingerprint to be compared
+	 * \return true if both halves are equal
+	 */
+	bool operator==(const Fingerprint& rhs) const;
+
+	/**
+	 * \brief Inequality operator.
+	 * \param rhs fingerprint to be compared
+	 * \return true if one of the halves differs
+	 */
+	bool operator!=(const Fingerprint& rhs) const;
+
+private:
+	unsigned long long _mHi; /**< Upper 64 bits */
+	unsigned long long _mLo; /**< Lower 64 bits */
+};
+
+
+/**
+ * \brief Incremental 128-bit FNV-1a hash generating a Fingerprint.
+ *
+ * The numbers are added in little-endian byte order and the coordinates are quantized, so the same geometry generates
+ * the same fingerprint on every platform even if it is evaluated with a slightly different round-off.
+ */
+class MODELBUILDER_EXPORT FingerprintBuilder
+{
+public:
+
+	/**
+	 * \brief Default constructor.
+	 */
+	FingerprintBuilder();
+
+	/**
+	 * \brief Adds raw bytes to the fingerprint.
+	 * \param data pointer to the data
+	 * \param size size of the data in bytes
+	 */
+	void add(const void* data, size_t size);
+
+	/**
+	 * \brief Adds an integer to the fingerprint.
+	 * \param value input value
+	 */
+	void add(int value);
+
+	/**
+	 * \brief Adds an unsigned 64-bit integer to the fingerprint.
+	 * \param value input value
+	 */
+	void add(unsigned long long value);
+
+	/**
+	 * \brief Adds a floating point number, with its exact value, to the fingerprint.
+	 * \param value input value
+	 */
+	void add(double value);
+
+	/**
+	 * \brief Adds a floating point number rounded to a multiple of the quantum to the fingerprint.
+	 * \param value input value
+	 * \param quantum rounding step, should be positive
+	 */
+	void add(double value, double quantum);
+
+	/**
+	 * \brief Adds a string and its length to the fingerprint.
+	 * \param str input string
+	 */
+	void add(const char* str);
+
+	/**
+	 * \brief Adds another fingerprint.
+	 * \param fp input fingerprint
+	 */
+	void add(const Fingerprint& fp);
+
+	/**
+	 * \brief Adds the degrees, knot vectors, weights and quantized control points of a NURBS surface.
+	 * \param nurbs input NURBS surface
+	 * \param quantum rounding step of the control point coordinates
+	 */
+	void add(delamo::NURBS<double>* nurbs, double quantum);
+
+	/**
+	 * \brief Adds the contents of a file to the fingerprint.
+	 * \param file_name name of the file
+	 * \return false if the file cannot be read
+	 */
+	bool add_file(const char* file_name);
+
+	/**
+	 * \brief Gets the fingerprint.
+	 * \return fingerprint value, never null
+	 */
+	Fingerprint value() const;
+
+private:
+	unsigned long long _mHi; /**< Upper 64 bits of the hash */
+	unsigned long long _mLo; /**< Lower 64 bits of the hash */
+};
+
+#endif // !FINGERPRINT_H
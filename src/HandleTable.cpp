@@ -0,0 +1,86 @@
+#include "HandleTable.h"
+
+
+HandleTable::HandleTable()
+{
+	this->_mSize = 0;
+}
+
+HandleTable::~HandleTable()
+{
+	this->clear();
+}
+
+int HandleTable::add(LayerSurface* ls)
+{
+	if (ls == nullptr)
+		return -1;
+
+	// Keep the existing slot
+	int slot = ls->handle_slot();
+	if (slot >= 0 && slot < (int) this->_mSlots.size() && this->_mSlots[slot] == ls)
+		return slot;
+
+	// Reuse a free slot if there is any
+	if (!this->_mFreeSlots.empty())
+	{
+		slot = this->_mFreeSlots.back();
+		this->_mFreeSlots.pop_back();
+		this->_mSlots[slot] = ls;
+	}
+	else
+	{
+		slot = (int) this->_mSlots.size();
+		this->_mSlots.push_back(ls);
+	}
+
+	ls->handle_slot(slot);
+	this->_mSize++;
+	return slot;
+}
+
+void HandleTable::remove(LayerSurface* ls)
+{
+	if (ls == nullptr)
+		return;
+
+	int slot = ls->handle_slot();
+	if (slot < 0 || slot >= (int) this->_mSlots.size() || this->_mSlots[slot] != ls)
+		return;
+
+	this->_mSlots[slot] = nullptr;
+	this->_mFreeSlots.push_back(slot);
+	ls->handle_slot(-1);
+	this->_mSize--;
+}
+
+LayerSurface* HandleTable::lookup(const SurfaceHandle& handle)
+{
+	if (handle.slot < 0 || handle.slot >= (int) this->_mSlots.size())
+		return nullptr;
+
+	// Generations are unique, so a reused slot or a modified surface doesn't match the handle
+	LayerSurface* ls = this->_mSlots[handle.slot];
+	if (ls == nullptr || ls->generation() != handle.generation)
+		return nullptr;
+
+	return ls;
+}
+
+bool HandleTable::is_valid(const SurfaceHandle& handle)
+{
+	return this->lookup(handle) != nullptr;
+}
+
+int HandleTable::size()
+{
+	return this->_mSize;
+}
+
+void HandleTable::clear()
+{
+	// The surfaces may already be destroyed, so their slot values are not reset
+	this->_mSlots.clear();
+	this->_mFreeSlots.clear();
+	this->_mSize = 0;
+}
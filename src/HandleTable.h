@@ -0,0 +1,79 @@
+#ifndef HANDLETABLE_H
+#define HANDLETABLE_H
+
+#include "APIConfig.h"
+#include "LayerSurface.h"
+// Export file is generated by CMake's GenerateExportHeader module
+#include "modelbuilder_export.h"
+
+
+/**
+ * \brief Maps the surface handles to the LayerSurface objects.
+ *
+ * Each registered surface occupies a slot and its handle stores the slot index with the surface generation. Looking up
+ * a handle is a direct slot access followed by a generation check, so a handle taken before the surface is split,
+ * imprinted or released resolves to nullptr instead of a different surface.
+ */
+class MODELBUILDER_EXPORT HandleTable
+{
+public:
+
+	/**
+	 * \brief Default constructor.
+	 */
+	HandleTable();
+
+	/**
+	 * \brief Default destructor.
+	 */
+	~HandleTable();
+
+	/**
+	 * \brief Registers a surface and assigns a slot to it.
+	 *
+	 * The slot is stored in the surface. Registering a surface twice keeps its existing slot.
+	 * \param ls LayerSurface to be registered
+	 * \return slot index
+	 */
+	int add(LayerSurface* ls);
+
+	/**
+	 * \brief Releases the slot of a surface.
+	 *
+	 * The handles of the surface become invalid and the slot is reused by the next registered surface.
+	 * \param ls LayerSurface to be released
+	 */
+	void remove(LayerSurface* ls);
+
+	/**
+	 * \brief Finds the surface referred by the handle.
+	 * \param handle surface handle
+	 * \return LayerSurface object, nullptr if the handle is null or outdated
+	 */
+	LayerSurface* lookup(const SurfaceHandle& handle);
+
+	/**
+	 * \brief Checks whether the handle refers to the current generation of a registered surface.
+	 * \param handle surface handle
+	 * \return true if the handle can be resolved, otherwise false
+	 */
+	bool is_valid(const SurfaceHandle& handle);
+
+	/**
+	 * \brief Gets the number of registered surfaces.
+	 * \return number of registered surfaces
+	 */
+	int size();
+
+	/**
+	 * \brief Releases all slots.
+	 */
+	void clear();
+
+private:
+	std::vector<LayerSurface*> _mSlots; /**< Registered surfaces, nullptr for the free slots */
+	std::vector<int> _mFreeSlots; /**< Free slots to be reused */
+	int _mSize; /**< Number of registered surfaces */
+};
+
+#endif // !HANDLETABLE_H
@@ -45,10 +45,13 @@ void Layer::init_vars()
 	this->_mId = std::numeric_limits<int>::max();
 	this->_mLayup = 0;
 	this->_eType = LayerType::LAMINA;
+	this->_eDirection = Direction::NODIR;
 	this->_pBodyList = nullptr;
 	this->_mBodyListSize = 0;
+	this->_mBodyListCapacity = 0;
 	this->_pMoldList = nullptr;
 	this->_mMoldListSize = 0;
+	this->_mMoldListCapacity = 0;
 	this->_pPairOrig = nullptr;
 	this->_pPairOffset = nullptr;
 	this->next_lb_id = 0;
@@ -68,6 +71,7 @@ void Layer::delete_vars()
 		delete[] this->_pBodyList;
 		this->_pBodyList = nullptr;
 		this->_mBodyListSize = 0;
+		this->_mBodyListCapacity = 0;
 	}
 
 	if (this->_pMoldList != nullptr)
@@ -75,6 +79,7 @@ void Layer::delete_vars()
 		delete[] this->_pMoldList;
 		this->_pMoldList = nullptr;
 		this->_mMoldListSize = 0;
+		this->_mMoldListCapacity = 0;
 	}
 
 	this->_pPairOrig = nullptr;
@@ -113,6 +118,7 @@ void Layer::copy_vars(const Layer& rhs, Layer& lhs)
 		lhs._pBodyList = nullptr;
 	}
 	lhs._mBodyListSize = rhs._mBodyListSize;
+	lhs._mBodyListCapacity = rhs._mBodyListSize;
 	lhs._pBodyList = new LayerBody*[lhs._mBodyListSize];
 	std::copy(rhs._pBodyList, rhs._pBodyList + rhs._mBodyListSize, lhs._pBodyList);
 
@@ -123,6 +129,7 @@ void Layer::copy_vars(const Layer& rhs, Layer& lhs)
 		lhs._pMoldList = nullptr;
 	}
 	lhs._mMoldListSize = rhs._mMoldListSize;
+	lhs._mMoldListCapacity = rhs._mMoldListSize;
 	lhs._pMoldList = new LayerMold*[lhs._mMoldListSize];
 	std::copy(rhs._pMoldList, rhs._pMoldList + rhs._mMoldListSize, lhs._pMoldList);
 	
@@ -132,6 +139,7 @@ void Layer::copy_vars(const Layer& rhs, Layer& lhs)
 	lhs._pPairOffset = rhs._pPairOffset;
 	lhs.next_lb_id = rhs.next_lb_id;
 	lhs._mDelamRefMold = rhs._mDelamRefMold;
+	lhs._mFingerprint = rhs._mFingerprint;
 }
 
 double Layer::thickness()
@@ -260,36 +268,63 @@ void Layer::update_owners()
 		{
 			ls[j]->owner(this->_pBodyList[i]);
 		}
+
+		// Keep the face lookup in sync with the LayerSurface list
+		this->_pBodyList[i]->update_face_index();
 	}
 }
 
 void Layer::add_body(LayerBody *elem)
 {
-	if (this->_pBodyList != nullptr)
-	{
-		// Allocate a new body list
-		LayerBody** new_list = new LayerBody*[this->_mBodyListSize + 1];
-		std::copy(this->_pBodyList, this->_pBodyList + this->_mBodyListSize, new_list);
-		new_list[this->_mBodyListSize] = elem;
-		this->_mBodyListSize += 1;
+	// Double the capacity when the list is full, so that N insertions cost O(N) copies in total
+	if (this->_mBodyListSize == this->_mBodyListCapacity)
+		this->reserve((this->_mBodyListCapacity > 0) ? 2 * this->_mBodyListCapacity : CONTAINER_DEFAULT_ALLOC_SZ);
 
-		// Delete existing body list
-		delete[] this->_pBodyList;
-		this->_pBodyList = nullptr;
+	// Bodies are numbered in the order they are added to the layer
+	if (elem != nullptr && elem->id() < 0)
+		elem->id(this->next_lb_id);
 
-		// Copy new list over the body list fields
-		this->_pBodyList = new LayerBody*[this->_mBodyListSize];
-		std::copy(new_list, new_list + this->_mBodyListSize, this->_pBodyList);
-		delete[] new_list;
-		new_list = nullptr;
+	this->_pBodyList[this->_mBodyListSize] = elem;
+	this->_mBodyListSize += 1;
+	this->next_lb_id++;
+}
+
+void Layer::add_bodies(delamo::Span<LayerBody*> elems)
+{
+	int num_elems = (int)elems.size();
+	if (num_elems == 0)
+		return;
+
+	// Grow once for the whole range
+	int required = this->_mBodyListSize + num_elems;
+	if (required > this->_mBodyListCapacity)
+		this->reserve(std::max(required, 2 * this->_mBodyListCapacity));
+
+	std::copy(elems.begin(), elems.end(), this->_pBodyList + this->_mBodyListSize);
+	for (int i = this->_mBodyListSize; i < required; i++)
+	{
+		// Bodies are numbered in the order they are added to the layer
+		if (this->_pBodyList[i] != nullptr && this->_pBodyList[i]->id() < 0)
+			this->_pBodyList[i]->id(this->next_lb_id + (i - this->_mBodyListSize));
 	}
-	else
+	this->_mBodyListSize = required;
+	this->next_lb_id += num_elems;
+}
+
+void Layer::reserve(int new_capacity)
+{
+	// Never decrease the allocated memory
+	if (new_capacity <= this->_mBodyListCapacity)
+		return;
+
+	LayerBody** new_list = new LayerBody*[new_capacity];
+	if (this->_pBodyList != nullptr)
 	{
-		this->_mBodyListSize += 1;
-		this->_pBodyList = new LayerBody*[this->_mBodyListSize];
-		this->_pBodyList[0] = elem;
+		std::copy(this->_pBodyList, this->_pBodyList + this->_mBodyListSize, new_list);
+		delete[] this->_pBodyList;
 	}
-	this->next_lb_id++;
+	this->_pBodyList = new_list;
+	this->_mBodyListCapacity = new_capacity;
 }
 
 class LayerBody** Layer::list()
@@ -321,11 +356,7 @@ int Layer::size()
 
 void Layer::clear()
 {
-	if (this->_pBodyList != nullptr)
-	{
-		delete[] this->_pBodyList;
-		this->_pBodyList = nullptr;
-	}
+	// Keep the allocated memory, the list is usually refilled right after clearing
 	this->_mBodyListSize = 0;
 	// Reset LayerBody counter
 	this->next_lb_id = 0;
@@ -340,31 +371,9 @@ void Layer::remove(int idx)
 		return;
 	}
 	
-	// Create a temporary pointer array for storing new LayerBody list
-	int sz_new = this->_mBodyListSize - 1;
-	LayerBody** list_new = new LayerBody*[sz_new];
-	int list_new_cnt = 0;
-
-	// Update the new pointer array
-	for (int i = 0; i < this->_mBodyListSize; i++)
-	{
-		if (i != idx)
-		{
-			list_new[list_new_cnt] = this->_pBodyList[i];
-			list_new_cnt++;
-		}
-	}
-
-	// Delete the current body list and update it with the new one
-	delete[] this->_pBodyList;
-	this->_pBodyList = nullptr;
-	this->_pBodyList = new LayerBody*[sz_new];
-	std::copy(list_new, list_new + sz_new, this->_pBodyList);
-	this->_mBodyListSize = sz_new;
-
-	// Deallocate the temoorary body list pointer array
-	delete[] list_new;
-	list_new = nullptr;
+	// Shift the remaining bodies in place
+	std::copy(this->_pBodyList + idx + 1, this->_pBodyList + this->_mBodyListSize, this->_pBodyList + idx);
+	this->_mBodyListSize -= 1;
 }
 
 void Layer::print_bodylist(bool extra_information)
@@ -400,30 +409,22 @@ void Layer::print_bodylist(bool extra_information)
 
 void Layer::add_mold(LayerMold *elem)
 {
-	if (this->_pMoldList != nullptr)
-	{
-		// Allocate a new body list
-		LayerMold** new_list = new LayerMold*[this->_mMoldListSize + 1];
-		std::copy(this->_pMoldList, this->_pMoldList + this->_mMoldListSize, new_list);
-		new_list[this->_mMoldListSize] = elem;
-		this->_mMoldListSize += 1;
-
-		// Delete existing body list
-		delete[] this->_pMoldList;
-		this->_pMoldList = nullptr;
-
-		// Copy new list over the body list fields
-		this->_pMoldList = new LayerMold*[this->_mMoldListSize];
-		std::copy(new_list, new_list + this->_mMoldListSize, this->_pMoldList);
-		delete[] new_list;
-		new_list = nullptr;
-	}
-	else
+	// Double the capacity when the list is full
+	if (this->_mMoldListSize == this->_mMoldListCapacity)
 	{
-		this->_mMoldListSize += 1;
-		this->_pMoldList = new LayerMold*[this->_mMoldListSize];
-		this->_pMoldList[0] = elem;
+		int new_capacity = (this->_mMoldListCapacity > 0) ? 2 * this->_mMoldListCapacity : CONTAINER_DEFAULT_ALLOC_SZ;
+		LayerMold** new_list = new LayerMold*[new_capacity];
+		if (this->_pMoldList != nullptr)
+		{
+			std::copy(this->_pMoldList, this->_pMoldList + this->_mMoldListSize, new_list);
+			delete[] this->_pMoldList;
+		}
+		this->_pMoldList = new_list;
+		this->_mMoldListCapacity = new_capacity;
 	}
+
+	this->_pMoldList[this->_mMoldListSize] = elem;
+	this->_mMoldListSize += 1;
 }
 
 LayerMold** Layer::list_mold()
@@ -438,11 +439,7 @@ int Layer::size_mold()
 
 void Layer::clear_mold()
 {
-	if (this->_pMoldList != nullptr)
-	{
-		delete[] this->_pMoldList;
-		this->_pMoldList = nullptr;
-	}
+	// Keep the allocated memory
 	this->_mMoldListSize = 0;
 }
 
@@ -489,3 +486,13 @@ void Layer::delam_profile_ref(LayerMold *orig_mold)
 {
 	this->_mDelamRefMold = orig_mold;
 }
+
+Fingerprint Layer::fingerprint()
+{
+	return this->_mFingerprint;
+}
+
+void Layer::fingerprint(const Fingerprint& fp)
+{
+	this->_mFingerprint = fp;
+}
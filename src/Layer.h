@@ -158,6 +158,18 @@ public:
 	 */
 	void add_body(LayerBody  *elem);
 
+	/**
+	 * \brief Adds multiple layer bodies to the layer with a single reallocation.
+	 * \param elems LayerBody elements to be contained in this layer
+	 */
+	void add_bodies(delamo::Span<LayerBody*> elems);
+
+	/**
+	 * \brief Reserves memory for the layer body list.
+	 * \param new_capacity number of LayerBody elements that can be stored without reallocation
+	 */
+	void reserve(int new_capacity);
+
 	/**
 	 * \brief Returns the list of layer bodies associated with this layer.
 	 * \return list of layer bodies
@@ -265,6 +277,22 @@ public:
 	 */
 	void delam_profile_ref(LayerMold *orig_mold);
 
+	/**
+	 * \brief Gets the fingerprint of the layer.
+	 *
+	 * The fingerprint covers the mold, thickness and direction of the layer and all operations applied to it.
+	 * \return fingerprint, null if the layer is not generated by the ModelBuilder
+	 */
+	Fingerprint fingerprint();
+
+	/**
+	 * \brief Sets the fingerprint of the layer.
+	 *
+	 * Restricted to internal use only and should only be called by the operations modifying the layer.
+	 * \param[in] fp fingerprint
+	 */
+	void fingerprint(const Fingerprint& fp);
+
 private:
 	double _mPosOrig; /**< z-value at original direction */
 	double _mPosOffset; /**< z-value at offset direction */
@@ -273,13 +301,16 @@ private:
 	int _mLayup; /**< Layer lay-up */
 	LayerBody** _pBodyList; /**< List of LayerBody objects */
 	int _mBodyListSize; /**< Size of the LayerBody objects list */
+	int _mBodyListCapacity; /**< Allocated capacity of the LayerBody objects list */
 	LayerMold** _pMoldList; /**< List of LayerMold objects */
 	int _mMoldListSize; /**< Size of the LayerMold objects list */
+	int _mMoldListCapacity; /**< Allocated capacity of the LayerMold objects list */
 	LayerType _eType; /**< Type of the generated Layer */
 	Direction _eDirection; /**< Direction of generation */
 	Layer* _pPairOffset; /**< Points the Layer object on this Layer's offset side */
 	Layer* _pPairOrig; /**< Points the Layer object on this Layer's original side */
 	LayerMold *_mDelamRefMold; /**< Stores a pointer to of the initially generated LayerMold object for the offset direction */
+	Fingerprint _mFingerprint; /**< Fingerprint of the mold and the operations which generated the layer */
 
 	void init_vars();
 	void delete_vars();
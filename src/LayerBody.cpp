@@ -35,9 +35,12 @@ void LayerBody::init_vars()
 {
 	this->_pName = nullptr;
 	this->_pOwner = nullptr;
+	this->_mId = -1;
 	this->_pSurfList = nullptr;
 	this->_mSurfListSize = 0;
+	this->_mSurfListCapacity = 0;
 	this->next_ls_id = 0;
+	this->_bBBoxValid = false;
 	// Objects which belong to 3rd party solid modeling libraries are always set to NULL
 	this->_pBody = NULL;
 }
@@ -57,7 +60,9 @@ void LayerBody::delete_vars()
 		delete[] this->_pSurfList;
 		this->_pSurfList = nullptr;
 		this->_mSurfListSize = 0;
+		this->_mSurfListCapacity = 0;
 	}
+	this->_mFaceIndex.clear();
 
 	// Objects which belong to 3rd party solid modeling libraries are always set to NULL
 	this->_pBody = NULL;
@@ -93,11 +98,18 @@ void LayerBody::copy_vars(const LayerBody& rhs, LayerBody& lhs)
 		lhs._pSurfList = nullptr;
 	}
 	lhs._mSurfListSize = rhs._mSurfListSize;
+	lhs._mSurfListCapacity = rhs._mSurfListSize;
 	lhs._pSurfList = new LayerSurface*[lhs._mSurfListSize];
 	std::copy(rhs._pSurfList, rhs._pSurfList + rhs._mSurfListSize, lhs._pSurfList);
 
+	lhs._mFaceIndex = rhs._mFaceIndex;
+
 	lhs._pOwner = rhs._pOwner;
+	lhs._mId = rhs._mId;
 	lhs.next_ls_id = rhs.next_ls_id;
+	lhs._mBBoxMin = rhs._mBBoxMin;
+	lhs._mBBoxMax = rhs._mBBoxMax;
+	lhs._bBBoxValid = rhs._bBBoxValid;
 }
 
 char* LayerBody::name()
@@ -130,36 +142,62 @@ DLM_BODYP LayerBody::body()
 void LayerBody::body(DLM_BODYP body)
 {
 	this->_pBody = body;
+	// The cached bounding box belongs to the old BODY object
+	this->_bBBoxValid = false;
 }
 
 void LayerBody::add_surface(LayerSurface *elem)
 {
-	if (this->_pSurfList != nullptr)
-	{
-		// Allocate a new body list
-		LayerSurface** new_list = new LayerSurface*[this->_mSurfListSize + 1];
-		std::copy(this->_pSurfList, this->_pSurfList + this->_mSurfListSize, new_list);
-		new_list[this->_mSurfListSize] = elem;
-		this->_mSurfListSize += 1;
+	// Double the capacity when the list is full, so that N insertions cost O(N) copies in total
+	if (this->_mSurfListSize == this->_mSurfListCapacity)
+		this->reserve((this->_mSurfListCapacity > 0) ? 2 * this->_mSurfListCapacity : CONTAINER_DEFAULT_ALLOC_SZ);
 
-		// Delete existing body list
-		delete[] this->_pSurfList;
-		this->_pSurfList = nullptr;
+	this->_pSurfList[this->_mSurfListSize] = elem;
+	if (elem != nullptr && elem->face() != NULL)
+		this->_mFaceIndex.emplace(elem->face(), this->_mSurfListSize);
+	this->_mSurfListSize += 1;
 
-		// Copy new list over the body list fields
-		this->_pSurfList = new LayerSurface*[this->_mSurfListSize];
-		std::copy(new_list, new_list + this->_mSurfListSize, this->_pSurfList);
-		delete[] new_list;
-		new_list = nullptr;
-	}
-	else
+	// Increment LayerSurface counter
+	this->next_ls_id++;
+}
+
+void LayerBody::add_surfaces(delamo::Span<LayerSurface*> elems)
+{
+	int num_elems = (int)elems.size();
+	if (num_elems == 0)
+		return;
+
+	// Grow once for the whole range
+	int required = this->_mSurfListSize + num_elems;
+	if (required > this->_mSurfListCapacity)
+		this->reserve(std::max(required, 2 * this->_mSurfListCapacity));
+
+	std::copy(elems.begin(), elems.end(), this->_pSurfList + this->_mSurfListSize);
+	for (int i = this->_mSurfListSize; i < required; i++)
 	{
-		this->_mSurfListSize += 1;
-		this->_pSurfList = new LayerSurface*[this->_mSurfListSize];
-		this->_pSurfList[0] = elem;
+		if (this->_pSurfList[i] != nullptr && this->_pSurfList[i]->face() != NULL)
+			this->_mFaceIndex.emplace(this->_pSurfList[i]->face(), i);
 	}
+	this->_mSurfListSize = required;
+
 	// Increment LayerSurface counter
-	this->next_ls_id++;
+	this->next_ls_id += num_elems;
+}
+
+void LayerBody::reserve(int new_capacity)
+{
+	// Never decrease the allocated memory
+	if (new_capacity <= this->_mSurfListCapacity)
+		return;
+
+	LayerSurface** new_list = new LayerSurface*[new_capacity];
+	if (this->_pSurfList != nullptr)
+	{
+		std::copy(this->_pSurfList, this->_pSurfList + this->_mSurfListSize, new_list);
+		delete[] this->_pSurfList;
+	}
+	this->_pSurfList = new_list;
+	this->_mSurfListCapacity = new_capacity;
 }
 
 LayerSurface** LayerBody::begin()
@@ -186,17 +224,24 @@ int LayerBody::size()
 
 void LayerBody::clear()
 {
-	if (this->_pSurfList != nullptr)
-	{
-		delete[] this->_pSurfList;
-		this->_pSurfList = nullptr;
-	}
+	// Keep the allocated memory, the list is usually refilled right after clearing
 	this->_mSurfListSize = 0;
+	this->_mFaceIndex.clear();
 	// Set the LayerSurface counter to zero
 	this->next_ls_id = 0;
 }
 
 
+int LayerBody::id()
+{
+	return this->_mId;
+}
+
+void LayerBody::id(int value)
+{
+	this->_mId = value;
+}
+
 void LayerBody::owner(Layer* owner)
 {
 	this->_pOwner = owner;
@@ -223,13 +268,23 @@ void LayerBody::error_handler(int errnum)
 
 int LayerBody::face_id(DLM_FACEP face_query)
 {
-	// Query surface list for the given face
+	// Query the face index for the given face
+	auto face_it = this->_mFaceIndex.find(face_query);
+	if (face_it != this->_mFaceIndex.end())
+		return face_it->second;
+	return -1;
+}
+
+void LayerBody::update_face_index()
+{
+	this->_mFaceIndex.clear();
+	this->_mFaceIndex.reserve(this->_mSurfListSize);
 	for (int i = 0; i < this->_mSurfListSize; i++)
 	{
-		if (face_query == this->_pSurfList[i]->face())
-			return i;
+		// The first LayerSurface wins if multiple surfaces share a face, like the linear search does
+		if (this->_pSurfList[i] != nullptr && this->_pSurfList[i]->face() != NULL)
+			this->_mFaceIndex.emplace(this->_pSurfList[i]->face(), i);
 	}
-	return -1;
 }
 
 LayerSurface** LayerBody::list()
@@ -248,3 +303,25 @@ LayerMold* LayerBody::mold()
 		return nullptr;
 	return &this->_mMold;
 }
+
+void LayerBody::bounding_box(const delamo::TPoint3<double>& bbox_min, const delamo::TPoint3<double>& bbox_max)
+{
+	this->_mBBoxMin = bbox_min;
+	this->_mBBoxMax = bbox_max;
+	this->_bBBoxValid = true;
+}
+
+bool LayerBody::bounding_box(delamo::TPoint3<double>& bbox_min, delamo::TPoint3<double>& bbox_max)
+{
+	if (!this->_bBBoxValid)
+		return false;
+
+	bbox_min = this->_mBBoxMin;
+	bbox_max = this->_mBBoxMax;
+	return true;
+}
+
+void LayerBody::bounding_box_clear()
+{
+	this->_bBBoxValid = false;
+}
@@ -75,6 +75,18 @@ public:
 	 */
 	void add_surface(LayerSurface *elem);
 
+	/**
+	 * \brief Adds multiple layer surfaces to the layer body with a single reallocation.
+	 * \param[in] elems LayerSurface elements to be contained in this LayerBody
+	 */
+	void add_surfaces(delamo::Span<LayerSurface*> elems);
+
+	/**
+	 * \brief Reserves memory for the layer surface list.
+	 * \param[in] new_capacity number of LayerSurface elements that can be stored without reallocation
+	 */
+	void reserve(int new_capacity);
+
 	/**
 	 * \brief LayerSurface iterator structure.
 	 * \return the first iterator object
@@ -111,6 +123,18 @@ public:
 	 */
 	void clear();
 
+	/**
+	 * \brief Gets the LayerBody ID.
+	 * \return the LayerBody ID, unique inside the owner Layer
+	 */
+	int id();
+
+	/**
+	 * \brief Sets the LayerBody ID.
+	 * \param value the new LayerBody ID
+	 */
+	void id(int value);
+
 	/**
 	 * \brief Sets the owner of the LayerBody object.
 	 * \param[in] owner new owner as a pointer to a Layer object
@@ -142,6 +166,35 @@ public:
 	 */
 	int face_id(DLM_FACEP face_query);
 
+	/**
+	 * \brief Rebuilds the face to LayerSurface index used by face_id().
+	 *
+	 * Needs to be called if the face of a contained LayerSurface is replaced after it is added to this LayerBody.
+	 */
+	void update_face_index();
+
+	/**
+	 * \brief Caches the bounding box of the BODY object.
+	 * \param[in] bbox_min minimum corner of the bounding box
+	 * \param[in] bbox_max maximum corner of the bounding box
+	 */
+	void bounding_box(const delamo::TPoint3<double>& bbox_min, const delamo::TPoint3<double>& bbox_max);
+
+	/**
+	 * \brief Gets the cached bounding box of the BODY object.
+	 * \param[out] bbox_min minimum corner of the bounding box
+	 * \param[out] bbox_max maximum corner of the bounding box
+	 * \return TRUE if a bounding box is cached, otherwise FALSE
+	 */
+	bool bounding_box(delamo::TPoint3<double>& bbox_min, delamo::TPoint3<double>& bbox_max);
+
+	/**
+	 * \brief Clears the cached bounding box.
+	 *
+	 * Needs to be called if the geometry of the BODY object is changed. Setting a new BODY object clears it automatically.
+	 */
+	void bounding_box_clear();
+
 protected:
 
 	/**
@@ -152,7 +205,13 @@ protected:
 private:
 	LayerSurface** _pSurfList; /**< List of LayerSurface objects contained in this LayerBody */
 	int _mSurfListSize; /**< Size of the LayerSurface objects list */
+	int _mSurfListCapacity; /**< Allocated capacity of the LayerSurface objects list */
+	std::unordered_map<DLM_FACEP, int> _mFaceIndex; /**< Maps the faces to their indices in the LayerSurface objects list */
 	Layer* _pOwner; /**< Owner as a pointer to a Layer object */
+	int _mId; /**< ID of the LayerBody */
+	delamo::TPoint3<double> _mBBoxMin; /**< Minimum corner of the cached bounding box */
+	delamo::TPoint3<double> _mBBoxMax; /**< Maximum corner of the cached bounding box */
+	bool _bBBoxValid; /**< Flag to check whether the cached bounding box is valid */
 	LayerMold _mMold; /**< Mold to generate this LayerBody */
 
 	// DLM_BODYP and name defined in base class
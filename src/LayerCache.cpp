@@ -0,0 +1,148 @@
+#include "LayerCache.h"
+#include <cstdio>
+#include <thread>
+
+
+// Header of the cache files
+static const char CACHE_FILE_MAGIC[8] = { 'D', 'L', 'M', 'C', 'A', 'C', 'H', '2' };
+
+
+void CacheWriter::write_string(const std::string& str)
+{
+	this->write((unsigned long long)str.size());
+	this->_mBuffer.append(str);
+}
+
+const std::string& CacheWriter::buffer()
+{
+	return this->_mBuffer;
+}
+
+
+CacheReader::CacheReader(const std::string& buffer) : _mBuffer(buffer)
+{
+	this->_mPos = 0;
+	this->_bGood = true;
+}
+
+bool CacheReader::read_string(std::string& str)
+{
+	unsigned long long len;
+	if (!this->read(len))
+		return false;
+
+	if (this->_mBuffer.size() - this->_mPos < len)
+	{
+		this->_bGood = false;
+		return false;
+	}
+	str.assign(this->_mBuffer.data() + this->_mPos, (size_t)len);
+	this->_mPos += (size_t)len;
+	return true;
+}
+
+bool CacheReader::good()
+{
+	return this->_bGood;
+}
+
+
+LayerCache::LayerCache()
+{
+	// Cache is disabled by default
+}
+
+void LayerCache::directory(const char* dir_name)
+{
+	this->_mDirectory = (dir_name == nullptr) ? "" : dir_name;
+}
+
+const char* LayerCache::directory()
+{
+	return this->_mDirectory.c_str();
+}
+
+bool LayerCache::enabled()
+{
+	return !this->_mDirectory.empty();
+}
+
+std::string LayerCache::file_name(const Fingerprint& key)
+{
+	std::ostringstream name;
+	name << this->_mDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << key.hash() << ".dlc";
+	return name.str();
+}
+
+bool LayerCache::load(const Fingerprint& key, std::string& blob)
+{
+	if (!this->enabled())
+		return false;
+
+	std::ifstream input(this->file_name(key).c_str(), std::ios::in | std::ios::binary);
+	if (!input.is_open())
+		return false;
+
+	// Check the header, the file name only has 64 bits of the key and a different full key means a collision
+	char magic[sizeof(CACHE_FILE_MAGIC)];
+	unsigned long long key_hi = 0, key_lo = 0;
+	unsigned long long blob_size = 0;
+	input.read(magic, sizeof(magic));
+	input.read(reinterpret_cast<char*>(&key_hi), sizeof(key_hi));
+	input.read(reinterpret_cast<char*>(&key_lo), sizeof(key_lo));
+	input.read(reinterpret_cast<char*>(&blob_size), sizeof(blob_size));
+	if (!input || std::memcmp(magic, CACHE_FILE_MAGIC, sizeof(magic)) != 0)
+		return false;
+	if (Fingerprint(key_hi, key_lo) != key)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_WARN)
+			std::cout << "WARNING: Ignoring the cache entry " << Fingerprint(key_hi, key_lo).hex() << " with the same file name as " << key.hex() << std::endl;
+		return false;
+	}
+
+	blob.resize((size_t)blob_size);
+	if (blob_size > 0)
+		input.read(&blob[0], (std::streamsize)blob_size);
+	return (bool)input;
+}
+
+bool LayerCache::store(const Fingerprint& key, const std::string& blob)
+{
+	if (!this->enabled())
+		return false;
+
+	// Write to a file which is unique to this thread, then move it in place
+	std::string entry_name = this->file_name(key);
+	std::ostringstream temp_name;
+	temp_name << entry_name << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id());
+
+	std::ofstream output(temp_name.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!output.is_open())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_WARN)
+			std::cout << "WARNING: Unable to write to the cache directory " << this->_mDirectory << std::endl;
+		return false;
+	}
+
+	unsigned long long key_hi = key.hi(), key_lo = key.lo();
+	unsigned long long blob_size = blob.size();
+	output.write(CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC));
+	output.write(reinterpret_cast<const char*>(&key_hi), sizeof(key_hi));
+	output.write(reinterpret_cast<const char*>(&key_lo), sizeof(key_lo));
+	output.write(reinterpret_cast<const char*>(&blob_size), sizeof(blob_size));
+	output.write(blob.data(), (std::streamsize)blob.size());
+	output.close();
+	if (!output)
+	{
+		std::remove(temp_name.str().c_str());
+		return false;
+	}
+
+	// Renaming over an existing file fails on Windows, the existing entry has the same contents anyway
+	if (std::rename(temp_name.str().c_str(), entry_name.c_str()) != 0)
+	{
+		std::remove(temp_name.str().c_str());
+		return false;
+	}
+	return true;
+}
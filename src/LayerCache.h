@@ -0,0 +1,157 @@
+#ifndef LAYERCACHE_H
+#define LAYERCACHE_H
+
+#include "APIConfig.h"
+#include "Fingerprint.h"
+// Export file is generated by CMake's GenerateExportHeader module
+#include "modelbuilder_export.h"
+
+
+/**
+ * \brief Appends the cached values to a byte buffer.
+ */
+class MODELBUILDER_EXPORT CacheWriter
+{
+public:
+
+	/**
+	 * \brief Appends a trivially copyable value.
+	 * \param value input value
+	 */
+	template <typename T>
+	void write(const T& value)
+	{
+		this->_mBuffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	/**
+	 * \brief Appends a string with its length.
+	 * \param str input string
+	 */
+	void write_string(const std::string& str);
+
+	/**
+	 * \brief Gets the buffer.
+	 * \return contents of the buffer
+	 */
+	const std::string& buffer();
+
+private:
+	std::string _mBuffer; /**< Written bytes */
+};
+
+
+/**
+ * \brief Reads the values written by a CacheWriter.
+ *
+ * Reading past the end of the buffer fails and all following reads fail too, so the caller can check the stream once
+ * after reading a whole record.
+ */
+class MODELBUILDER_EXPORT CacheReader
+{
+public:
+
+	/**
+	 * \brief Creates the reader.
+	 * \param buffer bytes to be read, should outlive the reader
+	 */
+	explicit CacheReader(const std::string& buffer);
+
+	/**
+	 * \brief Reads a trivially copyable value.
+	 * \param value output value
+	 * \return false if there is not enough data
+	 */
+	template <typename T>
+	bool read(T& value)
+	{
+		if (!this->_bGood || this->_mBuffer.size() - this->_mPos < sizeof(T))
+		{
+			this->_bGood = false;
+			return false;
+		}
+		std::memcpy(&value, this->_mBuffer.data() + this->_mPos, sizeof(T));
+		this->_mPos += sizeof(T);
+		return true;
+	}
+
+	/**
+	 * \brief Reads a string written by CacheWriter::write_string().
+	 * \param str output string
+	 * \return false if there is not enough data
+	 */
+	bool read_string(std::string& str);
+
+	/**
+	 * \brief Checks whether all reads are successful.
+	 * \return true if no read failed
+	 */
+	bool good();
+
+private:
+	const std::string& _mBuffer; /**< Bytes to be read */
+	size_t _mPos; /**< Current read position */
+	bool _bGood; /**< FALSE after the first failed read */
+};
+
+
+/**
+ * \brief Content-addressed on-disk storage of the layers generated by the ModelBuilder.
+ *
+ * Each operation result is stored in a separate file named after its key, which is derived from the fingerprints of
+ * the layers modified by the operation. The file name only has 64 bits of the key, so the full key is stored in the
+ * file and compared on load. The files are written to a temporary name and renamed, so concurrent writers and
+ * interrupted runs never leave a partial entry behind.
+ */
+class MODELBUILDER_EXPORT LayerCache
+{
+public:
+
+	/**
+	 * \brief Default constructor.
+	 */
+	LayerCache();
+
+	/**
+	 * \brief Sets the cache directory.
+	 *
+	 * The directory should exist. An empty name disables the cache.
+	 * \param dir_name name of the directory
+	 */
+	void directory(const char* dir_name);
+
+	/**
+	 * \brief Gets the cache directory.
+	 * \return name of the directory, empty if the cache is disabled
+	 */
+	const char* directory();
+
+	/**
+	 * \brief Checks whether a cache directory is set.
+	 * \return true if the cache is enabled
+	 */
+	bool enabled();
+
+	/**
+	 * \brief Reads a cache entry.
+	 * \param[in] key key of the entry
+	 * \param[out] blob contents of the entry
+	 * \return false if there is no valid entry with the key
+	 */
+	bool load(const Fingerprint& key, std::string& blob);
+
+	/**
+	 * \brief Writes a cache entry, an existing entry with the same key is replaced.
+	 * \param key key of the entry
+	 * \param blob contents of the entry
+	 * \return false if the entry cannot be written
+	 */
+	bool store(const Fingerprint& key, const std::string& blob);
+
+private:
+	std::string _mDirectory; /**< Cache directory, empty if the cache is disabled */
+
+	std::string file_name(const Fingerprint& key);
+};
+
+#endif // !LAYERCACHE_H
@@ -0,0 +1,64 @@
+#include "LayerJournal.h"
+
+
+LayerJournal::LayerJournal()
+{
+	this->_bActive = false;
+	this->_pInitialLayer = nullptr;
+	this->_mNumOperations = 0;
+}
+
+void LayerJournal::begin(Layer* initial_layer, int num_operations)
+{
+	std::lock_guard<std::mutex> lock(this->_mMutex);
+	this->_mEntries.clear();
+	this->_mLayers.clear();
+	this->_pInitialLayer = initial_layer;
+	this->_mNumOperations = num_operations;
+	this->_bActive = true;
+}
+
+bool LayerJournal::active()
+{
+	std::lock_guard<std::mutex> lock(this->_mMutex);
+	return this->_bActive;
+}
+
+bool LayerJournal::contains(Layer* layer)
+{
+	std::lock_guard<std::mutex> lock(this->_mMutex);
+	return this->_mLayers.count(layer) > 0;
+}
+
+void LayerJournal::add(JournalLayer& state)
+{
+	std::lock_guard<std::mutex> lock(this->_mMutex);
+	if (!this->_mLayers.insert(state.layer).second)
+		return;
+	this->_mEntries.push_back(std::move(state));
+}
+
+std::vector<JournalLayer>& LayerJournal::entries()
+{
+	return this->_mEntries;
+}
+
+Layer* LayerJournal::initial_layer()
+{
+	return this->_pInitialLayer;
+}
+
+int LayerJournal::num_operations()
+{
+	return this->_mNumOperations;
+}
+
+void LayerJournal::clear()
+{
+	std::lock_guard<std::mutex> lock(this->_mMutex);
+	this->_mEntries.clear();
+	this->_mLayers.clear();
+	this->_pInitialLayer = nullptr;
+	this->_mNumOperations = 0;
+	this->_bActive = false;
+}
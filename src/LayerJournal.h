@@ -0,0 +1,144 @@
+#ifndef LAYERJOURNAL_H
+#define LAYERJOURNAL_H
+
+#include "APIConfig.h"
+#include "Layer.h"
+#include <mutex>
+// Export file is generated by CMake's GenerateExportHeader module
+#include "modelbuilder_export.h"
+
+
+/**
+ * \brief State of a LayerSurface stored by the LayerJournal.
+ */
+struct JournalSurface
+{
+	LayerSurface* surface; /**< Journaled surface, the same object is restored */
+	int face_idx; /**< Index of the face in the serialized body */
+	int id; /**< ID of the surface */
+	delamo::TPoint3<double> point; /**< Reference point */
+	delamo::TPoint3<double> normal; /**< Reference normal */
+	double angle; /**< Angle between the reference normal and the surface normal */
+	Direction direction; /**< Surface direction */
+	DelaminationType delam_type; /**< Delamination type */
+	bool initial; /**< Initial surface flag */
+	bool modified; /**< Modified since the last surface pairing flag */
+	bool stiffener_gen; /**< Generated from stiffener flag */
+	bool stiffener_paired; /**< Stiffener paired flag */
+	unsigned long long topology_tag; /**< Topology tag of the face */
+	LayerSurface* pair; /**< Surface pair */
+	LayerSurface* created_from; /**< Origin surface */
+};
+
+
+/**
+ * \brief State of a LayerBody stored by the LayerJournal.
+ */
+struct JournalBody
+{
+	LayerBody* body; /**< Journaled body, the same object is restored */
+	std::string name; /**< Name of the body */
+	int id; /**< ID of the body */
+	std::string kernel_blob; /**< Solid body serialized by the solid modeling kernel */
+	bool has_mold; /**< TRUE if the body has a mold */
+	LayerMold mold; /**< Mold of the body */
+	std::vector<JournalSurface> surfaces; /**< Surfaces of the body in the list order */
+};
+
+
+/**
+ * \brief State of a Layer stored by the LayerJournal.
+ */
+struct JournalLayer
+{
+	Layer* layer; /**< Journaled layer */
+	LayerType type; /**< Layer type */
+	Direction direction; /**< Layer generation direction */
+	double pos_orig; /**< Position on the original side */
+	double pos_offset; /**< Position on the offset side */
+	int id; /**< ID of the layer */
+	int next_lb_id; /**< LayerBody counter of the layer */
+	Fingerprint fingerprint; /**< Fingerprint of the layer */
+	Layer* bond_orig; /**< Layer bonded on the original side */
+	Layer* bond_offset; /**< Layer bonded on the offset side */
+	std::vector<LayerMold*> molds; /**< Molds of the layer */
+	LayerMold* delam_profile_ref; /**< Reference mold for the delamination profiles */
+	std::vector<JournalBody> bodies; /**< Bodies of the layer in the list order */
+};
+
+
+/**
+ * \brief Undo journal of a ModelBuilder transaction.
+ *
+ * A layer is journaled right before the first operation of the transaction modifies it, so the journal only grows
+ * with the layers touched by the transaction. ModelBuilder::rollback() restores the journaled layers with their
+ * original LayerBody and LayerSurface objects, the references to them from the other layers stay valid.
+ */
+class MODELBUILDER_EXPORT LayerJournal
+{
+public:
+
+	/**
+	 * \brief Default constructor.
+	 */
+	LayerJournal();
+
+	/**
+	 * \brief Starts journaling.
+	 * \param initial_layer initial layer of the ModelBuilder at the beginning of the transaction
+	 * \param num_operations number of operations in the operation graph at the beginning of the transaction
+	 */
+	void begin(Layer* initial_layer, int num_operations);
+
+	/**
+	 * \brief Checks whether a transaction is active.
+	 * \return true if the layers are being journaled
+	 */
+	bool active();
+
+	/**
+	 * \brief Checks whether a layer is journaled.
+	 * \param layer input layer
+	 * \return true if the state of the layer is stored
+	 */
+	bool contains(Layer* layer);
+
+	/**
+	 * \brief Stores the state of a layer, the first stored state of a layer is kept.
+	 * \param state layer state
+	 */
+	void add(JournalLayer& state);
+
+	/**
+	 * \brief Gets the stored states in the journaling order.
+	 * \return stored layer states
+	 */
+	std::vector<JournalLayer>& entries();
+
+	/**
+	 * \brief Gets the initial layer at the beginning of the transaction.
+	 * \return initial layer
+	 */
+	Layer* initial_layer();
+
+	/**
+	 * \brief Gets the number of operations in the operation graph at the beginning of the transaction.
+	 * \return number of recorded operations
+	 */
+	int num_operations();
+
+	/**
+	 * \brief Discards the stored states and stops journaling.
+	 */
+	void clear();
+
+private:
+	bool _bActive; /**< Flag to journal the layers */
+	std::vector<JournalLayer> _mEntries; /**< Stored layer states in the journaling order */
+	std::unordered_set<Layer*> _mLayers; /**< Journaled layers */
+	Layer* _pInitialLayer; /**< Initial layer at the beginning of the transaction */
+	int _mNumOperations; /**< Number of recorded operations at the beginning of the transaction */
+	std::mutex _mMutex; /**< Guards the journal during the concurrent deferred operations */
+};
+
+#endif // !LAYERJOURNAL_H
@@ -42,6 +42,12 @@ void LayerMold::init_vars()
 
 void LayerMold::delete_vars()
 {
+	if (this->_pName != nullptr)
+	{
+		delete[] this->_pName;
+		this->_pName = nullptr;
+	}
+
 	this->_pOwner = nullptr;
 	// Objects which belong to 3rd party solid modeling libraries are always set to NULL
 	this->_pBody = NULL;
@@ -49,11 +55,24 @@ void LayerMold::delete_vars()
 
 void LayerMold::copy_vars(const LayerMold& rhs, LayerMold& lhs)
 {
+	if (lhs._pName != nullptr)
+	{
+		delete[] lhs._pName;
+		lhs._pName = nullptr;
+	}
+	if (rhs._pName != nullptr)
+	{
+		std::string rhsname(rhs._pName);
+		lhs._pName = new char[rhsname.size() + 1];
+		std::copy(rhsname.c_str(), rhsname.c_str() + rhsname.size(), lhs._pName);
+		lhs._pName[rhsname.size()] = '\0';
+	}
+
 	lhs._pOwner = rhs._pOwner;
 	lhs._eDirection = rhs._eDirection;
 	lhs._pBody = rhs._pBody;
-	lhs._pName = rhs._pName;
 	lhs._bStiffenerGenerated = rhs._bStiffenerGenerated;
+	lhs._mFingerprint = rhs._mFingerprint;
 }
 
 const Layer* LayerMold::owner()
@@ -118,3 +137,13 @@ bool LayerMold::is_stiffener_gen()
 {
 	return this->_bStiffenerGenerated;
 }
+
+Fingerprint LayerMold::fingerprint()
+{
+	return this->_mFingerprint;
+}
+
+void LayerMold::fingerprint(const Fingerprint& fp)
+{
+	this->_mFingerprint = fp;
+}
@@ -3,6 +3,7 @@
 
 #include "APIConfig.h"
 #include "MBBody.h"
+#include "Fingerprint.h"
 // Export file is generated by CMake's GenerateExportHeader module
 #include "modelbuilder_export.h"
 
@@ -107,10 +108,25 @@ public:
 	 */
 	bool is_stiffener_gen();
 
+	/**
+	 * \brief Gets the fingerprint of the mold geometry.
+	 * \return fingerprint, null if the mold is not generated by the ModelBuilder
+	 */
+	Fingerprint fingerprint();
+
+	/**
+	 * \brief Sets the fingerprint of the mold geometry.
+	 *
+	 * Restricted to internal use only and should only be called by the operations generating the mold.
+	 * \param fp fingerprint
+	 */
+	void fingerprint(const Fingerprint& fp);
+
 private:
 	Layer* _pOwner; /**< Pointer to the owner of this mold object */
 	Direction _eDirection; /**< Direction of this mold, i.e. ORIG or OFFSET */
 	bool _bStiffenerGenerated; /**< Stores "generated from stiffener" information */
+	Fingerprint _mFingerprint; /**< Fingerprint of the mold geometry */
 
 	// DLM_BODYP defined in base class
 	//DLM_BODYP _pBody; /**< Representation of the mold as a sheet body */
@@ -1,4 +1,14 @@
 #include "LayerSurface.h"
+#include "Layer.h"
+#include <atomic>
+
+
+// Generations are drawn from a single counter, so that a handle never matches a different surface
+static unsigned int next_generation()
+{
+	static std::atomic<unsigned int> generation_counter(0);
+	return ++generation_counter;
+}
 
 LayerSurface::LayerSurface()
 {
@@ -36,6 +46,9 @@ void LayerSurface::init_vars()
 	this->_mAngle = 0;
 	this->_eDelaminationType = DelaminationType::COHESIVE;
 	this->_bInitialSurface = false;
+	this->_bModified = true;
+	this->_pEvaluator = nullptr;
+	this->_mTopologyTag = 0;
 	this->_pOwner = nullptr;
 	this->_pSurfPair = nullptr;
 	// Objects which belong to 3rd party solid modeling libraries are always set to NULL
@@ -44,12 +57,15 @@ void LayerSurface::init_vars()
 	this->_bStiffenerPaired = false;
 	this->_pCreatedFrom = nullptr;
 	this->_eSurfDir = Direction::NODIR;
+	this->_mGeneration = next_generation();
+	this->_mHandleSlot = -1;
 }
 
 void LayerSurface::delete_vars()
 {
 	this->_pOwner = nullptr;
 	this->_pSurfPair = nullptr;
+	this->_pEvaluator = nullptr;
 	// Objects which belong to 3rd party solid modeling libraries are always set to NULL
 	this->_mFace = NULL;
 	this->_pCreatedFrom = nullptr;
@@ -63,6 +79,9 @@ void LayerSurface::copy_vars(const LayerSurface& rhs, LayerSurface& lhs)
 	lhs._mNormal = rhs._mNormal;
 	lhs._mAngle = rhs._mAngle;
 	lhs._bInitialSurface = rhs._bInitialSurface;
+	lhs._bModified = rhs._bModified;
+	lhs._pEvaluator = rhs._pEvaluator;
+	lhs._mTopologyTag = rhs._mTopologyTag;
 	lhs._eSurfDir = rhs._eSurfDir;
 	lhs._pOwner = rhs._pOwner;
 	lhs._eDelaminationType = rhs._eDelaminationType;
@@ -70,6 +89,8 @@ void LayerSurface::copy_vars(const LayerSurface& rhs, LayerSurface& lhs)
 	lhs._bStiffenerGenerated = rhs._bStiffenerGenerated;
 	lhs._bStiffenerPaired = rhs._bStiffenerPaired;
 	lhs._pCreatedFrom = rhs._pCreatedFrom;
+	// The handle slot is not copied, lhs is a different surface
+	lhs._mGeneration = next_generation();
 }
 
 DelaminationType LayerSurface::delam_type()
@@ -84,14 +105,30 @@ void LayerSurface::delam_type(DelaminationType status)
 
 delamo::TPoint3<double> LayerSurface::point_coords()
 {
-	delamo::TPoint3<double> ret(this->_mPoint.x(), this->_mPoint.y(), this->_mPoint.z());
-	return ret;
+	this->refresh();
+	return this->_mPoint;
+}
+
+void LayerSurface::point_coords(const delamo::TPoint3<double>& point)
+{
+	this->_mPoint = point;
+	this->_bModified = true;
+	// The explicitly set value replaces the deferred evaluation
+	this->_pEvaluator = nullptr;
 }
 
 delamo::TPoint3<double> LayerSurface::normal_coords()
 {
-	delamo::TPoint3<double> ret(this->_mNormal.x(), this->_mNormal.y(), this->_mNormal.z());
-	return ret;
+	this->refresh();
+	return this->_mNormal;
+}
+
+void LayerSurface::normal_coords(const delamo::TPoint3<double>& normal)
+{
+	this->_mNormal = normal;
+	this->_bModified = true;
+	// The explicitly set value replaces the deferred evaluation
+	this->_pEvaluator = nullptr;
 }
 
 DLM_FACEP LayerSurface::face()
@@ -101,28 +138,35 @@ DLM_FACEP LayerSurface::face()
 
 void LayerSurface::face(DLM_FACEP face)
 {
+	if (face != this->_mFace)
+		this->_mGeneration = next_generation();
 	this->_mFace = face;
+	this->_bModified = true;
 }
 
+#ifdef ACISOBJ
 DLM_POSITION LayerSurface::point()
 {
-	return this->_mPoint;
+	this->refresh();
+	return DLM_POSITION(this->_mPoint.x(), this->_mPoint.y(), this->_mPoint.z());
 }
 
 void LayerSurface::point(DLM_POSITION point)
 {
-	this->_mPoint = point;
+	this->point_coords(delamo::TPoint3<double>(point.x(), point.y(), point.z()));
 }
 
 DLM_UNITVECTOR LayerSurface::normal()
 {
-	return this->_mNormal;
+	this->refresh();
+	return DLM_UNITVECTOR(this->_mNormal.x(), this->_mNormal.y(), this->_mNormal.z());
 }
 
 void LayerSurface::normal(DLM_UNITVECTOR normal)
 {
-	this->_mNormal = normal;
+	this->normal_coords(delamo::TPoint3<double>(normal.x(), normal.y(), normal.z()));
 }
+#endif
 
 void LayerSurface::angle(double value)
 {
@@ -131,9 +175,55 @@ void LayerSurface::angle(double value)
 
 double LayerSurface::angle()
 {
+	this->refresh();
 	return this->_mAngle;
 }
 
+void LayerSurface::modified(bool flag)
+{
+	this->_bModified = flag;
+}
+
+bool LayerSurface::is_modified()
+{
+	return this->_bModified;
+}
+
+void LayerSurface::invalidate(LayerSurfaceEvaluator* evaluator)
+{
+	this->_pEvaluator = evaluator;
+	// The point will change, so the surface needs to be paired again
+	this->_bModified = true;
+}
+
+bool LayerSurface::is_stale()
+{
+	return (this->_pEvaluator != nullptr);
+}
+
+void LayerSurface::refresh()
+{
+	if (this->_pEvaluator == nullptr)
+		return;
+
+	// Reset the evaluator first, the evaluator sets the point and normal using this object
+	LayerSurfaceEvaluator* evaluator = this->_pEvaluator;
+	this->_pEvaluator = nullptr;
+	evaluator->evaluate(this);
+}
+
+void LayerSurface::topology_tag(unsigned long long tag)
+{
+	if (tag != this->_mTopologyTag)
+		this->_mGeneration = next_generation();
+	this->_mTopologyTag = tag;
+}
+
+unsigned long long LayerSurface::topology_tag()
+{
+	return this->_mTopologyTag;
+}
+
 void LayerSurface::initial_surface(bool flag)
 {
 	this->_bInitialSurface = flag;
@@ -224,3 +314,50 @@ LayerSurface* LayerSurface::created_from()
 {
 	return this->_pCreatedFrom;
 }
+
+unsigned int LayerSurface::generation()
+{
+	return this->_mGeneration;
+}
+
+void LayerSurface::handle_slot(int slot)
+{
+	this->_mHandleSlot = slot;
+}
+
+int LayerSurface::handle_slot()
+{
+	return this->_mHandleSlot;
+}
+
+SurfaceHandle LayerSurface::handle()
+{
+	SurfaceHandle ls_handle;
+	if (this->_mHandleSlot < 0)
+		return ls_handle;
+
+	ls_handle.surface_id = this->_mId;
+	ls_handle.slot = this->_mHandleSlot;
+	ls_handle.generation = this->_mGeneration;
+	if (this->_pOwner != nullptr)
+	{
+		ls_handle.body_id = this->_pOwner->id();
+		if (this->_pOwner->owner() != nullptr)
+			ls_handle.layer_id = this->_pOwner->owner()->id();
+	}
+	return ls_handle;
+}
+
+SurfaceHandle LayerSurface::pair_handle()
+{
+	if (this->_pSurfPair == nullptr)
+		return SurfaceHandle();
+	return this->_pSurfPair->handle();
+}
+
+SurfaceHandle LayerSurface::created_from_handle()
+{
+	if (this->_pCreatedFrom == nullptr)
+		return SurfaceHandle();
+	return this->_pCreatedFrom->handle();
+}
@@ -9,6 +9,24 @@
 
 // Forward declarations
 class LayerBody;
+class LayerSurface;
+
+/**
+ * \brief Interface for computing the reference point and normal of a LayerSurface on demand.
+ *
+ * Implemented by the solid modeling kernel, so that the point finding algorithms run only when the point or the normal is read.
+ */
+class MODELBUILDER_EXPORT LayerSurfaceEvaluator
+{
+public:
+	virtual ~LayerSurfaceEvaluator() {};
+
+	/**
+	 * \brief Computes and sets the reference point and normal (and optionally the angle) of the input surface.
+	 * \param ls LayerSurface to be evaluated
+	 */
+	virtual void evaluate(LayerSurface* ls) = 0;
+};
 
 // Defines the structure of the surfaces
 class MODELBUILDER_EXPORT LayerSurface
@@ -58,12 +76,24 @@ public:
 	 * \return reference point
 	 */
 	delamo::TPoint3<double> point_coords();
+
+	/**
+	 * \brief Sets reference point.
+	 * \param[in] point reference point
+	 */
+	void point_coords(const delamo::TPoint3<double>& point);
 	
 	/**
 	 * \brief Gets reference normal.
 	 * \return reference normal
 	 */
 	delamo::TPoint3<double> normal_coords();
+
+	/**
+	 * \brief Sets reference normal.
+	 * \param[in] normal reference normal
+	 */
+	void normal_coords(const delamo::TPoint3<double>& normal);
 	
 	/**
 	 * \brief Gets the face as defined by the solid modeling kernel.
@@ -77,6 +107,7 @@ public:
 	 */
 	void face(DLM_FACEP face);
 
+#ifdef ACISOBJ
 	/**
 	 * \brief Gets the reference point as defined the solid modeling kernel.
 	 * \return point object
@@ -100,6 +131,7 @@ public:
 	 * \param[in] normal vector object
 	 */
 	void normal(DLM_UNITVECTOR normal);
+#endif
 
 	/**
 	 * \brief Gets the angle between the LayerSurface and a vector on the OFFSET direction.
@@ -149,6 +181,48 @@ public:
 	 */
 	bool is_initial_surface();
 
+	/**
+	 * \brief Sets the modified flag.
+	 *
+	 * The flag is set automatically when the face, point or normal is changed and it is cleared after pairing.
+	 * \param[in] flag defines whether the surface needs to be paired again
+	 */
+	void modified(bool flag = true);
+
+	/**
+	 * \brief Checks whether this surface is created or modified since the last surface pairing.
+	 * \return if the surface needs to be paired again true, otherwise false
+	 */
+	bool is_modified();
+
+	/**
+	 * \brief Marks the reference point and normal as outdated.
+	 *
+	 * The evaluator is called when the point, normal or angle is read next time. Setting the point or the normal
+	 * explicitly cancels the deferred evaluation.
+	 * \param[in] evaluator evaluator which computes the new point and normal
+	 */
+	void invalidate(LayerSurfaceEvaluator* evaluator);
+
+	/**
+	 * \brief Checks whether the reference point and normal are waiting to be computed.
+	 * \return if the point and normal are outdated true, otherwise false
+	 */
+	bool is_stale();
+
+	/**
+	 * \brief Sets the topology tag of the face.
+	 *
+	 * The tag is computed by the solid modeling kernel and used to detect the faces changed by imprinting.
+	 * \param[in] tag topology tag
+	 */
+	void topology_tag(unsigned long long tag);
+
+	/**
+	 * \brief Gets the topology tag of the face.
+	 * \return topology tag, zero if it is not computed
+	 */
+	unsigned long long topology_tag();
 
 	/**
 	 * \brief Sets the owner of the LayerSurface object.
@@ -223,24 +297,70 @@ public:
 	 */
 	LayerSurface* created_from();
 
+	/**
+	 * \brief Gets the generation of the LayerSurface.
+	 *
+	 * A new generation is assigned when the face is replaced or its topology tag changes (e.g. after splitting or
+	 * imprinting), so that the handles taken before the change can be detected as outdated.
+	 * \return generation
+	 */
+	unsigned int generation();
+
+	/**
+	 * \brief Sets the slot of the LayerSurface in the handle table.
+	 * \param[in] slot slot index, -1 if the surface is not registered
+	 */
+	void handle_slot(int slot);
+
+	/**
+	 * \brief Gets the slot of the LayerSurface in the handle table.
+	 * \return slot index, -1 if the surface is not registered
+	 */
+	int handle_slot();
+
+	/**
+	 * \brief Gets a handle referring to the current generation of this LayerSurface.
+	 * \return surface handle, null if the surface is not registered in a handle table
+	 */
+	SurfaceHandle handle();
+
+	/**
+	 * \brief Gets a handle referring to the surface pair.
+	 * \return surface handle, null if there is no pair
+	 */
+	SurfaceHandle pair_handle();
+
+	/**
+	 * \brief Gets a handle referring to the origin surface.
+	 * \return surface handle, null if there is no origin surface
+	 */
+	SurfaceHandle created_from_handle();
+
 private:
-	int _mId; /**< ID of the LayerSurface */
-	DLM_FACEP _mFace; /**< Stores the CAD object representation of the LayerSurface */
-	DLM_POSITION _mPoint; /**< Stores the CAD representation of a point resides on this LayerSurface */
-	DLM_UNITVECTOR _mNormal; /**< Stores the CAD representation of a unit vector normal to this LayerSurface at the point, _mPoint */
-	double _mAngle; /**< Angle between the reference normal and the surface normal */
-	bool _bInitialSurface; /**< Flag to check whether this is the first surface or not */
-	Direction _eSurfDir; /**< LayerSurface direction */
-	LayerBody* _pOwner; /**< Owner of the LayerSurface */
-	DelaminationType _eDelaminationType; /**< Stores what kind of delamination that this LayerSurface has */
+	// Members used by the surface pairing loops come first, so that they share the same cache lines
+	delamo::TPoint3<double> _mPoint; /**< Stores a reference point which resides on this LayerSurface */
+	delamo::TPoint3<double> _mNormal; /**< Stores a unit vector normal to this LayerSurface at the point, _mPoint */
+	DLM_FACEP _mFace; /**< Stores the CAD object representation of the LayerSurface as an opaque kernel handle */
+	LayerSurfaceEvaluator* _pEvaluator; /**< Evaluator of the outdated point and normal, nullptr if they are up to date */
 	LayerSurface* _pSurfPair; /**< Pair of the LayerSurface set after adjacent_layers() */
+	LayerBody* _pOwner; /**< Owner of the LayerSurface */
+	Direction _eSurfDir; /**< LayerSurface direction */
+	bool _bInitialSurface; /**< Flag to check whether this is the first surface or not */
+	bool _bModified; /**< Flag to check whether this surface is created or modified since the last surface pairing */
 	bool _bStiffenerGenerated; /**< Stores "generated from stiffener" information */
 	bool _bStiffenerPaired; /**< Stores "stiffener paired" information */
+	int _mId; /**< ID of the LayerSurface */
+	DelaminationType _eDelaminationType; /**< Stores what kind of delamination that this LayerSurface has */
+	double _mAngle; /**< Angle between the reference normal and the surface normal */
+	unsigned long long _mTopologyTag; /**< Topology tag of the face */
 	LayerSurface* _pCreatedFrom; /**< Stores origin surface for tracking */
+	unsigned int _mGeneration; /**< Generation of the surface, unique among all LayerSurface objects */
+	int _mHandleSlot; /**< Slot of the surface in the handle table */
 
 	void init_vars();
 	void delete_vars();
 	void copy_vars(const LayerSurface& rhs, LayerSurface& lhs);
+	void refresh();
 };
 
 #endif // !LAYERSURFACE_H
@@ -1,48 +1,1709 @@
 #include "ModelBuilder.h"
+#include <array>
+#include <algorithm>
+#include <thread>
+#include <exception>
+
+
+// Marks the references to surfaces outside of the cached layers
+static const int CACHED_REF_NULL = -1;
+static const int CACHED_REF_EXTERNAL = -2;
+
+// LayerSurface record of a cache entry, stored as plain bytes
+struct CachedSurface
+{
+	int face_idx; /**< Index of the face in the restored body */
+	int id; /**< ID of the surface */
+	double point[3]; /**< Reference point */
+	double normal[3]; /**< Reference normal */
+	double angle; /**< Angle between the reference normal and the surface normal */
+	int direction; /**< Direction of the surface */
+	int delam_type; /**< Delamination type of the surface */
+	int initial; /**< Initial surface flag */
+	int modified; /**< Modified surface flag */
+	int stiffener_gen; /**< Generated from stiffener flag */
+	int stiffener_paired; /**< Stiffener paired flag */
+	unsigned long long topology_tag; /**< Topology tag of the face */
+	int pair[3]; /**< Layer, body and surface indices of the pair */
+	int created_from[3]; /**< Layer, body and surface indices of the origin surface */
+};
+
+// LayerBody record of a cache entry
+struct CachedBody
+{
+	std::string name; /**< Name of the body */
+	int id; /**< ID of the body */
+	std::string kernel_blob; /**< Solid body serialized by the kernel */
+	std::vector<CachedSurface> surfaces; /**< Surfaces of the body */
+};
+
+// Layer record of a cache entry
+struct CachedLayer
+{
+	int type; /**< Layer type */
+	int direction; /**< Layer direction */
+	double pos_orig; /**< Position of the orig side */
+	double pos_offset; /**< Position of the offset side */
+	std::vector<CachedBody> bodies; /**< Bodies of the layer */
+};
+
+// Kernel body restored into a scratch LayerBody, before it replaces the body of a layer
+struct RestoredBody
+{
+	DLM_BODYP body; /**< Restored kernel body */
+	delamo::List<DLM_FACEP> faces; /**< Faces of the body in the order of the serialized surfaces */
+};
+
+// Header of the checkpoint files
+static const char CHECKPOINT_MAGIC[8] = { 'D', 'L', 'M', 'C', 'K', 'P', 'T', '3' };
+
+// LayerMold record of a checkpoint
+struct CheckpointMold
+{
+	int direction; /**< Direction of the mold */
+	std::string name; /**< Name of the mold */
+	int stiffener_gen; /**< Generated from stiffener flag */
+	Fingerprint fingerprint; /**< Fingerprint of the mold */
+	std::string kernel_blob; /**< Solid body serialized by the kernel */
+};
+
+// Layer record of a checkpoint, the layers and molds are referred by their indices
+struct CheckpointLayer
+{
+	std::string name; /**< Name of the layer */
+	int id; /**< ID of the layer */
+	int layup; /**< Fiber orientation angle */
+	Fingerprint fingerprint; /**< Fingerprint of the layer */
+	int bond_pair[2]; /**< Layers on the orig and offset sides */
+	std::vector<CheckpointMold> molds; /**< Molds of the layer */
+	std::array<int, 2> delam_profile_ref; /**< Layer and mold indices of the delamination reference mold */
+	std::vector< std::array<int, 2> > body_molds; /**< Layer and mold indices of the molds of the bodies */
+};
 
 
 ModelBuilder::ModelBuilder()
 {
-	this->_bCrashOnException = false;
-	this->_mDelta = 1e-5;
-	this->_pInitialLayer = nullptr;
-	this->_pUnlockStr = nullptr;
-	this->_pPtNmAlgo = nullptr;
-	this->_mLayerID = 0;
-	this->offset_distance(1.0);
-	this->_mDebugMode = false;
+	this->_bCrashOnException = false;
+	this->_mDelta = 1e-5;
+	this->_pInitialLayer = nullptr;
+	this->_pUnlockStr = nullptr;
+#ifdef ACISOBJ
+	this->_pPtNmAlgo = nullptr;
+#endif
+	this->_mLayerID = 0;
+	this->_mSkippedImprints = 0;
+	this->_mCacheHits = 0;
+	this->_bBatchDelaminations = false;
+	this->_mQueryThreads = 1;
+	this->_bDeferred = false;
+	this->_mTaskThreads = 1;
+	this->_mDeferredTicket = -1;
+	this->_bProfileCache = false;
+	this->_bIncremental = false;
+	this->offset_distance(1.0);
+	this->_mDebugMode = false;
+}
+
+ModelBuilder::ModelBuilder(const char* license_key) : ModelBuilder()
+{
+	// Set license key
+	this->set_license_key(license_key);
+}
+
+ModelBuilder::~ModelBuilder()
+{
+	this->_pInitialLayer = nullptr;
+	if (this->_pUnlockStr != nullptr)
+	{
+		delete[] this->_pUnlockStr;
+		this->_pUnlockStr = nullptr;
+	}
+#ifdef ACISOBJ
+	if (this->_pPtNmAlgo != nullptr)
+	{
+		delete this->_pPtNmAlgo;
+		this->_pPtNmAlgo = nullptr;
+	}
+#endif
+	// Pending and recorded operations refer to the layer objects
+	this->_mTaskGraph.clear();
+	this->_mOperationGraph.clear();
+	for (auto& result : this->_mDeferredResults)
+		delete[] result.second.fal;
+	this->_mDeferredResults.clear();
+
+	// Bulk release the layer objects; bodies first as they refer to the surfaces
+	this->_mLayerPool.release();
+	this->_mHandles.clear();
+	this->_mBodyPool.release();
+	this->_mMoldPool.release();
+	this->_mSurfacePool.release();
+}
+
+void ModelBuilder::init() 
+{
+	// Wrapper function for ModelBuilder::start()
+	this->start();
+}
+
+LayerSurface* ModelBuilder::new_layer_surface()
+{
+	// The deferred operations can create objects concurrently
+	std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+	LayerSurface* ls = this->_mSurfacePool.create();
+	this->_mHandles.add(ls);
+	return ls;
+}
+
+LayerBody* ModelBuilder::new_layer_body()
+{
+	std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+	return this->_mBodyPool.create();
+}
+
+LayerMold* ModelBuilder::new_layer_mold()
+{
+	std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+	return this->_mMoldPool.create();
+}
+
+void ModelBuilder::delete_layer_mold(LayerMold* lm)
+{
+	std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+	this->_mMoldPool.destroy(lm);
+}
+
+double ModelBuilder::tolerance()
+{
+	return this->_mDelta;
+}
+
+int ModelBuilder::skipped_imprints()
+{
+	return this->_mSkippedImprints;
+}
+
+void ModelBuilder::batch_delaminations(bool flag)
+{
+	this->_bBatchDelaminations = flag;
+}
+
+bool ModelBuilder::batch_delaminations()
+{
+	return this->_bBatchDelaminations;
+}
+
+void ModelBuilder::query_threads(int num_threads)
+{
+	this->_mQueryThreads = std::max(1, num_threads);
+}
+
+int ModelBuilder::query_threads()
+{
+	return this->_mQueryThreads;
+}
+
+LayerSurface* ModelBuilder::surface(const SurfaceHandle& handle)
+{
+	return this->_mHandles.lookup(handle);
+}
+
+bool ModelBuilder::is_valid(const SurfaceHandle& handle)
+{
+	return this->_mHandles.is_valid(handle);
+}
+
+void ModelBuilder::deferred(bool flag)
+{
+	// Run the recorded operations before switching back to the immediate mode
+	if (!flag)
+		this->sync();
+	this->_bDeferred = flag;
+}
+
+bool ModelBuilder::is_deferred()
+{
+	return this->_bDeferred;
+}
+
+void ModelBuilder::sync()
+{
+	if (this->_mTaskGraph.size() == 0)
+		return;
+
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO)
+		std::cout << "INFO: Running " << this->_mTaskGraph.size() << " deferred operations" << std::endl;
+
+	// Operations of a kernel which is not thread-safe run in the recording order
+	int num_threads = this->thread_safe_modeling() ? this->_mTaskThreads : 1;
+	this->_mTaskGraph.run(num_threads);
+}
+
+int ModelBuilder::deferred_ticket()
+{
+	return this->_mDeferredTicket;
+}
+
+void ModelBuilder::deferred_result(int ticket, FaceAdjacency*& fal, int& fal_size)
+{
+	// The recorded operation might still be pending
+	this->sync();
+
+	auto result = this->_mDeferredResults.find(ticket);
+	if (result == this->_mDeferredResults.end())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: No face adjacency list is stored for the deferred operation " << ticket << "!" << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	// Hand over the face adjacency list to the caller
+	fal = result->second.fal;
+	fal_size = result->second.fal_size;
+	this->_mDeferredResults.erase(result);
+}
+
+void ModelBuilder::sync_layers(delamo::Span<const Layer*> layers)
+{
+	for (auto layer : layers)
+	{
+		if (this->_mTaskGraph.touches(layer))
+		{
+			this->sync();
+			return;
+		}
+	}
+}
+
+ModelBuilder::DeferredAdjacency* ModelBuilder::defer_adjacency_list(FaceAdjacency*& fal, int& fal_size)
+{
+	// The outputs of the caller may not live until sync(), e.g. the ones allocated by the Python wrapper
+	fal = nullptr;
+	fal_size = 0;
+
+	// Element references of the map stay valid while the other recorded operations add their results
+	DeferredAdjacency& result = this->_mDeferredResults[++this->_mDeferredTicket];
+	result.fal = nullptr;
+	result.fal_size = 0;
+	return &result;
+}
+
+void ModelBuilder::task_threads(int num_threads)
+{
+	this->_mTaskThreads = std::max(1, num_threads);
+}
+
+int ModelBuilder::task_threads()
+{
+	return this->_mTaskThreads;
+}
+
+void ModelBuilder::initial_layer(Layer* layer)
+{
+	std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+	if (this->_pInitialLayer == nullptr)
+		this->_pInitialLayer = layer;
+}
+
+bool ModelBuilder::thread_safe_modeling()
+{
+	return false;
+}
+
+std::unique_lock<std::recursive_mutex> ModelBuilder::kernel_lock()
+{
+	// Shared by all instances, the kernel is a process-wide resource
+	static std::recursive_mutex kernel_mutex;
+	if (this->thread_safe_modeling())
+		return std::unique_lock<std::recursive_mutex>();
+	return std::unique_lock<std::recursive_mutex>(kernel_mutex);
+}
+
+void ModelBuilder::read_delamination_file(const char* file_name, delamo::TPoint3<double>*& pts_out, int& pts_out_size)
+{
+	delamo::List< delamo::TPoint3<double> > pts;
+	this->read_delamination_file(file_name, pts);
+
+	// Same output as read_csv_file()
+	pts_out_size = (int)pts.size();
+	pts_out = new delamo::TPoint3<double>[pts_out_size];
+	for (int i = 0; i < pts_out_size; i++)
+		pts_out[i] = pts[i];
+}
+
+void ModelBuilder::read_delamination_file(const char* file_name, delamo::List< delamo::TPoint3<double> >& pts_out)
+{
+	if (!this->_bProfileCache)
+	{
+		read_csv_file(file_name, pts_out);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+	auto cached = this->_mProfileCache.find(file_name);
+	if (cached == this->_mProfileCache.end())
+	{
+		delamo::List< delamo::TPoint3<double> > pts;
+		read_csv_file(file_name, pts);
+		cached = this->_mProfileCache.insert(std::make_pair(std::string(file_name), pts)).first;
+	}
+	pts_out = cached->second;
+}
+
+void ModelBuilder::build_laminate(const LaminateSpec& spec, delamo::List<Layer*>& layers_out, delamo::List<FaceAdjacency*>& fal_out, delamo::List<int>& fal_size_out)
+{
+	// delamo::List has no const accessors
+	LaminateSpec& lspec = const_cast<LaminateSpec&>(spec);
+
+	// Check the input specification
+	int num_plies = (int)lspec.thickness.size();
+	int num_layup = (int)lspec.layup.size();
+	int num_names = (int)lspec.names.size();
+	int num_interfaces = (int)lspec.interfaces.size();
+	if (lspec.mold == nullptr && lspec.layer_mold == nullptr)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Laminate specification requires a mold!" << std::endl;
+		this->error_handler();
+		return;
+	}
+	if (num_plies == 0 || (num_layup > 0 && num_layup != num_plies) || (num_names > 0 && num_names != num_plies))
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Laminate specification requires the same number of thickness, layup and name values!" << std::endl;
+		this->error_handler();
+		return;
+	}
+	if (num_interfaces > 0 && num_interfaces != num_plies - 1)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Laminate specification requires an interface between each pair of consecutive plies!" << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	// The laminate is generated right away, the pending operations might refer to the mold layer
+	this->sync();
+	bool deferred = this->_bDeferred;
+	bool batch = this->_bBatchDelaminations;
+	this->_bDeferred = false;
+	this->_bBatchDelaminations = true;
+	this->_bProfileCache = true;
+
+	try
+	{
+		// Generate the plies on top of each other
+		layers_out.clear();
+		for (int i = 0; i < num_plies; i++)
+		{
+			Layer* layer;
+			{
+				std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+				layer = this->_mLayerPool.create();
+			}
+
+			double thickness = lspec.thickness[i];
+			if (i > 0)
+				this->create_layer(layers_out[i - 1], lspec.direction, thickness, layer);
+			else if (lspec.mold != nullptr)
+				this->create_layer(lspec.mold, lspec.direction, thickness, layer);
+			else
+				this->create_layer(lspec.layer_mold, lspec.direction, thickness, layer);
+
+			if (num_names > 0)
+				layer->name(lspec.names[i].c_str());
+			else
+				layer->name(("Layer_" + std::to_string(i + 1)).c_str());
+			layer->layup((num_layup > 0) ? lspec.layup[i] : 0);
+			layers_out.add(layer);
+		}
+
+		// Imprint the interfaces and generate their face adjacency lists
+		InterfaceSpec bonded;
+		fal_out.clear();
+		fal_size_out.clear();
+		for (int i = 0; i < num_plies - 1; i++)
+		{
+			fal_out.add(nullptr);
+			fal_size_out.add(0);
+			InterfaceSpec& ispec = (num_interfaces > 0) ? lspec.interfaces[i] : bonded;
+			if (ispec.delam_files.size() == 0)
+				this->adjacent_layers(layers_out[i], layers_out[i + 1]);
+			else if (ispec.delam_files.size() == 1)
+				this->adjacent_layers(layers_out[i], layers_out[i + 1], ispec.delam_files[0].c_str());
+			else
+				this->adjacent_layers(layers_out[i], layers_out[i + 1], ispec.delam_files);
+			this->generate_adjacency_list(layers_out[i], layers_out[i + 1], ispec.default_status, ispec.delam_region_status, ispec.delam_ring_status, fal_out[i], fal_size_out[i]);
+			this->record_adjacency_list(layers_out[i], layers_out[i + 1], ispec.default_status, ispec.delam_region_status, ispec.delam_ring_status, fal_out[i], fal_size_out[i]);
+		}
+	}
+	catch (...)
+	{
+		this->_bProfileCache = false;
+		this->_mProfileCache.clear();
+		this->_bBatchDelaminations = batch;
+		this->_bDeferred = deferred;
+		throw;
+	}
+
+	// Restore the settings of the caller
+	this->_bProfileCache = false;
+	this->_mProfileCache.clear();
+	this->_bBatchDelaminations = batch;
+	this->_bDeferred = deferred;
+}
+
+void ModelBuilder::cache_directory(const char* dir_name)
+{
+	this->_mLayerCache.directory(dir_name);
+}
+
+const char* ModelBuilder::cache_directory()
+{
+	return this->_mLayerCache.directory();
+}
+
+int ModelBuilder::cache_hits()
+{
+	return this->_mCacheHits;
+}
+
+void ModelBuilder::incremental(bool flag)
+{
+	// Pending deferred operations are recorded in the current mode
+	this->sync();
+	if (!flag)
+		this->_mOperationGraph.clear();
+	this->_bIncremental = flag;
+}
+
+bool ModelBuilder::is_incremental()
+{
+	return this->_bIncremental;
+}
+
+int ModelBuilder::replace_input(const char* old_file_name, const char* new_file_name)
+{
+	this->sync();
+	return this->_mOperationGraph.replace_file(old_file_name, new_file_name);
+}
+
+int ModelBuilder::rebuild(delamo::List<FaceAdjacency*>& fal_out, delamo::List<int>& fal_size_out)
+{
+	// Pending deferred operations are recorded when they run
+	this->sync();
+
+	// Rebuild releases the LayerSurface objects which the journal refers to
+	if (this->_mJournal.active())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Cannot rebuild during a transaction, commit or roll back first!" << std::endl;
+		this->error_handler();
+		return 0;
+	}
+
+	// Each layer is dirty from the first operation which may give a different result for it
+	int num_nodes = this->_mOperationGraph.size();
+	std::unordered_map<Layer*, int> dirty;
+	std::unordered_map<Layer*, int> last_node;
+	for (int i = 0; i < num_nodes; i++)
+	{
+		for (auto layer : this->_mOperationGraph.node(i).layers)
+			last_node[layer] = i;
+	}
+	for (auto i : this->_mOperationGraph.changed_nodes())
+	{
+		for (auto layer : this->_mOperationGraph.node(i).layers)
+		{
+			if (dirty.count(layer) == 0 || dirty[layer] > i)
+				dirty[layer] = i;
+		}
+	}
+	auto is_dirty = [&dirty](Layer* layer, int node_idx) {
+		auto found = dirty.find(layer);
+		return found != dirty.end() && found->second <= node_idx;
+	};
+
+	// Replayed operations are not recorded again
+	this->_bIncremental = false;
+
+	delamo::List<LayerSurface*> dropped;
+	delamo::List<LayerSurface*> scratch_surfaces;
+	delamo::List<LayerBody*> scratch_bodies;
+	delamo::List<Layer*> scratch_layers;
+	int num_replayed = 0;
+	bool converged = dirty.empty();
+	while (!converged)
+	{
+		converged = true;
+
+		// Reset the dirty layers to their states before the first operation to be replayed
+		for (auto& d : dirty)
+		{
+			Layer* layer = d.first;
+			LayerSnapshot& state = this->_mOperationGraph.state_before(d.second, layer);
+			if (!this->decode_layers(state.blob, delamo::Span<Layer*>(&layer, 1), true, dropped))
+			{
+				this->_bIncremental = true;
+				if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+					std::cout << "ERROR: Cannot reset the layer with ID " << layer->id() << " to its recorded state" << std::endl;
+				this->error_handler();
+				return 0;
+			}
+			layer->fingerprint(state.fingerprint);
+		}
+
+		for (int i = 0; converged && i < num_nodes; i++)
+		{
+			OperationGraph::Node& node = this->_mOperationGraph.node(i);
+			int num_layers = (int)node.layers.size();
+			bool touches_dirty = false;
+			for (auto layer : node.layers)
+				touches_dirty = touches_dirty || is_dirty(layer, i);
+			if (!touches_dirty)
+				continue;
+
+			// The clean layers are replaced by scratch copies of their states before the operation
+			std::vector<Layer*> op_layers(node.layers);
+			std::vector<Layer*> scratch(num_layers, nullptr);
+			for (int j = 0; j < num_layers; j++)
+			{
+				Layer* layer = node.layers[j];
+				if (is_dirty(layer, i))
+					continue;
+
+				Layer* sl;
+				{
+					std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+					sl = this->_mLayerPool.create();
+				}
+				*sl = *layer;
+				sl->clear();
+				LayerSnapshot& state = this->_mOperationGraph.state_before(i, layer);
+				if (!this->decode_layers(state.blob, delamo::Span<Layer*>(&sl, 1), true, dropped))
+				{
+					this->_bIncremental = true;
+					if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+						std::cout << "ERROR: Cannot reset the layer with ID " << layer->id() << " to its recorded state" << std::endl;
+					this->error_handler();
+					return 0;
+				}
+				sl->fingerprint(state.fingerprint);
+				for (int b = 0; b < sl->size() && b < layer->size(); b++)
+				{
+					if (layer->at(b)->mold() != nullptr)
+						sl->at(b)->mold(layer->at(b)->mold());
+				}
+				scratch[j] = sl;
+				op_layers[j] = sl;
+			}
+
+			node.func(delamo::Span<Layer*>(op_layers.data(), op_layers.size()), delamo::Span<const std::string>(node.files.data(), node.files.size()));
+			num_replayed++;
+
+			// The face adjacency list refers to the surface pairs set by this operation
+			if (node.has_fal && num_layers == 2)
+			{
+				FaceAdjacency* fal = nullptr;
+				int fal_size = 0;
+				this->generate_adjacency_list(op_layers[0], op_layers[1], node.fal_status[0], node.fal_status[1], node.fal_status[2], fal, fal_size);
+				node.fal.assign(fal, fal + fal_size);
+				delete[] fal;
+			}
+
+			// A clean layer with the same result stops the propagation, otherwise it is replayed from this operation
+			for (int j = 0; j < num_layers; j++)
+			{
+				if (scratch[j] != nullptr && this->layer_snapshot(scratch[j]).key != node.states[j].key)
+				{
+					dirty[node.layers[j]] = i;
+					converged = false;
+				}
+			}
+
+			if (converged)
+			{
+				// Surfaces of the clean layers keep their indices in the later operations
+				std::unordered_map<LayerSurface*, LayerSurface*> surface_map;
+				std::unordered_map<Layer*, Layer*> layer_map;
+				for (int j = 0; j < num_layers; j++)
+				{
+					if (scratch[j] == nullptr)
+						continue;
+					layer_map[scratch[j]] = node.layers[j];
+					for (int b = 0; b < scratch[j]->size() && b < node.layers[j]->size(); b++)
+					{
+						LayerBody* slb = scratch[j]->at(b);
+						LayerBody* lb = node.layers[j]->at(b);
+						for (int s = 0; s < slb->size() && s < lb->size(); s++)
+							surface_map[slb->at(s)] = lb->at(s);
+					}
+				}
+				auto map_surface = [&surface_map](LayerSurface* ls) {
+					auto found = surface_map.find(ls);
+					return (found == surface_map.end()) ? ls : found->second;
+				};
+				auto map_layer = [&layer_map](Layer* layer) {
+					auto found = layer_map.find(layer);
+					return (found == layer_map.end()) ? layer : found->second;
+				};
+
+				const Direction bond_dirs[2] = { Direction::ORIG, Direction::OFFSET };
+				for (int j = 0; j < num_layers; j++)
+				{
+					Layer* layer = node.layers[j];
+					if (scratch[j] == nullptr)
+					{
+						for (auto lb : *layer)
+						{
+							for (auto ls : *lb)
+							{
+								ls->pair(map_surface(ls->pair()));
+								ls->created_from(map_surface(ls->created_from()));
+							}
+						}
+						for (auto dir : bond_dirs)
+							layer->bond_pair(dir, map_layer(layer->bond_pair(dir)));
+						continue;
+					}
+
+					// Surface pairs of a clean layer are set by the last operation on it
+					if (last_node[layer] == i)
+					{
+						for (int b = 0; b < scratch[j]->size() && b < layer->size(); b++)
+						{
+							LayerBody* slb = scratch[j]->at(b);
+							LayerBody* lb = layer->at(b);
+							for (int s = 0; s < slb->size() && s < lb->size(); s++)
+								lb->at(s)->pair(map_surface(slb->at(s)->pair()));
+						}
+					}
+					for (auto dir : bond_dirs)
+					{
+						if (scratch[j]->bond_pair(dir) != nullptr)
+							layer->bond_pair(dir, map_layer(scratch[j]->bond_pair(dir)));
+					}
+				}
+
+				// The dirty layers have a new state after the operation
+				for (int j = 0; j < num_layers; j++)
+				{
+					if (scratch[j] == nullptr)
+						node.states[j] = this->layer_snapshot(node.layers[j]);
+				}
+			}
+
+			// Scratch layers are not referred anymore
+			for (int j = 0; j < num_layers; j++)
+			{
+				if (scratch[j] == nullptr)
+					continue;
+				for (auto lb : *scratch[j])
+				{
+					for (auto ls : *lb)
+						scratch_surfaces.add(ls);
+					this->release_cache_body(lb);
+					scratch_bodies.add(lb);
+				}
+				scratch_layers.add(scratch[j]);
+			}
+		}
+	}
+
+	// Operations are recorded again from now on
+	this->_bIncremental = true;
+	for (int i = 0; i < num_nodes; i++)
+	{
+		OperationGraph::Node& node = this->_mOperationGraph.node(i);
+		for (int j = 0; j < (int)node.files.size(); j++)
+			node.file_keys[j] = OperationGraph::file_key(node.files[j]);
+	}
+
+	// References to the removed surfaces are not valid anymore
+	std::unordered_set<LayerSurface*> removed(dropped.begin(), dropped.end());
+	removed.insert(scratch_surfaces.begin(), scratch_surfaces.end());
+	if (!removed.empty())
+	{
+		for (auto& ln : last_node)
+		{
+			for (auto lb : *ln.first)
+			{
+				for (auto ls : *lb)
+				{
+					if (removed.count(ls->pair()) > 0)
+						ls->pair(nullptr);
+					if (removed.count(ls->created_from()) > 0)
+						ls->created_from(nullptr);
+				}
+			}
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+		for (auto ls : removed)
+		{
+			this->_mHandles.remove(ls);
+			this->_mSurfacePool.destroy(ls);
+		}
+		for (auto lb : scratch_bodies)
+			this->_mBodyPool.destroy(lb);
+		for (auto sl : scratch_layers)
+			this->_mLayerPool.destroy(sl);
+	}
+
+	// Face adjacency lists of all interfaces, the ones which are not replayed are unchanged
+	fal_out.clear();
+	fal_size_out.clear();
+	for (int i = 0; i < num_nodes; i++)
+	{
+		OperationGraph::Node& node = this->_mOperationGraph.node(i);
+		if (!node.has_fal)
+			continue;
+		FaceAdjacency* fal = new FaceAdjacency[node.fal.size()];
+		std::copy(node.fal.begin(), node.fal.end(), fal);
+		fal_out.add(fal);
+		fal_size_out.add((int)node.fal.size());
+	}
+
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO)
+		std::cout << "INFO: Rebuild replayed " << num_replayed << " of " << num_nodes << " recorded operations on " << dirty.size() << " layers" << std::endl;
+	return num_replayed;
+}
+
+void ModelBuilder::begin_transaction()
+{
+	// Pending deferred operations belong to the previous state
+	this->sync();
+
+	if (this->_mJournal.active())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: A transaction is already started!" << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	// The layer states cannot be journaled without serializing the bodies
+	if (this->cache_format() == nullptr)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Transactions are not supported by this solid modeling kernel!" << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	Layer* initial_layer;
+	{
+		std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+		initial_layer = this->_pInitialLayer;
+	}
+	this->_mJournal.begin(initial_layer, this->_mOperationGraph.size());
+}
+
+bool ModelBuilder::in_transaction()
+{
+	return this->_mJournal.active();
+}
+
+void ModelBuilder::commit()
+{
+	// Deferred operations of the transaction are journaled when they run
+	this->sync();
+	this->_mJournal.clear();
+}
+
+int ModelBuilder::rollback()
+{
+	// Deferred operations of the transaction are journaled when they run
+	this->sync();
+
+	if (!this->_mJournal.active())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: There is no transaction to roll back!" << std::endl;
+		this->error_handler();
+		return 0;
+	}
+
+	std::vector<JournalLayer>& entries = this->_mJournal.entries();
+
+	// Objects which are not in the journal are created by the transaction
+	std::unordered_set<LayerBody*> kept_bodies;
+	std::unordered_set<LayerSurface*> kept_surfaces;
+	for (auto& jl : entries)
+	{
+		for (auto& jb : jl.bodies)
+		{
+			kept_bodies.insert(jb.body);
+			for (auto& js : jb.surfaces)
+				kept_surfaces.insert(js.surface);
+		}
+	}
+	delamo::List<LayerBody*> removed_bodies;
+	delamo::List<LayerSurface*> removed_surfaces;
+	for (auto& jl : entries)
+	{
+		for (auto lb : *jl.layer)
+		{
+			for (auto ls : *lb)
+			{
+				if (kept_surfaces.count(ls) == 0)
+					removed_surfaces.add(ls);
+			}
+			if (kept_bodies.count(lb) == 0)
+				removed_bodies.add(lb);
+		}
+	}
+
+	// Restore the journaled bodies into new kernel bodies first, so that a failed restore leaves the model untouched
+	std::vector< std::vector<RestoredBody> > restored(entries.size());
+	const JournalBody* failed_body = nullptr;
+	for (size_t i = 0; i < entries.size() && failed_body == nullptr; i++)
+	{
+		for (auto& jb : entries[i].bodies)
+		{
+			LayerBody scratch;
+			RestoredBody rb;
+			if (!this->restore_cache_body(&scratch, jb.kernel_blob, rb.faces))
+			{
+				failed_body = &jb;
+				break;
+			}
+			rb.body = scratch.body();
+			restored[i].push_back(rb);
+		}
+	}
+	if (failed_body != nullptr)
+	{
+		for (auto& layer_bodies : restored)
+		{
+			for (auto& rb : layer_bodies)
+			{
+				LayerBody scratch;
+				scratch.body(rb.body);
+				this->release_cache_body(&scratch);
+			}
+		}
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Cannot restore the journaled body " << failed_body->name << ", the transaction is not rolled back" << std::endl;
+		this->error_handler();
+		return 0;
+	}
+
+	// All bodies are restored, the current kernel bodies can be replaced
+	for (auto lb : removed_bodies)
+		this->release_cache_body(lb);
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		JournalLayer& jl = entries[i];
+		Layer* layer = jl.layer;
+		layer->clear();
+		for (size_t j = 0; j < jl.bodies.size(); j++)
+		{
+			JournalBody& jb = jl.bodies[j];
+			LayerBody* lb = jb.body;
+			delamo::List<DLM_FACEP>& faces = restored[i][j].faces;
+			this->release_cache_body(lb);
+			lb->body(restored[i][j].body);
+			lb->name(jb.name.c_str());
+			lb->id(jb.id);
+			if (jb.has_mold)
+				lb->mold(&jb.mold);
+
+			delamo::List<LayerSurface*> lsc;
+			for (auto& js : jb.surfaces)
+			{
+				LayerSurface* ls = js.surface;
+				ls->face(faces[js.face_idx]);
+				ls->topology_tag(js.topology_tag);
+				ls->id(js.id);
+				ls->point_coords(js.point);
+				ls->normal_coords(js.normal);
+				ls->angle(js.angle);
+				ls->direction(js.direction);
+				ls->delam_type(js.delam_type);
+				ls->initial_surface(js.initial);
+				ls->modified(js.modified);
+				ls->stiffener_gen(js.stiffener_gen);
+				ls->stiffener_paired(js.stiffener_paired);
+				ls->pair(js.pair);
+				ls->created_from(js.created_from);
+				lsc.add(ls);
+			}
+			lb->clear();
+			lb->add_surfaces(lsc);
+			lb->bounding_box_clear();
+			layer->add_body(lb);
+		}
+
+		layer->type(jl.type);
+		layer->direction(jl.direction);
+		layer->position(jl.pos_orig, jl.pos_offset);
+		layer->id(jl.id);
+		layer->next_lb_id = jl.next_lb_id;
+		layer->bond_pair(Direction::ORIG, jl.bond_orig);
+		layer->bond_pair(Direction::OFFSET, jl.bond_offset);
+
+		// Molds generated by the transaction are not referenced by the restored layer anymore
+		for (int i = 0; i < layer->size_mold(); i++)
+		{
+			LayerMold* lm = layer->list_mold()[i];
+			if (lm->owner() != layer || std::find(jl.molds.begin(), jl.molds.end(), lm) != jl.molds.end())
+				continue;
+			this->release_cache_mold(lm);
+			this->delete_layer_mold(lm);
+		}
+		layer->clear_mold();
+		for (auto lm : jl.molds)
+			layer->add_mold(lm);
+		layer->delam_profile_ref(jl.delam_profile_ref);
+		layer->update_owners();
+		layer->fingerprint(jl.fingerprint);
+	}
+
+	// References to the removed surfaces are not valid anymore
+	{
+		std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+		this->_pInitialLayer = this->_mJournal.initial_layer();
+		for (auto ls : removed_surfaces)
+		{
+			this->_mHandles.remove(ls);
+			this->_mSurfacePool.destroy(ls);
+		}
+		for (auto lb : removed_bodies)
+			this->_mBodyPool.destroy(lb);
+	}
+
+	// Operations of the transaction are not replayed by the later rebuilds
+	this->_mOperationGraph.truncate(this->_mJournal.num_operations());
+
+	int num_restored = (int)entries.size();
+	this->_mJournal.clear();
+
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO)
+		std::cout << "INFO: Rollback restored " << num_restored << " layers" << std::endl;
+	return num_restored;
+}
+
+int ModelBuilder::release_layers(delamo::List<Layer*>& layers)
+{
+	// Pending deferred operations might refer to the layers
+	this->sync();
+
+	// The journal restores the objects of the layers by their pointers
+	if (this->_mJournal.active())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Cannot release layers during a transaction!" << std::endl;
+		this->error_handler();
+		return 0;
+	}
+
+	std::unordered_set<Layer*> released;
+	for (auto layer : layers)
+	{
+		if (layer != nullptr)
+			released.insert(layer);
+	}
+	if (released.empty())
+		return 0;
+
+	// The layers bonded to the initial layer are found from the remaining layers
+	delamo::List<Layer*> remaining;
+	if (this->_pInitialLayer != nullptr)
+	{
+		delamo::List<Layer*> bonded;
+		this->prepare_layers(bonded);
+		for (auto layer : bonded)
+		{
+			if (released.count(layer) == 0)
+				remaining.add(layer);
+		}
+	}
+
+	// References from the remaining layers to the released ones are not valid anymore
+	std::unordered_set<LayerSurface*> removed;
+	for (auto layer : released)
+	{
+		for (auto lb : *layer)
+		{
+			for (auto ls : *lb)
+			{
+				removed.insert(ls);
+				if (ls->pair() != nullptr && ls->pair()->pair() == ls)
+					ls->pair()->pair(nullptr);
+			}
+		}
+		for (auto bond_dir : { Direction::ORIG, Direction::OFFSET })
+		{
+			Layer* bonded = layer->bond_pair(bond_dir);
+			if (bonded == nullptr || released.count(bonded) > 0)
+				continue;
+			if (bonded->bond_pair(Direction::ORIG) == layer)
+				bonded->bond_pair(Direction::ORIG, nullptr);
+			if (bonded->bond_pair(Direction::OFFSET) == layer)
+				bonded->bond_pair(Direction::OFFSET, nullptr);
+		}
+	}
+	for (auto layer : remaining)
+	{
+		for (auto lb : *layer)
+		{
+			for (auto ls : *lb)
+			{
+				if (removed.count(ls->pair()) > 0)
+					ls->pair(nullptr);
+				if (removed.count(ls->created_from()) > 0)
+					ls->created_from(nullptr);
+			}
+		}
+	}
+
+	// Recorded operations cannot be replayed without their layers
+	for (int i = 0; i < this->_mOperationGraph.size(); i++)
+	{
+		bool refers_released = false;
+		for (auto layer : this->_mOperationGraph.node(i).layers)
+			refers_released = refers_released || (released.count(layer) > 0);
+		if (refers_released)
+		{
+			if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO)
+				std::cout << "INFO: Discarding the recorded operations of the released layers" << std::endl;
+			this->_mOperationGraph.clear();
+			break;
+		}
+	}
+
+	// Solid bodies and the molds are deleted by the solid modeling kernel
+	delamo::List<LayerBody*> removed_bodies;
+	for (auto layer : released)
+	{
+		for (auto lb : *layer)
+		{
+			this->release_cache_body(lb);
+			removed_bodies.add(lb);
+		}
+		for (int i = 0; i < layer->size_mold(); i++)
+		{
+			LayerMold* lm = layer->list_mold()[i];
+			if (lm->owner() != layer)
+				continue;
+			this->release_cache_mold(lm);
+			this->delete_layer_mold(lm);
+		}
+		layer->clear();
+		layer->clear_mold();
+		layer->delam_profile_ref(nullptr);
+		layer->bond_pair(Direction::ORIG, nullptr);
+		layer->bond_pair(Direction::OFFSET, nullptr);
+		layer->fingerprint(Fingerprint());
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+		for (auto ls : removed)
+		{
+			this->_mHandles.remove(ls);
+			this->_mSurfacePool.destroy(ls);
+		}
+		for (auto lb : removed_bodies)
+			this->_mBodyPool.destroy(lb);
+
+		// The next created layer becomes the initial layer if no bonded layer remains
+		if (released.count(this->_pInitialLayer) > 0)
+			this->_pInitialLayer = remaining.empty() ? nullptr : remaining[0];
+
+		for (auto layer : released)
+		{
+			if (this->_mLayerPool.owns(layer))
+				this->_mLayerPool.destroy(layer);
+		}
+	}
+
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO)
+		std::cout << "INFO: Released " << released.size() << " layers" << std::endl;
+	return (int)released.size();
+}
+
+Fingerprint ModelBuilder::cache_key(delamo::Span<Layer*> layers)
+{
+	if (!this->_mLayerCache.enabled() || this->cache_format() == nullptr)
+		return Fingerprint();
+
+	// Layer fingerprints cover the inputs of all operations which generated them
+	FingerprintBuilder key;
+	key.add(this->cache_format());
+	key.add((int)layers.size());
+	for (auto layer : layers)
+	{
+		if (!layer->fingerprint().valid())
+			return Fingerprint();
+		key.add(layer->fingerprint());
+	}
+	return key.value();
+}
+
+void ModelBuilder::fingerprint_layer(Layer* layer_out, const char* op_name, const Fingerprint& source, Direction ldir, double thickness)
+{
+	FingerprintBuilder fp;
+	fp.add(op_name);
+	fp.add(source);
+	fp.add((int)ldir);
+	fp.add(thickness, this->_mDelta);
+	layer_out->fingerprint(fp.value());
+}
+
+void ModelBuilder::fingerprint_molds(Layer* layer)
+{
+	// Molds are only modified by the operations which also modify their owner
+	for (int i = 0; i < layer->size_mold(); i++)
+	{
+		LayerMold* lm = layer->list_mold()[i];
+		FingerprintBuilder fp;
+		fp.add("mold");
+		fp.add(layer->fingerprint());
+		fp.add(i);
+		fp.add((int)lm->direction());
+		fp.add(lm->is_stiffener_gen() ? 1 : 0);
+		lm->fingerprint(fp.value());
+	}
+
+	// LayerBody objects keep copies of their molds
+	for (auto lb : *layer)
+	{
+		LayerMold* body_mold = lb->mold();
+		for (int i = 0; body_mold != nullptr && i < layer->size_mold(); i++)
+		{
+			if (layer->list_mold()[i]->body() == body_mold->body())
+				body_mold->fingerprint(layer->list_mold()[i]->fingerprint());
+		}
+	}
+}
+
+Fingerprint ModelBuilder::mold_fingerprint(Layer* layer, Direction mold_dir)
+{
+	// The layers created on top of each other only depend on the molds, not on the later operations on the input layer
+	FingerprintBuilder fp;
+	fp.add("molds");
+	for (int i = 0; i < layer->size_mold(); i++)
+	{
+		LayerMold* lm = layer->list_mold()[i];
+		if (lm->direction() != mold_dir)
+			continue;
+		if (!lm->fingerprint().valid())
+			return Fingerprint();
+		fp.add(lm->fingerprint());
+	}
+	return fp.value();
 }
 
-ModelBuilder::ModelBuilder(const char* license_key) : ModelBuilder()
+void ModelBuilder::fingerprint_operation(delamo::Span<Layer*> layers, const char* op_name, delamo::Span<const std::string> file_names, delamo::Span<const double> params)
 {
-	// Set license key
-	this->set_license_key(license_key);
+	// All inputs of the operation are the same for all layers
+	FingerprintBuilder op_fp;
+	op_fp.add(op_name);
+	op_fp.add(this->offset_distance(), this->_mDelta);
+	op_fp.add(this->_bBatchDelaminations ? 1 : 0);
+	op_fp.add((int)params.size());
+	for (auto param : params)
+		op_fp.add(param, this->_mDelta);
+	op_fp.add((int)file_names.size());
+	for (auto& file_name : file_names)
+	{
+		// A missing file is a different input than an empty one
+		if (!op_fp.add_file(file_name.c_str()))
+			op_fp.add(-1);
+	}
+	op_fp.add((int)layers.size());
+	for (auto layer : layers)
+		op_fp.add(layer->fingerprint());
+	Fingerprint op_value = op_fp.value();
+
+	for (int l = 0; l < (int)layers.size(); l++)
+	{
+		FingerprintBuilder fp;
+		fp.add(op_value);
+		fp.add(l);
+		layers[l]->fingerprint(fp.value());
+	}
 }
 
-ModelBuilder::~ModelBuilder()
+bool ModelBuilder::restore_cached_layers(const Fingerprint& key, delamo::Span<Layer*> layers)
 {
-	this->_pInitialLayer = nullptr;
-	if (this->_pUnlockStr != nullptr)
+	if (!key.valid())
+		return false;
+
+	std::string blob;
+	if (!this->_mLayerCache.load(key, blob))
+		return false;
+
+	delamo::List<LayerSurface*> dropped;
+	if (!this->decode_layers(blob, layers, false, dropped))
 	{
-		delete[] this->_pUnlockStr;
-		this->_pUnlockStr = nullptr;
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_WARN)
+			std::cout << "WARNING: Ignoring the incompatible cache entry " << key.hex() << std::endl;
+		return false;
 	}
-	if (this->_pPtNmAlgo != nullptr)
+
+	this->_mCacheHits++;
+
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO)
+		std::cout << "INFO: Restored " << layers.size() << " layers from the cache entry " << key.hex() << std::endl;
+	return true;
+}
+
+void ModelBuilder::store_cached_layers(const Fingerprint& key, delamo::Span<Layer*> layers)
+{
+	if (!key.valid())
+		return;
+
+	std::string blob;
+	if (this->encode_layers(layers, blob, true))
+		this->_mLayerCache.store(key, blob);
+}
+
+bool ModelBuilder::encode_layers(delamo::Span<Layer*> layers, std::string& blob, bool keep_external)
+{
+	// Surfaces are referred by their layer, body and surface indices
+	std::unordered_map<LayerSurface*, std::array<int, 3>> surface_refs;
+	for (int l = 0; l < (int)layers.size(); l++)
 	{
-		delete this->_pPtNmAlgo;
-		this->_pPtNmAlgo = nullptr;
+		for (int b = 0; b < layers[l]->size(); b++)
+		{
+			LayerBody* lb = layers[l]->at(b);
+			for (int s = 0; s < lb->size(); s++)
+				surface_refs[lb->at(s)] = std::array<int, 3>{ { l, b, s } };
+		}
+	}
+	auto encode = [&surface_refs, keep_external](LayerSurface* ls, int* ref) {
+		ref[0] = (ls == nullptr || !keep_external) ? CACHED_REF_NULL : CACHED_REF_EXTERNAL;
+		ref[1] = -1;
+		ref[2] = -1;
+		auto found = surface_refs.find(ls);
+		if (found != surface_refs.end())
+			std::copy(found->second.begin(), found->second.end(), ref);
+	};
+
+	CacheWriter writer;
+	writer.write_string(this->cache_format());
+	writer.write((int)layers.size());
+	bool saved = true;
+	for (auto layer : layers)
+	{
+		writer.write((int)layer->type());
+		writer.write((int)layer->direction());
+		writer.write(layer->position_orig());
+		writer.write(layer->position_offset());
+		writer.write(layer->size());
+		for (auto lb : *layer)
+		{
+			std::string kernel_blob;
+			delamo::List<DLM_FACEP> faces;
+			saved = saved && this->save_cache_body(lb, kernel_blob, faces);
+			std::unordered_map<DLM_FACEP, int> face_index;
+			for (int i = 0; i < (int)faces.size(); i++)
+				face_index[faces[i]] = i;
+
+			writer.write_string(lb->name());
+			writer.write(lb->id());
+			writer.write_string(kernel_blob);
+			writer.write(lb->size());
+			for (auto ls : *lb)
+			{
+				CachedSurface cs;
+				std::memset(&cs, 0, sizeof(cs));
+				auto found = face_index.find(ls->face());
+				cs.face_idx = (found == face_index.end()) ? -1 : found->second;
+				cs.id = ls->id();
+				delamo::TPoint3<double> pt = ls->point_coords();
+				delamo::TPoint3<double> nm = ls->normal_coords();
+				for (int i = 0; i < 3; i++)
+				{
+					cs.point[i] = pt[i];
+					cs.normal[i] = nm[i];
+				}
+				cs.angle = ls->angle();
+				cs.direction = (int)ls->direction();
+				cs.delam_type = (int)ls->delam_type();
+				cs.initial = ls->is_initial_surface() ? 1 : 0;
+				cs.modified = ls->is_modified() ? 1 : 0;
+				cs.stiffener_gen = ls->is_stiffener_gen() ? 1 : 0;
+				cs.stiffener_paired = ls->is_stiffener_paired() ? 1 : 0;
+				cs.topology_tag = ls->topology_tag();
+				encode(ls->pair(), cs.pair);
+				encode(ls->created_from(), cs.created_from);
+				saved = saved && (cs.face_idx >= 0);
+				writer.write(cs);
+			}
+		}
 	}
+
+	blob = writer.buffer();
+	return saved;
 }
 
-void ModelBuilder::init() 
+bool ModelBuilder::decode_layers(const std::string& blob, delamo::Span<Layer*> layers, bool replace, delamo::List<LayerSurface*>& dropped)
 {
-	// Wrapper function for ModelBuilder::start()
-	this->start();
+	// Read the whole entry before modifying the layers
+	CacheReader reader(blob);
+	std::string format;
+	reader.read_string(format);
+	int num_layers = 0;
+	reader.read(num_layers);
+	if (!reader.good() || format != this->cache_format() || num_layers != (int)layers.size())
+		return false;
+
+	std::vector<CachedLayer> cached_layers(num_layers);
+	for (int l = 0; l < num_layers; l++)
+	{
+		CachedLayer& cl = cached_layers[l];
+		int num_bodies = 0;
+		reader.read(cl.type);
+		reader.read(cl.direction);
+		reader.read(cl.pos_orig);
+		reader.read(cl.pos_offset);
+		reader.read(num_bodies);
+		if (!reader.good() || num_bodies < 0 || (!replace && num_bodies < layers[l]->size()))
+			return false;
+
+		cl.bodies.resize(num_bodies);
+		for (auto& cb : cl.bodies)
+		{
+			int num_surfaces = 0;
+			reader.read_string(cb.name);
+			reader.read(cb.id);
+			reader.read_string(cb.kernel_blob);
+			reader.read(num_surfaces);
+			if (!reader.good() || num_surfaces < 0)
+				return false;
+			cb.surfaces.resize(num_surfaces);
+			for (auto& cs : cb.surfaces)
+				reader.read(cs);
+		}
+		if (!reader.good())
+			return false;
+
+		// The operation only adds surfaces, the existing ones are updated in place
+		for (int b = 0; !replace && b < layers[l]->size(); b++)
+		{
+			if ((int)cl.bodies[b].surfaces.size() < layers[l]->at(b)->size())
+				return false;
+		}
+	}
+
+	// Restore the cached bodies into new kernel bodies first, so that a failed restore leaves the layers untouched
+	std::vector< std::vector<RestoredBody> > restored(num_layers);
+	const CachedBody* failed_body = nullptr;
+	for (int l = 0; l < num_layers && failed_body == nullptr; l++)
+	{
+		for (auto& cb : cached_layers[l].bodies)
+		{
+			LayerBody scratch;
+			RestoredBody rb;
+			bool valid = this->restore_cache_body(&scratch, cb.kernel_blob, rb.faces);
+			rb.body = scratch.body();
+			if (rb.body != nullptr)
+				restored[l].push_back(rb);
+			for (int s = 0; valid && s < (int)cb.surfaces.size(); s++)
+				valid = (cb.surfaces[s].face_idx >= 0 && cb.surfaces[s].face_idx < (int)rb.faces.size());
+			if (!valid)
+			{
+				failed_body = &cb;
+				break;
+			}
+		}
+	}
+	if (failed_body != nullptr)
+	{
+		for (auto& layer_bodies : restored)
+		{
+			for (auto& rb : layer_bodies)
+			{
+				LayerBody scratch;
+				scratch.body(rb.body);
+				this->release_cache_body(&scratch);
+			}
+		}
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Cannot restore the cached body " << failed_body->name << std::endl;
+		return false;
+	}
+
+	// All bodies are restored, update the layers and collect all surfaces for resolving the references between them
+	std::vector< std::vector< std::vector<LayerSurface*> > > surfaces(num_layers);
+	for (int l = 0; l < num_layers; l++)
+	{
+		Layer* layer = layers[l];
+		CachedLayer& cl = cached_layers[l];
+		layer->type((LayerType)cl.type);
+		layer->direction((Direction)cl.direction);
+		layer->position(cl.pos_orig, cl.pos_offset);
+
+		// Bodies generated after the stored state are discarded with their surfaces
+		while (layer->size() > (int)cl.bodies.size())
+		{
+			LayerBody* lb = layer->at(layer->size() - 1);
+			for (auto ls : *lb)
+				dropped.add(ls);
+			this->release_cache_body(lb);
+			layer->remove(layer->size() - 1);
+		}
+
+		surfaces[l].resize(cl.bodies.size());
+		for (int b = 0; b < (int)cl.bodies.size(); b++)
+		{
+			CachedBody& cb = cl.bodies[b];
+			bool is_new_body = (b >= layer->size());
+			LayerBody* lb = is_new_body ? this->new_layer_body() : layer->at(b);
+			if (is_new_body)
+			{
+				lb->name(cb.name.c_str());
+				lb->owner(layer);
+				lb->id(cb.id);
+			}
+
+			delamo::List<DLM_FACEP>& faces = restored[l][b].faces;
+			this->release_cache_body(lb);
+			lb->body(restored[l][b].body);
+
+			delamo::List<LayerSurface*> lsc;
+			for (int s = 0; s < (int)cb.surfaces.size(); s++)
+			{
+				CachedSurface& cs = cb.surfaces[s];
+				LayerSurface* ls = (s < lb->size()) ? lb->at(s) : this->new_layer_surface();
+				ls->face(faces[cs.face_idx]);
+				ls->topology_tag(cs.topology_tag);
+				ls->id(cs.id);
+				ls->point_coords(delamo::TPoint3<double>(cs.point[0], cs.point[1], cs.point[2]));
+				ls->normal_coords(delamo::TPoint3<double>(cs.normal[0], cs.normal[1], cs.normal[2]));
+				ls->angle(cs.angle);
+				ls->direction((Direction)cs.direction);
+				ls->delam_type((DelaminationType)cs.delam_type);
+				ls->initial_surface(cs.initial != 0);
+				ls->stiffener_gen(cs.stiffener_gen != 0);
+				ls->stiffener_paired(cs.stiffener_paired != 0);
+				ls->owner(lb);
+				lsc.add(ls);
+				surfaces[l][b].push_back(ls);
+			}
+			for (int s = (int)cb.surfaces.size(); s < lb->size(); s++)
+				dropped.add(lb->at(s));
+			lb->clear();
+			lb->add_surfaces(lsc);
+			lb->update_face_index();
+			lb->bounding_box_clear();
+
+			if (is_new_body)
+				layer->add_body(lb);
+		}
+	}
+
+	// Resolve the references after all surfaces exist
+	auto resolve = [&surfaces](const int* ref) -> LayerSurface* {
+		if (ref[0] < 0 || ref[0] >= (int)surfaces.size() || ref[1] >= (int)surfaces[ref[0]].size() || ref[2] >= (int)surfaces[ref[0]][ref[1]].size())
+			return nullptr;
+		return surfaces[ref[0]][ref[1]][ref[2]];
+	};
+	for (int l = 0; l < num_layers; l++)
+	{
+		for (int b = 0; b < (int)surfaces[l].size(); b++)
+		{
+			for (int s = 0; s < (int)surfaces[l][b].size(); s++)
+			{
+				CachedSurface& cs = cached_layers[l].bodies[b].surfaces[s];
+				LayerSurface* ls = surfaces[l][b][s];
+
+				// References to the layers outside of the operation are kept as they are, unless the layers are reset
+				if (cs.pair[0] != CACHED_REF_EXTERNAL || replace)
+					ls->pair(resolve(cs.pair));
+				if (cs.created_from[0] != CACHED_REF_EXTERNAL || replace)
+					ls->created_from(resolve(cs.created_from));
+				ls->modified(cs.modified != 0);
+			}
+		}
+		layers[l]->update_owners();
+	}
+	return true;
 }
 
-double ModelBuilder::tolerance()
+const char* ModelBuilder::cache_format()
 {
-	return this->_mDelta;
+	return nullptr;
+}
+
+bool ModelBuilder::save_cache_body(LayerBody* /* lb */, std::string& /* blob */, delamo::List<DLM_FACEP>& /* faces */)
+{
+	return false;
+}
+
+bool ModelBuilder::restore_cache_body(LayerBody* /* lb */, const std::string& /* blob */, delamo::List<DLM_FACEP>& /* faces */)
+{
+	return false;
+}
+
+void ModelBuilder::release_cache_body(LayerBody* /* lb */)
+{
+	// Nothing to release by default
+}
+
+bool ModelBuilder::save_cache_mold(LayerMold* /* lm */, std::string& /* blob */)
+{
+	return false;
+}
+
+bool ModelBuilder::restore_cache_mold(LayerMold* /* lm */, const std::string& /* blob */)
+{
+	return false;
+}
+
+void ModelBuilder::release_cache_mold(LayerMold* /* lm */)
+{
+	// Nothing to release by default
+}
+
+LayerSnapshot ModelBuilder::layer_snapshot(Layer* layer)
+{
+	LayerSnapshot state;
+	this->encode_layers(delamo::Span<Layer*>(&layer, 1), state.blob, false);
+	FingerprintBuilder key;
+	key.add(state.blob.data(), state.blob.size());
+	state.key = key.value();
+	state.fingerprint = layer->fingerprint();
+	return state;
+}
+
+bool ModelBuilder::record_operation(OperationGraph::Operation op, delamo::Span<Layer*> layers, delamo::Span<const std::string> file_names)
+{
+	// Recorded or not, the operation modifies the layers of the transaction
+	this->journal_layers(layers);
+
+	// The layer states cannot be recorded without serializing the bodies
+	if (!this->_bIncremental || this->cache_format() == nullptr)
+		return false;
+
+	// Nested operations are replayed by the calling operation
+	if (!this->_mOperationGraph.begin(layers))
+		return false;
+
+	for (auto layer : layers)
+	{
+		if (!this->_mOperationGraph.has_initial_state(layer))
+			this->_mOperationGraph.initial_state(layer, this->layer_snapshot(layer));
+	}
+
+	// The replayed operation uses the settings of the recorded one
+	bool batch = this->_bBatchDelaminations;
+	double offset = this->_mOffsetDistance;
+	OperationGraph::Node node;
+	node.func = [this, op, batch, offset](delamo::Span<Layer*> op_layers, delamo::Span<const std::string> op_files) {
+		bool current_batch = this->_bBatchDelaminations;
+		double current_offset = this->_mOffsetDistance;
+		this->_bBatchDelaminations = batch;
+		this->_mOffsetDistance = offset;
+		op(op_layers, op_files);
+		this->_bBatchDelaminations = current_batch;
+		this->_mOffsetDistance = current_offset;
+	};
+	node.layers.assign(layers.begin(), layers.end());
+	node.files.assign(file_names.begin(), file_names.end());
+	for (auto& file_name : node.files)
+		node.file_keys.push_back(OperationGraph::file_key(file_name));
+	node.has_fal = false;
+
+	op(layers, file_names);
+
+	for (auto layer : layers)
+		node.states.push_back(this->layer_snapshot(layer));
+	this->_mOperationGraph.end(node);
+	return true;
+}
+
+void ModelBuilder::record_adjacency_list(Layer* layer_orig, Layer* layer_offset, BCStatus default_status, BCStatus delam_region_status, BCStatus delam_ring_status, FaceAdjacency* fal, int fal_size)
+{
+	if (!this->_bIncremental)
+		return;
+
+	Layer* layers[2] = { layer_orig, layer_offset };
+	const BCStatus status[3] = { default_status, delam_region_status, delam_ring_status };
+	this->_mOperationGraph.adjacency_list(delamo::Span<Layer*>(layers, 2), status, fal, fal_size);
+}
+
+void ModelBuilder::journal_layers(delamo::Span<Layer*> layers)
+{
+	if (!this->_mJournal.active())
+		return;
+
+	for (auto layer : layers)
+	{
+		if (this->_mJournal.contains(layer))
+			continue;
+
+		JournalLayer jl;
+		jl.layer = layer;
+		jl.type = layer->type();
+		jl.direction = layer->direction();
+		jl.pos_orig = layer->position_orig();
+		jl.pos_offset = layer->position_offset();
+		jl.id = layer->id();
+		jl.next_lb_id = layer->next_lb_id;
+		jl.fingerprint = layer->fingerprint();
+		jl.bond_orig = layer->bond_pair(Direction::ORIG);
+		jl.bond_offset = layer->bond_pair(Direction::OFFSET);
+		jl.molds.assign(layer->list_mold(), layer->list_mold() + layer->size_mold());
+		jl.delam_profile_ref = layer->delam_profile_ref();
+
+		bool saved = true;
+		jl.bodies.resize(layer->size());
+		for (int b = 0; b < layer->size(); b++)
+		{
+			LayerBody* lb = layer->at(b);
+			JournalBody& jb = jl.bodies[b];
+			delamo::List<DLM_FACEP> faces;
+			saved = saved && this->save_cache_body(lb, jb.kernel_blob, faces);
+			std::unordered_map<DLM_FACEP, int> face_index;
+			for (int i = 0; i < (int)faces.size(); i++)
+				face_index[faces[i]] = i;
+
+			jb.body = lb;
+			jb.name = (lb->name() == nullptr) ? "" : lb->name();
+			jb.id = lb->id();
+			jb.has_mold = (lb->mold() != nullptr);
+			if (jb.has_mold)
+				jb.mold = *lb->mold();
+			jb.surfaces.resize(lb->size());
+			for (int s = 0; s < lb->size(); s++)
+			{
+				LayerSurface* ls = lb->at(s);
+				JournalSurface& js = jb.surfaces[s];
+				auto found = face_index.find(ls->face());
+				js.surface = ls;
+				js.face_idx = (found == face_index.end()) ? -1 : found->second;
+				js.id = ls->id();
+				js.point = ls->point_coords();
+				js.normal = ls->normal_coords();
+				js.angle = ls->angle();
+				js.direction = ls->direction();
+				js.delam_type = ls->delam_type();
+				js.initial = ls->is_initial_surface();
+				js.modified = ls->is_modified();
+				js.stiffener_gen = ls->is_stiffener_gen();
+				js.stiffener_paired = ls->is_stiffener_paired();
+				js.topology_tag = ls->topology_tag();
+				js.pair = ls->pair();
+				js.created_from = ls->created_from();
+				saved = saved && (js.face_idx >= 0);
+			}
+		}
+		if (!saved)
+		{
+			if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+				std::cout << "ERROR: Cannot journal the layer " << layer->id() << " for the transaction" << std::endl;
+			this->error_handler();
+			return;
+		}
+		this->_mJournal.add(jl);
+	}
 }
 
 void ModelBuilder::error_handler()
@@ -228,57 +1889,352 @@ void ModelBuilder::generate_adjacency_list(Layer *layer_orig, Layer *layer_offse
 						bool spair_flag_orig = orig_ls->is_stiffener_paired();
 						bool spair_flag_offset = offset_ls->is_stiffener_paired();
 
-						// Push it to the vector
-						if (spair_flag_orig || spair_flag_offset)
-							continue;
-						else
-							fal_container.push_back(elem);
-					}
-				}
-			}
-		}
-	}
+						// Push it to the vector
+						if (spair_flag_orig || spair_flag_offset)
+							continue;
+						else
+							fal_container.push_back(elem);
+					}
+				}
+			}
+		}
+	}
+
+	// Copy the FAL data to the output variables
+	fal_size = fal_container.size();
+	fal = new FaceAdjacency[fal_size];
+	int counter = 0;
+	for (auto fa_elem : fal_container)
+	{
+		fal[counter] = fa_elem;
+		counter++;
+	}
+}
+
+void ModelBuilder::build_layer(Layer* layer_out, const char* op_name, const Fingerprint& source, Direction ldir, double thickness, const std::function<void()>& kernel_op)
+{
+	// Rollback of a transaction resets the new layer to its current state
+	this->journal_layers(delamo::Span<Layer*>(&layer_out, 1));
+
+	// The layer fingerprint is derived from the fingerprint of the input
+	this->fingerprint_layer(layer_out, op_name, source, ldir, thickness);
+
+	// Restore the layer from the cache if it is generated before, otherwise create it
+	Layer* cached_layers[1] = { layer_out };
+	Fingerprint cache_key = source.valid() ? this->cache_key(cached_layers) : Fingerprint();
+	bool restored = this->restore_cached_layers(cache_key, cached_layers);
+	if (!restored)
+		kernel_op();
+
+	// Set a unique layer ID
+	layer_out->id(this->next_layer_id());
+
+	// Generate molds
+	this->generate_mold(layer_out);
+
+	// Update layer surface owners
+	layer_out->update_owners();
+
+	// Store the layer in the cache
+	if (!restored)
+		this->store_cached_layers(cache_key, cached_layers);
+}
+
+void ModelBuilder::build_interface(Layer* layer_orig, Layer* layer_offset, const char* op_name, delamo::Span<const std::string> file_names, const std::function<void()>& kernel_op)
+{
+	// Add the interface to the layer fingerprints
+	Layer* op_layers[2] = { layer_orig, layer_offset };
+	this->fingerprint_operation(op_layers, op_name, file_names);
+
+	// Restore the imprinted layers from the cache if the interface is generated before, otherwise imprint them
+	Fingerprint cache_key = this->cache_key(op_layers);
+	bool restored = this->restore_cached_layers(cache_key, op_layers);
+	if (!restored)
+		kernel_op();
+
+	// Set adjacent pairs
+	layer_offset->bond_pair(Direction::ORIG, layer_orig);
+	layer_orig->bond_pair(Direction::OFFSET, layer_offset);
+
+	this->initial_layer(layer_orig);
+
+	// Store the imprinted layers in the cache
+	if (!restored)
+		this->store_cached_layers(cache_key, op_layers);
+}
+
+void ModelBuilder::create_layer(delamo::NURBS<double> *nurbs_in, Direction ldir, double thickness, Layer *layer_out)
+{
+	// Finish the deferred operations on the output layer
+	const Layer* used_layers[1] = { layer_out };
+	this->sync_layers(used_layers);
+
+	auto lock = this->kernel_lock();
+
+	// Check whether the modeler is running or not
+	this->is_builder_started();
+
+	// Check whether thickness is positive or not
+	if (thickness <= 0)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Please provide a positive thickness!" << std::endl;
+		this->error_handler();
+	}
+
+	this->build_layer(layer_out, "create_layer_nurbs", this->fingerprint(nurbs_in), ldir, thickness, [&]() {
+		this->do_create_layer(nurbs_in, ldir, thickness, layer_out);
+	});
+}
+
+void ModelBuilder::create_layer(delamo::NURBS<double> *nurbs_surface_in, double thickness, Layer *layer_out)
+{
+	this->create_layer(nurbs_surface_in, Direction::OFFSET, thickness, layer_out);
+}
+
+void ModelBuilder::create_layer(Layer *layer_in, Direction ldir, double thickness, Layer *layer_out)
+{
+	// Finish the deferred operations on the input and output layers
+	const Layer* used_layers[2] = { layer_in, layer_out };
+	this->sync_layers(used_layers);
+
+	auto lock = this->kernel_lock();
+
+	// Check whether the modeler is running or not
+	this->is_builder_started();
+
+	// Check whether thickness is positive or not
+	if (thickness <= 0)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Please provide a positive thickness!" << std::endl;
+		this->error_handler();
+	}
+
+	// Check the input layer has a body or not
+	if (0 == layer_in->size())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Input layer is empty!" << std::endl;
+		this->error_handler();
+	}
+
+	this->build_layer(layer_out, "create_layer", this->mold_fingerprint(layer_in, ldir), ldir, thickness, [&]() {
+		this->do_create_layer(layer_in, ldir, thickness, layer_out);
+	});
+}
+
+void ModelBuilder::create_layer(LayerMold *mold_in, Direction ldir, double thickness, Layer *layer_out)
+{
+	// Finish the deferred operations on the layer of the mold and the output layer
+	const Layer* used_layers[2] = { mold_in->owner(), layer_out };
+	this->sync_layers(used_layers);
+
+	auto lock = this->kernel_lock();
+
+	// Check whether the modeler is running or not
+	this->is_builder_started();
+
+	// Check whether thickness is positive or not
+	if (thickness <= 0)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Please provide a positive thickness!" << std::endl;
+		this->error_handler();
+	}
+
+	// Check the input mold has a sheet body or not
+	if (mold_in->body() == nullptr)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Input mold is empty!" << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	this->build_layer(layer_out, "create_layer_mold", mold_in->fingerprint(), ldir, thickness, [&]() {
+		this->do_create_layer(mold_in, ldir, thickness, layer_out);
+	});
+}
+
+void ModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset)
+{
+	// Finish the deferred operations on the input layers
+	const Layer* used_layers[2] = { layer_orig, layer_offset };
+	this->sync_layers(used_layers);
+
+	auto lock = this->kernel_lock();
+
+	// Record the operation for the incremental rebuilds
+	Layer* op_layers[2] = { layer_orig, layer_offset };
+	if (this->record_operation([this](delamo::Span<Layer*> layers, delamo::Span<const std::string> files) { this->adjacent_layers(layers[0], layers[1]); }, op_layers, delamo::Span<const std::string>()))
+		return;
+
+	this->build_interface(layer_orig, layer_offset, "adjacent_layers", delamo::Span<const std::string>(), [&]() {
+		this->do_adjacent_layers(layer_orig, layer_offset);
+	});
+}
+
+void ModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name)
+{
+	// Finish the deferred operations on the input layers
+	const Layer* used_layers[2] = { layer_orig, layer_offset };
+	this->sync_layers(used_layers);
+
+	auto lock = this->kernel_lock();
+
+	// Record the operation for the incremental rebuilds
+	const std::string op_files[1] = { (file_name == nullptr) ? "" : file_name };
+	Layer* op_layers[2] = { layer_orig, layer_offset };
+	if (this->record_operation([this](delamo::Span<Layer*> layers, delamo::Span<const std::string> files) { this->adjacent_layers(layers[0], layers[1], files[0].c_str()); }, op_layers, op_files))
+		return;
+
+	this->build_interface(layer_orig, layer_offset, "adjacent_layers_file", op_files, [&]() {
+		this->do_adjacent_layers(layer_orig, layer_offset, file_name);
+	});
+}
+
+void ModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, delamo::List<std::string>& file_names)
+{
+	// Finish the deferred operations on the input layers
+	const Layer* used_layers[2] = { layer_orig, layer_offset };
+	this->sync_layers(used_layers);
+
+	auto lock = this->kernel_lock();
 
-	// Copy the FAL data to the output variables
-	fal_size = fal_container.size();
-	fal = new FaceAdjacency[fal_size];
-	int counter = 0;
-	for (auto fa_elem : fal_container)
-	{
-		fal[counter] = fa_elem;
-		counter++;
-	}
+	// Record the operation for the incremental rebuilds
+	Layer* op_layers[2] = { layer_orig, layer_offset };
+	auto op = [this](delamo::Span<Layer*> layers, delamo::Span<const std::string> files) {
+		delamo::List<std::string> op_files;
+		for (auto& file_name : files)
+			op_files.add(file_name);
+		this->adjacent_layers(layers[0], layers[1], op_files);
+	};
+	if (this->record_operation(op, op_layers, file_names))
+		return;
+
+	this->build_interface(layer_orig, layer_offset, "adjacent_layers_files", file_names, [&]() {
+		this->do_adjacent_layers(layer_orig, layer_offset, file_names);
+	});
+}
+
+void ModelBuilder::split_layer(Layer *layer_in, const char* file_name)
+{
+	// Finish the deferred operations on the input layer
+	const Layer* used_layers[1] = { layer_in };
+	this->sync_layers(used_layers);
+
+	auto lock = this->kernel_lock();
+
+	// Record the operation for the incremental rebuilds
+	const std::string op_files[1] = { (file_name == nullptr) ? "" : file_name };
+	if (this->record_operation([this](delamo::Span<Layer*> layers, delamo::Span<const std::string> files) { this->split_layer(layers[0], files[0].c_str()); }, delamo::Span<Layer*>(&layer_in, 1), op_files))
+		return;
+
+	this->fingerprint_operation(delamo::Span<Layer*>(&layer_in, 1), "split_layer", op_files);
+
+	this->do_split_layer(layer_in, file_name);
+}
+
+void ModelBuilder::create_hat_stiffener(Layer *layer_orig, Layer *stiffener, const char* file_name, double radius)
+{
+	// Finish the deferred operations on the input layers
+	const Layer* used_layers[2] = { layer_orig, stiffener };
+	this->sync_layers(used_layers);
+
+	auto lock = this->kernel_lock();
+
+	// Record the operation for the incremental rebuilds
+	Layer* op_layers[2] = { layer_orig, stiffener };
+	const std::string op_files[1] = { (file_name == nullptr) ? "" : file_name };
+	auto op = [this, radius](delamo::Span<Layer*> layers, delamo::Span<const std::string> files) {
+		this->create_hat_stiffener(layers[0], layers[1], files[0].c_str(), radius);
+	};
+	if (this->record_operation(op, op_layers, op_files))
+		return;
+
+	const double op_params[1] = { radius };
+	this->fingerprint_operation(op_layers, "create_hat_stiffener", op_files, op_params);
+
+	this->do_create_hat_stiffener(layer_orig, stiffener, file_name, radius);
 }
 
 void ModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, BCStatus delam_region_status, FaceAdjacency*& fal, int& fal_size)
 {
+	// Record the operation to be run by sync()
+	if (this->_bDeferred)
+	{
+		Layer* layers[2] = { layer_orig, layer_offset };
+		DeferredAdjacency* result = this->defer_adjacency_list(fal, fal_size);
+		this->_mTaskGraph.add([=]() {
+			this->adjacent_layers(layer_orig, layer_offset);
+			this->generate_adjacency_list(layer_orig, layer_offset, is_cohesive, delam_region_status, is_none, result->fal, result->fal_size);
+			this->record_adjacency_list(layer_orig, layer_offset, is_cohesive, delam_region_status, is_none, result->fal, result->fal_size);
+		}, delamo::Span<Layer*>(layers, 2));
+		return;
+	}
+
 	// Imprint layers to each other
 	this->adjacent_layers(layer_orig, layer_offset);
 
 	// Generate face adjacency list
 	this->generate_adjacency_list(layer_orig, layer_offset, is_cohesive, delam_region_status, is_none, fal, fal_size);
+	this->record_adjacency_list(layer_orig, layer_offset, is_cohesive, delam_region_status, is_none, fal, fal_size);
 }
 
 void ModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name, BCStatus delam_region_status, FaceAdjacency*& fal, int& fal_size)
 {
+	// Record the operation to be run by sync(), the file name is copied as the input string may not live until then
+	if (this->_bDeferred)
+	{
+		Layer* layers[2] = { layer_orig, layer_offset };
+		std::string file_name_str(file_name);
+		DeferredAdjacency* result = this->defer_adjacency_list(fal, fal_size);
+		this->_mTaskGraph.add([=]() {
+			this->adjacent_layers(layer_orig, layer_offset, file_name_str.c_str());
+			this->generate_adjacency_list(layer_orig, layer_offset, is_cohesive, delam_region_status, is_none, result->fal, result->fal_size);
+			this->record_adjacency_list(layer_orig, layer_offset, is_cohesive, delam_region_status, is_none, result->fal, result->fal_size);
+		}, delamo::Span<Layer*>(layers, 2));
+		return;
+	}
+
 	// Imprint delamination outline between the input layers
 	this->adjacent_layers(layer_orig, layer_offset, file_name);
 
 	// Generate face adjacency list
 	this->generate_adjacency_list(layer_orig, layer_offset, is_cohesive, delam_region_status, is_none, fal, fal_size);
+	this->record_adjacency_list(layer_orig, layer_offset, is_cohesive, delam_region_status, is_none, fal, fal_size);
 }
 
 void ModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, delamo::List<std::string> file_names, BCStatus default_status, BCStatus delam_region_status, BCStatus delam_ring_status,FaceAdjacency*& fal, int& fal_size)
 {
+	// Record the operation to be run by sync()
+	if (this->_bDeferred)
+	{
+		Layer* layers[2] = { layer_orig, layer_offset };
+		DeferredAdjacency* result = this->defer_adjacency_list(fal, fal_size);
+		this->_mTaskGraph.add([=]() {
+			delamo::List<std::string> file_names_copy(file_names);
+			this->adjacent_layers(layer_orig, layer_offset, file_names_copy);
+			this->generate_adjacency_list(layer_orig, layer_offset, default_status, delam_region_status, delam_ring_status, result->fal, result->fal_size);
+			this->record_adjacency_list(layer_orig, layer_offset, default_status, delam_region_status, delam_ring_status, result->fal, result->fal_size);
+		}, delamo::Span<Layer*>(layers, 2));
+		return;
+	}
+
 	// Imprint multiple delamination outlines between the input layers
 	this->adjacent_layers(layer_orig, layer_offset, file_names);
 
 	// Generate face adjacency list
 	this->generate_adjacency_list(layer_orig, layer_offset, default_status, delam_region_status, delam_ring_status, fal, fal_size);
+	this->record_adjacency_list(layer_orig, layer_offset, default_status, delam_region_status, delam_ring_status, fal, fal_size);
 }
 
 void ModelBuilder::save(const char* file_name)
 {
+	// Finish the deferred operations
+	this->sync();
+
 	// Check for empty file name
 	if (file_name == nullptr)
 	{
@@ -298,6 +2254,9 @@ void ModelBuilder::save(const char* file_name)
 
 void ModelBuilder::save(const char* file_name, delamo::List< std::string >& bodynames)
 {
+	// Finish the deferred operations
+	this->sync();
+
 	// Check for empty file name
 	if (file_name == nullptr)
 	{
@@ -327,6 +2286,9 @@ void ModelBuilder::save(const char* file_name, delamo::List< std::string >& body
 
 void ModelBuilder::save(const char* file_name, char**& bodynames, int& num_bodynames)
 {
+	// Finish the deferred operations
+	this->sync();
+
 	// Check for empty file name
 	if (file_name == nullptr)
 	{
@@ -366,6 +2328,9 @@ void ModelBuilder::save(const char* file_name, char**& bodynames, int& num_bodyn
 
 void ModelBuilder::save(const char* file_name, delamo::List<Layer*>& layer_list, delamo::List< std::string >& names_list)
 {
+	// Finish the deferred operations
+	this->sync();
+
 	// Fill up bodynames container with the saved layer body names
 	for (auto lyr : layer_list)
 	{
@@ -385,6 +2350,9 @@ void ModelBuilder::save(const char* file_name, delamo::List<Layer*>& layer_list,
 
 void ModelBuilder::save(const char* file_name, delamo::List<Layer*>& layer_list, delamo::List<MBBody*>& mbbody_list, delamo::List< std::string >& names_list)
 {
+	// Finish the deferred operations
+	this->sync();
+
 	// Fill up bodynames container with the saved layer body names
 	for (auto lyr : layer_list)
 	{
@@ -414,13 +2382,594 @@ void ModelBuilder::save(const char* file_name, delamo::List<Layer*>& layer_list,
 	this->save_cad_model(file_name, layer_list, mbbody_list);
 }
 
+// Quotes and escapes a string for the JSON manifest
+static std::string json_string(const char* str)
+{
+	std::ostringstream out;
+	out << '"';
+	for (const char* c = (str == nullptr) ? "" : str; *c != '\0'; c++)
+	{
+		if (*c == '"' || *c == '\\')
+			out << '\\' << *c;
+		else if ((unsigned char)*c < 0x20)
+			out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)(unsigned char)*c << std::dec;
+		else
+			out << *c;
+	}
+	out << '"';
+	return out.str();
+}
+
+int ModelBuilder::save_sharded(const char* manifest_file, int bodies_per_shard)
+{
+	// Finish the deferred operations
+	this->sync();
+
+	// Prepare the layers list
+	delamo::List<Layer*> layer_list;
+	this->prepare_layers(layer_list);
+
+	return this->save_sharded(manifest_file, layer_list, bodies_per_shard);
+}
+
+int ModelBuilder::save_sharded(const char* manifest_file, delamo::List<Layer*>& layer_list, int bodies_per_shard)
+{
+	// Finish the deferred operations
+	this->sync();
+
+	// Check for empty file name
+	if (manifest_file == nullptr)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: File name cannot be empty!" << std::endl;
+		this->error_handler();
+		return 0;
+	}
+
+	// Shards are saved next to the manifest, their names in the manifest are relative to it
+	std::string manifest_name(manifest_file);
+	size_t dir_end = manifest_name.find_last_of("/\\");
+	std::string dir_name = (dir_end == std::string::npos) ? "" : manifest_name.substr(0, dir_end + 1);
+	std::string stem = manifest_name.substr(dir_name.size());
+	size_t ext_begin = stem.find_last_of('.');
+	if (ext_begin != std::string::npos && ext_begin > 0)
+		stem = stem.substr(0, ext_begin);
+
+	struct Shard
+	{
+		int layer_idx;
+		std::string file_name;
+		std::vector<LayerBody*> bodies;
+		bool saved;
+	};
+	std::vector<Shard> shards;
+	std::unordered_map<Layer*, int> layer_index;
+	for (int l = 0; l < (int)layer_list.size(); l++)
+	{
+		Layer* layer = layer_list[l];
+		layer_index[layer] = l;
+		int shard_size = (bodies_per_shard > 0) ? bodies_per_shard : std::max(1, layer->size());
+		for (int first = 0; first < layer->size(); first += shard_size)
+		{
+			Shard shard;
+			shard.layer_idx = l;
+			shard.saved = false;
+			shard.file_name = stem + "." + std::to_string(shards.size()) + this->cad_file_extension();
+			int last = std::min(first + shard_size, layer->size());
+			for (int b = first; b < last; b++)
+				shard.bodies.push_back(layer->at(b));
+			shards.push_back(shard);
+		}
+	}
+
+	// Each thread saves its own shards, a kernel which is not thread-safe saves them in order
+	int num_shards = (int)shards.size();
+	int num_threads = this->thread_safe_modeling() ? this->_mTaskThreads : 1;
+	num_threads = std::max(1, std::min(num_threads, num_shards));
+	// An exception cannot leave a worker thread, the error of each shard is kept and rethrown on the calling thread
+	std::vector<std::exception_ptr> shard_errors(num_shards);
+	auto save_shards = [this, &shards, &shard_errors, &layer_list, &dir_name, num_threads](int first) {
+		for (int i = first; i < (int)shards.size(); i += num_threads)
+		{
+			Shard& shard = shards[i];
+			std::string file_name = dir_name + shard.file_name;
+			try
+			{
+				this->save_cad_shard(file_name.c_str(), layer_list[shard.layer_idx], delamo::Span<LayerBody*>(shard.bodies.data(), shard.bodies.size()));
+				shard.saved = true;
+			}
+			catch (...)
+			{
+				shard_errors[i] = std::current_exception();
+			}
+		}
+	};
+	if (num_threads == 1)
+	{
+		save_shards(0);
+	}
+	else
+	{
+		std::vector<std::thread> workers;
+		for (int t = 0; t < num_threads; t++)
+			workers.push_back(std::thread(save_shards, t));
+		for (auto& w : workers)
+			w.join();
+	}
+
+	// The manifest is not written if any of the shards is missing
+	for (int i = 0; i < num_shards; i++)
+	{
+		if (shards[i].saved)
+			continue;
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Unable to save the shard " << dir_name + shards[i].file_name << "!" << std::endl;
+		std::rethrow_exception(shard_errors[i]);
+	}
+
+	// Interfaces are the layer pairs with paired surfaces, listed with their paired bodies
+	std::map< std::pair<int, int>, std::map< std::pair<std::string, std::string>, int > > interfaces;
+	for (int l = 0; l < (int)layer_list.size(); l++)
+	{
+		for (auto lb : *layer_list[l])
+		{
+			for (auto ls : *lb)
+			{
+				LayerSurface* pair = ls->pair();
+				if (pair == nullptr || pair->owner() == nullptr)
+					continue;
+				auto found = layer_index.find(pair->owner()->owner());
+				if (found == layer_index.end() || found->second <= l)
+					continue;
+				interfaces[std::make_pair(l, found->second)][std::make_pair(std::string(lb->name()), std::string(pair->owner()->name()))]++;
+			}
+		}
+	}
+
+	std::ofstream manifest(manifest_file, std::ios::out | std::ios::trunc);
+	if (!manifest.good())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Unable to open file for writing!" << std::endl;
+		this->error_handler();
+		return 0;
+	}
+
+	manifest << "{" << std::endl;
+	manifest << "  \"format\": \"delamo-sharded-model\"," << std::endl;
+	manifest << "  \"version\": 1," << std::endl;
+	manifest << "  \"kernel\": " << json_string(this->cache_format()) << "," << std::endl;
+	manifest << "  \"shards\": [";
+	for (int i = 0; i < num_shards; i++)
+	{
+		manifest << ((i > 0) ? "," : "") << std::endl;
+		manifest << "    { \"index\": " << i << ", \"file\": " << json_string(shards[i].file_name.c_str()) << ", \"layer\": " << shards[i].layer_idx << ", \"bodies\": [";
+		for (int b = 0; b < (int)shards[i].bodies.size(); b++)
+			manifest << ((b > 0) ? ", " : "") << json_string(shards[i].bodies[b]->name());
+		manifest << "] }";
+	}
+	manifest << std::endl << "  ]," << std::endl;
+	manifest << "  \"layers\": [";
+	for (int l = 0; l < (int)layer_list.size(); l++)
+	{
+		Layer* layer = layer_list[l];
+		manifest << ((l > 0) ? "," : "") << std::endl;
+		manifest << "    { \"index\": " << l << ", \"id\": " << layer->id() << ", \"name\": " << json_string(layer->name()) << ", \"fingerprint\": " << json_string(layer->fingerprint().hex().c_str()) << ", \"shards\": [";
+		bool first = true;
+		for (int i = 0; i < num_shards; i++)
+		{
+			if (shards[i].layer_idx != l)
+				continue;
+			manifest << (first ? "" : ", ") << i;
+			first = false;
+		}
+		manifest << "] }";
+	}
+	manifest << std::endl << "  ]," << std::endl;
+	manifest << "  \"interfaces\": [";
+	bool first_interface = true;
+	for (auto& itf : interfaces)
+	{
+		manifest << (first_interface ? "" : ",") << std::endl;
+		manifest << "    { \"layers\": [" << itf.first.first << ", " << itf.first.second << "], \"body_pairs\": [";
+		bool first_pair = true;
+		for (auto& bp : itf.second)
+		{
+			manifest << (first_pair ? "" : ", ") << "{ \"name1\": " << json_string(bp.first.first.c_str()) << ", \"name2\": " << json_string(bp.first.second.c_str()) << ", \"faces\": " << bp.second << " }";
+			first_pair = false;
+		}
+		manifest << "] }";
+		first_interface = false;
+	}
+	manifest << std::endl << "  ]" << std::endl;
+	manifest << "}" << std::endl;
+	manifest.close();
+	if (!manifest)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Unable to write the manifest " << manifest_file << "!" << std::endl;
+		this->error_handler();
+		return 0;
+	}
+
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO)
+		std::cout << "SUCCESS: Saved " << num_shards << " shards with the manifest " << manifest_file << std::endl;
+	return num_shards;
+}
+
+void ModelBuilder::checkpoint(const char* file_name)
+{
+	this->sync();
+	if (this->_pInitialLayer == nullptr)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: There are no bonded layers to be saved in the checkpoint!" << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	delamo::List<Layer*> layer_list;
+	this->prepare_layers(layer_list);
+	this->checkpoint(file_name, layer_list);
+}
+
+void ModelBuilder::checkpoint(const char* file_name, delamo::Span<Layer*> layers)
+{
+	// Pending operations modify the layers
+	this->sync();
+	if (this->cache_format() == nullptr)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: The solid modeling kernel does not support checkpoints!" << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	// Layers and molds are referred by their indices in the checkpoint. The LayerBody objects keep copies of their
+	// molds, so the molds are identified by their bodies.
+	std::unordered_map<Layer*, int> layer_index;
+	std::unordered_map<DLM_BODYP, std::array<int, 2>> mold_index;
+	for (int l = 0; l < (int)layers.size(); l++)
+	{
+		layer_index[layers[l]] = l;
+		for (int m = 0; m < layers[l]->size_mold(); m++)
+			mold_index.insert(std::make_pair(layers[l]->list_mold()[m]->body(), std::array<int, 2>{ { l, m } }));
+	}
+	auto layer_ref = [&layer_index](Layer* layer) {
+		auto found = layer_index.find(layer);
+		return (found == layer_index.end()) ? -1 : found->second;
+	};
+	auto write_mold_ref = [&mold_index](CacheWriter& writer, LayerMold* lm) {
+		auto found = (lm == nullptr) ? mold_index.end() : mold_index.find(lm->body());
+		std::array<int, 2> ref = (found == mold_index.end()) ? std::array<int, 2>{ { -1, -1 } } : found->second;
+		writer.write(ref[0]);
+		writer.write(ref[1]);
+	};
+
+	CacheWriter writer;
+	writer.write_string(this->cache_format());
+	writer.write(this->_mLayerID);
+	writer.write(layer_ref(this->_pInitialLayer));
+	writer.write((int)layers.size());
+	bool saved = true;
+	for (auto layer : layers)
+	{
+		writer.write_string((layer->name() == nullptr) ? "" : layer->name());
+		writer.write(layer->id());
+		writer.write(layer->layup());
+		writer.write(layer->fingerprint());
+		writer.write(layer_ref(layer->bond_pair(Direction::ORIG)));
+		writer.write(layer_ref(layer->bond_pair(Direction::OFFSET)));
+
+		writer.write(layer->size_mold());
+		for (int m = 0; m < layer->size_mold(); m++)
+		{
+			LayerMold* lm = layer->list_mold()[m];
+			std::string kernel_blob;
+			saved = saved && this->save_cache_mold(lm, kernel_blob);
+			writer.write((int)lm->direction());
+			writer.write_string((lm->name() == nullptr) ? "" : lm->name());
+			writer.write(lm->is_stiffener_gen() ? 1 : 0);
+			writer.write(lm->fingerprint());
+			writer.write_string(kernel_blob);
+		}
+		write_mold_ref(writer, layer->delam_profile_ref());
+
+		writer.write(layer->size());
+		for (auto lb : *layer)
+			write_mold_ref(writer, lb->mold());
+	}
+
+	// Bodies, surfaces and the references between them
+	std::string layers_blob;
+	saved = saved && this->encode_layers(layers, layers_blob, false);
+	writer.write_string(layers_blob);
+	if (!saved)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Cannot serialize the layers for the checkpoint!" << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	std::ofstream output(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!output.is_open())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Unable to open checkpoint file: " << file_name << std::endl;
+		this->error_handler();
+		return;
+	}
+	output.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+	output.write(writer.buffer().data(), (std::streamsize)writer.buffer().size());
+	output.close();
+	if (!output)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Unable to write checkpoint file: " << file_name << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO)
+		std::cout << "INFO: Saved " << layers.size() << " layers to the checkpoint " << file_name << std::endl;
+}
+
+void ModelBuilder::restore(const char* file_name, delamo::List<Layer*>& layers_out)
+{
+	this->sync();
+
+	// Read the whole file
+	std::string contents;
+	std::ifstream input(file_name, std::ios::in | std::ios::binary);
+	if (input.is_open())
+	{
+		std::ostringstream buffer;
+		buffer << input.rdbuf();
+		contents = buffer.str();
+	}
+	if (contents.size() < sizeof(CHECKPOINT_MAGIC) || std::memcmp(contents.data(), CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Unable to read checkpoint file: " << file_name << std::endl;
+		this->error_handler();
+		return;
+	}
+	contents.erase(0, sizeof(CHECKPOINT_MAGIC));
+
+	// Parse all records before creating any objects
+	CacheReader reader(contents);
+	std::string format;
+	int layer_id = 0, initial_idx = -1, num_layers = 0;
+	reader.read_string(format);
+	reader.read(layer_id);
+	reader.read(initial_idx);
+	reader.read(num_layers);
+	if (!reader.good() || format != ((this->cache_format() == nullptr) ? "" : this->cache_format()) || num_layers < 0)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: The checkpoint is saved by another solid modeling kernel: " << file_name << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	std::vector<CheckpointLayer> saved_layers(num_layers);
+	for (auto& cl : saved_layers)
+	{
+		int num_molds = 0, num_bodies = 0;
+		reader.read_string(cl.name);
+		reader.read(cl.id);
+		reader.read(cl.layup);
+		reader.read(cl.fingerprint);
+		reader.read(cl.bond_pair[0]);
+		reader.read(cl.bond_pair[1]);
+		reader.read(num_molds);
+		for (int m = 0; reader.good() && m < num_molds; m++)
+		{
+			CheckpointMold cm;
+			reader.read(cm.direction);
+			reader.read_string(cm.name);
+			reader.read(cm.stiffener_gen);
+			reader.read(cm.fingerprint);
+			reader.read_string(cm.kernel_blob);
+			cl.molds.push_back(cm);
+		}
+		reader.read(cl.delam_profile_ref[0]);
+		reader.read(cl.delam_profile_ref[1]);
+		reader.read(num_bodies);
+		for (int b = 0; reader.good() && b < num_bodies; b++)
+		{
+			std::array<int, 2> ref{ { -1, -1 } };
+			reader.read(ref[0]);
+			reader.read(ref[1]);
+			cl.body_molds.push_back(ref);
+		}
+	}
+	std::string layers_blob;
+	reader.read_string(layers_blob);
+	if (!reader.good())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: The checkpoint file is truncated: " << file_name << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	// Create the layers and their molds
+	std::vector<Layer*> layers(num_layers);
+	std::vector< std::vector<LayerMold*> > molds(num_layers);
+	auto discard_layers = [&]() {
+		// Releases the objects created before a failure, nothing else refers to them yet
+		for (int l = 0; l < num_layers; l++)
+		{
+			if (layers[l] == nullptr)
+				continue;
+			for (auto lb : *layers[l])
+			{
+				for (auto ls : *lb)
+				{
+					std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+					this->_mHandles.remove(ls);
+					this->_mSurfacePool.destroy(ls);
+				}
+				this->release_cache_body(lb);
+				std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+				this->_mBodyPool.destroy(lb);
+			}
+			for (auto lm : molds[l])
+			{
+				this->release_cache_mold(lm);
+				this->delete_layer_mold(lm);
+			}
+			layers[l]->clear();
+			layers[l]->clear_mold();
+			std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+			this->_mLayerPool.destroy(layers[l]);
+		}
+	};
+	for (int l = 0; l < num_layers; l++)
+	{
+		CheckpointLayer& cl = saved_layers[l];
+		{
+			std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+			layers[l] = this->_mLayerPool.create();
+		}
+		layers[l]->name(cl.name.c_str());
+		layers[l]->id(cl.id);
+		layers[l]->layup(cl.layup);
+
+		for (auto& cm : cl.molds)
+		{
+			LayerMold* lm = this->new_layer_mold();
+			if (!this->restore_cache_mold(lm, cm.kernel_blob))
+			{
+				this->release_cache_mold(lm);
+				this->delete_layer_mold(lm);
+				discard_layers();
+				if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+					std::cout << "ERROR: Cannot restore the molds of the layer " << cl.name << std::endl;
+				this->error_handler();
+				return;
+			}
+			lm->direction((Direction)cm.direction);
+			lm->name(cm.name.c_str());
+			lm->stiffener_gen(cm.stiffener_gen != 0);
+			lm->fingerprint(cm.fingerprint);
+			lm->owner(layers[l]);
+			layers[l]->add_mold(lm);
+			molds[l].push_back(lm);
+		}
+	}
+	auto resolve_layer = [&layers](int idx) -> Layer* {
+		return (idx < 0 || idx >= (int)layers.size()) ? nullptr : layers[idx];
+	};
+	auto resolve_mold = [&molds](const std::array<int, 2>& ref) -> LayerMold* {
+		if (ref[0] < 0 || ref[0] >= (int)molds.size() || ref[1] < 0 || ref[1] >= (int)molds[ref[0]].size())
+			return nullptr;
+		return molds[ref[0]][ref[1]];
+	};
+
+	// Bodies and surfaces are restored in one pass, so that the surface pairs between the layers are resolved
+	delamo::List<LayerSurface*> dropped;
+	bool decoded = false;
+	try
+	{
+		decoded = this->decode_layers(layers_blob, delamo::Span<Layer*>(layers.data(), layers.size()), false, dropped);
+	}
+	catch (...)
+	{
+		discard_layers();
+		throw;
+	}
+	if (!decoded)
+	{
+		discard_layers();
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Cannot restore the layers from the checkpoint file: " << file_name << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	layers_out.clear();
+	for (int l = 0; l < num_layers; l++)
+	{
+		CheckpointLayer& cl = saved_layers[l];
+		Layer* layer = layers[l];
+		layer->bond_pair(Direction::ORIG, resolve_layer(cl.bond_pair[0]));
+		layer->bond_pair(Direction::OFFSET, resolve_layer(cl.bond_pair[1]));
+		layer->delam_profile_ref(resolve_mold(cl.delam_profile_ref));
+		for (int b = 0; b < layer->size() && b < (int)cl.body_molds.size(); b++)
+		{
+			LayerMold* lm = resolve_mold(cl.body_molds[b]);
+			if (lm != nullptr)
+				layer->at(b)->mold(lm);
+		}
+		layer->fingerprint(cl.fingerprint);
+		layers_out.add(layer);
+	}
+
+	// Continue the session from the saved state
+	{
+		std::lock_guard<std::mutex> lock(this->_mObjectMutex);
+		if (resolve_layer(initial_idx) != nullptr)
+			this->_pInitialLayer = resolve_layer(initial_idx);
+	}
+	this->_mLayerID = std::max(this->_mLayerID, layer_id);
+
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO)
+		std::cout << "INFO: Restored " << num_layers << " layers from the checkpoint " << file_name << std::endl;
+}
+
+Fingerprint ModelBuilder::fingerprint(delamo::NURBS<double>* nurbs)
+{
+	FingerprintBuilder fp;
+	fp.add(nurbs, this->_mDelta);
+	return fp.value();
+}
+
+Fingerprint ModelBuilder::fingerprint(LayerMold* mold)
+{
+	return mold->fingerprint();
+}
+
+Fingerprint ModelBuilder::fingerprint(Layer* layer)
+{
+	// Pending operations modify the layer
+	this->sync();
+	return layer->fingerprint();
+}
+
+Fingerprint ModelBuilder::fingerprint(delamo::Span<Layer*> layers)
+{
+	this->sync();
+	FingerprintBuilder fp;
+	fp.add("model");
+	fp.add((int)layers.size());
+	for (auto layer : layers)
+		fp.add(layer->fingerprint());
+	return fp.value();
+}
+
 void ModelBuilder::load_molds(const char* file_name, delamo::List<LayerMold*>& lm_list)
 {
 	// Currently, we only use SAT files
 	bool text_mode = true;
 
 	// Load CAD model from the file
+	int first_mold = (int)lm_list.size();
 	this->load_cad_model(file_name, text_mode, lm_list);
+
+	// Loaded molds are identified by the file contents and their order in the file
+	FingerprintBuilder file_fp;
+	file_fp.add("load_molds");
+	file_fp.add_file(file_name);
+	for (int i = first_mold; i < (int)lm_list.size(); i++)
+	{
+		FingerprintBuilder fp;
+		fp.add(file_fp.value());
+		fp.add(i - first_mold);
+		lm_list[i]->fingerprint(fp.value());
+	}
 }
 
 void ModelBuilder::create_shell_cutout(const char* file_name, delamo::List<LayerMold*>& lm_list)
@@ -450,6 +2999,58 @@ void ModelBuilder::load_shell_model(LayerMold *lm, delamo::List<delamo::TPoint3<
 	this->load_shell_sat_model(lm, point_list, tangent_list, normal_list);
 }
 
+void ModelBuilder::find_closest_points(delamo::Span<Layer*> layer_list, delamo::TPoint3<double> point_in, delamo::List< delamo::TPoint3<double> >& point_list, delamo::List< delamo::TPoint3<double> >& normal_list, delamo::List< std::string >& name_list)
+{
+	delamo::TPoint3<double>* points = nullptr;
+	delamo::TPoint3<double>* normals = nullptr;
+	char** names = nullptr;
+	int list_size = 0;
+
+	// The queries need the imprinted faces
+	this->sync();
+	this->find_closest_points(layer_list.data(), (int)layer_list.size(), point_in, points, normals, names, list_size);
+
+	// Move the results into the output containers and free the arrays allocated by the kernel implementation
+	point_list = delamo::List< delamo::TPoint3<double> >(delamo::Span<const delamo::TPoint3<double>>(points, list_size));
+	normal_list = delamo::List< delamo::TPoint3<double> >(delamo::Span<const delamo::TPoint3<double>>(normals, list_size));
+	name_list.clear();
+	for (int i = 0; i < list_size; i++)
+	{
+		name_list.push_back(std::string(names[i]));
+		// C-style strings can only be deleted by free
+		free(names[i]);
+	}
+	delete[] points;
+	delete[] normals;
+	delete[] names;
+}
+
+void ModelBuilder::find_closest_faces_to_points(delamo::Span<Layer*> layer_list, delamo::Span<delamo::TPoint3<double>> points_in, delamo::List< delamo::TPoint3<double> >& point_list, delamo::List< delamo::TPoint3<double> >& normal_list, delamo::List< std::string >& name_list)
+{
+	delamo::TPoint3<double>* points = nullptr;
+	delamo::TPoint3<double>* normals = nullptr;
+	char** names = nullptr;
+	int list_size = 0;
+
+	// The queries need the imprinted faces
+	this->sync();
+	this->find_closest_faces_to_points(layer_list.data(), (int)layer_list.size(), points_in.data(), (int)points_in.size(), points, normals, names, list_size);
+
+	// Move the results into the output containers and free the arrays allocated by the kernel implementation
+	point_list = delamo::List< delamo::TPoint3<double> >(delamo::Span<const delamo::TPoint3<double>>(points, list_size));
+	normal_list = delamo::List< delamo::TPoint3<double> >(delamo::Span<const delamo::TPoint3<double>>(normals, list_size));
+	name_list.clear();
+	for (int i = 0; i < list_size; i++)
+	{
+		name_list.push_back(std::string(names[i]));
+		// C-style strings can only be deleted by free
+		free(names[i]);
+	}
+	delete[] points;
+	delete[] normals;
+	delete[] names;
+}
+
 void ModelBuilder::offset_distance(double val)
 {
 	this->_mOffsetDistance = val;
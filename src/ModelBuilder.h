@@ -3,8 +3,18 @@
 
 #include "APIConfig.h"
 #include "Layer.h"
+#ifdef ACISOBJ
 #include "PNFind_ABS.h"
+#endif
 #include "mb_utilities.h"
+#include "ObjectPool.h"
+#include "HandleTable.h"
+#include "TaskGraph.h"
+#include "LayerCache.h"
+#include "OperationGraph.h"
+#include "LayerJournal.h"
+#include <mutex>
+#include <atomic>
 
 // Export file is generated by CMake's GenerateExportHeader module
 #include "modelbuilder_export.h"
@@ -54,7 +64,7 @@ public:
 	/**
 	 * \brief Default destructor
 	 */
-	~ModelBuilder();
+	virtual ~ModelBuilder();
 
 	/**
 	 * \brief Wrapper function for ModelBuilder::start()
@@ -79,6 +89,27 @@ public:
 	 */
 	double offset_distance();
 
+	/**
+	 * \brief Returns the number of body imprints skipped because the bodies are not touching each other
+	 * \return number of skipped imprints
+	 */
+	int skipped_imprints();
+
+	/**
+	 * \brief Enables or disables batch processing of multiple delamination profiles
+	 *
+	 * In batch mode, all delamination profiles of an interface are read up front and the profiles which do not overlap
+	 * each other are imprinted together.
+	 * \param flag TRUE enables batch processing
+	 */
+	void batch_delaminations(bool flag);
+
+	/**
+	 * \brief Returns whether multiple delamination profiles are processed in batch mode or not
+	 * \return TRUE if batch processing is enabled, otherwise FALSE
+	 */
+	bool batch_delaminations();
+
 	/**
 	 * \brief Sets the license key (where necessary)
 	 * \param key license key as a string
@@ -87,55 +118,68 @@ public:
 
 	/**
 	 * \brief Virtual function for initializing the modeler engine
+	 *
+	 * Each instance keeps its own layers and session state, so separate instances can be used from separate threads.
+	 * A kernel which is not thread-safe is started once per process and runs the operations of the instances one at a
+	 * time. This is the case for ACIS: all ACISModelBuilder instances share a single kernel lock, so model variants
+	 * built on separate threads are not built in parallel, only their calls are interleaved. Calling start() again on
+	 * a started instance has no effect.
 	 */
 	virtual void start() = 0;
 
 	/**
 	 * \brief Virtual function for stopping the modeler engine
+	 *
+	 * A kernel shared by multiple instances is stopped with the last instance.
 	 */
 	virtual void stop() = 0;
 
 	/**
-	 * \brief Virtual function for creating a new layer from a NURBS surface
+	 * \brief Creates a new layer from a NURBS surface
+	 *
+	 * The layer operations journal, fingerprint and cache the layers here, the kernel only generates the geometry.
 	 * \param[in] nurbs_surface_in input NURBS surface to be used as a mold for the new layer
 	 * \param[in] ldir the layer direction in which the mold will be offset
 	 * \param[in] thickness the layer thickness
 	 * \param[out] layer_out new layer generated from the input NURBS surface
 	 */
-	virtual void create_layer(delamo::NURBS<double> *nurbs_surface_in, Direction ldir, double thickness, Layer *layer_out) = 0;
+	void create_layer(delamo::NURBS<double> *nurbs_surface_in, Direction ldir, double thickness, Layer *layer_out);
 
 	/**
-	 * \brief Virtual function for creating a new layer from a NURBS surface in the OFFSET direction
+	 * \brief Creates a new layer from a NURBS surface in the OFFSET direction
 	 * \param[in] nurbs_surface_in input NURBS surface to be used as a mold for the new layer
 	 * \param[in] thickness the layer thickness
 	 * \param[out] layer_out new layer generated from the input NURBS surface
 	 */
-	virtual void create_layer(delamo::NURBS<double> *nurbs_surface_in, double thickness, Layer *layer_out) = 0;
+	void create_layer(delamo::NURBS<double> *nurbs_surface_in, double thickness, Layer *layer_out);
 	
 	/**
-	 * \brief Virtual function for creating a new layer from the original or offset surface of the provided layer
+	 * \brief Creates a new layer from the original or offset surface of the provided layer
 	 * \param[in] layer_in input layer to be used as a mold
 	 * \param[in] ldir the layer direction in which the mold will be offset
 	 * \param[in] thickness the layer thickness
 	 * \param[out] layer_out the new layer
 	 */
-	virtual void create_layer(Layer *layer_in, Direction ldir, double thickness, Layer *layer_out) = 0;
+	void create_layer(Layer *layer_in, Direction ldir, double thickness, Layer *layer_out);
 
 	/**
-	 * \brief Virtual function for creating a new layer from a LayerMold object
+	 * \brief Creates a new layer from a LayerMold object
+	 *
+	 * The mold can be generated by another instance of the same kernel. It is only read, so it can be shared by the
+	 * instances running on separate threads, but its instance should not be stopped before the others.
 	 * \param[in] mold_in input mold
 	 * \param[in] ldir the layer direction in which the mold will be offset
 	 * \param[in] thickness layer thickness
 	 * \param[out] layer_out the new layer
 	 */
-	virtual void create_layer(LayerMold *mold_in, Direction ldir, double thickness, Layer *layer_out) = 0;
+	void create_layer(LayerMold *mold_in, Direction ldir, double thickness, Layer *layer_out);
 
 	/**
 	 * \brief Imprints the the adjacent faces of the input layers to each other
 	 * \param layer_orig layer on the ORIG side
 	 * \param layer_offset layer on the OFFSET side
 	 */
-	virtual void adjacent_layers(Layer *layer_orig, Layer *layer_offset) = 0;
+	void adjacent_layers(Layer *layer_orig, Layer *layer_offset);
 
 	/**
 	 * \brief Imprints delamination profile to the input layers
@@ -143,7 +187,7 @@ public:
 	 * \param[in] layer_offset layer on the OFFSET side
 	 * \param[in] file_name CSV file containing the outer delamination profile
 	 */
-	virtual void adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name) = 0;
+	void adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name);
 
 	/**
 	 * \brief Imprints multiple delamination profiles to the input layers
@@ -151,10 +195,13 @@ public:
 	 * \param[in] layer_offset layer on the OFFSET side
 	 * \param[in] file_names a list of CSV files containing the outer delamination profile
 	 */
-	virtual void adjacent_layers(Layer *layer_orig, Layer *layer_offset, delamo::List< std::string > &file_names) = 0;
+	void adjacent_layers(Layer *layer_orig, Layer *layer_offset, delamo::List< std::string > &file_names);
 
 	/**
 	 * \brief Imprints the the adjacent faces of the input layers to each other and generates a face adjacency list
+	 *
+	 * In deferred mode, the operation is recorded, the outputs are set to an empty list and the face adjacency list is
+	 * kept by the ModelBuilder until it is collected by deferred_result().
 	 * \param[in] layer_orig layer on the ORIG side
 	 * \param[in] layer_offset layer on the OFFSET side
 	 * \param[out] fal the face adjacency list
@@ -165,6 +212,9 @@ public:
 
 	/**
 	 * \brief Imprints delamination profile to the input layers and generates a face adjacency list
+	 *
+	 * In deferred mode, the operation is recorded, the outputs are set to an empty list and the face adjacency list is
+	 * kept by the ModelBuilder until it is collected by deferred_result().
 	 * \param[in] layer_orig layer on the ORIG side
 	 * \param[in] layer_offset layer on the OFFSET side
 	 * \param[in] file_name CSV file containing the outer delamination profile
@@ -176,6 +226,9 @@ public:
 
 	/**
 	 * \brief Imprints multiple delamination profiles to the input layers and generates a face adjacency list
+	 *
+	 * In deferred mode, the operation is recorded, the outputs are set to an empty list and the face adjacency list is
+	 * kept by the ModelBuilder until it is collected by deferred_result().
 	 * \param[in] layer_orig layer on the ORIG side
 	 * \param[in] layer_offset layer on the OFFSET side
 	 * \param[in] file_names a list of CSV files containing the outer delamination profile
@@ -185,6 +238,22 @@ public:
 	 */
 	void adjacent_layers(Layer * layer_orig, Layer *layer_offset, delamo::List< std::string > file_names, BCStatus default_status, BCStatus delam_region_status, BCStatus delam_ring_status,FaceAdjacency*& fal, int& fal_size);
 
+	/**
+	 * \brief Generates all plies of a laminate and the face adjacency lists of the interfaces between them.
+	 *
+	 * The first ply is created on the mold and each following ply on the previous one. The delamination outline files
+	 * are read once for the whole laminate and the interfaces with multiple delaminations are processed in batch mode.
+	 * The operations run immediately, also in deferred mode. The layers are owned by the ModelBuilder and the face
+	 * adjacency lists should be deleted by the caller.
+	 * The Python wrapper returns the plies and the face adjacency lists in the format of adjacent_layers() and deletes
+	 * the lists.
+	 * \param[in] spec layup specification of the laminate
+	 * \param[out] layers_out generated plies
+	 * \param[out] fal_out face adjacency lists of the interfaces
+	 * \param[out] fal_size_out sizes of the face adjacency lists
+	 */
+	void build_laminate(const LaminateSpec& spec, delamo::List<Layer*>& layers_out, delamo::List<FaceAdjacency*>& fal_out, delamo::List<int>& fal_size_out);
+
 	/**
 	 * \brief Saves the CAD model
 	 * \param file_name file name to save
@@ -223,6 +292,92 @@ public:
 	*/
 	void save(const char* file_name, delamo::List<Layer*>& layer_list, delamo::List<MBBody*>& mbbody_list, delamo::List< std::string >& names_list);
 
+	/**
+	 * \brief Saves the layers of the session as separate shard files with a JSON manifest
+	 * \param manifest_file name of the JSON manifest file
+	 * \param bodies_per_shard maximum number of layer bodies in a shard, 0 for one shard per layer
+	 * \return number of saved shards
+	 */
+	int save_sharded(const char* manifest_file, int bodies_per_shard = 0);
+
+	/**
+	 * \brief Saves the layers as separate shard files with a JSON manifest
+	 *
+	 * Each shard contains the bodies of a single layer, so the downstream readers can load the shards they need in
+	 * parallel. The shards are named after the manifest file, e.g. model.json is saved with model.0.sat, model.1.sat,
+	 * etc., and they are written concurrently if the solid modeling kernel is thread-safe. The manifest lists the
+	 * shards with their body names, the layers with their IDs and fingerprints, and the paired body names of each
+	 * interface, i.e. the bodies referred by its face adjacency list.
+	 * \param manifest_file name of the JSON manifest file
+	 * \param layer_list list of layers to be saved
+	 * \param bodies_per_shard maximum number of layer bodies in a shard, 0 for one shard per layer
+	 * \return number of saved shards
+	 */
+	int save_sharded(const char* manifest_file, delamo::List<Layer*>& layer_list, int bodies_per_shard = 0);
+
+	/**
+	 * \brief Saves the layers of the session to a binary checkpoint file
+	 *
+	 * The layers bonded to the initial layer are saved with their bodies, surfaces, surface pairs, bond pairs and
+	 * molds. The solid bodies are embedded in the format of the solid modeling kernel.
+	 * \param file_name name of the checkpoint file
+	 */
+	void checkpoint(const char* file_name);
+
+	/**
+	 * \brief Saves the input layers to a binary checkpoint file
+	 *
+	 * The references to the layers which are not in the input list are not saved.
+	 * \param file_name name of the checkpoint file
+	 * \param layers layers to be saved
+	 */
+	void checkpoint(const char* file_name, delamo::Span<Layer*> layers);
+
+	/**
+	 * \brief Restores the layers saved by checkpoint()
+	 *
+	 * The layers are owned by the ModelBuilder and the saved initial layer becomes the initial layer of the session.
+	 * The checkpoint should be saved by a ModelBuilder with the same solid modeling kernel.
+	 * \param[in] file_name name of the checkpoint file
+	 * \param[out] layers_out restored layers in the saved order
+	 */
+	void restore(const char* file_name, delamo::List<Layer*>& layers_out);
+
+	/**
+	 * \brief Computes the fingerprint of a NURBS surface
+	 *
+	 * The control points are rounded to the tolerance, so the surfaces which differ only by round-off have the same
+	 * fingerprint.
+	 * \param nurbs input NURBS surface
+	 * \return fingerprint of the surface
+	 */
+	Fingerprint fingerprint(delamo::NURBS<double>* nurbs);
+
+	/**
+	 * \brief Returns the fingerprint of a LayerMold
+	 * \param mold input LayerMold
+	 * \return fingerprint of the mold, null if the mold is not generated by the ModelBuilder
+	 */
+	Fingerprint fingerprint(LayerMold* mold);
+
+	/**
+	 * \brief Returns the fingerprint of a Layer
+	 *
+	 * The fingerprint covers the mold, thickness and direction of the layer and the operations applied to it, so two
+	 * layers with the same fingerprint have identical geometries. The layers which are not modified by rebuild() keep
+	 * their fingerprints, even if the fingerprints of their neighbors change.
+	 * \param layer input Layer
+	 * \return fingerprint of the layer, null if the layer is not generated by the ModelBuilder
+	 */
+	Fingerprint fingerprint(Layer* layer);
+
+	/**
+	 * \brief Computes the fingerprint of a model from the fingerprints of its layers
+	 * \param layers layers of the model in the stacking order
+	 * \return fingerprint of the model
+	 */
+	Fingerprint fingerprint(delamo::Span<Layer*> layers);
+
 	/**
 	 * \brief Loads the CAD model with sheet bodies and converts them into LayerMold objects
 	 * \param[in] file_name name of the CAD model file
@@ -275,6 +430,19 @@ public:
 	 */
 	virtual void find_closest_points(Layer** layer_list, int layer_list_size, delamo::TPoint3<double> point_in, delamo::TPoint3<double>*& point_list, delamo::TPoint3<double>*& normal_list, char**& name_list, int& list_size) = 0;
 
+	/**
+	 * \brief Finds the closest points and normal at this points for the input layers to use with SIMULIA Abaqus FEA
+	 *
+	 * Same as the pointer array version, but the layers are passed as a view and the results are returned in containers which own them.
+	 *
+	 * \param[in] layer_list view of the layers
+	 * \param[in] point_in reference point
+	 * \param[out] point_list list of points
+	 * \param[out] normal_list list of normals
+	 * \param[out] name_list list of layer body names
+	 */
+	void find_closest_points(delamo::Span<Layer*> layer_list, delamo::TPoint3<double> point_in, delamo::List< delamo::TPoint3<double> >& point_list, delamo::List< delamo::TPoint3<double> >& normal_list, delamo::List< std::string >& name_list);
+
 	/**
 	 * \brief Finds the closest point and normal at this point for the input layer to use with SIMULIA Abaqus FEA
 	 *
@@ -290,6 +458,229 @@ public:
 	 */
 	virtual void find_closest_face_to_point(Layer *layer_in, delamo::TPoint3<double> point_in, delamo::TPoint3<double>& point_out, delamo::TPoint3<double>& normal_out, char*& name_out) = 0;
 
+	/**
+	 * \brief Finds the closest points and normals on the faces of the input layers for a batch of query points
+	 *
+	 * A bounding volume hierarchy is built over all faces of the input layers once and it is reused for all query points.
+	 * The function initializes the point, normal and name list pointer arrays, but leaves the memory deallocation to the user.
+	 *
+	 * \note
+	 * This function has a typemap which converts the special objects to native Python lists. The function and the return signature change to
+	 *	>> point_list, normal_list, name_list = acis.find_closest_faces_to_points([list of layers], [[x1, y1, z1], [x2, y2, z2], ...]);
+	 *
+	 * \param[in] layer_list list of layers
+	 * \param[in] layer_list_size size of the layer list
+	 * \param[in] points_in list of query points
+	 * \param[in] points_in_size size of the query point list
+	 * \param[out] point_list list of the closest points, one for each query point
+	 * \param[out] normal_list list of the face normals at the closest points
+	 * \param[out] name_list list of layer body names
+	 * \param[out] list_size size of the point, normal and name lists
+	 */
+	virtual void find_closest_faces_to_points(Layer** layer_list, int layer_list_size, delamo::TPoint3<double>* points_in, int points_in_size, delamo::TPoint3<double>*& point_list, delamo::TPoint3<double>*& normal_list, char**& name_list, int& list_size) = 0;
+
+	/**
+	 * \brief Finds the closest points and normals on the faces of the input layers for a batch of query points
+	 *
+	 * Same as the pointer array version, but the inputs are passed as views and the results are returned in containers which own them.
+	 *
+	 * \param[in] layer_list view of the layers
+	 * \param[in] points_in view of the query points
+	 * \param[out] point_list list of the closest points
+	 * \param[out] normal_list list of the face normals at the closest points
+	 * \param[out] name_list list of layer body names
+	 */
+	void find_closest_faces_to_points(delamo::Span<Layer*> layer_list, delamo::Span<delamo::TPoint3<double>> points_in, delamo::List< delamo::TPoint3<double> >& point_list, delamo::List< delamo::TPoint3<double> >& normal_list, delamo::List< std::string >& name_list);
+
+	/**
+	 * \brief Sets the number of threads used for the batch closest point queries
+	 *
+	 * The queries are only distributed over the threads if the solid modeling kernel supports concurrent evaluation.
+	 * \param num_threads number of threads
+	 */
+	void query_threads(int num_threads);
+
+	/**
+	 * \brief Returns the number of threads used for the batch closest point queries
+	 * \return number of threads
+	 */
+	int query_threads();
+
+	/**
+	 * \brief Finds the LayerSurface referred by the handle
+	 *
+	 * Handles are taken with LayerSurface::handle() and they are outdated when the surface is split or imprinted.
+	 * \param handle surface handle
+	 * \return LayerSurface object, nullptr if the handle is outdated
+	 */
+	LayerSurface* surface(const SurfaceHandle& handle);
+
+	/**
+	 * \brief Checks whether the handle refers to the current state of a LayerSurface created by this ModelBuilder
+	 * \param handle surface handle
+	 * \return true if the handle can be resolved, otherwise false
+	 */
+	bool is_valid(const SurfaceHandle& handle);
+
+	/**
+	 * \brief Enables or disables the deferred execution mode
+	 *
+	 * In deferred mode, adjacent_layers() calls generating a face adjacency list are recorded in a dependency graph
+	 * instead of running immediately. The recorded operations run when sync() is called, and the operations on
+	 * disjoint layers run concurrently if the solid modeling kernel supports it. Disabling the deferred mode runs the
+	 * pending operations. The face adjacency lists of the recorded calls are stored by the ModelBuilder, the caller's
+	 * outputs are never written after the call returns.
+	 * \param flag true to enable, false to disable
+	 */
+	void deferred(bool flag);
+
+	/**
+	 * \brief Checks whether the deferred execution mode is enabled
+	 * \return true if enabled, otherwise false
+	 */
+	bool is_deferred();
+
+	/**
+	 * \brief Runs the pending deferred operations and waits for them to finish
+	 *
+	 * Called automatically before saving the model and before the closest point queries. It should be called before
+	 * using the layers and the face adjacency lists of the recorded operations.
+	 */
+	void sync();
+
+	/**
+	 * \brief Returns the ticket of the last recorded adjacent_layers() call generating a face adjacency list
+	 * \return ticket of the recorded call, -1 if no call is recorded
+	 */
+	int deferred_ticket();
+
+	/**
+	 * \brief Collects the face adjacency list generated by a recorded adjacent_layers() call
+	 *
+	 * Runs the pending deferred operations. The face adjacency list is handed over to the caller and the ticket cannot be
+	 * used again.
+	 * \param[in] ticket ticket of the recorded call returned by deferred_ticket()
+	 * \param[out] fal the face adjacency list
+	 * \param[out] fal_size size of the face adjacency list
+	 */
+	void deferred_result(int ticket, FaceAdjacency*& fal, int& fal_size);
+
+	/**
+	 * \brief Sets the number of threads used for running the deferred operations
+	 * \param num_threads number of threads
+	 */
+	void task_threads(int num_threads);
+
+	/**
+	 * \brief Returns the number of threads used for running the deferred operations
+	 * \return number of threads
+	 */
+	int task_threads();
+
+	/**
+	 * \brief Enables the on-disk cache of the generated layers and interfaces
+	 *
+	 * The results of create_layer() and adjacent_layers() are stored in the cache directory with a key computed from the
+	 * operation inputs, i.e. the mold, thickness, direction, delamination files, offset distance and the keys of the
+	 * input layers. When an operation is repeated with the same inputs, e.g. by the next run of the same model script,
+	 * the layers are restored from the cache instead of being generated again. The cache should be enabled before
+	 * creating the first layer and the directory should exist.
+	 * \param dir_name name of the cache directory, empty string disables the cache
+	 */
+	void cache_directory(const char* dir_name);
+
+	/**
+	 * \brief Returns the cache directory
+	 * \return name of the cache directory, empty string if the cache is disabled
+	 */
+	const char* cache_directory();
+
+	/**
+	 * \brief Returns the number of operations whose layers are restored from the layer cache
+	 * \return number of cache hits
+	 */
+	int cache_hits();
+
+	/**
+	 * \brief Enables or disables the incremental rebuilds
+	 *
+	 * In incremental mode, the interface, split and stiffener operations are recorded in an operation graph with their
+	 * input files and the states of the layers they modify. When an input file changes, rebuild() replays only the
+	 * operations on the affected layers. The incremental mode should be enabled before the first interface operation.
+	 * Disabling the incremental mode discards the recorded operations.
+	 * \param flag true to enable, false to disable
+	 */
+	void incremental(bool flag);
+
+	/**
+	 * \brief Checks whether the incremental rebuilds are enabled
+	 * \return true if the incremental mode is enabled, otherwise false
+	 */
+	bool is_incremental();
+
+	/**
+	 * \brief Replaces an input file of the recorded operations, e.g. to try another delamination outline
+	 * \param old_file_name file name used by the recorded operations
+	 * \param new_file_name new file name
+	 * \return number of replaced inputs
+	 */
+	int replace_input(const char* old_file_name, const char* new_file_name);
+
+	/**
+	 * \brief Replays the recorded operations affected by the modified input files
+	 *
+	 * The layers of the modified operations are reset to their states before these operations and the following
+	 * operations on them are run again. A neighbouring layer is regenerated only if an operation gives a different
+	 * result for it. The face adjacency lists should be deleted by the caller.
+	 * \param[out] fal_out face adjacency lists of all recorded interface operations in the recording order
+	 * \param[out] fal_size_out sizes of the face adjacency lists
+	 * \return number of replayed operations
+	 */
+	int rebuild(delamo::List<FaceAdjacency*>& fal_out, delamo::List<int>& fal_size_out);
+
+	/**
+	 * \brief Starts a transaction, e.g. to try a delamination outline or a split and undo it
+	 *
+	 * The layers are journaled right before the first operation of the transaction modifies them, so the cost of the
+	 * journal and of rollback() grows with the layers touched by the transaction instead of the model size. Layers
+	 * created in the transaction are journaled empty. Transactions cannot be nested.
+	 */
+	void begin_transaction();
+
+	/**
+	 * \brief Checks whether a transaction is started
+	 * \return true if a transaction is active, otherwise false
+	 */
+	bool in_transaction();
+
+	/**
+	 * \brief Keeps the changes of the transaction and discards its journal
+	 */
+	void commit();
+
+	/**
+	 * \brief Restores the layers modified by the transaction to their states at begin_transaction()
+	 *
+	 * The original LayerBody and LayerSurface objects are restored with their solid bodies, so the references and the
+	 * handles to them stay valid. The objects created in the transaction are released. In incremental mode, the
+	 * operations recorded in the transaction are discarded. If a solid body cannot be restored, the layers are left as
+	 * they are and the transaction stays active.
+	 * \return number of restored layers
+	 */
+	int rollback();
+
+	/**
+	 * \brief Releases the layers with their solid bodies, surfaces and molds
+	 *
+	 * The solid bodies and the molds generated for the layers are deleted, and the LayerBody and LayerSurface objects
+	 * are returned to the object pools. The references from the other layers to the released ones are cleared. The
+	 * Layer objects created by the ModelBuilder are returned to the pool, the others are left empty. In incremental
+	 * mode, the recorded operations are discarded if any of them refers to a released layer.
+	 * \param layers layers to be released
+	 * \return number of released layers
+	 */
+	int release_layers(delamo::List<Layer*>& layers);
+
 	/**
 	 * \brief Generates a hat stiffener
 	 * \param[in] layer_orig layer on the original side
@@ -297,7 +688,7 @@ public:
 	 * \param[in] file_name file containing the stiffener outline
 	 * \param[in] radius blending radius
 	 */
-	virtual void create_hat_stiffener(Layer *layer_orig, Layer *stiffener, const char* file_name, double radius = 0) = 0;
+	void create_hat_stiffener(Layer *layer_orig, Layer *stiffener, const char* file_name, double radius = 0);
 
 	/**
 	 * \brief Splits the layer using the points included in the input file
@@ -307,7 +698,7 @@ public:
 	 * \param layer_in layer to be split
 	 * \param file_name file which contains the points for wire generation
 	 */
-	virtual void split_layer(Layer *layer_in, const char* file_name) = 0;
+	void split_layer(Layer *layer_in, const char* file_name);
 
 	/**
 	 * \brief Converts input 2D parametric positions into 3D positions
@@ -386,12 +777,259 @@ public:
 protected:
 	Layer* _pInitialLayer; /**< Stores the first layer during the pre-bonding stage (adjacent layers) */
 	char* _pUnlockStr; /**< Stores Solid Modeling Kernel license key */
+#ifdef ACISOBJ
 	PNFind_ABS* _pPtNmAlgo; /**< Stores a pointer to the point-normal find algorithm class */
+#endif
 	bool _mDebugMode;
 	int _mLayerID;
+	std::atomic<int> _mSkippedImprints; /**< Number of body imprints skipped by the bounding box check */
+	ObjectPool<LayerSurface> _mSurfacePool; /**< Stores the LayerSurface objects created by the builder */
+	ObjectPool<LayerBody> _mBodyPool; /**< Stores the LayerBody objects created by the builder */
+	ObjectPool<LayerMold> _mMoldPool; /**< Stores the LayerMold objects created by the builder */
+	HandleTable _mHandles; /**< Maps the surface handles to the LayerSurface objects in the surface pool */
+	ObjectPool<Layer> _mLayerPool; /**< Stores the Layer objects created by build_laminate() and rebuild() */
 
 	int next_layer_id();
 
+	/**
+	 * \brief Sets the initial layer if it is not set yet.
+	 *
+	 * Safe to call from the concurrently running deferred operations.
+	 * \param layer layer to be used as the first layer
+	 */
+	void initial_layer(Layer* layer);
+
+	/**
+	 * \brief Reads the points of a delamination outline file.
+	 *
+	 * While a laminate is built, the files are parsed once and the points are reused for all interfaces.
+	 * \param[in] file_name name of the CSV file
+	 * \param[out] pts_out points of the outline, should be deleted by the caller
+	 * \param[out] pts_out_size number of points
+	 */
+	void read_delamination_file(const char* file_name, delamo::TPoint3<double>*& pts_out, int& pts_out_size);
+
+	/**
+	 * \brief Reads the points of a delamination outline file.
+	 * \param[in] file_name name of the CSV file
+	 * \param[out] pts_out points of the outline
+	 */
+	void read_delamination_file(const char* file_name, delamo::List< delamo::TPoint3<double> >& pts_out);
+
+	/**
+	 * \brief Checks whether the modeling operations on disjoint layers can run concurrently.
+	 *
+	 * The deferred operations run on a single thread if the solid modeling kernel is not thread-safe.
+	 * \return true if the kernel operations are thread-safe, otherwise false
+	 */
+	virtual bool thread_safe_modeling();
+
+	/**
+	 * \brief Locks the solid modeling kernel for the calling operation.
+	 *
+	 * A kernel which is not thread-safe keeps global state, so the ModelBuilder instances of the process use it one at a
+	 * time. The lock is recursive, so the nested operations can lock it again.
+	 * \return lock owning the kernel, empty if the kernel is thread-safe
+	 */
+	std::unique_lock<std::recursive_mutex> kernel_lock();
+
+	/**
+	 * \brief Creates a new LayerSurface object in the surface pool.
+	 *
+	 * The object is owned by the ModelBuilder and stays valid until the ModelBuilder is destroyed. The object is
+	 * registered in the handle table.
+	 * \return pointer to the new LayerSurface object
+	 */
+	LayerSurface* new_layer_surface();
+
+	/**
+	 * \brief Creates a new LayerBody object in the body pool.
+	 *
+	 * The object is owned by the ModelBuilder and stays valid until the ModelBuilder is destroyed.
+	 * \return pointer to the new LayerBody object
+	 */
+	LayerBody* new_layer_body();
+
+	/**
+	 * \brief Creates a new LayerMold object in the mold pool.
+	 *
+	 * The object is owned by the ModelBuilder and stays valid until it is deleted by delete_layer_mold() or the
+	 * ModelBuilder is destroyed.
+	 * \return pointer to the new LayerMold object
+	 */
+	LayerMold* new_layer_mold();
+
+	/**
+	 * \brief Deletes a LayerMold object created by new_layer_mold().
+	 * \param lm LayerMold object to be deleted
+	 */
+	void delete_layer_mold(LayerMold* lm);
+
+	/**
+	 * \brief Computes the cache key of an operation from the fingerprints of the layers modified by it.
+	 *
+	 * Called after the layers are fingerprinted, so the key covers all inputs of the operation.
+	 * \param layers layers modified by the operation
+	 * \return cache key, null if the cache is disabled or one of the layers has no fingerprint
+	 */
+	Fingerprint cache_key(delamo::Span<Layer*> layers);
+
+	/**
+	 * \brief Sets the fingerprint of a layer generated by create_layer().
+	 * \param layer_out generated layer
+	 * \param op_name name of the operation variant
+	 * \param source fingerprint of the input surface, layer or mold
+	 * \param ldir direction of the layer
+	 * \param thickness thickness of the layer
+	 */
+	void fingerprint_layer(Layer* layer_out, const char* op_name, const Fingerprint& source, Direction ldir, double thickness);
+
+	/**
+	 * \brief Sets the fingerprints of the molds of a layer from the fingerprint of the layer.
+	 * \param layer input layer
+	 */
+	void fingerprint_molds(Layer* layer);
+
+	/**
+	 * \brief Combines the fingerprints of the molds of a layer in a direction.
+	 * \param layer input layer
+	 * \param mold_dir direction of the molds
+	 * \return fingerprint of the molds, null if one of the molds has no fingerprint
+	 */
+	Fingerprint mold_fingerprint(Layer* layer, Direction mold_dir);
+
+	/**
+	 * \brief Adds an operation to the fingerprints of the layers modified by it.
+	 *
+	 * Each layer fingerprint is combined with the fingerprints of the other layers before the operation.
+	 * \param layers layers modified by the operation in the argument order
+	 * \param op_name name of the operation variant
+	 * \param file_names input files of the operation, identified by their contents
+	 * \param params numerical parameters of the operation
+	 */
+	void fingerprint_operation(delamo::Span<Layer*> layers, const char* op_name, delamo::Span<const std::string> file_names, delamo::Span<const double> params = delamo::Span<const double>());
+
+	/**
+	 * \brief Restores the layers modified by an operation from the cache.
+	 *
+	 * Called before running the operation, after the layers are fingerprinted.
+	 * \param key cache key of the operation
+	 * \param layers layers modified by the operation
+	 * \return true if the layers are restored and the operation should be skipped
+	 */
+	bool restore_cached_layers(const Fingerprint& key, delamo::Span<Layer*> layers);
+
+	/**
+	 * \brief Stores the layers modified by an operation in the cache.
+	 * \param key cache key of the operation
+	 * \param layers layers modified by the operation
+	 */
+	void store_cached_layers(const Fingerprint& key, delamo::Span<Layer*> layers);
+
+	/**
+	 * \brief Returns the name and version of the format of the cached bodies.
+	 * \return format name, nullptr if the solid modeling kernel does not support caching
+	 */
+	virtual const char* cache_format();
+
+	/**
+	 * \brief Serializes the solid body of a LayerBody for the cache.
+	 * \param[in] lb input LayerBody
+	 * \param[out] blob serialized body
+	 * \param[out] faces faces of the body in the order they are restored by restore_cache_body()
+	 * \return false if the body cannot be serialized
+	 */
+	virtual bool save_cache_body(LayerBody* lb, std::string& blob, delamo::List<DLM_FACEP>& faces);
+
+	/**
+	 * \brief Replaces the solid body of a LayerBody with a body serialized by save_cache_body().
+	 * \param[in] lb LayerBody to be updated, it has no body if the layer is being created
+	 * \param[in] blob serialized body
+	 * \param[out] faces faces of the body in the order they are serialized
+	 * \return false if the body cannot be restored
+	 */
+	virtual bool restore_cache_body(LayerBody* lb, const std::string& blob, delamo::List<DLM_FACEP>& faces);
+
+	/**
+	 * \brief Releases the solid body of a LayerBody which is removed from its layer by a rebuild.
+	 * \param lb input LayerBody
+	 */
+	virtual void release_cache_body(LayerBody* lb);
+
+	/**
+	 * \brief Serializes the solid body of a LayerMold for a checkpoint.
+	 * \param[in] lm input LayerMold
+	 * \param[out] blob serialized body
+	 * \return false if the body cannot be serialized
+	 */
+	virtual bool save_cache_mold(LayerMold* lm, std::string& blob);
+
+	/**
+	 * \brief Sets the solid body of a LayerMold from a body serialized by save_cache_mold().
+	 * \param[in] lm LayerMold to be updated
+	 * \param[in] blob serialized body
+	 * \return false if the body cannot be restored
+	 */
+	virtual bool restore_cache_mold(LayerMold* lm, const std::string& blob);
+
+	/**
+	 * \brief Releases the solid body of a LayerMold which is deleted with its layer.
+	 * \param lm input LayerMold
+	 */
+	virtual void release_cache_mold(LayerMold* lm);
+
+	/**
+	 * \brief Serializes the layers with the references between their surfaces.
+	 * \param[in] layers input layers
+	 * \param[out] blob serialized layers
+	 * \param[in] keep_external true to mark the references to the other layers, otherwise they are stored as null
+	 * \return false if one of the bodies cannot be serialized
+	 */
+	bool encode_layers(delamo::Span<Layer*> layers, std::string& blob, bool keep_external);
+
+	/**
+	 * \brief Updates the layers from the output of encode_layers().
+	 *
+	 * All bodies are restored before the first layer is modified, so the layers are not changed if it fails.
+	 * \param[in] blob serialized layers
+	 * \param[in] layers layers to be updated
+	 * \param[in] replace false if the layers can only grow, true to reset them to an earlier state
+	 * \param[out] dropped surfaces removed from the layers in replace mode
+	 * \return false if the blob does not match the layers or one of the bodies cannot be restored
+	 */
+	bool decode_layers(const std::string& blob, delamo::Span<Layer*> layers, bool replace, delamo::List<LayerSurface*>& dropped);
+
+	/**
+	 * \brief Serializes a layer for the operation graph.
+	 * \param layer input layer
+	 * \return layer state
+	 */
+	LayerSnapshot layer_snapshot(Layer* layer);
+
+	/**
+	 * \brief Runs an operation and records it in the operation graph in incremental mode.
+	 *
+	 * Called at the beginning of the operation with a function calling the operation again.
+	 * \param op operation to be run
+	 * \param layers layers modified by the operation
+	 * \param file_names input files of the operation
+	 * \return true if the operation is run, false if it is not recorded and should run as usual
+	 */
+	bool record_operation(OperationGraph::Operation op, delamo::Span<Layer*> layers, delamo::Span<const std::string> file_names);
+
+	/**
+	 * \brief Attaches a face adjacency list to the last recorded operation on the input layers in incremental mode.
+	 */
+	void record_adjacency_list(Layer* layer_orig, Layer* layer_offset, BCStatus default_status, BCStatus delam_region_status, BCStatus delam_ring_status, FaceAdjacency* fal, int fal_size);
+
+	/**
+	 * \brief Stores the states of the layers in the transaction journal before an operation modifies them.
+	 *
+	 * Called at the beginning of the operations, the layers already journaled in the transaction are skipped.
+	 * \param layers layers to be modified by the operation
+	 */
+	void journal_layers(delamo::Span<Layer*> layers);
+
 	/**
 	 * \brief Generates the CAD model file
 	 * \param file_name name of the file which contains the CAD model
@@ -407,6 +1045,22 @@ protected:
 	*/
 	virtual void save_cad_model(const char* file_name, delamo::List<Layer*>& layer_list, delamo::List<MBBody*>& mbbody_list) = 0;
 
+	/**
+	 * \brief Saves the bodies of a layer to a shard file of a sharded model
+	 *
+	 * Called concurrently for the different shards if the modeling is thread-safe.
+	 * \param file_name name of the shard file
+	 * \param layer layer of the bodies
+	 * \param bodies layer bodies to be saved in the file
+	 */
+	virtual void save_cad_shard(const char* file_name, Layer* layer, delamo::Span<LayerBody*> bodies) = 0;
+
+	/**
+	 * \brief Returns the extension of the CAD model files, including the leading dot
+	 * \return file extension
+	 */
+	virtual const char* cad_file_extension() = 0;
+
 
 	/**
 	 * \brief Load the CAD model from a file
@@ -434,12 +1088,142 @@ protected:
 	 */
 	void generate_adjacency_list(Layer *layer_orig, Layer *layer_offset, BCStatus default_status, BCStatus delam_region_status, BCStatus delam_ring_status, FaceAdjacency*& fal, int& fal_size);
 
+	/**
+	 * \brief Face adjacency list of a recorded adjacent_layers() call
+	 */
+	struct DeferredAdjacency
+	{
+		FaceAdjacency* fal; /**< Face adjacency list generated by the recorded operation */
+		int fal_size; /**< Size of the face adjacency list */
+	};
+
+	/**
+	 * \brief Allocates the result of a recorded adjacent_layers() call and sets the caller's outputs to an empty list
+	 * \param[out] fal the face adjacency list of the caller
+	 * \param[out] fal_size size of the face adjacency list of the caller
+	 * \return result filled by the recorded operation when it runs
+	 */
+	DeferredAdjacency* defer_adjacency_list(FaceAdjacency*& fal, int& fal_size);
+
+	/**
+	 * \brief Runs the pending deferred operations if any of them reads or modifies the input layers
+	 *
+	 * Called by the operations which are not recorded in the deferred execution mode, before they use the layers.
+	 * \param layers layers to be used by the calling operation
+	 */
+	void sync_layers(delamo::Span<const Layer*> layers);
+
 	/**
 	 * \brief Collects all of the adjacent layers into a container
 	 * \param layer_list_out an array containing the layers to be saved
 	 */
 	void prepare_layers(delamo::List<Layer*>& layer_list_out);
 
+	/**
+	 * \brief Runs the common steps of the create_layer() variants around the kernel implementation.
+	 *
+	 * Journals and fingerprints the new layer, restores it from the cache or calls the kernel implementation, then sets
+	 * the layer ID, generates the molds and stores the new layer in the cache.
+	 * \param layer_out the new layer
+	 * \param op_name name of the operation variant
+	 * \param source fingerprint of the input surface, layer or mold, null if the input is not generated by the ModelBuilder
+	 * \param ldir direction of the layer
+	 * \param thickness thickness of the layer
+	 * \param kernel_op kernel implementation generating the bodies of the new layer
+	 */
+	void build_layer(Layer* layer_out, const char* op_name, const Fingerprint& source, Direction ldir, double thickness, const std::function<void()>& kernel_op);
+
+	/**
+	 * \brief Runs the common steps of the adjacent_layers() variants around the kernel implementation.
+	 *
+	 * Fingerprints the interface, restores the imprinted layers from the cache or calls the kernel implementation, then
+	 * bonds the layers and stores them in the cache.
+	 * \param layer_orig layer on the ORIG side
+	 * \param layer_offset layer on the OFFSET side
+	 * \param op_name name of the operation variant
+	 * \param file_names delamination outline files
+	 * \param kernel_op kernel implementation imprinting the layers
+	 */
+	void build_interface(Layer* layer_orig, Layer* layer_offset, const char* op_name, delamo::Span<const std::string> file_names, const std::function<void()>& kernel_op);
+
+	/**
+	 * \brief Kernel implementation of create_layer() from a NURBS surface
+	 *
+	 * Only generates the bodies of the new layer. The inputs are checked and the layer ID, molds and cache entry are
+	 * handled by create_layer().
+	 * \param[in] nurbs_surface_in input NURBS surface to be used as a mold for the new layer
+	 * \param[in] ldir the layer direction in which the mold will be offset
+	 * \param[in] thickness the layer thickness
+	 * \param[out] layer_out the new layer
+	 */
+	virtual void do_create_layer(delamo::NURBS<double> *nurbs_surface_in, Direction ldir, double thickness, Layer *layer_out) = 0;
+
+	/**
+	 * \brief Kernel implementation of create_layer() from the molds of a layer
+	 * \param[in] layer_in input layer to be used as a mold
+	 * \param[in] ldir the layer direction in which the mold will be offset
+	 * \param[in] thickness the layer thickness
+	 * \param[out] layer_out the new layer
+	 */
+	virtual void do_create_layer(Layer *layer_in, Direction ldir, double thickness, Layer *layer_out) = 0;
+
+	/**
+	 * \brief Kernel implementation of create_layer() from a LayerMold object
+	 * \param[in] mold_in input mold, its body is checked by create_layer()
+	 * \param[in] ldir the layer direction in which the mold will be offset
+	 * \param[in] thickness layer thickness
+	 * \param[out] layer_out the new layer
+	 */
+	virtual void do_create_layer(LayerMold *mold_in, Direction ldir, double thickness, Layer *layer_out) = 0;
+
+	/**
+	 * \brief Kernel implementation of adjacent_layers()
+	 *
+	 * Only imprints the layers and pairs their surfaces. The bond pairs and the cache entry are handled by
+	 * adjacent_layers().
+	 * \param layer_orig layer on the ORIG side
+	 * \param layer_offset layer on the OFFSET side
+	 */
+	virtual void do_adjacent_layers(Layer *layer_orig, Layer *layer_offset) = 0;
+
+	/**
+	 * \brief Kernel implementation of adjacent_layers() with a delamination profile
+	 * \param layer_orig layer on the ORIG side
+	 * \param layer_offset layer on the OFFSET side
+	 * \param file_name CSV file containing the outer delamination profile
+	 */
+	virtual void do_adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name) = 0;
+
+	/**
+	 * \brief Kernel implementation of adjacent_layers() with multiple delamination profiles
+	 * \param layer_orig layer on the ORIG side
+	 * \param layer_offset layer on the OFFSET side
+	 * \param file_names a list of CSV files containing the outer delamination profile
+	 */
+	virtual void do_adjacent_layers(Layer *layer_orig, Layer *layer_offset, delamo::List< std::string > &file_names) = 0;
+
+	/**
+	 * \brief Kernel implementation of create_hat_stiffener()
+	 * \param[in] layer_orig layer on the original side
+	 * \param[out] stiffener stiffener to be generated
+	 * \param[in] file_name file containing the stiffener outline
+	 * \param[in] radius blending radius
+	 */
+	virtual void do_create_hat_stiffener(Layer *layer_orig, Layer *stiffener, const char* file_name, double radius) = 0;
+
+	/**
+	 * \brief Kernel implementation of split_layer()
+	 * \param layer_in layer to be split
+	 * \param file_name file which contains the points for wire generation
+	 */
+	virtual void do_split_layer(Layer *layer_in, const char* file_name) = 0;
+
+	/**
+	 * \brief Generates the molds of a new layer
+	 * \param layer_in input layer
+	 */
+	virtual void generate_mold(Layer *layer_in) = 0;
+
 	/**
 	 * \brief Virtual function for checking whether the modeler engine is started or not.
 	 */
@@ -457,6 +1241,21 @@ private:
 	bool _bCrashOnException; /**< Flag to set Python mode which converts exception throws to assert(0) */
 	double _mDelta; /**< Defines the tolerance value */
 	double _mOffsetDistance; /**< Defines the delamination offset distance */
+	bool _bBatchDelaminations; /**< Flag to process multiple delamination profiles in batch mode */
+	int _mQueryThreads; /**< Number of threads for the batch closest point queries */
+	bool _bDeferred; /**< Flag to record the operations instead of running them immediately */
+	int _mTaskThreads; /**< Number of threads for the deferred operations */
+	bool _bProfileCache; /**< Flag to reuse the points of the delamination outline files */
+	LayerCache _mLayerCache; /**< On-disk cache of the generated layers */
+	std::atomic<int> _mCacheHits; /**< Number of operations restored from the layer cache */
+	std::unordered_map< std::string, delamo::List< delamo::TPoint3<double> > > _mProfileCache; /**< Points of the delamination outline files read while building a laminate */
+	TaskGraph _mTaskGraph; /**< Pending deferred operations */
+	std::unordered_map<int, DeferredAdjacency> _mDeferredResults; /**< Face adjacency lists of the recorded operations by ticket */
+	int _mDeferredTicket; /**< Ticket of the last recorded operation */
+	bool _bIncremental; /**< Flag to record the operations for the incremental rebuilds */
+	OperationGraph _mOperationGraph; /**< Recorded operations for the incremental rebuilds */
+	LayerJournal _mJournal; /**< States of the layers at the beginning of the transaction */
+	std::mutex _mObjectMutex; /**< Guards the object pools, the handle table and the initial layer */
 };
 
 #endif // !MODELBUILDER_H
@@ -0,0 +1,168 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include "APIConfig.h"
+
+
+/**
+ * \brief Slab allocator for the objects created by the ModelBuilder.
+ *
+ * Objects are constructed in fixed-size slabs, so that the objects created one after another (e.g. the LayerSurface
+ * objects of a LayerBody) are close to each other in memory. Destroyed objects are put on a free list and their
+ * memory is reused by the next create() call. All remaining objects are destroyed when the pool is released.
+ */
+template <typename T, int SLAB_SIZE = 64>
+class ObjectPool
+{
+public:
+
+	/**
+	 * \brief Default constructor.
+	 */
+	ObjectPool()
+	{
+		this->_pFreeList = nullptr;
+		this->_mLiveCount = 0;
+	}
+
+	/**
+	 * \brief Default destructor.
+	 *
+	 * Destroys all objects which are still alive.
+	 */
+	~ObjectPool()
+	{
+		this->release();
+	}
+
+	/**
+	 * \brief Constructs a new object inside the pool.
+	 * \param args constructor arguments
+	 * \return pointer to the new object, owned by the pool
+	 */
+	template <typename... Args>
+	T* create(Args&&... args)
+	{
+		if (this->_pFreeList == nullptr)
+			this->add_slab();
+
+		// Take the first free slot
+		Slot* slot = this->_pFreeList;
+		T* obj = new (&slot->storage) T(std::forward<Args>(args)...);
+		this->_pFreeList = slot->next_free;
+		slot->next_free = nullptr;
+		slot->live = true;
+		this->_mLiveCount++;
+		return obj;
+	}
+
+	/**
+	 * \brief Destroys an object which was created by this pool and puts its slot on the free list.
+	 * \param obj object to be destroyed
+	 */
+	void destroy(T* obj)
+	{
+		if (obj == nullptr)
+			return;
+
+		// The object storage is the first member of the slot
+		Slot* slot = reinterpret_cast<Slot*>(obj);
+		if (!slot->live)
+			return;
+
+		obj->~T();
+		slot->live = false;
+		slot->next_free = this->_pFreeList;
+		this->_pFreeList = slot;
+		this->_mLiveCount--;
+	}
+
+	/**
+	 * \brief Checks whether an object is created by this pool.
+	 * \param obj object to be checked
+	 * \return true if the object is stored in one of the slabs, otherwise false
+	 */
+	bool owns(const T* obj) const
+	{
+		const Slot* slot = reinterpret_cast<const Slot*>(obj);
+		for (auto slab : this->_mSlabs)
+		{
+			if (slot >= slab && slot < slab + SLAB_SIZE)
+				return slot->live;
+		}
+		return false;
+	}
+
+	/**
+	 * \brief Destroys all objects and frees all slabs.
+	 */
+	void release()
+	{
+		for (auto slab : this->_mSlabs)
+		{
+			for (int i = 0; i < SLAB_SIZE; i++)
+			{
+				if (slab[i].live)
+					reinterpret_cast<T*>(&slab[i].storage)->~T();
+			}
+			delete[] slab;
+		}
+		this->_mSlabs.clear();
+		this->_pFreeList = nullptr;
+		this->_mLiveCount = 0;
+	}
+
+	/**
+	 * \brief Gets the number of objects alive in the pool.
+	 * \return number of objects
+	 */
+	size_t size() const
+	{
+		return this->_mLiveCount;
+	}
+
+	/**
+	 * \brief Gets the number of objects that can be stored without allocating a new slab.
+	 * \return number of slots
+	 */
+	size_t capacity() const
+	{
+		return this->_mSlabs.size() * SLAB_SIZE;
+	}
+
+private:
+
+	// Memory of a single object, linked into the free list when not in use
+	struct Slot
+	{
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage; /**< Storage for the object, must be the first member */
+		Slot* next_free; /**< Next free slot */
+		bool live; /**< TRUE if an object is constructed in this slot */
+	};
+
+	std::vector<Slot*> _mSlabs; /**< List of allocated slabs */
+	Slot* _pFreeList; /**< First free slot */
+	size_t _mLiveCount; /**< Number of objects alive */
+
+	/**
+	 * \brief Allocates a new slab and links its slots into the free list.
+	 */
+	void add_slab()
+	{
+		Slot* slab = new Slot[SLAB_SIZE];
+		// Link in reverse order, so that the slots are handed out in memory order
+		for (int i = SLAB_SIZE - 1; i >= 0; i--)
+		{
+			slab[i].live = false;
+			slab[i].next_free = this->_pFreeList;
+			this->_pFreeList = &slab[i];
+		}
+		this->_mSlabs.push_back(slab);
+	}
+
+	// The pool owns its objects, so it cannot be copied
+	ObjectPool(const ObjectPool&);
+	ObjectPool& operator=(const ObjectPool&);
+};
+
+#endif // !OBJECTPOOL_H
@@ -0,0 +1,163 @@
+#include "OperationGraph.h"
+#include "Fingerprint.h"
+#include <algorithm>
+
+
+OperationGraph::OperationGraph()
+{
+}
+
+bool OperationGraph::begin(delamo::Span<Layer*> layers)
+{
+	std::lock_guard<std::mutex> lock(this->_mMutex);
+
+	// Nested operations modify the layers of the calling operation
+	for (auto layer : layers)
+	{
+		if (this->_mActiveLayers.count(layer) > 0)
+			return false;
+	}
+	for (auto layer : layers)
+		this->_mActiveLayers.insert(layer);
+	return true;
+}
+
+void OperationGraph::end(Node& node)
+{
+	std::lock_guard<std::mutex> lock(this->_mMutex);
+	for (auto layer : node.layers)
+		this->_mActiveLayers.erase(layer);
+	this->_mNodes.push_back(std::move(node));
+}
+
+void OperationGraph::adjacency_list(delamo::Span<Layer*> layers, const BCStatus* status, FaceAdjacency* fal, int fal_size)
+{
+	std::lock_guard<std::mutex> lock(this->_mMutex);
+
+	// The operations on the same layers never run concurrently, so the last one is the caller
+	for (int i = (int)this->_mNodes.size() - 1; i >= 0; i--)
+	{
+		Node& node = this->_mNodes[i];
+		if (node.layers.size() == layers.size() && std::equal(layers.begin(), layers.end(), node.layers.begin()))
+		{
+			node.has_fal = true;
+			std::copy(status, status + 3, node.fal_status);
+			node.fal.assign(fal, fal + fal_size);
+			return;
+		}
+	}
+}
+
+bool OperationGraph::has_initial_state(Layer* layer)
+{
+	std::lock_guard<std::mutex> lock(this->_mMutex);
+	return this->_mInitialStates.count(layer) > 0;
+}
+
+void OperationGraph::initial_state(Layer* layer, const LayerSnapshot& state)
+{
+	std::lock_guard<std::mutex> lock(this->_mMutex);
+	this->_mInitialStates[layer] = state;
+}
+
+LayerSnapshot& OperationGraph::initial_state(Layer* layer)
+{
+	std::lock_guard<std::mutex> lock(this->_mMutex);
+	return this->_mInitialStates.at(layer);
+}
+
+LayerSnapshot& OperationGraph::state_before(int node_idx, Layer* layer)
+{
+	// The previous operation on the same layer holds its state, otherwise the layer is not modified yet
+	for (int i = node_idx - 1; i >= 0; i--)
+	{
+		Node& prev = this->_mNodes[i];
+		for (size_t j = 0; j < prev.layers.size(); j++)
+		{
+			if (prev.layers[j] == layer)
+				return prev.states[j];
+		}
+	}
+	return this->initial_state(layer);
+}
+
+std::vector<int> OperationGraph::changed_nodes()
+{
+	std::vector<int> changed;
+	for (int i = 0; i < (int)this->_mNodes.size(); i++)
+	{
+		Node& node = this->_mNodes[i];
+		for (size_t j = 0; j < node.files.size(); j++)
+		{
+			if (OperationGraph::file_key(node.files[j]) != node.file_keys[j])
+			{
+				changed.push_back(i);
+				break;
+			}
+		}
+	}
+	return changed;
+}
+
+int OperationGraph::replace_file(const std::string& old_file_name, const std::string& new_file_name)
+{
+	int num_replaced = 0;
+	for (auto& node : this->_mNodes)
+	{
+		for (auto& file_name : node.files)
+		{
+			if (file_name == old_file_name)
+			{
+				file_name = new_file_name;
+				num_replaced++;
+			}
+		}
+	}
+	return num_replaced;
+}
+
+Fingerprint OperationGraph::file_key(const std::string& file_name)
+{
+	FingerprintBuilder key;
+	if (!key.add_file(file_name.c_str()))
+		return Fingerprint();
+	return key.value();
+}
+
+OperationGraph::Node& OperationGraph::node(int idx)
+{
+	return this->_mNodes[idx];
+}
+
+int OperationGraph::size()
+{
+	return (int)this->_mNodes.size();
+}
+
+void OperationGraph::truncate(int size)
+{
+	std::lock_guard<std::mutex> lock(this->_mMutex);
+	if (size >= (int)this->_mNodes.size())
+		return;
+	this->_mNodes.erase(this->_mNodes.begin() + size, this->_mNodes.end());
+
+	// Layers which are not touched by the remaining operations get a new initial state with their next operation
+	std::unordered_set<Layer*> touched;
+	for (auto& node : this->_mNodes)
+		touched.insert(node.layers.begin(), node.layers.end());
+	for (auto it = this->_mInitialStates.begin(); it != this->_mInitialStates.end();)
+	{
+		if (touched.count(it->first) == 0)
+			it = this->_mInitialStates.erase(it);
+		else
+			++it;
+	}
+}
+
+void OperationGraph::clear()
+{
+	std::lock_guard<std::mutex> lock(this->_mMutex);
+	this->_mNodes.clear();
+	this->_mInitialStates.clear();
+	this->_mActiveLayers.clear();
+}
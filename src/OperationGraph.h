@@ -0,0 +1,162 @@
+#ifndef OPERATIONGRAPH_H
+#define OPERATIONGRAPH_H
+
+#include "APIConfig.h"
+#include "Layer.h"
+#include <functional>
+#include <mutex>
+// Export file is generated by CMake's GenerateExportHeader module
+#include "modelbuilder_export.h"
+
+
+/**
+ * \brief State of a layer recorded by the OperationGraph.
+ */
+struct LayerSnapshot
+{
+	std::string blob; /**< Serialized layer, the references to the other layers are not stored */
+	Fingerprint key; /**< Hash of the serialized layer */
+	Fingerprint fingerprint; /**< Fingerprint of the layer, it is not a part of the hash */
+};
+
+
+/**
+ * \brief Operations of a ModelBuilder session with their inputs and the states of the layers they modify.
+ *
+ * The operations touching the same layer form a chain in the recording order, so the graph is the union of one chain
+ * per layer. When an input file of an operation changes, the layers modified by it are reset to their first recorded
+ * states and only the operations touching these layers are replayed by ModelBuilder::rebuild().
+ */
+class MODELBUILDER_EXPORT OperationGraph
+{
+public:
+
+	/**
+	 * \brief Replays an operation on the given layers with the given input files.
+	 */
+	typedef std::function<void(delamo::Span<Layer*>, delamo::Span<const std::string>)> Operation;
+
+	/**
+	 * \brief Recorded operation.
+	 */
+	struct Node
+	{
+		Operation func; /**< Operation to be replayed */
+		std::vector<Layer*> layers; /**< Layers modified by the operation in the argument order */
+		std::vector<std::string> files; /**< Input files of the operation */
+		std::vector<Fingerprint> file_keys; /**< Hashes of the input file contents */
+		bool has_fal; /**< TRUE if a face adjacency list is generated after the operation */
+		BCStatus fal_status[3]; /**< Default, delamination region and delamination ring boundary conditions of the face adjacency list */
+		std::vector<FaceAdjacency> fal; /**< Face adjacency list generated after the operation */
+		std::vector<LayerSnapshot> states; /**< States of the layers after the operation */
+	};
+
+	/**
+	 * \brief Default constructor.
+	 */
+	OperationGraph();
+
+	/**
+	 * \brief Marks the layers as being modified by an operation.
+	 * \param layers layers of the operation
+	 * \return false if one of the layers is already being modified, i.e. the operation is called by another recorded operation
+	 */
+	bool begin(delamo::Span<Layer*> layers);
+
+	/**
+	 * \brief Records a finished operation and releases its layers.
+	 * \param node recorded operation
+	 */
+	void end(Node& node);
+
+	/**
+	 * \brief Attaches a face adjacency list to the last recorded operation on the given layers.
+	 * \param layers layers of the operation
+	 * \param status default, delamination region and delamination ring boundary conditions
+	 * \param fal face adjacency list generated after the operation
+	 * \param fal_size size of the face adjacency list
+	 */
+	void adjacency_list(delamo::Span<Layer*> layers, const BCStatus* status, FaceAdjacency* fal, int fal_size);
+
+	/**
+	 * \brief Checks whether the first state of a layer is recorded.
+	 * \param layer input layer
+	 * \return true if the layer is touched by a recorded operation before
+	 */
+	bool has_initial_state(Layer* layer);
+
+	/**
+	 * \brief Records the state of a layer before the first operation touching it.
+	 * \param layer input layer
+	 * \param state layer state
+	 */
+	void initial_state(Layer* layer, const LayerSnapshot& state);
+
+	/**
+	 * \brief Gets the state of a layer before the first recorded operation touching it.
+	 * \param layer input layer
+	 * \return layer state
+	 */
+	LayerSnapshot& initial_state(Layer* layer);
+
+	/**
+	 * \brief Gets the state of a layer before a recorded operation.
+	 * \param node_idx index of the operation
+	 * \param layer input layer, should be one of the layers of the operation
+	 * \return layer state
+	 */
+	LayerSnapshot& state_before(int node_idx, Layer* layer);
+
+	/**
+	 * \brief Finds the operations whose input files are modified since they are recorded.
+	 * \return indices of the modified operations in the recording order
+	 */
+	std::vector<int> changed_nodes();
+
+	/**
+	 * \brief Replaces an input file of the recorded operations.
+	 * \param old_file_name file name to be replaced
+	 * \param new_file_name new file name
+	 * \return number of replaced inputs
+	 */
+	int replace_file(const std::string& old_file_name, const std::string& new_file_name);
+
+	/**
+	 * \brief Computes the hash of the contents of an input file.
+	 * \param file_name name of the file
+	 * \return hash value, null if the file cannot be read
+	 */
+	static Fingerprint file_key(const std::string& file_name);
+
+	/**
+	 * \brief Gets a recorded operation.
+	 * \param idx index of the operation
+	 * \return recorded operation
+	 */
+	Node& node(int idx);
+
+	/**
+	 * \brief Gets the number of recorded operations.
+	 * \return number of recorded operations
+	 */
+	int size();
+
+	/**
+	 * \brief Discards the operations recorded after the first ones, e.g. the operations of a rolled back transaction.
+	 * \param size number of operations to be kept
+	 */
+	void truncate(int size);
+
+	/**
+	 * \brief Discards all recorded operations and states.
+	 */
+	void clear();
+
+private:
+	std::vector<Node> _mNodes; /**< Recorded operations in the recording order */
+	std::unordered_map<Layer*, LayerSnapshot> _mInitialStates; /**< States of the layers before their first recorded operation */
+	std::unordered_set<Layer*> _mActiveLayers; /**< Layers modified by the running operations */
+	std::mutex _mMutex; /**< Guards the graph during the concurrent deferred operations */
+};
+
+#endif // !OPERATIONGRAPH_H
@@ -0,0 +1,864 @@
+#include "ReferenceGeometry.h"
+#include "mb_utilities.h"
+
+
+static double dot3(const delamo::TPoint3<double>& a, const delamo::TPoint3<double>& b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static delamo::TPoint3<double> cross3(const delamo::TPoint3<double>& a, const delamo::TPoint3<double>& b)
+{
+	return delamo::TPoint3<double>(a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]);
+}
+
+static double length3(const delamo::TPoint3<double>& a)
+{
+	return std::sqrt(dot3(a, a));
+}
+
+static double clamp01(double value)
+{
+	return std::max(0.0, std::min(1.0, value));
+}
+
+// Distance between a point and a line segment in the parametric space
+static double segment_distance_2d(double u, double v, const delamo::TPoint3<double>& p0, const delamo::TPoint3<double>& p1)
+{
+	double eu = p1[0] - p0[0];
+	double ev = p1[1] - p0[1];
+	double len_sq = eu * eu + ev * ev;
+	double t = 0.0;
+	if (len_sq > 0.0)
+		t = std::max(0.0, std::min(1.0, ((u - p0[0]) * eu + (v - p0[1]) * ev) / len_sq));
+	double du = p0[0] + t * eu - u;
+	double dv = p0[1] + t * ev - v;
+	return std::sqrt(du * du + dv * dv);
+}
+
+// Closest point on a triangle, see Ericson, Real-Time Collision Detection, Section 5.1.5
+static delamo::TPoint3<double> closest_point_triangle(const delamo::TPoint3<double>& p, const delamo::TPoint3<double>& a, const delamo::TPoint3<double>& b, const delamo::TPoint3<double>& c)
+{
+	delamo::TPoint3<double> ab = b - a;
+	delamo::TPoint3<double> ac = c - a;
+	delamo::TPoint3<double> ap = p - a;
+	double d1 = dot3(ab, ap);
+	double d2 = dot3(ac, ap);
+	if (d1 <= 0.0 && d2 <= 0.0)
+		return a;
+
+	delamo::TPoint3<double> bp = p - b;
+	double d3 = dot3(ab, bp);
+	double d4 = dot3(ac, bp);
+	if (d3 >= 0.0 && d4 <= d3)
+		return b;
+
+	double vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+		return a + ab * (d1 / (d1 - d3));
+
+	delamo::TPoint3<double> cp = p - c;
+	double d5 = dot3(ab, cp);
+	double d6 = dot3(ac, cp);
+	if (d6 >= 0.0 && d5 <= d6)
+		return c;
+
+	double vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+		return a + ac * (d2 / (d2 - d6));
+
+	double va = d3 * d6 - d5 * d4;
+	if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+	double denom = 1.0 / (va + vb + vc);
+	return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+
+RefSurface::RefSurface(delamo::NURBS<double>* nurbs_in) : _mNurbs(*nurbs_in)
+{
+	this->_bValid = this->_mNurbs.check();
+	if (!this->_bValid)
+		return;
+
+	// Check for sidedness (RHS or LHS) and ensure that we always use RHS like the ACIS backend does
+	delamo::TPoint3<double> pt, normal, der_u, der_v;
+	this->derivatives(0.05, 0.05, pt, normal, der_u, der_v);
+	if (normal.z() < 0)
+		this->_mNurbs.transpose();
+
+	// Sample the surface once, the samples are used as initial guesses for the projections
+	int num_samples = REFGEOM_GRID_SIZE + 1;
+	this->_mGridPoints.reserve(num_samples * num_samples);
+	this->_mGridNormals.reserve(num_samples * num_samples);
+	for (int i = 0; i < num_samples; i++)
+	{
+		for (int j = 0; j < num_samples; j++)
+		{
+			this->derivatives(double(i) / REFGEOM_GRID_SIZE, double(j) / REFGEOM_GRID_SIZE, pt, normal, der_u, der_v);
+			this->_mGridPoints.push_back(pt);
+			this->_mGridNormals.push_back(normal);
+		}
+	}
+}
+
+RefSurface::~RefSurface()
+{
+	this->_mGridPoints.clear();
+	this->_mGridNormals.clear();
+}
+
+bool RefSurface::valid()
+{
+	return this->_bValid;
+}
+
+delamo::NURBS<double>* RefSurface::nurbs()
+{
+	return &this->_mNurbs;
+}
+
+void RefSurface::evaluate(double u, double v, double level, delamo::TPoint3<double>& pt, delamo::TPoint3<double>& normal)
+{
+	delamo::TPoint3<double> der_u, der_v;
+	this->derivatives(u, v, pt, normal, der_u, der_v);
+	pt += normal * level;
+}
+
+void RefSurface::derivatives(double u, double v, delamo::TPoint3<double>& pt, delamo::TPoint3<double>& normal, delamo::TPoint3<double>& der_u, delamo::TPoint3<double>& der_v)
+{
+	delamo::TPoint3<double>** SKL = nullptr;
+	if (!this->_mNurbs.derivatives(clamp01(u), clamp01(v), 1, SKL))
+	{
+		pt = delamo::TPoint3<double>(0.0);
+		normal = delamo::TPoint3<double>(0.0, 0.0, 1.0);
+		der_u = delamo::TPoint3<double>(1.0, 0.0, 0.0);
+		der_v = delamo::TPoint3<double>(0.0, 1.0, 0.0);
+		return;
+	}
+
+	pt = SKL[0][0];
+	der_u = SKL[1][0];
+	der_v = SKL[0][1];
+
+	// The caller owns the derivatives array
+	for (int i = 0; i < 2; i++)
+		delete[] SKL[i];
+	delete[] SKL;
+
+	normal = cross3(der_u, der_v);
+	double normal_len = length3(normal);
+	if (normal_len > 0.0)
+		normal /= normal_len;
+	else
+		normal = delamo::TPoint3<double>(0.0, 0.0, 1.0);
+}
+
+void RefSurface::project(const delamo::TPoint3<double>& pt, double level, double& u, double& v)
+{
+	// Initial guess from the closest grid sample
+	int num_samples = REFGEOM_GRID_SIZE + 1;
+	double dist_min = std::numeric_limits<double>::max();
+	u = 0.0;
+	v = 0.0;
+	for (int i = 0; i < num_samples; i++)
+	{
+		for (int j = 0; j < num_samples; j++)
+		{
+			int idx = i * num_samples + j;
+			delamo::TPoint3<double> diff = this->_mGridPoints[idx] + this->_mGridNormals[idx] * level - pt;
+			double dist = dot3(diff, diff);
+			if (dist < dist_min)
+			{
+				dist_min = dist;
+				u = double(i) / REFGEOM_GRID_SIZE;
+				v = double(j) / REFGEOM_GRID_SIZE;
+			}
+		}
+	}
+
+	// Gauss-Newton iterations on the offset surface, the derivatives of the normal are neglected
+	for (int iter = 0; iter < 20; iter++)
+	{
+		delamo::TPoint3<double> surf_pt, normal, der_u, der_v;
+		this->derivatives(u, v, surf_pt, normal, der_u, der_v);
+		delamo::TPoint3<double> residual = surf_pt + normal * level - pt;
+
+		double a11 = dot3(der_u, der_u);
+		double a12 = dot3(der_u, der_v);
+		double a22 = dot3(der_v, der_v);
+		double b1 = -dot3(der_u, residual);
+		double b2 = -dot3(der_v, residual);
+		double det = a11 * a22 - a12 * a12;
+		if (std::abs(det) < 1e-30)
+			break;
+
+		double u_new = clamp01(u + (b1 * a22 - b2 * a12) / det);
+		double v_new = clamp01(v + (a11 * b2 - a12 * b1) / det);
+		double step = std::abs(u_new - u) + std::abs(v_new - v);
+		u = u_new;
+		v = v_new;
+		if (step < 1e-12)
+			break;
+	}
+}
+
+
+RefProfile::RefProfile(delamo::Span<const delamo::TPoint3<double>> pts)
+{
+	int num_pts = (int)pts.size();
+	// The polygon is closed implicitly
+	if (num_pts > 1 && std::abs(pts[0][0] - pts[num_pts - 1][0]) < 1e-12 && std::abs(pts[0][1] - pts[num_pts - 1][1]) < 1e-12)
+		num_pts--;
+
+	// Outlines clamped to the surface boundary can contain repeated points and spikes folding back on the boundary
+	std::vector< delamo::TPoint3<double> > clean_pts;
+	for (int i = 0; i < num_pts; i++)
+		clean_pts.push_back(delamo::TPoint3<double>(pts[i][0], pts[i][1], 0.0));
+
+	bool is_changed = true;
+	while (is_changed && clean_pts.size() > 2)
+	{
+		is_changed = false;
+		int curr_size = (int)clean_pts.size();
+		for (int i = 0; i < curr_size; i++)
+		{
+			delamo::TPoint3<double> edge_prev = clean_pts[i] - clean_pts[(i + curr_size - 1) % curr_size];
+			delamo::TPoint3<double> edge_next = clean_pts[(i + 1) % curr_size] - clean_pts[i];
+			double len_sq = std::max(dot3(edge_prev, edge_prev), dot3(edge_next, edge_next));
+			double turn = edge_prev[0] * edge_next[1] - edge_prev[1] * edge_next[0];
+			bool is_repeated = dot3(edge_prev, edge_prev) < 1e-24;
+			bool is_spike = std::abs(turn) <= 1e-12 * len_sq && dot3(edge_prev, edge_next) < 0.0;
+			if (is_repeated || is_spike)
+			{
+				clean_pts.erase(clean_pts.begin() + i);
+				is_changed = true;
+				break;
+			}
+		}
+	}
+
+	this->_mPoints.reserve(clean_pts.size());
+	for (auto& pt : clean_pts)
+		this->_mPoints.push_back(pt);
+
+	this->_mBBoxMin = delamo::TPoint3<double>(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), 0.0);
+	this->_mBBoxMax = delamo::TPoint3<double>(-std::numeric_limits<double>::max(), -std::numeric_limits<double>::max(), 0.0);
+	for (auto& pt : this->_mPoints)
+	{
+		for (int axis = 0; axis < 2; axis++)
+		{
+			this->_mBBoxMin[axis] = std::min(this->_mBBoxMin[axis], pt[axis]);
+			this->_mBBoxMax[axis] = std::max(this->_mBBoxMax[axis], pt[axis]);
+		}
+	}
+}
+
+bool RefProfile::contains(double u, double v)
+{
+	if (u < this->_mBBoxMin[0] || u > this->_mBBoxMax[0] || v < this->_mBBoxMin[1] || v > this->_mBBoxMax[1])
+		return false;
+	return wn_pnpoly(delamo::TPoint3<double>(u, v, 0.0), this->points()) != 0;
+}
+
+double RefProfile::boundary_distance(double u, double v)
+{
+	double dist_min = std::numeric_limits<double>::max();
+	int num_pts = (int)this->_mPoints.size();
+	for (int i = 0; i < num_pts; i++)
+		dist_min = std::min(dist_min, segment_distance_2d(u, v, this->_mPoints[i], this->_mPoints[(i + 1) % num_pts]));
+	return dist_min;
+}
+
+RefProfile* RefProfile::offset(double distance)
+{
+	int num_pts = (int)this->_mPoints.size();
+	if (num_pts < 3)
+		return nullptr;
+
+	// Inward direction depends on the polygon orientation
+	double orig_area = this->area();
+	double orient = (orig_area > 0) ? 1.0 : -1.0;
+
+	delamo::List< delamo::TPoint3<double> > offset_pts;
+	offset_pts.reserve(num_pts);
+	for (int i = 0; i < num_pts; i++)
+	{
+		const delamo::TPoint3<double>& pt_prev = this->_mPoints[(i + num_pts - 1) % num_pts];
+		const delamo::TPoint3<double>& pt_curr = this->_mPoints[i];
+		const delamo::TPoint3<double>& pt_next = this->_mPoints[(i + 1) % num_pts];
+
+		// Inward normals of the adjacent edges
+		delamo::TPoint3<double> edge_prev = pt_curr - pt_prev;
+		delamo::TPoint3<double> edge_next = pt_next - pt_curr;
+		double len_prev = length3(edge_prev);
+		double len_next = length3(edge_next);
+		if (len_prev <= 0.0)
+			edge_prev = edge_next, len_prev = len_next;
+		if (len_next <= 0.0)
+			edge_next = edge_prev, len_next = len_prev;
+		if (len_prev <= 0.0)
+			continue;
+		delamo::TPoint3<double> normal_prev(-orient * edge_prev[1] / len_prev, orient * edge_prev[0] / len_prev, 0.0);
+		delamo::TPoint3<double> normal_next(-orient * edge_next[1] / len_next, orient * edge_next[0] / len_next, 0.0);
+
+		// Move the vertex along the miter direction, the miter length is limited at the sharp corners
+		delamo::TPoint3<double> miter = normal_prev + normal_next;
+		double miter_len = length3(miter);
+		double scale = 1.0;
+		if (miter_len < 1e-12)
+		{
+			miter = normal_prev;
+		}
+		else
+		{
+			miter /= miter_len;
+			scale = std::min(4.0, 1.0 / std::max(dot3(miter, normal_prev), 0.25));
+		}
+		offset_pts.push_back(pt_curr + miter * (distance * scale));
+	}
+
+	// The offset polygon must keep its orientation and stay inside the input polygon
+	RefProfile* profile_out = new RefProfile(offset_pts);
+	double offset_area = profile_out->area();
+	bool is_valid = (offset_area * orient > 0.0) && (std::abs(offset_area) < std::abs(orig_area));
+	for (auto& pt : offset_pts)
+	{
+		if (!is_valid)
+			break;
+		is_valid = this->contains(pt[0], pt[1]);
+	}
+	if (!is_valid)
+	{
+		delete profile_out;
+		return nullptr;
+	}
+	return profile_out;
+}
+
+void RefProfile::bounding_box(delamo::TPoint3<double>& bbox_min, delamo::TPoint3<double>& bbox_max)
+{
+	bbox_min = this->_mBBoxMin;
+	bbox_max = this->_mBBoxMax;
+}
+
+delamo::Span<const delamo::TPoint3<double>> RefProfile::points()
+{
+	return delamo::Span<const delamo::TPoint3<double>>(this->_mPoints.data(), this->_mPoints.size());
+}
+
+double RefProfile::area()
+{
+	double area_sum = 0.0;
+	int num_pts = (int)this->_mPoints.size();
+	for (int i = 0; i < num_pts; i++)
+	{
+		const delamo::TPoint3<double>& p0 = this->_mPoints[i];
+		const delamo::TPoint3<double>& p1 = this->_mPoints[(i + 1) % num_pts];
+		area_sum += p0[0] * p1[1] - p1[0] * p0[1];
+	}
+	return area_sum / 2.0;
+}
+
+
+RefFace::RefFace(RefBody* owner, RefSurface* surf, double level, double normal_sign)
+{
+	this->_pOwner = owner;
+	this->_pSurface = surf;
+	this->_mSide = -1;
+	this->_mLevel = level;
+	this->_mLevelEnd = level;
+	this->_mNormalSign = normal_sign;
+	this->_mParMin[0] = 0.0; this->_mParMin[1] = 0.0;
+	this->_mParMax[0] = 1.0; this->_mParMax[1] = 1.0;
+	this->invalidate();
+}
+
+RefFace::RefFace(RefBody* owner, RefSurface* surf, int side, double level_start, double level_end)
+{
+	this->_pOwner = owner;
+	this->_pSurface = surf;
+	this->_mSide = side;
+	this->_mLevel = level_start;
+	this->_mLevelEnd = level_end;
+	this->_mNormalSign = 1.0;
+	this->_mParMin[0] = 0.0; this->_mParMin[1] = 0.0;
+	this->_mParMax[0] = 1.0; this->_mParMax[1] = 1.0;
+	this->invalidate();
+}
+
+RefBody* RefFace::owner()
+{
+	return this->_pOwner;
+}
+
+RefSurface* RefFace::surface()
+{
+	return this->_pSurface;
+}
+
+bool RefFace::is_cap()
+{
+	return this->_mSide < 0;
+}
+
+double RefFace::level()
+{
+	return this->_mLevel;
+}
+
+double RefFace::normal_sign()
+{
+	return this->_mNormalSign;
+}
+
+bool RefFace::contains(double u, double v)
+{
+	if (u < 0.0 || u > 1.0 || v < 0.0 || v > 1.0)
+		return false;
+
+	for (auto& c : this->_mConstraints)
+	{
+		if (c.profile->contains(u, v) != c.inside)
+			return false;
+	}
+	return true;
+}
+
+void RefFace::evaluate(double u, double v, delamo::TPoint3<double>& pt, delamo::TPoint3<double>& normal)
+{
+	if (this->is_cap())
+	{
+		this->_pSurface->evaluate(u, v, this->_mLevel, pt, normal);
+		normal *= this->_mNormalSign;
+		return;
+	}
+
+	// Side faces run along a domain boundary and across the thickness
+	double surf_u = (this->_mSide < 2) ? double(this->_mSide) : u;
+	double surf_v = (this->_mSide < 2) ? u : double(this->_mSide - 2);
+	delamo::TPoint3<double> surf_normal, der_u, der_v;
+	this->_pSurface->derivatives(surf_u, surf_v, pt, surf_normal, der_u, der_v);
+	pt += surf_normal * (this->_mLevel + v * (this->_mLevelEnd - this->_mLevel));
+
+	// Outward normal is the surface tangent across the boundary
+	normal = (this->_mSide < 2) ? der_u : der_v;
+	normal -= surf_normal * dot3(normal, surf_normal);
+	double normal_len = length3(normal);
+	if (normal_len > 0.0)
+		normal /= normal_len;
+	if (this->_mSide == 0 || this->_mSide == 2)
+		normal *= -1.0;
+}
+
+int RefFace::split(RefProfile* profile, RefFace*& inside_face)
+{
+	inside_face = nullptr;
+
+	// Profiles are only imprinted to the caps
+	if (!this->is_cap())
+		return -1;
+
+	// A profile which doesn't overlap the face cannot split it
+	delamo::TPoint3<double> pp_min, pp_max;
+	profile->bounding_box(pp_min, pp_max);
+	if (pp_min[0] >= this->_mParMax[0] || pp_max[0] <= this->_mParMin[0] || pp_min[1] >= this->_mParMax[1] || pp_max[1] <= this->_mParMin[1])
+		return -1;
+
+	// Region inside the profile
+	RefFace* face_in = new RefFace(*this);
+	face_in->_mConstraints.push_back(Constraint{ profile, true });
+	for (int axis = 0; axis < 2; axis++)
+	{
+		face_in->_mParMin[axis] = std::max(this->_mParMin[axis], pp_min[axis]);
+		face_in->_mParMax[axis] = std::min(this->_mParMax[axis], pp_max[axis]);
+	}
+	face_in->invalidate();
+
+	double u, v;
+	if (!face_in->reference_uv(u, v))
+	{
+		delete face_in;
+		return -1;
+	}
+
+	// Region outside the profile
+	this->_mConstraints.push_back(Constraint{ profile, false });
+	this->invalidate();
+	if (!this->reference_uv(u, v))
+	{
+		this->_mConstraints.pop_back();
+		this->invalidate();
+		delete face_in;
+		return 1;
+	}
+
+	this->_pOwner->add_face(face_in);
+	inside_face = face_in;
+	return 0;
+}
+
+bool RefFace::is_constrained(RefProfile* profile)
+{
+	for (auto& c : this->_mConstraints)
+	{
+		if (c.profile == profile)
+			return true;
+	}
+	return false;
+}
+
+delamo::List<RefProfile*> RefFace::profiles()
+{
+	delamo::List<RefProfile*> profile_list;
+	for (auto& c : this->_mConstraints)
+		profile_list.add(c.profile);
+	return profile_list;
+}
+
+int RefFace::side()
+{
+	return this->_mSide;
+}
+
+double RefFace::level_end()
+{
+	return this->_mLevelEnd;
+}
+
+void RefFace::constraints(delamo::List<RefProfile*>& profile_list, delamo::List<int>& inside_list, double* par_min, double* par_max)
+{
+	profile_list.clear();
+	inside_list.clear();
+	for (auto& c : this->_mConstraints)
+	{
+		profile_list.add(c.profile);
+		inside_list.add(c.inside ? 1 : 0);
+	}
+	for (int axis = 0; axis < 2; axis++)
+	{
+		par_min[axis] = this->_mParMin[axis];
+		par_max[axis] = this->_mParMax[axis];
+	}
+}
+
+void RefFace::constraints(delamo::Span<RefProfile* const> profile_list, delamo::Span<const int> inside_list, const double* par_min, const double* par_max)
+{
+	this->_mConstraints.clear();
+	for (size_t i = 0; i < profile_list.size(); i++)
+		this->_mConstraints.push_back(Constraint{ profile_list[i], inside_list[i] != 0 });
+	for (int axis = 0; axis < 2; axis++)
+	{
+		this->_mParMin[axis] = par_min[axis];
+		this->_mParMax[axis] = par_max[axis];
+	}
+	this->invalidate();
+}
+
+double RefFace::clearance(double u, double v)
+{
+	double dist = std::min(std::min(u, 1.0 - u), std::min(v, 1.0 - v));
+	for (auto& c : this->_mConstraints)
+		dist = std::min(dist, c.profile->boundary_distance(u, v));
+	return dist;
+}
+
+bool RefFace::reference_uv(double& u, double& v)
+{
+	if (!this->_bRefValid)
+	{
+		this->_bRefValid = true;
+		this->_bRefFound = false;
+
+		if (!this->is_cap())
+		{
+			this->_mRefUV[0] = 0.5;
+			this->_mRefUV[1] = 0.5;
+			this->_bRefFound = true;
+		}
+		else
+		{
+			// Sample the cell centers of the parametric bounding box
+			double step[2];
+			for (int axis = 0; axis < 2; axis++)
+				step[axis] = (this->_mParMax[axis] - this->_mParMin[axis]) / REFGEOM_GRID_SIZE;
+
+			double best = -1.0;
+			for (int i = 0; i < REFGEOM_GRID_SIZE; i++)
+			{
+				for (int j = 0; j < REFGEOM_GRID_SIZE; j++)
+				{
+					double su = this->_mParMin[0] + (i + 0.5) * step[0];
+					double sv = this->_mParMin[1] + (j + 0.5) * step[1];
+					if (!this->contains(su, sv))
+						continue;
+					double dist = this->clearance(su, sv);
+					if (dist > best)
+					{
+						best = dist;
+						this->_mRefUV[0] = su;
+						this->_mRefUV[1] = sv;
+					}
+				}
+			}
+
+			// Narrow regions, like the no model zone, might fall between the samples. Try both sides of the profile edges.
+			if (best < 0.0)
+			{
+				double h = std::max(step[0], step[1]);
+				for (auto& c : this->_mConstraints)
+				{
+					delamo::Span<const delamo::TPoint3<double>> pts = c.profile->points();
+					int num_pts = (int)pts.size();
+					for (int i = 0; i < num_pts; i++)
+					{
+						const delamo::TPoint3<double>& p0 = pts[i];
+						const delamo::TPoint3<double>& p1 = pts[(i + 1) % num_pts];
+						double eu = p1[0] - p0[0];
+						double ev = p1[1] - p0[1];
+						double elen = std::sqrt(eu * eu + ev * ev);
+						if (elen <= 0.0)
+							continue;
+						double mu = (p0[0] + p1[0]) / 2.0;
+						double mv = (p0[1] + p1[1]) / 2.0;
+						for (double dist_edge = h / 4.0; dist_edge > h / 256.0; dist_edge /= 4.0)
+						{
+							for (int side = -1; side <= 1; side += 2)
+							{
+								double su = mu - side * dist_edge * ev / elen;
+								double sv = mv + side * dist_edge * eu / elen;
+								if (!this->contains(su, sv))
+									continue;
+								double dist = this->clearance(su, sv);
+								if (dist > best)
+								{
+									best = dist;
+									this->_mRefUV[0] = su;
+									this->_mRefUV[1] = sv;
+								}
+							}
+						}
+					}
+				}
+			}
+
+			this->_bRefFound = (best >= 0.0);
+		}
+	}
+
+	u = this->_mRefUV[0];
+	v = this->_mRefUV[1];
+	return this->_bRefFound;
+}
+
+bool RefFace::reference(delamo::TPoint3<double>& pt, delamo::TPoint3<double>& normal)
+{
+	double u, v;
+	if (!this->reference_uv(u, v))
+		return false;
+	this->evaluate(u, v, pt, normal);
+	return true;
+}
+
+void RefFace::bounding_box(delamo::TPoint3<double>& bbox_min, delamo::TPoint3<double>& bbox_max)
+{
+	bbox_min = delamo::TPoint3<double>(std::numeric_limits<double>::max());
+	bbox_max = delamo::TPoint3<double>(-std::numeric_limits<double>::max());
+
+	// Sample the parametric bounding box, side faces are sampled along the boundary on both caps
+	const int num_samples = 9;
+	for (int i = 0; i < num_samples; i++)
+	{
+		for (int j = 0; j < num_samples; j++)
+		{
+			double su = this->_mParMin[0] + (this->_mParMax[0] - this->_mParMin[0]) * i / (num_samples - 1);
+			double sv = this->_mParMin[1] + (this->_mParMax[1] - this->_mParMin[1]) * j / (num_samples - 1);
+			delamo::TPoint3<double> pt, normal;
+			this->evaluate(su, sv, pt, normal);
+			for (int axis = 0; axis < 3; axis++)
+			{
+				bbox_min[axis] = std::min(bbox_min[axis], pt[axis]);
+				bbox_max[axis] = std::max(bbox_max[axis], pt[axis]);
+			}
+		}
+	}
+
+	// Expand the box to cover the surface between the samples
+	double pad = 0.02 * length3(bbox_max - bbox_min);
+	bbox_min -= pad;
+	bbox_max += pad;
+}
+
+delamo::List< delamo::TPoint3<double> >& RefFace::facets()
+{
+	if (this->_bFacetsValid)
+		return this->_mFacets;
+
+	this->_mFacets.clear();
+	this->_bFacetsValid = true;
+
+	// Side faces have a single row of cells across the thickness
+	int num_u = REFGEOM_FACET_SIZE;
+	int num_v = this->is_cap() ? REFGEOM_FACET_SIZE : 1;
+
+	// Evaluate the grid vertices once
+	std::vector< delamo::TPoint3<double> > grid_pts((num_u + 1) * (num_v + 1));
+	std::vector< delamo::TPoint3<double> > grid_normals((num_u + 1) * (num_v + 1));
+	for (int i = 0; i <= num_u; i++)
+	{
+		for (int j = 0; j <= num_v; j++)
+		{
+			double su = this->_mParMin[0] + (this->_mParMax[0] - this->_mParMin[0]) * i / num_u;
+			double sv = this->_mParMin[1] + (this->_mParMax[1] - this->_mParMin[1]) * j / num_v;
+			this->evaluate(su, sv, grid_pts[i * (num_v + 1) + j], grid_normals[i * (num_v + 1) + j]);
+		}
+	}
+
+	for (int i = 0; i < num_u; i++)
+	{
+		for (int j = 0; j < num_v; j++)
+		{
+			int idx[4] = { i * (num_v + 1) + j, (i + 1) * (num_v + 1) + j, (i + 1) * (num_v + 1) + j + 1, i * (num_v + 1) + j + 1 };
+			int tris[2][3] = { { 0, 1, 2 }, { 0, 2, 3 } };
+			double cell_u[4] = { double(i), double(i + 1), double(i + 1), double(i) };
+			double cell_v[4] = { double(j), double(j), double(j + 1), double(j + 1) };
+			for (int t = 0; t < 2; t++)
+			{
+				// Keep the triangles whose centroids are inside the face
+				double cu = 0.0, cv = 0.0;
+				for (int k = 0; k < 3; k++)
+				{
+					cu += cell_u[tris[t][k]] / 3.0;
+					cv += cell_v[tris[t][k]] / 3.0;
+				}
+				cu = this->_mParMin[0] + (this->_mParMax[0] - this->_mParMin[0]) * cu / num_u;
+				cv = this->_mParMin[1] + (this->_mParMax[1] - this->_mParMin[1]) * cv / num_v;
+				if (this->is_cap() && !this->contains(cu, cv))
+					continue;
+
+				delamo::TPoint3<double> a = grid_pts[idx[tris[t][0]]];
+				delamo::TPoint3<double> b = grid_pts[idx[tris[t][1]]];
+				delamo::TPoint3<double> c = grid_pts[idx[tris[t][2]]];
+
+				// Orient the triangle along the outward normal
+				if (dot3(cross3(b - a, c - a), grid_normals[idx[tris[t][0]]]) < 0.0)
+					std::swap(b, c);
+				this->_mFacets.push_back(a);
+				this->_mFacets.push_back(b);
+				this->_mFacets.push_back(c);
+			}
+		}
+	}
+
+	return this->_mFacets;
+}
+
+double RefFace::closest_point(const delamo::TPoint3<double>& pt, delamo::TPoint3<double>& closest, delamo::TPoint3<double>& normal)
+{
+	// Exact projection if the closest point of the surface is inside the face
+	if (this->is_cap())
+	{
+		double u, v;
+		this->_pSurface->project(pt, this->_mLevel, u, v);
+		if (this->contains(u, v))
+		{
+			this->evaluate(u, v, closest, normal);
+			return length3(closest - pt);
+		}
+	}
+
+	// Otherwise, use the tessellation
+	delamo::List< delamo::TPoint3<double> >& tris = this->_bFacetsValid ? this->_mFacets : this->facets();
+	double dist_min = std::numeric_limits<double>::max();
+	int num_tris = (int)tris.size() / 3;
+	for (int t = 0; t < num_tris; t++)
+	{
+		const delamo::TPoint3<double>& a = tris[3 * t];
+		const delamo::TPoint3<double>& b = tris[3 * t + 1];
+		const delamo::TPoint3<double>& c = tris[3 * t + 2];
+		delamo::TPoint3<double> tri_pt = closest_point_triangle(pt, a, b, c);
+		double dist = length3(tri_pt - pt);
+		if (dist < dist_min)
+		{
+			dist_min = dist;
+			closest = tri_pt;
+			normal = cross3(b - a, c - a);
+		}
+	}
+	double normal_len = length3(normal);
+	if (dist_min < std::numeric_limits<double>::max() && normal_len > 0.0)
+		normal /= normal_len;
+	return dist_min;
+}
+
+void RefFace::invalidate()
+{
+	this->_bRefValid = false;
+	this->_bRefFound = false;
+	this->_mRefUV[0] = 0.5;
+	this->_mRefUV[1] = 0.5;
+	this->_bFacetsValid = false;
+	this->_mFacets.clear();
+}
+
+
+RefBody::RefBody(RefSurface* surf, double level_mold, double level_far)
+{
+	this->_pSurface = surf;
+	this->_mLevelMold = level_mold;
+	this->_mLevelFar = level_far;
+}
+
+RefBody::~RefBody()
+{
+	for (auto face : this->_mFaces)
+		delete face;
+	this->_mFaces.clear();
+}
+
+RefSurface* RefBody::surface()
+{
+	return this->_pSurface;
+}
+
+double RefBody::level_mold()
+{
+	return this->_mLevelMold;
+}
+
+double RefBody::level_far()
+{
+	return this->_mLevelFar;
+}
+
+bool RefBody::is_sheet()
+{
+	return this->_mLevelMold == this->_mLevelFar;
+}
+
+void RefBody::add_face(RefFace* face)
+{
+	this->_mFaces.add(face);
+}
+
+delamo::List<RefFace*>& RefBody::faces()
+{
+	return this->_mFaces;
+}
+
+void RefBody::bounding_box(delamo::TPoint3<double>& bbox_min, delamo::TPoint3<double>& bbox_max)
+{
+	bbox_min = delamo::TPoint3<double>(std::numeric_limits<double>::max());
+	bbox_max = delamo::TPoint3<double>(-std::numeric_limits<double>::max());
+	for (auto face : this->_mFaces)
+	{
+		delamo::TPoint3<double> face_min, face_max;
+		face->bounding_box(face_min, face_max);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			bbox_min[axis] = std::min(bbox_min[axis], face_min[axis]);
+			bbox_max[axis] = std::max(bbox_max[axis], face_max[axis]);
+		}
+	}
+}
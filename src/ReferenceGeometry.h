@@ -0,0 +1,432 @@
+#ifndef REFERENCEGEOMETRY_H
+#define REFERENCEGEOMETRY_H
+
+#include "APIConfig.h"
+// Export file is generated by CMake's GenerateExportHeader module
+#include "modelbuilder_export.h"
+
+
+// Number of grid cells along one parametric direction for projection seeds and region sampling
+#define REFGEOM_GRID_SIZE 32
+
+// Number of grid cells along one parametric direction for tessellation
+#define REFGEOM_FACET_SIZE 16
+
+class RefBody;
+
+/**
+ * \brief Offset surface family of a NURBS surface.
+ *
+ * A point at the level t is defined as S(u, v) + t * n(u, v), where S is the NURBS surface and n is its unit normal.
+ * All layers generated from the same mold share the same surface object, so their faces can be compared in the parametric
+ * space. The NURBS surface is copied and oriented so that its normal points to +z direction like the ACIS backend.
+ */
+class MODELBUILDER_EXPORT RefSurface
+{
+public:
+
+	/**
+	 * \brief Creates the surface from a copy of the input NURBS surface.
+	 * \param nurbs_in input NURBS surface
+	 */
+	explicit RefSurface(delamo::NURBS<double>* nurbs_in);
+
+	/**
+	 * \brief Default destructor.
+	 */
+	~RefSurface();
+
+	/**
+	 * \brief Checks whether the NURBS surface can be evaluated or not.
+	 * \return TRUE if the surface is valid, otherwise FALSE
+	 */
+	bool valid();
+
+	/**
+	 * \brief Evaluates the point and the unit normal at the given parametric position and level.
+	 * \param[in] u u-coordinate, clamped into [0, 1]
+	 * \param[in] v v-coordinate, clamped into [0, 1]
+	 * \param[in] level offset distance along the normal
+	 * \param[out] pt evaluated point
+	 * \param[out] normal unit normal of the surface
+	 */
+	void evaluate(double u, double v, double level, delamo::TPoint3<double>& pt, delamo::TPoint3<double>& normal);
+
+	/**
+	 * \brief Evaluates the point, the unit normal and the first derivatives at the given parametric position.
+	 * \param[in] u u-coordinate, clamped into [0, 1]
+	 * \param[in] v v-coordinate, clamped into [0, 1]
+	 * \param[out] pt surface point at level zero
+	 * \param[out] normal unit normal of the surface
+	 * \param[out] der_u first derivative w.r.t. u
+	 * \param[out] der_v first derivative w.r.t. v
+	 */
+	void derivatives(double u, double v, delamo::TPoint3<double>& pt, delamo::TPoint3<double>& normal, delamo::TPoint3<double>& der_u, delamo::TPoint3<double>& der_v);
+
+	/**
+	 * \brief Finds the parametric position of the closest point on the surface at the given level.
+	 *
+	 * The closest grid sample is used as the initial guess for the Gauss-Newton iterations.
+	 * \param[in] pt query point
+	 * \param[in] level offset distance along the normal
+	 * \param[out] u u-coordinate of the closest point
+	 * \param[out] v v-coordinate of the closest point
+	 */
+	void project(const delamo::TPoint3<double>& pt, double level, double& u, double& v);
+
+	/**
+	 * \brief Gets the oriented copy of the input NURBS surface.
+	 * \return NURBS surface
+	 */
+	delamo::NURBS<double>* nurbs();
+
+private:
+	delamo::NURBS<double> _mNurbs; /**< Copy of the input NURBS surface */
+	bool _bValid; /**< TRUE if the NURBS surface can be evaluated */
+	std::vector< delamo::TPoint3<double> > _mGridPoints; /**< Surface points sampled on the parametric grid */
+	std::vector< delamo::TPoint3<double> > _mGridNormals; /**< Unit normals sampled on the parametric grid */
+};
+
+/**
+ * \brief Closed polygon in the parametric space of a RefSurface.
+ *
+ * Delamination outlines are imprinted to the faces as polygonal profiles, so the faces do not need a B-rep.
+ */
+class MODELBUILDER_EXPORT RefProfile
+{
+public:
+
+	/**
+	 * \brief Creates the profile from the parametric positions, z-coordinates are ignored.
+	 *
+	 * The last point is dropped if it is equal to the first one.
+	 * \param pts parametric positions of the polygon vertices
+	 */
+	explicit RefProfile(delamo::Span<const delamo::TPoint3<double>> pts);
+
+	/**
+	 * \brief Checks whether the parametric position is inside the polygon or not.
+	 * \param u u-coordinate
+	 * \param v v-coordinate
+	 * \return TRUE if the position is inside the polygon, otherwise FALSE
+	 */
+	bool contains(double u, double v);
+
+	/**
+	 * \brief Computes the distance between the parametric position and the polygon boundary.
+	 * \param u u-coordinate
+	 * \param v v-coordinate
+	 * \return distance to the closest polygon edge
+	 */
+	double boundary_distance(double u, double v);
+
+	/**
+	 * \brief Generates a new profile by offsetting the polygon inwards.
+	 *
+	 * The vertices are moved along the miter directions of the adjacent edges, so the offset is exact for the straight edges.
+	 * \param distance offset distance in the parametric space
+	 * \return new profile, nullptr if the polygon vanishes or flips
+	 */
+	RefProfile* offset(double distance);
+
+	/**
+	 * \brief Gets the bounding box of the polygon.
+	 * \param[out] bbox_min minimum corner
+	 * \param[out] bbox_max maximum corner
+	 */
+	void bounding_box(delamo::TPoint3<double>& bbox_min, delamo::TPoint3<double>& bbox_max);
+
+	/**
+	 * \brief Gets the vertices of the polygon.
+	 * \return view of the polygon vertices
+	 */
+	delamo::Span<const delamo::TPoint3<double>> points();
+
+	/**
+	 * \brief Computes the signed area of the polygon.
+	 * \return signed area, positive for counter-clockwise polygons
+	 */
+	double area();
+
+private:
+	delamo::List< delamo::TPoint3<double> > _mPoints; /**< Polygon vertices, the polygon is closed implicitly */
+	delamo::TPoint3<double> _mBBoxMin; /**< Minimum corner of the bounding box */
+	delamo::TPoint3<double> _mBBoxMax; /**< Maximum corner of the bounding box */
+};
+
+/**
+ * \brief Face of a RefBody.
+ *
+ * A cap face lies on a RefSurface at a constant level and covers the parametric domain which satisfies all of its profile
+ * constraints. A side face connects the caps along one of the parametric domain boundaries.
+ */
+class MODELBUILDER_EXPORT RefFace
+{
+public:
+
+	/**
+	 * \brief Creates a cap face covering the whole parametric domain.
+	 * \param owner body which owns the face
+	 * \param surf underlying surface
+	 * \param level offset distance of the cap
+	 * \param normal_sign +1 if the face normal is along the surface normal, otherwise -1
+	 */
+	RefFace(RefBody* owner, RefSurface* surf, double level, double normal_sign);
+
+	/**
+	 * \brief Creates a side face.
+	 * \param owner body which owns the face
+	 * \param surf underlying surface
+	 * \param side domain boundary; 0: u=0, 1: u=1, 2: v=0, 3: v=1
+	 * \param level_start level of the first cap
+	 * \param level_end level of the second cap
+	 */
+	RefFace(RefBody* owner, RefSurface* surf, int side, double level_start, double level_end);
+
+	/**
+	 * \brief Gets the body which owns the face.
+	 * \return owner body
+	 */
+	RefBody* owner();
+
+	/**
+	 * \brief Gets the underlying surface.
+	 * \return surface
+	 */
+	RefSurface* surface();
+
+	/**
+	 * \brief Checks whether the face is a cap face or not.
+	 * \return TRUE if the face is a cap, FALSE if it is a side face
+	 */
+	bool is_cap();
+
+	/**
+	 * \brief Gets the level of a cap face.
+	 * \return offset distance of the cap
+	 */
+	double level();
+
+	/**
+	 * \brief Gets the orientation of the face normal w.r.t. the surface normal.
+	 * \return +1 or -1
+	 */
+	double normal_sign();
+
+	/**
+	 * \brief Checks whether the parametric position is inside the face or not.
+	 * \param u u-coordinate (position along the boundary for side faces)
+	 * \param v v-coordinate (position across the thickness for side faces)
+	 * \return TRUE if the position is inside the face, otherwise FALSE
+	 */
+	bool contains(double u, double v);
+
+	/**
+	 * \brief Evaluates the point and the outward normal of the face at the given parametric position.
+	 * \param[in] u u-coordinate (position along the boundary for side faces)
+	 * \param[in] v v-coordinate (position across the thickness for side faces)
+	 * \param[out] pt evaluated point
+	 * \param[out] normal outward unit normal
+	 */
+	void evaluate(double u, double v, delamo::TPoint3<double>& pt, delamo::TPoint3<double>& normal);
+
+	/**
+	 * \brief Splits the face with the profile.
+	 *
+	 * If the profile crosses the face, the face keeps the region outside the profile and a new face is created for the
+	 * region inside the profile. The new face is added to the owner body.
+	 * \param[in] profile profile to be imprinted
+	 * \param[out] inside_face new face, nullptr if the face is not split
+	 * \return -1 if the face is outside the profile, 1 if the face is inside the profile, 0 if the face is split
+	 */
+	int split(RefProfile* profile, RefFace*& inside_face);
+
+	/**
+	 * \brief Checks whether the face was split with the profile or not.
+	 * \param profile profile to be checked
+	 * \return TRUE if the profile is one of the face constraints, otherwise FALSE
+	 */
+	bool is_constrained(RefProfile* profile);
+
+	/**
+	 * \brief Gets the profiles which were imprinted to the face.
+	 * \return list of the profile constraints
+	 */
+	delamo::List<RefProfile*> profiles();
+
+	/**
+	 * \brief Gets the domain boundary of a side face.
+	 * \return domain boundary index, -1 for cap faces
+	 */
+	int side();
+
+	/**
+	 * \brief Gets the second cap level of a side face.
+	 * \return level of the second cap, same as level() for cap faces
+	 */
+	double level_end();
+
+	/**
+	 * \brief Gets the profile constraints of the face.
+	 * \param[out] profile_list imprinted profiles
+	 * \param[out] inside_list 1 if the face is inside the corresponding profile, otherwise 0
+	 * \param[out] par_min minimum corner of the parametric bounding box
+	 * \param[out] par_max maximum corner of the parametric bounding box
+	 */
+	void constraints(delamo::List<RefProfile*>& profile_list, delamo::List<int>& inside_list, double* par_min, double* par_max);
+
+	/**
+	 * \brief Replaces the profile constraints of the face, e.g. while restoring the face from a cache.
+	 * \param[in] profile_list imprinted profiles
+	 * \param[in] inside_list 1 if the face is inside the corresponding profile, otherwise 0
+	 * \param[in] par_min minimum corner of the parametric bounding box
+	 * \param[in] par_max maximum corner of the parametric bounding box
+	 */
+	void constraints(delamo::Span<RefProfile* const> profile_list, delamo::Span<const int> inside_list, const double* par_min, const double* par_max);
+
+	/**
+	 * \brief Finds a parametric position well inside the face.
+	 *
+	 * The sampled position with the largest distance to the face boundary is chosen, so that the containment checks on the
+	 * reference points are robust. The result is cached until the face is split.
+	 * \param[out] u u-coordinate
+	 * \param[out] v v-coordinate
+	 * \return FALSE if the face region is empty, otherwise TRUE
+	 */
+	bool reference_uv(double& u, double& v);
+
+	/**
+	 * \brief Evaluates the reference point and the outward normal of the face.
+	 * \param[out] pt reference point
+	 * \param[out] normal outward unit normal at the reference point
+	 * \return FALSE if the face region is empty, otherwise TRUE
+	 */
+	bool reference(delamo::TPoint3<double>& pt, delamo::TPoint3<double>& normal);
+
+	/**
+	 * \brief Computes the bounding box of the face.
+	 * \param[out] bbox_min minimum corner
+	 * \param[out] bbox_max maximum corner
+	 */
+	void bounding_box(delamo::TPoint3<double>& bbox_min, delamo::TPoint3<double>& bbox_max);
+
+	/**
+	 * \brief Tessellates the face.
+	 *
+	 * The triangles are oriented along the outward normal and cached until the face is split.
+	 * \return triangle vertices, three consecutive points for each triangle
+	 */
+	delamo::List< delamo::TPoint3<double> >& facets();
+
+	/**
+	 * \brief Finds the closest point on the face.
+	 *
+	 * Cap faces are projected exactly if the projection lies inside the face, otherwise the tessellation is used.
+	 * The function doesn't modify the face if the tessellation is already cached.
+	 * \param[in] pt query point
+	 * \param[out] closest closest point
+	 * \param[out] normal outward unit normal at the closest point
+	 * \return distance between the query point and the closest point
+	 */
+	double closest_point(const delamo::TPoint3<double>& pt, delamo::TPoint3<double>& closest, delamo::TPoint3<double>& normal);
+
+private:
+	// Profile constraint of a cap face
+	struct Constraint
+	{
+		RefProfile* profile; /**< Imprinted profile */
+		bool inside; /**< TRUE if the face is inside the profile */
+	};
+
+	RefBody* _pOwner; /**< Body which owns the face */
+	RefSurface* _pSurface; /**< Underlying surface */
+	int _mSide; /**< -1 for cap faces, domain boundary index for side faces */
+	double _mLevel; /**< Level of the cap, or the first cap level for side faces */
+	double _mLevelEnd; /**< Second cap level for side faces */
+	double _mNormalSign; /**< Orientation of the cap normal */
+	std::vector<Constraint> _mConstraints; /**< Profile constraints of the cap */
+	double _mParMin[2]; /**< Minimum corner of the parametric bounding box */
+	double _mParMax[2]; /**< Maximum corner of the parametric bounding box */
+	bool _bRefValid; /**< TRUE if the cached reference position is valid */
+	bool _bRefFound; /**< TRUE if the face region is not empty */
+	double _mRefUV[2]; /**< Cached reference position */
+	bool _bFacetsValid; /**< TRUE if the cached tessellation is valid */
+	delamo::List< delamo::TPoint3<double> > _mFacets; /**< Cached tessellation */
+
+	double clearance(double u, double v);
+	void invalidate();
+};
+
+/**
+ * \brief Faceted solid or sheet body between two levels of a RefSurface.
+ *
+ * The body owns its faces. Sheet bodies have a single cap face and they are used as molds.
+ */
+class MODELBUILDER_EXPORT RefBody
+{
+public:
+
+	/**
+	 * \brief Creates an empty body.
+	 * \param surf underlying surface
+	 * \param level_mold level of the mold side
+	 * \param level_far level of the opposite side, equal to level_mold for sheet bodies
+	 */
+	RefBody(RefSurface* surf, double level_mold, double level_far);
+
+	/**
+	 * \brief Deletes the faces of the body.
+	 */
+	~RefBody();
+
+	/**
+	 * \brief Gets the underlying surface.
+	 * \return surface
+	 */
+	RefSurface* surface();
+
+	/**
+	 * \brief Gets the level of the mold side.
+	 * \return level
+	 */
+	double level_mold();
+
+	/**
+	 * \brief Gets the level of the side opposite to the mold.
+	 * \return level
+	 */
+	double level_far();
+
+	/**
+	 * \brief Checks whether the body is a sheet body or not.
+	 * \return TRUE if the body is a sheet, otherwise FALSE
+	 */
+	bool is_sheet();
+
+	/**
+	 * \brief Adds a face to the body. The body takes ownership of the face.
+	 * \param face face to be added
+	 */
+	void add_face(RefFace* face);
+
+	/**
+	 * \brief Gets the faces of the body.
+	 * \return list of faces
+	 */
+	delamo::List<RefFace*>& faces();
+
+	/**
+	 * \brief Computes the bounding box of the body.
+	 * \param[out] bbox_min minimum corner
+	 * \param[out] bbox_max maximum corner
+	 */
+	void bounding_box(delamo::TPoint3<double>& bbox_min, delamo::TPoint3<double>& bbox_max);
+
+private:
+	RefSurface* _pSurface; /**< Underlying surface */
+	double _mLevelMold; /**< Level of the mold side */
+	double _mLevelFar; /**< Level of the opposite side */
+	delamo::List<RefFace*> _mFaces; /**< Faces of the body */
+};
+
+#endif // !REFERENCEGEOMETRY_H
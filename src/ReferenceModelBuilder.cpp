@@ -0,0 +1,1889 @@
+#include "ReferenceModelBuilder.h"
+
+
+// Angle between the input unit normal and the z-axis in degrees
+static double angle_to_z(const delamo::TPoint3<double>& normal, double reference_normal_z)
+{
+	double cos_angle = std::max(-1.0, std::min(1.0, normal.z() * reference_normal_z));
+	return std::acos(cos_angle) * 180.0 / std::acos(-1.0);
+}
+
+// Cache key of the polygon vertices of a RefProfile
+static unsigned long long profile_cache_key(RefProfile* profile)
+{
+	FingerprintBuilder key;
+	for (auto& pt : profile->points())
+	{
+		key.add(pt.x());
+		key.add(pt.y());
+		key.add(pt.z());
+	}
+	return key.value().hash();
+}
+
+// Appends a NURBS surface to a cache entry
+static void write_nurbs(CacheWriter& writer, delamo::NURBS<double>* nurbs)
+{
+	writer.write(nurbs->degree_u());
+	writer.write(nurbs->degree_v());
+	writer.write(nurbs->knotvector_u_len());
+	for (int i = 0; i < nurbs->knotvector_u_len(); i++)
+		writer.write(nurbs->knotvector_u()[i]);
+	writer.write(nurbs->knotvector_v_len());
+	for (int i = 0; i < nurbs->knotvector_v_len(); i++)
+		writer.write(nurbs->knotvector_v()[i]);
+	writer.write(nurbs->ctrlpts_u_len());
+	writer.write(nurbs->ctrlpts_v_len());
+	for (int i = 0; i < nurbs->ctrlpts_len(); i++)
+	{
+		writer.write(nurbs->ctrlpts()[i].x());
+		writer.write(nurbs->ctrlpts()[i].y());
+		writer.write(nurbs->ctrlpts()[i].z());
+	}
+	bool has_weights = (nurbs->weights() != nullptr);
+	writer.write(has_weights ? 1 : 0);
+	for (int i = 0; has_weights && i < nurbs->ctrlpts_len(); i++)
+		writer.write(nurbs->weights()[i]);
+}
+
+// Reads a NURBS surface written by write_nurbs()
+static bool read_nurbs(CacheReader& reader, delamo::NURBS<double>& nurbs)
+{
+	int degree_u = 0, degree_v = 0, knots_len = 0, ctrlpts_u_len = 0, ctrlpts_v_len = 0, has_weights = 0;
+	delamo::List<double> knots_u, knots_v, weights;
+	delamo::List< delamo::TPoint3<double> > ctrlpts;
+
+	reader.read(degree_u);
+	reader.read(degree_v);
+	reader.read(knots_len);
+	for (int i = 0; reader.good() && i < knots_len; i++)
+	{
+		double knot = 0.0;
+		reader.read(knot);
+		knots_u.add(knot);
+	}
+	reader.read(knots_len);
+	for (int i = 0; reader.good() && i < knots_len; i++)
+	{
+		double knot = 0.0;
+		reader.read(knot);
+		knots_v.add(knot);
+	}
+	reader.read(ctrlpts_u_len);
+	reader.read(ctrlpts_v_len);
+	for (int i = 0; reader.good() && i < ctrlpts_u_len * ctrlpts_v_len; i++)
+	{
+		double x = 0.0, y = 0.0, z = 0.0;
+		reader.read(x);
+		reader.read(y);
+		reader.read(z);
+		ctrlpts.add(delamo::TPoint3<double>(x, y, z));
+	}
+	reader.read(has_weights);
+	for (int i = 0; reader.good() && has_weights != 0 && i < ctrlpts_u_len * ctrlpts_v_len; i++)
+	{
+		double weight = 0.0;
+		reader.read(weight);
+		weights.add(weight);
+	}
+	if (!reader.good() || ctrlpts.size() == 0 || knots_u.size() == 0 || knots_v.size() == 0)
+		return false;
+
+	nurbs.ctrlpts(&ctrlpts[0], ctrlpts_u_len, ctrlpts_v_len);
+	nurbs.knotvector_u(&knots_u[0], (int)knots_u.size());
+	nurbs.knotvector_v(&knots_v[0], (int)knots_v.size());
+	nurbs.degree_u(degree_u);
+	nurbs.degree_v(degree_v);
+	if (has_weights != 0)
+		nurbs.weights(&weights[0], (int)weights.size());
+	return true;
+}
+
+ReferenceModelBuilder::~ReferenceModelBuilder()
+{
+	// Release the geometry if the user forgets to stop the modeler
+	if (this->_bStarted)
+		this->stop();
+}
+
+void ReferenceModelBuilder::start()
+{
+	// The reference modeler has no licensing or kernel initialization steps
+	this->_bStarted = true;
+}
+
+void ReferenceModelBuilder::stop()
+{
+	// Bodies own their faces and the faces refer to the surfaces and the profiles
+	for (auto body : this->_mBodies)
+		delete body;
+	this->_mBodies.clear();
+
+	for (auto profile : this->_mProfiles)
+		delete profile;
+	this->_mProfiles.clear();
+
+	for (auto surf : this->_mSurfaces)
+		delete surf;
+	this->_mSurfaces.clear();
+
+	this->_mSurfaceKeys.clear();
+	this->_mProfileKeys.clear();
+
+	this->_bStarted = false;
+}
+
+void ReferenceModelBuilder::debug_mode(bool flag)
+{
+	if (!this->_bStarted)
+		this->_mDebugMode = flag;
+	else
+		std::cout << "ERROR: Cannot change debugging mode after starting the Model Builder!" << std::endl;
+}
+
+void ReferenceModelBuilder::is_builder_started()
+{
+	if (!this->_bStarted)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Please start the Model Builder before using it!" << std::endl;
+		this->error_handler();
+	}
+}
+
+bool ReferenceModelBuilder::thread_safe_modeling()
+{
+	return true;
+}
+
+const char* ReferenceModelBuilder::cache_format()
+{
+	return "Reference-1";
+}
+
+bool ReferenceModelBuilder::save_cache_body(LayerBody* lb, std::string& blob, delamo::List<DLM_FACEP>& faces)
+{
+	return this->save_ref_body((RefBody*)lb->body(), blob, faces);
+}
+
+bool ReferenceModelBuilder::restore_cache_body(LayerBody* lb, const std::string& blob, delamo::List<DLM_FACEP>& faces)
+{
+	RefBody* body = (RefBody*)lb->body();
+	if (!this->restore_ref_body(body, blob, faces))
+		return false;
+	lb->body(body);
+	return true;
+}
+
+void ReferenceModelBuilder::release_cache_body(LayerBody* lb)
+{
+	this->delete_ref_body((RefBody*)lb->body());
+	lb->body(nullptr);
+}
+
+bool ReferenceModelBuilder::save_cache_mold(LayerMold* lm, std::string& blob)
+{
+	delamo::List<DLM_FACEP> faces;
+	return this->save_ref_body((RefBody*)lm->body(), blob, faces);
+}
+
+bool ReferenceModelBuilder::restore_cache_mold(LayerMold* lm, const std::string& blob)
+{
+	RefBody* body = (RefBody*)lm->body();
+	delamo::List<DLM_FACEP> faces;
+	if (!this->restore_ref_body(body, blob, faces))
+		return false;
+	lm->body(body);
+	return true;
+}
+
+void ReferenceModelBuilder::release_cache_mold(LayerMold* lm)
+{
+	this->delete_ref_body((RefBody*)lm->body());
+	lm->body(nullptr);
+}
+
+void ReferenceModelBuilder::delete_ref_body(RefBody* body)
+{
+	if (body == nullptr)
+		return;
+
+	// Bodies are deleted one by one, the order of the list does not matter
+	std::lock_guard<std::mutex> lock(this->_mGeometryMutex);
+	for (int i = 0; i < (int)this->_mBodies.size(); i++)
+	{
+		if (this->_mBodies[i] != body)
+			continue;
+		this->_mBodies[i] = this->_mBodies[this->_mBodies.size() - 1];
+		this->_mBodies.pop_back();
+		delete body;
+		return;
+	}
+}
+
+bool ReferenceModelBuilder::save_ref_body(RefBody* body, std::string& blob, delamo::List<DLM_FACEP>& faces)
+{
+	if (body == nullptr)
+		return false;
+
+	// Collect the profiles, they are shared by the faces
+	std::vector<RefProfile*> profiles;
+	std::unordered_map<RefProfile*, int> profile_index;
+	for (auto face : body->faces())
+	{
+		for (auto profile : face->profiles())
+		{
+			if (profile_index.insert(std::make_pair(profile, (int)profiles.size())).second)
+				profiles.push_back(profile);
+		}
+	}
+
+	CacheWriter writer;
+	write_nurbs(writer, body->surface()->nurbs());
+	writer.write(body->level_mold());
+	writer.write(body->level_far());
+
+	writer.write((int)profiles.size());
+	for (auto profile : profiles)
+	{
+		delamo::Span<const delamo::TPoint3<double>> pts = profile->points();
+		writer.write((int)pts.size());
+		for (auto& pt : pts)
+		{
+			writer.write(pt.x());
+			writer.write(pt.y());
+			writer.write(pt.z());
+		}
+
+		// The restored faces should refer to the same profile objects as the faces generated in this run
+		std::lock_guard<std::mutex> lock(this->_mGeometryMutex);
+		this->_mProfileKeys.insert(std::make_pair(profile_cache_key(profile), profile));
+	}
+
+	writer.write((int)body->faces().size());
+	for (auto face : body->faces())
+	{
+		delamo::List<RefProfile*> profile_list;
+		delamo::List<int> inside_list;
+		double par_min[2], par_max[2];
+		face->constraints(profile_list, inside_list, par_min, par_max);
+
+		writer.write(face->side());
+		writer.write(face->level());
+		writer.write(face->level_end());
+		writer.write(face->normal_sign());
+		writer.write(par_min[0]);
+		writer.write(par_min[1]);
+		writer.write(par_max[0]);
+		writer.write(par_max[1]);
+		writer.write((int)profile_list.size());
+		for (int i = 0; i < (int)profile_list.size(); i++)
+		{
+			writer.write(profile_index[profile_list[i]]);
+			writer.write(inside_list[i]);
+		}
+		faces.add(face);
+	}
+
+	blob = writer.buffer();
+	return true;
+}
+
+bool ReferenceModelBuilder::restore_ref_body(RefBody*& body_io, const std::string& blob, delamo::List<DLM_FACEP>& faces)
+{
+	CacheReader reader(blob);
+
+	// Find the surface of the body, the bodies on the same surface should share it
+	delamo::NURBS<double> nurbs;
+	if (!read_nurbs(reader, nurbs))
+		return false;
+	RefSurface* surf = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(this->_mGeometryMutex);
+		unsigned long long surf_key = this->fingerprint(&nurbs).hash();
+		auto found = this->_mSurfaceKeys.find(surf_key);
+		if (found != this->_mSurfaceKeys.end())
+		{
+			surf = found->second;
+		}
+		else
+		{
+			surf = new RefSurface(&nurbs);
+			this->_mSurfaces.add(surf);
+			this->_mSurfaceKeys[surf_key] = surf;
+		}
+	}
+	if (!surf->valid())
+		return false;
+
+	double level_mold = 0.0, level_far = 0.0;
+	reader.read(level_mold);
+	reader.read(level_far);
+
+	// Find or create the profiles
+	int num_profiles = 0;
+	reader.read(num_profiles);
+	std::vector<RefProfile*> profiles;
+	for (int p = 0; reader.good() && p < num_profiles; p++)
+	{
+		int num_pts = 0;
+		reader.read(num_pts);
+		delamo::List< delamo::TPoint3<double> > pts;
+		for (int i = 0; reader.good() && i < num_pts; i++)
+		{
+			double x = 0.0, y = 0.0, z = 0.0;
+			reader.read(x);
+			reader.read(y);
+			reader.read(z);
+			pts.add(delamo::TPoint3<double>(x, y, z));
+		}
+		if (!reader.good())
+			return false;
+
+		RefProfile* profile = new RefProfile(pts);
+		std::lock_guard<std::mutex> lock(this->_mGeometryMutex);
+		auto inserted = this->_mProfileKeys.insert(std::make_pair(profile_cache_key(profile), profile));
+		if (inserted.second)
+		{
+			this->_mProfiles.add(profile);
+		}
+		else
+		{
+			delete profile;
+			profile = inserted.first->second;
+		}
+		profiles.push_back(profile);
+	}
+
+	// Read all face records before modifying the body
+	struct FaceRecord
+	{
+		int side;
+		double level;
+		double level_end;
+		double normal_sign;
+		double par_min[2];
+		double par_max[2];
+		std::vector<RefProfile*> profile_list;
+		std::vector<int> inside_list;
+	};
+	int num_faces = 0;
+	reader.read(num_faces);
+	std::vector<FaceRecord> records;
+	for (int f = 0; reader.good() && f < num_faces; f++)
+	{
+		FaceRecord rec;
+		int num_constraints = 0;
+		reader.read(rec.side);
+		reader.read(rec.level);
+		reader.read(rec.level_end);
+		reader.read(rec.normal_sign);
+		reader.read(rec.par_min[0]);
+		reader.read(rec.par_min[1]);
+		reader.read(rec.par_max[0]);
+		reader.read(rec.par_max[1]);
+		reader.read(num_constraints);
+		for (int i = 0; reader.good() && i < num_constraints; i++)
+		{
+			int profile_idx = -1, inside = 0;
+			reader.read(profile_idx);
+			reader.read(inside);
+			if (profile_idx < 0 || profile_idx >= (int)profiles.size())
+				return false;
+			rec.profile_list.push_back(profiles[profile_idx]);
+			rec.inside_list.push_back(inside);
+		}
+		records.push_back(rec);
+	}
+	if (!reader.good())
+		return false;
+
+	// Keep the existing body if the cached one is generated from it, so that the LayerSurface objects stay valid
+	RefBody* body = body_io;
+	bool is_new_body = (body == nullptr || body->surface() != surf || body->level_mold() != level_mold || body->level_far() != level_far || (int)body->faces().size() > num_faces);
+	if (is_new_body)
+	{
+		body = new RefBody(surf, level_mold, level_far);
+		std::lock_guard<std::mutex> lock(this->_mGeometryMutex);
+		this->_mBodies.add(body);
+	}
+
+	for (int f = 0; f < num_faces; f++)
+	{
+		FaceRecord& rec = records[f];
+		RefFace* face;
+		if (f < (int)body->faces().size())
+		{
+			face = body->faces()[f];
+		}
+		else
+		{
+			if (rec.side < 0)
+				face = new RefFace(body, surf, rec.level, rec.normal_sign);
+			else
+				face = new RefFace(body, surf, rec.side, rec.level, rec.level_end);
+			body->add_face(face);
+		}
+		face->constraints(delamo::Span<RefProfile* const>(rec.profile_list.data(), rec.profile_list.size()), delamo::Span<const int>(rec.inside_list.data(), rec.inside_list.size()), rec.par_min, rec.par_max);
+		faces.add(face);
+	}
+
+	body_io = body;
+	return true;
+}
+
+RefBody* ReferenceModelBuilder::create_sheet(RefSurface* surf, double level)
+{
+	RefBody* sheet_body = new RefBody(surf, level, level);
+	sheet_body->add_face(new RefFace(sheet_body, surf, level, 1.0));
+	std::lock_guard<std::mutex> lock(this->_mGeometryMutex);
+	this->_mBodies.add(sheet_body);
+	return sheet_body;
+}
+
+void ReferenceModelBuilder::process_layer(Layer *layer_in, RefBody* sheet_body_in, Direction ldir)
+{
+	// Generate a LayerBody object
+	LayerBody *layer_body = this->new_layer_body();
+	// Set layer body name
+	std::string body_name = "LB" + std::to_string(layer_in->next_lb_id);
+	layer_body->name(body_name.c_str());
+	// Set owner
+	layer_body->owner(layer_in);
+
+	// Always consider the direction
+	double layer_thickness = layer_in->thickness();
+	if (ldir == Direction::ORIG)
+		layer_thickness = -1 * layer_thickness;
+
+	// Generate the block between the mold and the offset level
+	RefSurface* surf = sheet_body_in->surface();
+	double level_mold = sheet_body_in->level_mold();
+	double level_far = level_mold + layer_thickness;
+	double level_lo = std::min(level_mold, level_far);
+	double level_hi = std::max(level_mold, level_far);
+
+	RefBody* current_body = new RefBody(surf, level_mold, level_far);
+	current_body->add_face(new RefFace(current_body, surf, level_lo, -1.0));
+	current_body->add_face(new RefFace(current_body, surf, level_hi, 1.0));
+	for (int side = 0; side < 4; side++)
+		current_body->add_face(new RefFace(current_body, surf, side, level_lo, level_hi));
+	{
+		std::lock_guard<std::mutex> lock(this->_mGeometryMutex);
+		this->_mBodies.add(current_body);
+	}
+	layer_body->body(current_body);
+
+	// Caps facing the surface normal are on the OFFSET side, the others are on the ORIG side
+	double reference_normal_z = (ldir == Direction::ORIG) ? -1.0 : 1.0;
+	delamo::List<LayerSurface*> lsc_new;
+	lsc_new.reserve(current_body->faces().size());
+	for (auto current_face : current_body->faces())
+	{
+		LayerSurface *current_layersurface = this->new_layer_surface();
+		current_layersurface->id(layer_body->next_ls_id + lsc_new.size());
+		current_layersurface->face(current_face);
+		this->update_point_normal(current_layersurface, reference_normal_z, true);
+		if (!current_face->is_cap())
+			current_layersurface->direction(Direction::SIDE);
+		else if (current_face->normal_sign() > 0)
+			current_layersurface->direction(Direction::OFFSET);
+		else
+			current_layersurface->direction(Direction::ORIG);
+		// This layer surface is generated at the initial create_layer() stage
+		current_layersurface->initial_surface();
+		// Set owner of the surface
+		current_layersurface->owner(layer_body);
+
+		lsc_new.add(current_layersurface);
+	}
+
+	// Add the generated layer surface objects to the layer body
+	layer_body->add_surfaces(lsc_new);
+
+	// Add layer body to the layer
+	layer_in->add_body(layer_body);
+}
+
+void ReferenceModelBuilder::generate_mold(Layer *layer_in)
+{
+	// Loop through all layer bodies to generate mold
+	for (auto& layerbody : *layer_in)
+	{
+		RefBody* current_body = (RefBody*)layerbody->body();
+		if (current_body == NULL || current_body->is_sheet())
+		{
+			if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+				std::cout << "ERROR: Cannot generate mold. Check your input!" << std::endl;
+			this->error_handler();
+		}
+
+		// Molds always cover the whole surface at the levels of the caps
+		double level_lo = std::min(current_body->level_mold(), current_body->level_far());
+		double level_hi = std::max(current_body->level_mold(), current_body->level_far());
+
+		// Store the offset mold inside the layer
+		LayerMold *layer_mold_offset = this->new_layer_mold();
+		layer_mold_offset->body(this->create_sheet(current_body->surface(), level_hi));
+		layer_mold_offset->direction(Direction::OFFSET);
+		layer_mold_offset->owner(layer_in);
+		layer_in->add_mold(layer_mold_offset);
+
+		// Store a reference for the offset mold for delamination imprinting if and only if there exists no reference mold
+		LayerMold* delam_profile_ref_mold = layer_in->delam_profile_ref();
+		if (delam_profile_ref_mold == nullptr)
+			layer_in->delam_profile_ref(layer_mold_offset);
+
+		// Store the orig mold inside the layer
+		LayerMold *layer_mold_orig = this->new_layer_mold();
+		layer_mold_orig->body(this->create_sheet(current_body->surface(), level_lo));
+		layer_mold_orig->direction(Direction::ORIG);
+		layer_mold_orig->owner(layer_in);
+		layer_in->add_mold(layer_mold_orig);
+
+		// Add orig mold to the LayerBody object
+		layerbody->mold(layer_mold_orig);
+	}
+
+	// Molds are identified by the layer they are generated from
+	this->fingerprint_molds(layer_in);
+}
+
+void ReferenceModelBuilder::do_create_layer(delamo::NURBS<double> *nurbs_in, Direction ldir, double thickness, Layer *layer_out)
+{
+	// Create the mold surface
+	RefSurface* surf = new RefSurface(nurbs_in);
+	if (!surf->valid())
+	{
+		delete surf;
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Cannot evaluate the input NURBS surface. Check your input!" << std::endl;
+		this->error_handler();
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(this->_mGeometryMutex);
+		this->_mSurfaces.add(surf);
+		this->_mSurfaceKeys.insert(std::make_pair(this->fingerprint(surf->nurbs()).hash(), surf));
+	}
+
+	// Set layer type
+	layer_out->type(LayerType::LAMINA);
+
+	// Set layer generation direction
+	layer_out->direction(ldir);
+
+	// Set thickness of the layer (NURBS layer is always the first one)
+	layer_out->position(0.0, thickness);
+
+	// Create the layer
+	this->process_layer(layer_out, this->create_sheet(surf, 0.0), ldir);
+}
+
+void ReferenceModelBuilder::do_create_layer(Layer *layer_in, Direction ldir, double thickness, Layer *layer_out)
+{
+	// Set layer type
+	layer_out->type(LayerType::LAMINA);
+
+	// Set layer generation direction
+	layer_out->direction(ldir);
+
+	// Initial position depends on the input direction
+	double pos_at_orig;
+	if (ldir == Direction::OFFSET)
+		pos_at_orig = layer_in->position_offset();
+	else
+		pos_at_orig = layer_in->position_orig();
+
+	// Set thickness of the layer
+	layer_out->position(pos_at_orig, pos_at_orig + thickness);
+
+	LayerMold** lm_list = layer_in->list_mold();
+	int lm_list_size = layer_in->size_mold();
+
+	for (int i = 0; i < lm_list_size; i++)
+	{
+		// Use mold in the chosen direction
+		if (ldir == lm_list[i]->direction())
+		{
+			if (lm_list[i]->is_stiffener_gen() && MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_WARN)
+				std::cout << "WARNING: Stiffened molds are processed as regular molds by the reference backend" << std::endl;
+
+			// Molds are never modified, so the new body can use the mold directly
+			this->process_layer(layer_out, (RefBody*)lm_list[i]->body(), ldir);
+		}
+	}
+}
+
+void ReferenceModelBuilder::do_create_layer(LayerMold *mold_in, Direction ldir, double thickness, Layer *layer_out)
+{
+	// Retrieve sheet body from input LayerMold
+	RefBody* sheet_body = (RefBody*)mold_in->body();
+
+	// Set layer type
+	layer_out->type(LayerType::LAMINA);
+
+	// Set layer generation direction
+	layer_out->direction(ldir);
+
+	// Find the z position of the sheet body
+	delamo::TPoint3<double> sheet_pos, sheet_normal;
+	sheet_body->surface()->evaluate(0.0, 0.0, sheet_body->level_mold(), sheet_pos, sheet_normal);
+	layer_out->position(sheet_pos.z(), sheet_pos.z() + thickness);
+
+	// Create the layer
+	this->process_layer(layer_out, sheet_body, ldir);
+}
+
+void ReferenceModelBuilder::imprint_bodies(RefBody* target_body, RefBody* tool_body)
+{
+	delamo::List<RefFace*>& target_faces = target_body->faces();
+	for (auto tool_face : tool_body->faces())
+	{
+		if (!tool_face->is_cap())
+			continue;
+
+		for (auto profile : tool_face->profiles())
+		{
+			// The list grows while splitting, the new faces are also checked for the remaining profiles
+			for (int i = 0; i < (int)target_faces.size(); i++)
+			{
+				RefFace* target_face = target_faces[i];
+				if (!target_face->is_cap() || target_face->surface() != tool_face->surface() || target_face->is_constrained(profile))
+					continue;
+
+				// Only the touching faces are imprinted
+				if (target_face->normal_sign() * tool_face->normal_sign() > 0 || std::abs(target_face->level() - tool_face->level()) > this->tolerance())
+					continue;
+
+				RefFace* inside_face;
+				target_face->split(profile, inside_face);
+			}
+		}
+	}
+}
+
+void ReferenceModelBuilder::update_imprinted_surfaces(Layer *layer_in, Direction surf_direction)
+{
+	// Use a reference normal according to layer generation direction
+	double reference_normal_z = (Direction::ORIG == layer_in->direction()) ? -1.0 : 1.0;
+
+	for (auto& lb : *layer_in)
+	{
+		RefBody* current_body = (RefBody*)lb->body();
+		delamo::List<RefFace*>& facelist = current_body->faces();
+
+		// Only update the LayerSurface list if we have new faces
+		if ((int)facelist.size() <= lb->size())
+			continue;
+
+		// Container to store the LayerSurface objects of the new faces
+		delamo::List<LayerSurface *> lsc_new;
+		lsc_new.reserve(facelist.size() - lb->size());
+
+		for (auto current_face : facelist)
+		{
+			// Number of profiles is the topology tag of the face
+			unsigned long long topo_tag = current_face->profiles().size();
+
+			// Check if this face exists in our list
+			int face_idx = lb->face_id(current_face);
+			if (face_idx >= 0)
+			{
+				LayerSurface* face_ls = lb->at(face_idx);
+				if (surf_direction == face_ls->direction())
+				{
+					// Update existing LayerSurface
+					face_ls->initial_surface(false);
+
+					// Only the faces changed by imprinting need a new reference point and normal
+					if (topo_tag != face_ls->topology_tag())
+					{
+						face_ls->topology_tag(topo_tag);
+						this->update_point_normal(face_ls, reference_normal_z, false);
+					}
+				}
+			}
+			else
+			{
+				LayerSurface *current_layersurface = this->new_layer_surface();
+				current_layersurface->id(lb->next_ls_id + lsc_new.size());
+				current_layersurface->face(current_face);
+				current_layersurface->topology_tag(topo_tag);
+				this->update_point_normal(current_layersurface, reference_normal_z, true);
+				current_layersurface->direction(surf_direction);
+				current_layersurface->owner(lb);
+				lsc_new.add(current_layersurface);
+			}
+		}
+
+		// Add the generated layer surface objects to the layer body
+		lb->add_surfaces(lsc_new);
+	}
+}
+
+void ReferenceModelBuilder::update_point_normal(LayerSurface* ls_in, double reference_normal_z, bool update_angle)
+{
+	RefFace* face_in = (RefFace*)ls_in->face();
+	delamo::TPoint3<double> eval_pos, eval_normal;
+	if (!face_in->reference(eval_pos, eval_normal))
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Cannot find a reference point on the face " << ls_in->id() << std::endl;
+		this->error_handler();
+	}
+
+	ls_in->point_coords(eval_pos);
+	ls_in->normal_coords(eval_normal);
+	if (update_angle)
+		ls_in->angle(angle_to_z(eval_normal, reference_normal_z));
+}
+
+void ReferenceModelBuilder::do_adjacent_layers(Layer *layer_orig, Layer *layer_offset)
+{
+	// Find pairs before applying any imprint operations
+	this->update_surface_pairs(layer_offset, layer_orig);
+
+	// Imprint layers to each other
+	int skipped_imprints = 0;
+	for (auto& lb_orig : *layer_orig)
+	{
+		for (auto& lb_offset : *layer_offset)
+		{
+			// Bodies which are not touching each other have nothing to imprint
+			if (!this->bodies_overlap(lb_orig, lb_offset))
+			{
+				skipped_imprints++;
+				continue;
+			}
+			this->imprint_bodies((RefBody*)lb_orig->body(), (RefBody*)lb_offset->body());
+			this->imprint_bodies((RefBody*)lb_offset->body(), (RefBody*)lb_orig->body());
+		}
+	}
+	this->_mSkippedImprints += skipped_imprints;
+
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO && skipped_imprints > 0)
+		std::cout << "INFO: Skipped " << skipped_imprints << " imprint operations between non-overlapping layer bodies" << std::endl;
+
+	// All new faces should be on the OFFSET side for orig layer and on the ORIG side for offset layer
+	this->update_imprinted_surfaces(layer_orig, Direction::OFFSET);
+	this->update_imprinted_surfaces(layer_offset, Direction::ORIG);
+
+	// Update layer surface owners after imprinting operation
+	layer_orig->update_owners();
+	layer_offset->update_owners();
+
+	// New layer surfaces generated by imprinting will be paired here
+	this->update_surface_pairs(layer_offset, layer_orig);
+}
+
+void ReferenceModelBuilder::do_adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name)
+{
+	// Read delamination points
+	delamo::TPoint3<double>* delampts = nullptr;
+	int delampts_size;
+	this->read_delamination_file(file_name, delampts, delampts_size);
+
+	// Check if we were able to load some points from the file
+	if (delampts == nullptr)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: There is a problem processing delamination profile. Please check your input file: " << std::string(file_name) << std::endl;
+		this->error_handler();
+		return;
+	}
+	else
+	{
+		// Check if the last and the first delamination profile points are equal
+		if (delampts[0] != delampts[delampts_size - 1])
+		{
+			if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+				std::cout << "ERROR: The first and the last delamination profile points must be equal. Skipping delamination imprint..." << std::endl;
+
+			// Do layer imprinting without delamination
+			delete[] delampts;
+			this->do_adjacent_layers(layer_orig, layer_offset);
+			return;
+		}
+	}
+
+	// Update surface pairs before processing delamination
+	this->update_surface_pairs(layer_offset, layer_orig);
+
+	// Process delamination
+	this->process_delamination(layer_orig, layer_offset, delampts, delampts_size);
+
+	// Delete delamination points
+	delete[] delampts;
+	delampts = nullptr;
+
+	// Update layer surface owners after imprinting operation
+	layer_orig->update_owners();
+	layer_offset->update_owners();
+
+	// New layer surfaces generated by imprinting will be paired here
+	this->update_modified_surface_pairs(layer_offset, layer_orig);
+}
+
+void ReferenceModelBuilder::do_adjacent_layers(Layer *layer_orig, Layer* layer_offset, delamo::List<std::string>& file_names)
+{
+	// Update surface pairs before processing delamination
+	this->update_surface_pairs(layer_offset, layer_orig);
+
+	// Imprint the delamination profiles which do not overlap each other together
+	if (this->batch_delaminations())
+	{
+		this->process_delamination_batch(layer_orig, layer_offset, file_names);
+	}
+	else
+	{
+		for (auto file_name : file_names)
+		{
+			// Read delamination points
+			delamo::TPoint3<double>* delampts = nullptr;
+			int delampts_size;
+			this->read_delamination_file(file_name.c_str(), delampts, delampts_size);
+
+			// Check if we were able to load some points from the file
+			if (delampts == nullptr)
+			{
+				if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+					std::cout << "ERROR: There is a problem processing delamination profile. Please check your input file: " << std::string(file_name) << std::endl;
+				this->error_handler();
+				continue;
+			}
+			else
+			{
+				// Check if the last and the first delamination profile points are equal
+				if (delampts[0] != delampts[delampts_size - 1])
+				{
+					if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+						std::cout << "ERROR: The first and the last delamination profile points must be equal. Skipping delamination imprint..." << std::endl;
+					delete[] delampts;
+					continue;
+				}
+			}
+
+			// Process delamination
+			this->process_delamination(layer_orig, layer_offset, delampts, delampts_size);
+
+			// Delete delamination points
+			delete[] delampts;
+			delampts = nullptr;
+
+			// Update layer surface owners after imprinting operation
+			layer_orig->update_owners();
+			layer_offset->update_owners();
+
+			// New layer surfaces generated by imprinting will be paired here
+			this->update_modified_surface_pairs(layer_offset, layer_orig);
+		}
+	}
+}
+
+void ReferenceModelBuilder::process_delamination(Layer *layer_orig, Layer *layer_offset, delamo::TPoint3<double>* delampts, int delampts_size)
+{
+	// Check if the orig layer has 1 mold with a single face on its offset direction
+	RefFace* ref_mold = this->find_delam_ref_face(layer_orig);
+	if (ref_mold == NULL)
+		return;
+
+	// Generate delamination profiles, only once for all faces of the interface
+	RefProfile* outer_profile; RefProfile* inner_profile;
+	if (!this->generate_delamination_profiles(ref_mold, delampts, delampts_size, outer_profile, inner_profile))
+		return;
+
+	// Imprint delamination shape to both layers
+	this->imprint_delamination_profiles(layer_orig, layer_offset, outer_profile, inner_profile, true);
+}
+
+void ReferenceModelBuilder::process_delamination_batch(Layer *layer_orig, Layer *layer_offset, delamo::List<std::string>& file_names)
+{
+	// Read all delamination outlines up front
+	std::vector< delamo::List< delamo::TPoint3<double> > > outlines;
+	for (auto file_name : file_names)
+	{
+		delamo::List< delamo::TPoint3<double> > delampts;
+		this->read_delamination_file(file_name.c_str(), delampts);
+
+		// Check if we were able to load some points from the file
+		if (delampts.size() == 0)
+		{
+			if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+				std::cout << "ERROR: There is a problem processing delamination profile. Please check your input file: " << std::string(file_name) << std::endl;
+			this->error_handler();
+			continue;
+		}
+
+		// Check if the last and the first delamination profile points are equal
+		if (delampts[0] != delampts[delampts.size() - 1])
+		{
+			if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+				std::cout << "ERROR: The first and the last delamination profile points must be equal. Skipping delamination imprint..." << std::endl;
+			continue;
+		}
+
+		outlines.push_back(delampts);
+	}
+
+	if (outlines.empty())
+		return;
+
+	// Check if the orig layer has 1 mold with a single face on its offset direction
+	RefFace* ref_mold = this->find_delam_ref_face(layer_orig);
+	if (ref_mold == NULL)
+		return;
+
+	// Profiles are generated in the parametric space of the reference face, so their bounding boxes can be compared directly
+	std::vector<RefProfile*> outer_profiles;
+	std::vector<RefProfile*> inner_profiles;
+	delamo::List< delamo::TPoint3<double> > bbox_min;
+	delamo::List< delamo::TPoint3<double> > bbox_max;
+	for (auto& delampts : outlines)
+	{
+		RefProfile* outer_profile; RefProfile* inner_profile;
+		if (!this->generate_delamination_profiles(ref_mold, delampts.data(), (int)delampts.size(), outer_profile, inner_profile))
+			continue;
+		outer_profiles.push_back(outer_profile);
+		inner_profiles.push_back(inner_profile);
+
+		delamo::TPoint3<double> pp_min, pp_max;
+		outer_profile->bounding_box(pp_min, pp_max);
+		bbox_min.add(pp_min);
+		bbox_max.add(pp_max);
+	}
+
+	// Outlines in the same group do not overlap each other, so they can be imprinted together
+	delamo::List<int> group_ids;
+	int num_groups = group_disjoint_regions(bbox_min, bbox_max, this->tolerance(), group_ids);
+
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO)
+		std::cout << "INFO: Imprinting " << outer_profiles.size() << " delamination profiles in " << num_groups << " batches" << std::endl;
+
+	for (int group = 0; group < num_groups; group++)
+	{
+		// Imprint the whole group without pairing the surfaces after each imprinting couple
+		for (int i = 0; i < (int)outer_profiles.size(); i++)
+		{
+			if (group_ids[i] == group)
+				this->imprint_delamination_profiles(layer_orig, layer_offset, outer_profiles[i], inner_profiles[i], false);
+		}
+
+		// Update layer surface owners after imprinting operation
+		layer_orig->update_owners();
+		layer_offset->update_owners();
+
+		// Pair the new layer surfaces once per group, the next group uses these pairs
+		this->update_modified_surface_pairs(layer_offset, layer_orig);
+	}
+}
+
+RefFace* ReferenceModelBuilder::find_delam_ref_face(Layer *layer_orig)
+{
+	// Check if the orig layer has 1 mold with a single face on its offset direction
+	LayerMold* delam_profile_ref_mold = layer_orig->delam_profile_ref();
+	if (delam_profile_ref_mold == nullptr)
+	{
+		std::cout << "ERROR: Cannot find a reference face for delamination profile generation. Please check your input layers. Aborting delamination imprinting!" << std::endl;
+		return NULL;
+	}
+
+	RefBody* ref_mold_sb = (RefBody*)delam_profile_ref_mold->body();
+	if (ref_mold_sb == NULL || ref_mold_sb->faces().size() != 1)
+	{
+		std::cout << "ERROR: Reference mold has multiple faces. Aborting delamination imprinting!" << std::endl;
+		return NULL;
+	}
+
+	return ref_mold_sb->faces()[0];
+}
+
+bool ReferenceModelBuilder::generate_delamination_profiles(RefFace* ref_face, delamo::TPoint3<double>* delampts, int delampts_size, RefProfile*& outer_profile, RefProfile*& inner_profile)
+{
+	outer_profile = nullptr;
+	inner_profile = nullptr;
+
+	// Offset distance is scaled with the size of the reference face, as the offset is computed in the parametric space
+	delamo::List< delamo::TPoint3<double> >& ref_facets = ref_face->facets();
+	delamo::TPoint3<double> face_min(std::numeric_limits<double>::max());
+	delamo::TPoint3<double> face_max(-std::numeric_limits<double>::max());
+	for (auto& pt : ref_facets)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			face_min[axis] = std::min(face_min[axis], pt[axis]);
+			face_max[axis] = std::max(face_max[axis], pt[axis]);
+		}
+	}
+	double multifact = std::max(face_max.x() - face_min.x(), face_max.y() - face_min.y());
+
+	// Find parametric positions of the delamination outline w.r.t. reference face's surface
+	delamo::List< delamo::TPoint3<double> > outer_parpos;
+	outer_parpos.reserve(delampts_size);
+	for (int i = 0; i < delampts_size; i++)
+	{
+		double u, v;
+		ref_face->surface()->project(delampts[i], ref_face->level(), u, v);
+		outer_parpos.add(delamo::TPoint3<double>(u, v, 0.0));
+	}
+
+	outer_profile = new RefProfile(outer_parpos);
+	if (outer_profile->points().size() < 3 || std::abs(outer_profile->area()) <= 0.0)
+	{
+		delete outer_profile;
+		outer_profile = nullptr;
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Input delamination profile points do not enclose a region. Check your input!" << std::endl;
+		this->error_handler();
+		return false;
+	}
+
+	// Offset outer profile to create inner profile
+	inner_profile = outer_profile->offset(this->offset_distance() / multifact);
+	if (inner_profile == nullptr)
+	{
+		delete outer_profile;
+		outer_profile = nullptr;
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Offsetting input profile does not generate a valid inner profile. Please check your input profile!" << std::endl;
+		this->error_handler();
+		return false;
+	}
+
+	// The split faces refer to the profiles until the modeler is stopped
+	std::lock_guard<std::mutex> lock(this->_mGeometryMutex);
+	this->_mProfiles.add(outer_profile);
+	this->_mProfiles.add(inner_profile);
+	return true;
+}
+
+void ReferenceModelBuilder::imprint_delamination_profiles(Layer *layer_orig, Layer *layer_offset, RefProfile* outer_profile, RefProfile* inner_profile, bool pair_each_couple)
+{
+	// Imprint delamination shape to both layers
+	for (auto& lb_orig : *layer_orig) // START LB LOOP
+	{
+		// Container to store faces after imprint operation
+		delamo::List<LayerSurface *> lsc_new_orig;
+
+		for (auto& ls_orig : *lb_orig) // START LS LOOP
+		{
+			// Only imprint to the faces in the chosen direction
+			if (Direction::OFFSET == ls_orig->direction() && DelaminationType::COHESIVE == ls_orig->delam_type())
+			{
+				// Imprint delamination outlines
+				this->imprint_delamination(ls_orig, Direction::OFFSET, outer_profile, inner_profile, lsc_new_orig);
+
+				// OFFSET PAIR
+				LayerSurface* ls_offset = ls_orig->pair();
+				if (ls_offset != nullptr)
+				{
+					LayerBody* lb_offset = ls_offset->owner();
+
+					// Imprint delamination outlines
+					delamo::List<LayerSurface *> lsc_new_offset;
+					this->imprint_delamination(ls_offset, Direction::ORIG, outer_profile, inner_profile, lsc_new_offset);
+
+					// Add new faces to the layer body
+					lb_offset->add_surfaces(lsc_new_offset);
+					lsc_new_offset.clear();
+				}
+
+				// Update surface pairs of the new and modified surfaces after each imprinting couple
+				if (pair_each_couple)
+					this->update_modified_surface_pairs(layer_orig, layer_offset);
+			}
+		} // END LS LOOP
+
+		// Add new faces to the layer body
+		lb_orig->add_surfaces(lsc_new_orig);
+		lsc_new_orig.clear();
+
+	} // END LB LOOP
+}
+
+void ReferenceModelBuilder::imprint_delamination(LayerSurface* layersurface_in, Direction surf_direction, RefProfile* outer_profile, RefProfile* inner_profile, delamo::List<LayerSurface *>& lsc_new)
+{
+	// Get stiffened paired property from the input LayerSurface
+	bool stiffener_paired_flag = layersurface_in->is_stiffener_paired();
+
+	// Get the layer body and the face contained in the input layer surface
+	LayerBody* current_lb = layersurface_in->owner();
+	RefFace* face_in = (RefFace*)layersurface_in->face();
+
+	// Split the face with the outer profile, nothing to imprint if the profile doesn't overlap the face
+	RefFace* face_outer = nullptr;
+	int outer_status = face_in->split(outer_profile, face_outer);
+	if (outer_status < 0)
+		return;
+	if (outer_status > 0)
+		face_outer = face_in;
+
+	// Split the region inside the outer profile with the inner profile
+	RefFace* face_inner = nullptr;
+	int inner_status = face_outer->split(inner_profile, face_inner);
+	if (inner_status != 0)
+		face_inner = nullptr;
+
+	// The input face and the new faces need to be classified
+	RefFace* faces_changed[3] = { face_in, (face_outer != face_in) ? face_outer : nullptr, face_inner };
+
+	DelaminationType delam_type;
+	for (auto f : faces_changed)
+	{
+		if (f == nullptr)
+			continue;
+
+		// Find the face in the current layer body
+		int face_idx = current_lb->face_id(f);
+		if (face_idx >= 0)
+		{
+			// We have the face in our layer surface array
+			LayerSurface* face_ls = current_lb->at(face_idx);
+			if (surf_direction == face_ls->direction() && DelaminationType::COHESIVE == face_ls->delam_type())
+			{
+				if (stiffener_paired_flag)
+				{
+					face_ls->delam_type(DelaminationType::NODELAM);
+				}
+				else
+				{
+					this->find_delam_bc(f, outer_profile, inner_profile, delam_type);
+					face_ls->delam_type(delam_type);
+				}
+
+				// Update point and normal for this layer surface
+				face_ls->topology_tag(f->profiles().size());
+				this->update_point_normal(face_ls, 1.0, false);
+				// And, this is not our initial layer surface anymore
+				face_ls->initial_surface(false);
+				face_ls->stiffener_paired(stiffener_paired_flag);
+			}
+		}
+		else
+		{
+			// Generate a new layer surface
+			LayerSurface *ls_new = this->new_layer_surface();
+			ls_new->id(current_lb->next_ls_id + lsc_new.size());
+			ls_new->face(f);
+			ls_new->topology_tag(f->profiles().size());
+			this->update_point_normal(ls_new, 1.0, true);
+			ls_new->owner(current_lb);
+			ls_new->direction(surf_direction);
+			ls_new->stiffener_paired(stiffener_paired_flag);
+
+			if (stiffener_paired_flag)
+			{
+				ls_new->delam_type(DelaminationType::NODELAM);
+			}
+			else
+			{
+				this->find_delam_bc(f, outer_profile, inner_profile, delam_type);
+				ls_new->delam_type(delam_type);
+			}
+
+			// Add to the container
+			lsc_new.add(ls_new);
+		}
+	}
+}
+
+void ReferenceModelBuilder::find_delam_bc(RefFace* face_in, RefProfile* outer_profile, RefProfile* inner_profile, DelaminationType& delam_type)
+{
+	// The faces are either completely inside or outside of the profiles, so testing the reference point is enough
+	double u, v;
+	face_in->reference_uv(u, v);
+
+	if (!outer_profile->contains(u, v))
+		delam_type = DelaminationType::COHESIVE;
+	else if (inner_profile->contains(u, v))
+		delam_type = DelaminationType::CONTACT;
+	else
+		delam_type = DelaminationType::NOMODEL;
+}
+
+void ReferenceModelBuilder::update_surface_pairs(Layer *layer1, Layer *layer2)
+{
+	// Clear all surface pairs for the 1st input layer
+	for (auto& layer1_lb : *layer1)
+	{
+		for (auto& layer1_ls : *layer1_lb)
+		{
+			layer1_ls->pair_clear();
+		}
+	}
+
+	// Clear all surface pairs for the 2nd input layer
+	for (auto& layer2_lb : *layer2)
+	{
+		for (auto& layer2_ls : *layer2_lb)
+		{
+			layer2_ls->pair_clear();
+		}
+	}
+
+	// Set stiffener special condition
+	bool layer_is_stiffener = false;
+	if (LayerType::STIFFENER == layer1->type() || LayerType::STIFFENER == layer2->type())
+		layer_is_stiffener = true;
+
+	// Build the broad-phase index for the 2nd input layer
+	SurfacePairIndex layer2_index;
+	this->build_surface_index(layer2, layer2_index);
+	delamo::List<LayerSurface*> candidates;
+
+	for (auto& layer1_lb : *layer1) // START L1 LB
+	{
+		for (auto& layer1_ls : *layer1_lb) // START L1 LS
+		{
+			// Only check the surfaces which could contain the point of the layer1 surface
+			layer2_index.query(layer1_ls, candidates);
+
+			for (auto& layer2_ls : candidates) // START L2 LS
+			{
+				if (this->check_surface_pair(layer1_ls, layer2_ls))
+				{
+					layer2_ls->pair(layer1_ls);
+					layer1_ls->pair(layer2_ls);
+					layer2_ls->stiffener_paired(layer_is_stiffener);
+					layer1_ls->stiffener_paired(layer_is_stiffener);
+				}
+			} // END L2 LS
+		} // END L1 LS
+	} // END L1 LB
+
+	// All surfaces are paired now, so the modified flags can be cleared too
+	for (auto& layer1_lb : *layer1)
+	{
+		for (auto& layer1_ls : *layer1_lb)
+		{
+			if (layer_is_stiffener && layer1_ls->pair() == NULL)
+				layer1_ls->stiffener_paired(false);
+			layer1_ls->modified(false);
+		}
+	}
+	for (auto& layer2_lb : *layer2)
+	{
+		for (auto& layer2_ls : *layer2_lb)
+		{
+			if (layer_is_stiffener && layer2_ls->pair() == NULL)
+				layer2_ls->stiffener_paired(false);
+			layer2_ls->modified(false);
+		}
+	}
+}
+
+void ReferenceModelBuilder::update_modified_surface_pairs(Layer *layer1, Layer *layer2)
+{
+	// Find the surfaces created or modified since the last pairing
+	std::unordered_set<LayerSurface*> modified_ls;
+	for (auto& layer1_lb : *layer1)
+	{
+		for (auto& layer1_ls : *layer1_lb)
+		{
+			if (layer1_ls->is_modified())
+				modified_ls.insert(layer1_ls);
+		}
+	}
+	for (auto& layer2_lb : *layer2)
+	{
+		for (auto& layer2_ls : *layer2_lb)
+		{
+			if (layer2_ls->is_modified())
+				modified_ls.insert(layer2_ls);
+		}
+	}
+
+	// Existing pairs are still valid
+	if (modified_ls.empty())
+		return;
+
+	// Collect the surfaces to be paired again. These are the modified surfaces and their old pairs.
+	std::unordered_set<LayerSurface*> repair_ls;
+	SurfacePairIndex layer2_repair_index;
+	layer2_repair_index.tolerance(this->tolerance());
+	for (auto& layer1_lb : *layer1)
+	{
+		for (auto& layer1_ls : *layer1_lb)
+		{
+			if (modified_ls.count(layer1_ls) || modified_ls.count(layer1_ls->pair()))
+				repair_ls.insert(layer1_ls);
+		}
+	}
+	for (auto& layer2_lb : *layer2)
+	{
+		for (auto& layer2_ls : *layer2_lb)
+		{
+			if (modified_ls.count(layer2_ls) || modified_ls.count(layer2_ls->pair()))
+			{
+				repair_ls.insert(layer2_ls);
+
+				delamo::TPoint3<double> bbox_min, bbox_max;
+				((RefFace*)layer2_ls->face())->bounding_box(bbox_min, bbox_max);
+				layer2_repair_index.add(layer2_ls, bbox_min, bbox_max);
+			}
+		}
+	}
+
+	// Clear the surface pairs which will be computed again
+	for (auto& ls : repair_ls)
+		ls->pair_clear();
+
+	// Set stiffener special condition
+	bool layer_is_stiffener = false;
+	if (LayerType::STIFFENER == layer1->type() || LayerType::STIFFENER == layer2->type())
+		layer_is_stiffener = true;
+
+	// The surfaces to be paired again are checked against all surfaces of the 2nd layer,
+	// and the remaining surfaces of the 1st layer are only checked against the surfaces to be paired again.
+	SurfacePairIndex layer2_index;
+	this->build_surface_index(layer2, layer2_index);
+	delamo::List<LayerSurface*> candidates;
+
+	// A clean surface paired again leaves its old partner without a pair instead of an asymmetric pair. The old partner
+	// is handled with the surfaces paired again, e.g. for the stiffener flags.
+	auto release_old_pair = [&repair_ls](LayerSurface* ls, LayerSurface* new_pair) {
+		LayerSurface* old_pair = ls->pair();
+		if (old_pair == nullptr || old_pair == new_pair || old_pair->pair() != ls)
+			return;
+		old_pair->pair_clear();
+		repair_ls.insert(old_pair);
+	};
+
+	for (auto& layer1_lb : *layer1) // START L1 LB
+	{
+		for (auto& layer1_ls : *layer1_lb) // START L1 LS
+		{
+			if (repair_ls.count(layer1_ls))
+				layer2_index.query(layer1_ls, candidates);
+			else
+				layer2_repair_index.query(layer1_ls, candidates);
+
+			for (auto& layer2_ls : candidates) // START L2 LS
+			{
+				if (this->check_surface_pair(layer1_ls, layer2_ls))
+				{
+					release_old_pair(layer1_ls, layer2_ls);
+					release_old_pair(layer2_ls, layer1_ls);
+					layer2_ls->pair(layer1_ls);
+					layer1_ls->pair(layer2_ls);
+					layer2_ls->stiffener_paired(layer_is_stiffener);
+					layer1_ls->stiffener_paired(layer_is_stiffener);
+				}
+			} // END L2 LS
+		} // END L1 LS
+	} // END L1 LB
+
+	// Fix stiffener paired surface flags as in update_surface_pairs()
+	for (auto& ls : repair_ls)
+	{
+		if (layer_is_stiffener && ls->pair() == NULL)
+			ls->stiffener_paired(false);
+	}
+	for (auto& ls : modified_ls)
+		ls->modified(false);
+}
+
+bool ReferenceModelBuilder::check_surface_pair(LayerSurface* layer1_ls, LayerSurface* layer2_ls)
+{
+	RefFace* face1 = (RefFace*)layer1_ls->face();
+	RefFace* face2 = (RefFace*)layer2_ls->face();
+
+	// Check that the faces in consideration are touching caps with opposite normals
+	if (!face1->is_cap() || !face2->is_cap() || face1->normal_sign() * face2->normal_sign() > 0)
+		return false;
+
+	double u, v;
+	if (!face1->reference_uv(u, v))
+		return false;
+
+	if (face1->surface() == face2->surface())
+	{
+		// Faces of the same surface can be compared in the parametric space
+		if (std::abs(face1->level() - face2->level()) >= this->tolerance())
+			return false;
+	}
+	else
+	{
+		// Otherwise, project the reference point of the 1st face to the 2nd face
+		delamo::TPoint3<double> ref_pt = layer1_ls->point_coords();
+		face2->surface()->project(ref_pt, face2->level(), u, v);
+		delamo::TPoint3<double> proj_pt, proj_normal;
+		face2->evaluate(u, v, proj_pt, proj_normal);
+		delamo::TPoint3<double> diff = proj_pt - ref_pt;
+		if (std::sqrt(diff.x() * diff.x() + diff.y() * diff.y() + diff.z() * diff.z()) >= this->tolerance())
+			return false;
+	}
+
+	// Check that layer2 face contains the point which is on layer1 face
+	return face2->contains(u, v);
+}
+
+void ReferenceModelBuilder::build_surface_index(Layer *layer_in, SurfacePairIndex& index)
+{
+	// Bounding boxes are expanded with the model tolerance
+	index.tolerance(this->tolerance());
+
+	for (auto& lb : *layer_in)
+	{
+		for (auto& ls : *lb)
+		{
+			delamo::TPoint3<double> bbox_min, bbox_max;
+			((RefFace*)ls->face())->bounding_box(bbox_min, bbox_max);
+			index.add(ls, bbox_min, bbox_max);
+		}
+	}
+}
+
+void ReferenceModelBuilder::build_face_bvh(Layer** layer_list, int layer_list_size, FaceBVH& bvh)
+{
+	for (int i = 0; i < layer_list_size; i++)
+	{
+		for (auto& lb : *layer_list[i])
+		{
+			for (auto& ls : *lb)
+			{
+				RefFace* face = (RefFace*)ls->face();
+
+				// Generate the tessellation before the queries, so that the queries don't modify the faces
+				face->facets();
+
+				delamo::TPoint3<double> bbox_min, bbox_max;
+				face->bounding_box(bbox_min, bbox_max);
+				bvh.add(ls, lb, bbox_min, bbox_max);
+			}
+		}
+	}
+}
+
+bool ReferenceModelBuilder::bodies_overlap(LayerBody* lb1, LayerBody* lb2)
+{
+	delamo::TPoint3<double> bbox_min[2];
+	delamo::TPoint3<double> bbox_max[2];
+	LayerBody* lb_list[2] = { lb1, lb2 };
+
+	for (int i = 0; i < 2; i++)
+	{
+		// Compute the bounding box only if it is not cached
+		if (!lb_list[i]->bounding_box(bbox_min[i], bbox_max[i]))
+		{
+			((RefBody*)lb_list[i]->body())->bounding_box(bbox_min[i], bbox_max[i]);
+			lb_list[i]->bounding_box(bbox_min[i], bbox_max[i]);
+		}
+	}
+
+	// Touching bodies have overlapping boxes within the tolerance value
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (bbox_min[0][axis] > bbox_max[1][axis] + this->tolerance() || bbox_min[1][axis] > bbox_max[0][axis] + this->tolerance())
+			return false;
+	}
+	return true;
+}
+
+void ReferenceModelBuilder::find_closest_points(Layer** layer_list, int layer_list_size, delamo::TPoint3<double> point_in, delamo::TPoint3<double>*& point_list, delamo::TPoint3<double>*& normal_list, char**& name_list, int& list_size)
+{
+	// Initialize the return arrays, one element for each layer
+	list_size = layer_list_size;
+	point_list = new delamo::TPoint3<double>[list_size];
+	normal_list = new delamo::TPoint3<double>[list_size];
+	name_list = new char*[list_size];
+
+	for (int i = 0; i < list_size; i++)
+	{
+		name_list[i] = nullptr;
+		this->find_closest_face_to_point(layer_list[i], point_in, point_list[i], normal_list[i], name_list[i]);
+		if (name_list[i] == nullptr)
+			name_list[i] = strdup("");
+	}
+}
+
+void ReferenceModelBuilder::find_closest_face_to_point(Layer *layer_in, delamo::TPoint3<double> point_in, delamo::TPoint3<double>& point_out, delamo::TPoint3<double>& normal_out, char*& name_out)
+{
+	// Find the closest face
+	double distance_min = std::numeric_limits<double>::max();
+	LayerBody* closest_lb = nullptr;
+	for (auto lb : *layer_in)
+	{
+		for (auto ls : *lb)
+		{
+			delamo::TPoint3<double> closest_pos, face_normal;
+			double distance = ((RefFace*)ls->face())->closest_point(point_in, closest_pos, face_normal);
+			if (distance < distance_min)
+			{
+				point_out = closest_pos;
+				normal_out = face_normal;
+				closest_lb = lb;
+				distance_min = distance;
+			}
+		}
+	}
+
+	if (closest_lb != nullptr)
+		name_out = strdup(closest_lb->name());
+}
+
+void ReferenceModelBuilder::find_closest_faces_to_points(Layer** layer_list, int layer_list_size, delamo::TPoint3<double>* points_in, int points_in_size, delamo::TPoint3<double>*& point_list, delamo::TPoint3<double>*& normal_list, char**& name_list, int& list_size)
+{
+	// Build the hierarchy once for all query points
+	FaceBVH bvh;
+	this->build_face_bvh(layer_list, layer_list_size, bvh);
+
+	// Find the closest faces
+	FaceDistance face_distance;
+	delamo::List<FaceBVH::Result> results;
+	bvh.nearest(delamo::Span<const delamo::TPoint3<double>>(points_in, points_in_size), face_distance, results, this->query_threads());
+
+	// Initialize the return arrays
+	list_size = points_in_size;
+	point_list = new delamo::TPoint3<double>[list_size];
+	normal_list = new delamo::TPoint3<double>[list_size];
+	name_list = new char*[list_size];
+
+	for (int i = 0; i < list_size; i++)
+	{
+		if (results[i].surface == nullptr)
+		{
+			if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+				std::cout << "ERROR: Cannot find a face close to the query point (" << points_in[i].x() << ", " << points_in[i].y() << ", " << points_in[i].z() << ")" << std::endl;
+			this->error_handler();
+			name_list[i] = strdup("");
+			continue;
+		}
+
+		// Find face normal at the closest point
+		delamo::TPoint3<double> closest_pos, face_normal;
+		((RefFace*)results[i].surface->face())->closest_point(results[i].point, closest_pos, face_normal);
+
+		// Add the closest point, normal and body name to the relevant list
+		point_list[i] = results[i].point;
+		normal_list[i] = face_normal;
+		name_list[i] = strdup(results[i].body->name());
+	}
+}
+
+double ReferenceModelBuilder::FaceDistance::distance(LayerSurface* ls, const delamo::TPoint3<double>& pt, delamo::TPoint3<double>& closest)
+{
+	delamo::TPoint3<double> normal;
+	return ((RefFace*)ls->face())->closest_point(pt, closest, normal);
+}
+
+bool ReferenceModelBuilder::FaceDistance::thread_safe()
+{
+	return true;
+}
+
+void ReferenceModelBuilder::parpos_csv_to_pos(const char* csv_in, Layer *ref_layer, Direction ref_dir, const char* csv_out)
+{
+	if (ref_layer->size() > 1)
+	{
+		std::cout << "MULTI LB: This layer has already been altered by some damage-incorporation method!" << std::endl;
+		this->error_handler();
+	}
+
+	RefFace* ref_face = NULL;
+	for (auto ref_lb : *ref_layer)
+	{
+		int face_cnt = 0;
+		for (auto ref_ls : *ref_lb)
+		{
+			if (ref_ls->direction() == ref_dir)
+			{
+				ref_face = (RefFace*)ref_ls->face();
+				face_cnt++;
+			}
+		}
+		if (face_cnt > 1)
+		{
+			std::cout << "MULTI LS: This layer has already been altered by some damage-incorporation method!" << std::endl;
+			this->error_handler();
+		}
+	}
+
+	if (ref_face == NULL)
+	{
+		std::cout << "NO FACE: This layer has not been correctly generated!" << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	delamo::TPoint3<double>* pps; int pps_size;
+	read_csv_file(csv_in, pps, pps_size);
+
+	std::ofstream outfile;
+	outfile.open(csv_out);
+	outfile << "\"Points:0\",\"Points:1\",\"Points:2\"\n";
+
+	for (int i = 0; i < pps_size; i++)
+	{
+		delamo::TPoint3<double> pos_temp, normal_temp;
+		ref_face->evaluate(pps[i].x(), pps[i].y(), pos_temp, normal_temp);
+		outfile << pos_temp.x() << "," << pos_temp.y() << "," << pos_temp.z() << "\n";
+	}
+
+	outfile.close();
+	delete[] pps;
+}
+
+void ReferenceModelBuilder::write_stl(const char* file_name, const char* name, delamo::List<RefFace*>& face_list)
+{
+	std::ofstream stlFile(file_name);
+	if (!stlFile.good())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO)
+			std::cout << "Failed to open file: " << file_name << std::endl;
+		return;
+	}
+
+	stlFile << "object " << name << std::endl;
+	for (auto face : face_list)
+	{
+		delamo::List< delamo::TPoint3<double> >& triVerts = face->facets();
+		int numTriangles = (int)triVerts.size() / 3;
+		for (int triNum = 0; triNum < numTriangles; triNum++)
+		{
+			delamo::TPoint3<double> side1 = triVerts[triNum * 3 + 1] - triVerts[triNum * 3 + 0];
+			delamo::TPoint3<double> side2 = triVerts[triNum * 3 + 2] - triVerts[triNum * 3 + 0];
+			delamo::TPoint3<double> faceNormal(side1.y() * side2.z() - side1.z() * side2.y(), side1.z() * side2.x() - side1.x() * side2.z(), side1.x() * side2.y() - side1.y() * side2.x());
+			double normalLen = std::sqrt(faceNormal.x() * faceNormal.x() + faceNormal.y() * faceNormal.y() + faceNormal.z() * faceNormal.z());
+			if (normalLen > 0.0)
+				faceNormal /= normalLen;
+
+			stlFile << "facet normal " << faceNormal.x() << " " << faceNormal.y() << " " << faceNormal.z() << std::endl;
+			stlFile << "outer loop" << std::endl;
+			for (int i = 0; i < 3; i++)
+				stlFile << "\tvertex " << triVerts[triNum * 3 + i].x() << " " << triVerts[triNum * 3 + i].y() << " " << triVerts[triNum * 3 + i].z() << std::endl;
+			stlFile << "endloop" << std::endl;
+			stlFile << "endfacet" << std::endl;
+		}
+	}
+	stlFile.close();
+}
+
+void ReferenceModelBuilder::save_layer_stl(const char* file_name, Layer *layer)
+{
+	delamo::List<RefFace*> face_list;
+	for (auto& lb : *layer)
+	{
+		for (auto face : ((RefBody*)lb->body())->faces())
+			face_list.add(face);
+	}
+
+	// Set layer name based on first body name
+	const char* name = (layer->size() > 0) ? layer->at(0)->name() : "";
+	this->write_stl(file_name, name, face_list);
+}
+
+void ReferenceModelBuilder::save_layer_surface_stl(const char* file_name, Layer *layer1, Layer *layer2)
+{
+	this->update_surface_pairs(layer1, layer2);
+
+	// Collect the surfaces of layer 1 which are paired with a surface of layer 2
+	delamo::List<RefFace*> face_list;
+	for (auto& lb_in1 : *layer1)
+	{
+		for (auto& ls_in1 : *lb_in1)
+		{
+			LayerSurface* ls_pair = ls_in1->pair();
+			if (ls_pair != nullptr && ls_pair->owner() != nullptr && ls_pair->owner()->owner() == layer2)
+				face_list.add((RefFace*)ls_in1->face());
+		}
+	}
+
+	// Set layer name based on first body name
+	const char* name = (layer1->size() > 0) ? layer1->at(0)->name() : "";
+	this->write_stl(file_name, name, face_list);
+}
+
+void ReferenceModelBuilder::save_cad_model(const char* file_name, delamo::List<Layer *>& layer_list)
+{
+	// Check if there are any layers to save
+	if (layer_list.size() <= 0)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Cannot save! Nothing to save.   " << __LINE__ << std::endl;
+		this->error_handler();
+	}
+
+	// Try to create a file handle for writing
+	std::ofstream stlFile(file_name);
+	if (!stlFile.good())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Unable to open file for writing!" << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	// There is no solid model file format without a kernel, so each layer body is saved as a separate STL solid
+	int totalLayerBodies = 0;
+	for (auto layer : layer_list)
+	{
+		for (auto& lb : *layer)
+		{
+			this->write_body_stl(stlFile, lb);
+			totalLayerBodies++;
+		}
+	}
+
+	// Display the success message
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_INFO)
+	{
+		std::cout << "Saved " << totalLayerBodies << " Layer Bodies." << std::endl;
+		std::cout << "SUCCESS: Saved STL file!" << std::endl;
+	}
+
+	stlFile.close();
+}
+
+void ReferenceModelBuilder::save_cad_model(const char* file_name, delamo::List<Layer *>& layer_list, delamo::List<MBBody*>& mbbody_list)
+{
+	if (mbbody_list.size() > 0 && MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_WARN)
+		std::cout << "WARNING: Shell bodies are not supported by the reference backend and they will not be saved" << std::endl;
+
+	this->save_cad_model(file_name, layer_list);
+}
+
+void ReferenceModelBuilder::save_cad_shard(const char* file_name, Layer* /* layer */, delamo::Span<LayerBody*> bodies)
+{
+	// Try to create a file handle for writing
+	std::ofstream stlFile(file_name);
+	if (!stlFile.good())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Unable to open file for writing!" << std::endl;
+		this->error_handler();
+		return;
+	}
+
+	for (auto lb : bodies)
+		this->write_body_stl(stlFile, lb);
+
+	stlFile.close();
+	if (!stlFile)
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: Unable to write the shard " << file_name << "!" << std::endl;
+		this->error_handler();
+	}
+}
+
+const char* ReferenceModelBuilder::cad_file_extension()
+{
+	return ".stl";
+}
+
+void ReferenceModelBuilder::write_body_stl(std::ostream& out, LayerBody* lb)
+{
+	out << "solid " << lb->name() << std::endl;
+	for (auto face : ((RefBody*)lb->body())->faces())
+	{
+		delamo::List< delamo::TPoint3<double> >& triVerts = face->facets();
+		int numTriangles = (int)triVerts.size() / 3;
+		for (int triNum = 0; triNum < numTriangles; triNum++)
+		{
+			out << "facet normal 0 0 0" << std::endl;
+			out << "outer loop" << std::endl;
+			for (int i = 0; i < 3; i++)
+				out << "\tvertex " << triVerts[triNum * 3 + i].x() << " " << triVerts[triNum * 3 + i].y() << " " << triVerts[triNum * 3 + i].z() << std::endl;
+			out << "endloop" << std::endl;
+			out << "endfacet" << std::endl;
+		}
+	}
+	out << "endsolid " << lb->name() << std::endl;
+}
+
+void ReferenceModelBuilder::load_cad_model(const char* /* file_name */, bool /* text_mode */, delamo::List<LayerMold *>& /* lm_list */)
+{
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+		std::cout << "ERROR: Loading SAT files is not supported by the reference backend" << std::endl;
+	this->error_handler();
+}
+
+void ReferenceModelBuilder::create_shell_cutout_sat(const char* /* file_name */, bool /* text_mode */, delamo::List<LayerMold *>& /* lm_list */)
+{
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+		std::cout << "ERROR: Shell cutouts are not supported by the reference backend" << std::endl;
+	this->error_handler();
+}
+
+void ReferenceModelBuilder::load_shell_sat_model(const char* /* file_name */, bool /* text_mode */, delamo::List<delamo::TPoint3<double>>& /* point_list */, delamo::List<delamo::TPoint3<double>>& /* tangent_list */, delamo::List<delamo::TPoint3<double>>& /* normal_list */)
+{
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+		std::cout << "ERROR: Loading SAT files is not supported by the reference backend" << std::endl;
+	this->error_handler();
+}
+
+void ReferenceModelBuilder::load_shell_sat_model(LayerMold */* lm */, delamo::List<delamo::TPoint3<double>>& /* point_list */, delamo::List<delamo::TPoint3<double>>& /* tangent_list */, delamo::List<delamo::TPoint3<double>>& /* normal_list */)
+{
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+		std::cout << "ERROR: Shell models are not supported by the reference backend" << std::endl;
+	this->error_handler();
+}
+
+void ReferenceModelBuilder::do_split_layer(Layer */* layer_in */, const char* /* file_name */)
+{
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+		std::cout << "ERROR: Splitting layers is not supported by the reference backend" << std::endl;
+	this->error_handler();
+}
+
+void ReferenceModelBuilder::do_create_hat_stiffener(Layer */* layer_orig */, Layer */* stiffener */, const char* /* file_name */, double /* radius */)
+{
+	if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+		std::cout << "ERROR: Stiffeners are not supported by the reference backend" << std::endl;
+	this->error_handler();
+}
+
+void ReferenceModelBuilder::translate_shell_edge_points(delamo::List<delamo::TPoint3<double>>& edge_point_list, delamo::List<delamo::TPoint3<double>>& edge_normal_list, double thickness, delamo::List<delamo::TPoint3<double>>& layer_point_list)
+{
+	if (edge_point_list.size() != edge_normal_list.size())
+	{
+		if (MODELBUILDER_DEBUG_LEVEL >= MODELBUILDER_DEBUG_ERROR)
+			std::cout << "ERROR: The number of shell edge points and normals do not match!" << std::endl;
+		this->error_handler();
+	}
+
+	// Offset all points along their normals in one pass over the coordinate lanes
+	delamo::Point3Array<double> points(edge_point_list);
+	delamo::Point3Array<double> normals(edge_normal_list);
+	points.translate(normals, thickness);
+
+	// Add translated points to return list
+	points.to_list(layer_point_list);
+}
+
+LayerSurface* ReferenceModelBuilder::find_closest_side(Layer *layer_in, delamo::TPoint3<double>& point_in)
+{
+	LayerSurface* closest_ls = nullptr;
+	double min_distance = std::numeric_limits<double>::max();
+	for (auto &lb_in : *layer_in)
+	{
+		for (auto &ls_in : *lb_in)
+		{
+			if (Direction::SIDE == ls_in->direction())
+			{
+				delamo::TPoint3<double> closest_pos, face_normal;
+				double distance = ((RefFace*)ls_in->face())->closest_point(point_in, closest_pos, face_normal);
+				if (min_distance > distance)
+				{
+					min_distance = distance;
+					closest_ls = ls_in;
+				}
+			}
+		}
+	}
+	return closest_ls;
+}
+
+void ReferenceModelBuilder::find_side_faces(Layer *layer_in, delamo::List<delamo::TPoint3<double>>& side_point_list, delamo::List<delamo::TPoint3<double>>& point_out, delamo::List<delamo::TPoint3<double>>& normal_out)
+{
+	for (unsigned int sideNum = 0; sideNum < side_point_list.size(); sideNum++)
+	{
+		delamo::TPoint3<double> side_point = side_point_list[sideNum];
+		LayerSurface* closest_face = this->find_closest_side(layer_in, side_point);
+		if (closest_face == nullptr)
+			continue;
+		point_out.add(closest_face->point_coords());
+		normal_out.add(closest_face->normal_coords());
+	}
+}
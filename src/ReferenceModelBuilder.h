@@ -0,0 +1,560 @@
+#ifndef REFERENCEMODELBUILDER_H
+#define REFERENCEMODELBUILDER_H
+
+#include "ModelBuilder.h"
+#include "ReferenceGeometry.h"
+#include "SurfacePairIndex.h"
+#include "FaceBVH.h"
+
+
+/**
+ * \brief ModelBuilder sub-class which only depends on the NURBS library
+ *
+ * The reference backend represents a layer body as an offset block of the mold surface: two caps at the mold and the far
+ * levels and four side faces along the boundaries of the parametric domain. Imprinting splits the caps with polygonal
+ * profiles in the parametric space of the mold surface, so it is not a general B-rep modeler. Planar and offset-surface
+ * layers, delamination imprinting, surface pairing and face adjacency list generation work like the ACIS backend,
+ * which makes the backend suitable for benchmarking and testing without a solid modeling kernel license.
+ * Stiffeners, layer splitting and SAT file input are not supported.
+ */
+class MODELBUILDER_EXPORT ReferenceModelBuilder : public ModelBuilder
+{
+public:
+
+	/**
+	 * \brief Default constructor
+	 */
+	ReferenceModelBuilder() : ModelBuilder() { this->_bStarted = false; };
+
+	/**
+	 * \brief Constructor with a license key, the key is not used by the reference backend
+	 * \param unlock_str license key
+	 */
+	explicit ReferenceModelBuilder(const char* unlock_str) : ModelBuilder(unlock_str) { this->_bStarted = false; };
+
+	/**
+	 * \brief Default destructor
+	 */
+	virtual ~ReferenceModelBuilder();
+
+	/**
+	 * \brief Starts the reference modeler
+	 */
+	void start();
+
+	/**
+	 * \brief Stops the reference modeler and deletes all generated geometry
+	 */
+	void stop();
+
+	/**
+	 * \brief Finds the closest point and normal on each input layer
+	 *
+	 * The function initializes the point and normal list pointer array, but leaves the memory deallocation to the the user.
+	 *
+	 * \param[in] layer_list list of layers
+	 * \param[in] layer_list_size size of the layer list
+	 * \param[in] point_in reference point
+	 * \param[out] point_list list of points
+	 * \param[out] normal_list list of normals
+	 * \param[out] name_list list of layer body names
+	 * \param[out] list_size size of the point and normal lists
+	 */
+	void find_closest_points(Layer** layer_list, int layer_list_size, delamo::TPoint3<double> point_in, delamo::TPoint3<double>*& point_list, delamo::TPoint3<double>*& normal_list, char**& name_list, int& list_size);
+	using ModelBuilder::find_closest_points; /**< Keeps the container overload visible */
+
+	/**
+	 * \brief Finds the closest point and normal at this point for the input layer
+	 *
+	 * \param[in] layer_in input layer
+	 * \param[in] point_in reference point
+	 * \param[out] point_out evaluated point
+	 * \param[out] normal_out evaluated normal
+	 * \param[out] name_out name of the layer body
+	 */
+	void find_closest_face_to_point(Layer *layer_in, delamo::TPoint3<double> point_in, delamo::TPoint3<double>& point_out, delamo::TPoint3<double>& normal_out, char*& name_out);
+
+	/**
+	 * \brief Finds the closest points and normals on the faces of the input layers for a batch of query points
+	 *
+	 * A bounding volume hierarchy is built over all faces of the input layers once and it is reused for all query points.
+	 * The face distances are thread-safe, so the queries use ModelBuilder::query_threads() threads.
+	 * The function initializes the point, normal and name list pointer arrays, but leaves the memory deallocation to the user.
+	 *
+	 * \param[in] layer_list list of layers
+	 * \param[in] layer_list_size size of the layer list
+	 * \param[in] points_in list of query points
+	 * \param[in] points_in_size size of the query point list
+	 * \param[out] point_list list of the closest points, one for each query point
+	 * \param[out] normal_list list of the face normals at the closest points
+	 * \param[out] name_list list of layer body names
+	 * \param[out] list_size size of the point, normal and name lists
+	 */
+	void find_closest_faces_to_points(Layer** layer_list, int layer_list_size, delamo::TPoint3<double>* points_in, int points_in_size, delamo::TPoint3<double>*& point_list, delamo::TPoint3<double>*& normal_list, char**& name_list, int& list_size);
+	using ModelBuilder::find_closest_faces_to_points; /**< Keeps the container overload visible */
+
+	/**
+	 * \brief Converts input 2D parametric positions into 3D positions
+	 *
+	 * \param[in] csv_in file name of the input CSV file containing the parametric positions
+	 * \param[in] ref_layer reference layer for evaluation of parametric positions
+	 * \param[in] ref_dir direction of the reference surface in the layer
+	 * \param[in] csv_out file name of the output CSV file containing the evaluated 3D positions
+	 */
+	void parpos_csv_to_pos(const char* csv_in, Layer *ref_layer, Direction ref_dir, const char* csv_out);
+
+	/**
+	* \brief Saves the layer as a text STL file
+	* \param file_name name of the STL file to be saved
+	* \param layer layer to be saved in the file
+	*/
+	void save_layer_stl(const char* file_name, Layer *layer);
+
+	/**
+	* \brief Saves the boundary between layer1 and layer2 as a text STL file. Should be called AFTER adjacent_layers()/bond_layers()
+	* \param file_name name of the STL file to be saved
+	* \param layer1  First layer
+	* \param layer2  Second layer
+	*/
+	void save_layer_surface_stl(const char* file_name, Layer *layer1, Layer *layer2);
+
+	/**
+	 * \brief Sets the debugging mode flag, it can only be changed before starting the modeler
+	 * \param[in] flag enable or disable debugging mode
+	 */
+	void debug_mode(bool flag);
+
+protected:
+
+	/**
+	 * \brief Creates a new layer from a NURBS surface
+	 *
+	 * \param[in] nurbs_surface_in input NURBS surface to be used as a mold for the new layer
+	 * \param[in] ldir the layer direction in which the mold will be offset
+	 * \param[in] thickness the layer thickness
+	 * \param[out] layer_out new layer generated from the input NURBS surface
+	 */
+	void do_create_layer(delamo::NURBS<double> *nurbs_surface_in, Direction ldir, double thickness, Layer *layer_out);
+
+	/**
+	 * \brief Creates a new layer using previously generated layers as a mold
+	 *
+	 * \param[in] layer_in input layer to be used as a mold
+	 * \param[in] ldir the layer direction in which the mold will be offset
+	 * \param[in] thickness the layer thickness
+	 * \param[out] layer_out the new layer
+	 */
+	void do_create_layer(Layer *layer_in, Direction ldir, double thickness, Layer *layer_out);
+
+	/**
+	 * \brief Creates a new layer from a LayerMold object
+	 * \param[in] mold_in input mold
+	 * \param[in] ldir the layer direction in which the mold will be offset
+	 * \param[in] thickness layer thickness
+	 * \param[out] layer_out the new layer
+	 */
+	void do_create_layer(LayerMold *mold_in, Direction ldir, double thickness, Layer *layer_out);
+
+	/**
+	 * \brief Imprints the the adjacent faces of the input layers to each other
+	 *
+	 * \param layer_orig layer on the ORIG side
+	 * \param layer_offset layer on the OFFSET side
+	 */
+	void do_adjacent_layers(Layer *layer_orig, Layer *layer_offset);
+
+	/**
+	 * \brief Imprints delamination profile to the input layers
+	 *
+	 * \param layer_orig layer on the ORIG side
+	 * \param layer_offset layer on the OFFSET side
+	 * \param file_name CSV file containing the outer delamination profile
+	 */
+	void do_adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name);
+
+	/**
+	 * \brief Imprints multiple delamination profiles to the input layers
+	 *
+	 * \param layer_orig layer on the ORIG side
+	 * \param layer_offset layer on the OFFSET side
+	 * \param file_names a list of CSV files containing the outer delamination profile
+	 */
+	void do_adjacent_layers(Layer *layer_orig, Layer *layer_offset, delamo::List< std::string >& file_names);
+
+	/**
+	 * \brief Not supported by the reference backend
+	 */
+	void do_split_layer(Layer *layer_in, const char* file_name);
+
+	/**
+	 * \brief Not supported by the reference backend
+	 */
+	void do_create_hat_stiffener(Layer *layer_orig, Layer *stiffener, const char* file_name, double radius);
+
+	/**
+	 * \brief Checks whether the deferred operations can run concurrently
+	 *
+	 * The reference geometry has no global state, the operations on disjoint layers are independent.
+	 * \return true
+	 */
+	bool thread_safe_modeling();
+
+	/**
+	 * \brief Returns the name and version of the format of the cached bodies
+	 * \return format name
+	 */
+	const char* cache_format();
+
+	/**
+	 * \brief Serializes the surface, the levels, the faces and the profile constraints of a body for the cache
+	 * \param[in] lb input LayerBody
+	 * \param[out] blob serialized body
+	 * \param[out] faces faces of the body in the order they are serialized
+	 * \return false if the LayerBody has no body
+	 */
+	bool save_cache_body(LayerBody* lb, std::string& blob, delamo::List<DLM_FACEP>& faces);
+
+	/**
+	 * \brief Restores a body serialized by save_cache_body()
+	 *
+	 * The existing faces of the body are updated in place, so that the LayerSurface objects referring to them stay
+	 * valid. The surfaces and the profiles with the same contents are shared between the restored bodies.
+	 * \param[in] lb LayerBody to be updated
+	 * \param[in] blob serialized body
+	 * \param[out] faces faces of the body in the order they are serialized
+	 * \return false if the blob is not valid
+	 */
+	bool restore_cache_body(LayerBody* lb, const std::string& blob, delamo::List<DLM_FACEP>& faces);
+
+	/**
+	 * \brief Deletes the body of a LayerBody which is removed from its layer
+	 * \param[in] lb input LayerBody
+	 */
+	void release_cache_body(LayerBody* lb);
+
+	/**
+	 * \brief Serializes the sheet body of a mold for a checkpoint
+	 * \param[in] lm input LayerMold
+	 * \param[out] blob serialized body
+	 * \return false if the LayerMold has no body
+	 */
+	bool save_cache_mold(LayerMold* lm, std::string& blob);
+
+	/**
+	 * \brief Restores the sheet body of a mold serialized by save_cache_mold()
+	 * \param[in] lm LayerMold to be updated
+	 * \param[in] blob serialized body
+	 * \return false if the blob is not valid
+	 */
+	bool restore_cache_mold(LayerMold* lm, const std::string& blob);
+
+	/**
+	 * \brief Deletes the sheet body of a mold which is deleted with its layer
+	 * \param[in] lm input LayerMold
+	 */
+	void release_cache_mold(LayerMold* lm);
+
+	/**
+	 * \brief Creates a sheet body with a single face covering the whole surface
+	 * \param surf mold surface
+	 * \param level level of the sheet along the surface normal
+	 * \return new sheet body
+	 */
+	RefBody* create_sheet(RefSurface* surf, double level);
+
+	/**
+	 * \brief Internal function for processing layers during generation
+	 * \param layer_in input layer
+	 * \param sheet_body_in mold body
+	 * \param ldir layer offsetting direction
+	 */
+	void process_layer(Layer *layer_in, RefBody* sheet_body_in, Direction ldir);
+
+	/**
+	 * \brief Generates molds on the original and offset direction of the input layer
+	 * \param layer_in input layer
+	 */
+	void generate_mold(Layer *layer_in);
+
+	/**
+	 * \brief Imprints the profiles of the tool body faces to the touching faces of the target body
+	 * \param target_body body to be imprinted
+	 * \param tool_body body containing the profiles
+	 */
+	void imprint_bodies(RefBody* target_body, RefBody* tool_body);
+
+	/**
+	 * \brief Updates the LayerSurface objects of the input layer after imprinting the adjacent layer
+	 * \param layer_in input layer
+	 * \param surf_direction direction of the imprinted faces
+	 */
+	void update_imprinted_surfaces(Layer *layer_in, Direction surf_direction);
+
+	/**
+	 * \brief Evaluates the reference point and the normal of the face and updates the input LayerSurface object
+	 * \param ls_in input LayerSurface
+	 * \param reference_normal_z z-component of the reference normal used for computing the surface angle
+	 * \param update_angle flag to compute the surface angle
+	 */
+	void update_point_normal(LayerSurface* ls_in, double reference_normal_z, bool update_angle);
+
+	/**
+	 * \brief Internal function for processing layers for delamination imprinting
+	 * \param layer_orig layer on the original side
+	 * \param layer_offset layer on the offset side
+	 * \param delampts points defining the delamination outline
+	 * \param delampts_size number of points stored in the "delampts" pointer
+	 */
+	void process_delamination(Layer *layer_orig, Layer *layer_offset, delamo::TPoint3<double>* delampts, int delampts_size);
+
+	/**
+	 * \brief Internal function for imprinting multiple delamination outlines in batches
+	 * The outlines in the same group do not overlap in the parametric space of the reference face, so the surfaces are
+	 * paired once per group.
+	 *
+	 * \param layer_orig layer on the original side
+	 * \param layer_offset layer on the offset side
+	 * \param file_names list of CSV files containing the outer delamination profiles
+	 */
+	void process_delamination_batch(Layer *layer_orig, Layer *layer_offset, delamo::List<std::string>& file_names);
+
+	/**
+	 * \brief Finds the reference face for delamination profile generation
+	 * \param layer_orig layer on the original side
+	 * \return reference face, NULL if the layer does not have a valid reference mold
+	 */
+	RefFace* find_delam_ref_face(Layer *layer_orig);
+
+	/**
+	* \brief Generates inner and outer delamination profiles in the parametric space of the reference face
+	* \param[in] ref_face reference face for generating profiles
+	* \param[in] delampts list of delamination edge points
+	* \param[in] delampts_size size of the delamination edge points list
+	* \param[out] outer_profile outer delamination profile
+	* \param[out] inner_profile inner delamination profile
+	* \return TRUE if the profiles are generated, otherwise FALSE
+	*/
+	bool generate_delamination_profiles(RefFace* ref_face, delamo::TPoint3<double>* delampts, int delampts_size, RefProfile*& outer_profile, RefProfile*& inner_profile);
+
+	/**
+	 * \brief Imprints the delamination profiles to all cohesive faces between the input layers
+	 * \param layer_orig layer on the original side
+	 * \param layer_offset layer on the offset side
+	 * \param outer_profile outer delamination profile
+	 * \param inner_profile inner delamination profile
+	 * \param pair_each_couple TRUE updates the surface pairs after imprinting each face couple
+	 */
+	void imprint_delamination_profiles(Layer *layer_orig, Layer *layer_offset, RefProfile* outer_profile, RefProfile* inner_profile, bool pair_each_couple);
+
+	/**
+	 * \brief Imprints delamination and updates LayerSurface object
+	 * \param[in] layersurface_in input LayerSurface
+	 * \param[in] surf_direction surface direction (offset or original)
+	 * \param[in] outer_profile outer delamination profile
+	 * \param[in] inner_profile inner delamination profile
+	 * \param[out] lsc_new list of newly generated LayerSurface objects
+	 */
+	void imprint_delamination(LayerSurface* layersurface_in, Direction surf_direction, RefProfile* outer_profile, RefProfile* inner_profile, delamo::List<LayerSurface *>& lsc_new);
+
+	/**
+	 * \brief Finds boundary conditions on the delaminated face
+	 * \param[in] face_in face to be evaluated
+	 * \param[in] outer_profile outer delamination profile
+	 * \param[in] inner_profile inner delamination profile
+	 * \param[out] delam_type delamination type
+	 */
+	void find_delam_bc(RefFace* face_in, RefProfile* outer_profile, RefProfile* inner_profile, DelaminationType& delam_type);
+
+	/**
+	 * \brief Updates surface pairs in the input layers
+	 * \param layer1 input layer 1
+	 * \param layer2 input layer 2
+	 */
+	void update_surface_pairs(Layer *layer1, Layer *layer2);
+
+	/**
+	 * \brief Updates surface pairs of the surfaces created or modified since the last pairing
+	 *
+	 * The modified surfaces and their old pairs are paired again, all other surface pairs are kept.
+	 * \param layer1 input layer 1
+	 * \param layer2 input layer 2
+	 */
+	void update_modified_surface_pairs(Layer *layer1, Layer *layer2);
+
+	/**
+	 * \brief Checks whether the reference point of the 1st surface is inside the facing 2nd surface
+	 * \param layer1_ls surface of the input layer 1
+	 * \param layer2_ls surface of the input layer 2
+	 * \return TRUE if the surfaces are a pair, otherwise FALSE
+	 */
+	bool check_surface_pair(LayerSurface* layer1_ls, LayerSurface* layer2_ls);
+
+	/**
+	 * \brief Adds all surfaces of the input layer to the surface pair index
+	 * \param[in] layer_in input layer
+	 * \param[out] index surface pair index
+	 */
+	void build_surface_index(Layer *layer_in, SurfacePairIndex& index);
+
+	/**
+	 * \brief Adds all faces of the input layers to the bounding volume hierarchy
+	 * \param[in] layer_list list of layers
+	 * \param[in] layer_list_size size of the layer list
+	 * \param[out] bvh bounding volume hierarchy
+	 */
+	void build_face_bvh(Layer** layer_list, int layer_list_size, FaceBVH& bvh);
+
+	/**
+	 * \brief Checks whether the bounding boxes of the input layer bodies overlap within the tolerance value
+	 * The bounding boxes are cached in the LayerBody objects.
+	 *
+	 * \param lb1 input layer body 1
+	 * \param lb2 input layer body 2
+	 * \return TRUE if the bounding boxes overlap, otherwise FALSE
+	 */
+	bool bodies_overlap(LayerBody* lb1, LayerBody* lb2);
+
+	/**
+	 * \brief Checks whether the reference modeler is running or not
+	 */
+	void is_builder_started();
+
+	/**
+	 * \brief Saves the layers as a text STL file with one solid for each layer body
+	 *
+	 * \param file_name name of the file which contains the model
+	 * \param layer_list list of the layers to be saved in the file
+	 */
+	void save_cad_model(const char* file_name, delamo::List<Layer *>& layer_list);
+
+	/**
+	* \brief Saves the layers as a text STL file with one solid for each layer body. Shell bodies are not supported.
+	*
+	* \param file_name name of the file which contains the model
+	* \param layer_list list of the layers to be saved in the file
+	* \param mbbody_list list of additional shell bodies, must be empty
+	*/
+	void save_cad_model(const char* file_name, delamo::List<Layer*>& layer_list, delamo::List<MBBody*>& mbbody_list);
+
+	/**
+	 * \brief Saves the bodies of a layer as a text STL file with one solid for each layer body
+	 *
+	 * Each body belongs to a single shard, so its faces are tessellated by a single thread when the shards are saved concurrently.
+	 * \param file_name name of the shard file
+	 * \param layer layer of the bodies
+	 * \param bodies layer bodies to be saved in the file
+	 */
+	void save_cad_shard(const char* file_name, Layer* layer, delamo::Span<LayerBody*> bodies);
+
+	/**
+	 * \brief Returns the extension of the STL files saved by the reference backend
+	 * \return file extension
+	 */
+	const char* cad_file_extension();
+
+	/**
+	 * \brief Not supported by the reference backend
+	 */
+	void load_cad_model(const char* file_name, bool text_mode, delamo::List<LayerMold*>& lm_list);
+
+	/**
+	* \brief Not supported by the reference backend
+	*/
+	void create_shell_cutout_sat(const char* file_name, bool text_mode, delamo::List<LayerMold*>& lm_mold);
+
+	/**
+	* \brief Not supported by the reference backend
+	*/
+	void load_shell_sat_model(const char* file_name, bool text_mode, delamo::List<delamo::TPoint3<double>>& point_list, delamo::List<delamo::TPoint3<double>>& tangent_list, delamo::List<delamo::TPoint3<double>>& normal_list);
+
+	/**
+	* \brief Not supported by the reference backend
+	*/
+	void load_shell_sat_model(LayerMold *lm, delamo::List<delamo::TPoint3<double>>& point_list, delamo::List<delamo::TPoint3<double>>& tangent_list, delamo::List<delamo::TPoint3<double>>& normal_list);
+
+	/**
+	* \brief Translate the points on the edges of the shell model alomg the normals to the middle of ths side faces
+	*
+	* \param edge_point_list points on the edges of the shell model
+	* \param edge_normal_list normals on the edges of the shell model
+	* \param thickness is the distance to translate
+	* \param layer_point_list is the translated point list
+	*/
+	void translate_shell_edge_points(delamo::List<delamo::TPoint3<double>>& edge_point_list, delamo::List<delamo::TPoint3<double>>& edge_normal_list, double thickness, delamo::List<delamo::TPoint3<double>>& layer_point_list);
+
+	/**
+	* \brief Finds the side faces corresponding to the input points list on the given layer and outputs the points and normals
+	*
+	* \param layer_in input layer
+	* \param side_point_list points on the sides of the layer
+	* \param point_out output points on the sides of the layer
+	* \param normal_out output normal on the sides of the layer
+	*/
+	void find_side_faces(Layer *layer_in, delamo::List<delamo::TPoint3<double>>& side_point_list, delamo::List<delamo::TPoint3<double>>& point_out, delamo::List<delamo::TPoint3<double>>& normal_out);
+
+	/**
+	 * \brief Finds the closest side face w.r.t. the given point
+	 * \param layer_in input layer
+	 * \param point_in input reference point
+	 * \return reference to the LayerSurface object containing the closest side face
+	 */
+	LayerSurface* find_closest_side(Layer *layer_in, delamo::TPoint3<double>& point_in);
+
+	/**
+	 * \brief Writes the tessellation of the input faces as a text STL file
+	 * \param file_name name of the STL file to be saved
+	 * \param name object name
+	 * \param face_list faces to be saved in the file
+	 */
+	void write_stl(const char* file_name, const char* name, delamo::List<RefFace*>& face_list);
+
+	/**
+	 * \brief Writes the tessellation of a layer body as a solid of a text STL file
+	 * \param out output stream
+	 * \param lb layer body to be saved
+	 */
+	void write_body_stl(std::ostream& out, LayerBody* lb);
+
+	/**
+	 * \brief Serializes a layer or mold body, see save_cache_body()
+	 * \param[in] body input body
+	 * \param[out] blob serialized body
+	 * \param[out] faces faces of the body in the order they are serialized
+	 * \return false if there is no body
+	 */
+	bool save_ref_body(RefBody* body, std::string& blob, delamo::List<DLM_FACEP>& faces);
+
+	/**
+	 * \brief Restores a layer or mold body, see restore_cache_body()
+	 * \param[in,out] body_io existing body, replaced by a new body if the blob is not generated from it
+	 * \param[in] blob serialized body
+	 * \param[out] faces faces of the body in the order they are serialized
+	 * \return false if the blob is not valid
+	 */
+	bool restore_ref_body(RefBody*& body_io, const std::string& blob, delamo::List<DLM_FACEP>& faces);
+
+	/**
+	 * \brief Deletes a layer or mold body created by the modeler
+	 * \param[in] body body to be deleted
+	 */
+	void delete_ref_body(RefBody* body);
+
+private:
+	bool _bStarted; /**< TRUE if the modeler is started */
+	delamo::List<RefSurface*> _mSurfaces; /**< Surfaces created by the modeler */
+	delamo::List<RefBody*> _mBodies; /**< Layer and mold bodies created by the modeler */
+	delamo::List<RefProfile*> _mProfiles; /**< Delamination profiles, the split faces refer to them */
+	std::unordered_map<unsigned long long, RefSurface*> _mSurfaceKeys; /**< Surfaces by the fingerprints of their NURBS, shared by the restored bodies */
+	std::unordered_map<unsigned long long, RefProfile*> _mProfileKeys; /**< Profiles by the cache keys of their points, shared by the restored faces */
+	std::mutex _mGeometryMutex; /**< Guards the geometry lists during the concurrent deferred operations */
+
+	// Computes the point-face distances for the FaceBVH queries (thread-safe, as the face tessellations are generated before the queries)
+	class FaceDistance : public FaceDistanceEvaluator
+	{
+	public:
+		double distance(LayerSurface* ls, const delamo::TPoint3<double>& pt, delamo::TPoint3<double>& closest);
+		bool thread_safe();
+	};
+};
+
+#endif /* REFERENCEMODELBUILDER_H */
@@ -0,0 +1,186 @@
+#include "SurfacePairIndex.h"
+
+
+SurfacePairIndex::SurfacePairIndex()
+{
+	this->_mTolerance = 1e-5;
+	this->_bDirty = true;
+	for (int i = 0; i < 3; i++)
+	{
+		this->_mOrigin[i] = 0.0;
+		this->_mCellSize[i] = 1.0;
+		this->_mDims[i] = 1;
+	}
+}
+
+SurfacePairIndex::~SurfacePairIndex()
+{
+	this->clear();
+}
+
+void SurfacePairIndex::tolerance(double value)
+{
+	this->_mTolerance = value;
+}
+
+double SurfacePairIndex::tolerance()
+{
+	return this->_mTolerance;
+}
+
+void SurfacePairIndex::clear()
+{
+	this->_mEntries.clear();
+	this->_mCells.clear();
+	this->_bDirty = true;
+}
+
+void SurfacePairIndex::add(LayerSurface* ls, const delamo::TPoint3<double>& bbox_min, const delamo::TPoint3<double>& bbox_max)
+{
+	Entry e;
+	e.surface = ls;
+	e.normal = ls->normal_coords();
+	e.bbox_min = bbox_min - this->_mTolerance;
+	e.bbox_max = bbox_max + this->_mTolerance;
+	this->_mEntries.push_back(e);
+	this->_bDirty = true;
+}
+
+void SurfacePairIndex::query(LayerSurface* ls, delamo::List<LayerSurface*>& candidates)
+{
+	candidates.clear();
+
+	if (this->_mEntries.empty())
+		return;
+
+	if (this->_bDirty)
+		this->build();
+
+	delamo::TPoint3<double> pt = ls->point_coords();
+	delamo::TPoint3<double> nm = ls->normal_coords();
+
+	// Find the cell containing the point
+	int cell[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		cell[axis] = this->cell_coord(pt[axis], axis);
+		// The point is outside of the grid
+		if (cell[axis] < 0)
+			return;
+	}
+
+	// Entry indices are stored in ascending order, so the candidates keep the insertion order
+	for (auto idx : this->_mCells[this->cell_index(cell[0], cell[1], cell[2])])
+	{
+		const Entry& e = this->_mEntries[idx];
+
+		// Facing surfaces must have opposite normals
+		double dot = nm.x() * e.normal.x() + nm.y() * e.normal.y() + nm.z() * e.normal.z();
+		if (dot >= 0.0)
+			continue;
+
+		// The point must be inside the bounding box of the candidate surface
+		bool inside = true;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (pt[axis] < e.bbox_min[axis] || pt[axis] > e.bbox_max[axis])
+			{
+				inside = false;
+				break;
+			}
+		}
+
+		if (inside)
+			candidates.add(e.surface);
+	}
+}
+
+int SurfacePairIndex::size()
+{
+	return (int) this->_mEntries.size();
+}
+
+void SurfacePairIndex::build()
+{
+	// Find the grid bounds
+	double grid_max[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		this->_mOrigin[axis] = std::numeric_limits<double>::max();
+		grid_max[axis] = -std::numeric_limits<double>::max();
+	}
+	for (auto& e : this->_mEntries)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			this->_mOrigin[axis] = std::min(this->_mOrigin[axis], e.bbox_min[axis]);
+			grid_max[axis] = std::max(grid_max[axis], e.bbox_max[axis]);
+		}
+	}
+
+	// Use approximately one cell per entry along the largest axis of the grid
+	double max_extent = 0.0;
+	for (int axis = 0; axis < 3; axis++)
+		max_extent = std::max(max_extent, grid_max[axis] - this->_mOrigin[axis]);
+	int resolution = (int) std::ceil(std::cbrt((double) this->_mEntries.size()));
+	resolution = std::max(1, std::min(resolution, SURFACEPAIRINDEX_MAX_CELLS));
+	double cell_size = max_extent / resolution;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		double extent = grid_max[axis] - this->_mOrigin[axis];
+		if (cell_size <= 0.0 || extent <= cell_size)
+		{
+			this->_mDims[axis] = 1;
+			this->_mCellSize[axis] = std::max(extent, this->_mTolerance);
+		}
+		else
+		{
+			this->_mDims[axis] = std::min((int) std::ceil(extent / cell_size), SURFACEPAIRINDEX_MAX_CELLS);
+			this->_mCellSize[axis] = extent / this->_mDims[axis];
+		}
+	}
+
+	// Insert entries into all cells overlapped by their bounding boxes
+	this->_mCells.clear();
+	this->_mCells.resize(this->_mDims[0] * this->_mDims[1] * this->_mDims[2]);
+	for (int idx = 0; idx < (int) this->_mEntries.size(); idx++)
+	{
+		const Entry& e = this->_mEntries[idx];
+		int cmin[3], cmax[3];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			cmin[axis] = std::max(this->cell_coord(e.bbox_min[axis], axis), 0);
+			cmax[axis] = this->cell_coord(e.bbox_max[axis], axis);
+			if (cmax[axis] < 0)
+				cmax[axis] = this->_mDims[axis] - 1;
+		}
+		for (int i = cmin[0]; i <= cmax[0]; i++)
+		{
+			for (int j = cmin[1]; j <= cmax[1]; j++)
+			{
+				for (int k = cmin[2]; k <= cmax[2]; k++)
+				{
+					this->_mCells[this->cell_index(i, j, k)].push_back(idx);
+				}
+			}
+		}
+	}
+
+	this->_bDirty = false;
+}
+
+int SurfacePairIndex::cell_coord(double value, int axis)
+{
+	double rel = value - this->_mOrigin[axis];
+	// Allow the points on the grid boundary
+	if (rel < 0.0 || rel > this->_mDims[axis] * this->_mCellSize[axis])
+		return -1;
+	int c = (int) (rel / this->_mCellSize[axis]);
+	return std::min(c, this->_mDims[axis] - 1);
+}
+
+int SurfacePairIndex::cell_index(int i, int j, int k)
+{
+	return (k * this->_mDims[1] + j) * this->_mDims[0] + i;
+}
@@ -0,0 +1,102 @@
+#ifndef SURFACEPAIRINDEX_H
+#define SURFACEPAIRINDEX_H
+
+#include "APIConfig.h"
+#include "LayerSurface.h"
+// Export file is generated by CMake's GenerateExportHeader module
+#include "modelbuilder_export.h"
+
+
+// Maximum number of grid cells along one axis
+#define SURFACEPAIRINDEX_MAX_CELLS 64
+
+/**
+ * \brief Broad-phase spatial index for finding the surface pairs of two adjacent layers.
+ *
+ * The surfaces of one layer are added with their bounding boxes and stored in a uniform grid. A query returns the
+ * surfaces whose bounding boxes contain the reference point of the query surface and whose normals are facing the
+ * query normal. The index does not depend on the solid modeling kernel, so the exact containment test is left to the
+ * caller and it only runs on the returned candidates.
+ */
+class MODELBUILDER_EXPORT SurfacePairIndex
+{
+public:
+
+	/**
+	 * \brief Default constructor.
+	 */
+	SurfacePairIndex();
+
+	/**
+	 * \brief Default destructor.
+	 */
+	~SurfacePairIndex();
+
+	/**
+	 * \brief Sets the tolerance value used for expanding the bounding boxes.
+	 *
+	 * The tolerance is applied when a surface is added, so it should be set before adding the surfaces.
+	 * \param value tolerance
+	 */
+	void tolerance(double value);
+
+	/**
+	 * \brief Gets the tolerance value used for expanding the bounding boxes.
+	 * \return tolerance
+	 */
+	double tolerance();
+
+	/**
+	 * \brief Removes all surfaces from the index.
+	 */
+	void clear();
+
+	/**
+	 * \brief Adds a surface to the index.
+	 *
+	 * The grid is rebuilt during the next query.
+	 * \param ls LayerSurface to be added
+	 * \param bbox_min minimum corner of the surface bounding box
+	 * \param bbox_max maximum corner of the surface bounding box
+	 */
+	void add(LayerSurface* ls, const delamo::TPoint3<double>& bbox_min, const delamo::TPoint3<double>& bbox_max);
+
+	/**
+	 * \brief Finds the pairing candidates of the input surface.
+	 *
+	 * Candidates are returned in the order they were added to the index.
+	 * \param[in] ls query surface
+	 * \param[out] candidates list of the candidate surfaces
+	 */
+	void query(LayerSurface* ls, delamo::List<LayerSurface*>& candidates);
+
+	/**
+	 * \brief Gets the number of surfaces in the index.
+	 * \return number of surfaces
+	 */
+	int size();
+
+private:
+	// Surface stored in the index
+	struct Entry
+	{
+		LayerSurface* surface; /**< Indexed surface */
+		delamo::TPoint3<double> normal; /**< Normal of the indexed surface */
+		delamo::TPoint3<double> bbox_min; /**< Minimum corner of the expanded bounding box */
+		delamo::TPoint3<double> bbox_max; /**< Maximum corner of the expanded bounding box */
+	};
+
+	double _mTolerance; /**< Tolerance value for expanding the bounding boxes */
+	bool _bDirty; /**< TRUE if the grid needs to be rebuilt */
+	std::vector<Entry> _mEntries; /**< Surfaces in the index */
+	std::vector<std::vector<int>> _mCells; /**< Entry indices for each grid cell */
+	double _mOrigin[3]; /**< Minimum corner of the grid */
+	double _mCellSize[3]; /**< Size of a grid cell along each axis */
+	int _mDims[3]; /**< Number of grid cells along each axis */
+
+	void build();
+	int cell_coord(double value, int axis);
+	int cell_index(int i, int j, int k);
+};
+
+#endif // !SURFACEPAIRINDEX_H
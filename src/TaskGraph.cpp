@@ -0,0 +1,142 @@
+#include "TaskGraph.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+
+
+TaskGraph::TaskGraph()
+{
+}
+
+TaskGraph::~TaskGraph()
+{
+	this->clear();
+}
+
+int TaskGraph::add(const std::function<void()>& task, delamo::Span<Layer*> layers)
+{
+	int task_idx = (int) this->_mTasks.size();
+	Task new_task;
+	new_task.func = task;
+	new_task.num_deps = 0;
+	this->_mTasks.push_back(new_task);
+
+	// Wait for the previous operations on the same layers
+	for (size_t i = 0; i < layers.size(); i++)
+	{
+		Layer* layer = layers[i];
+		auto last = this->_mLastTask.find(layer);
+		if (last != this->_mLastTask.end())
+		{
+			std::vector<int>& successors = this->_mTasks[last->second].successors;
+			// Both layers can be touched by the same previous operation
+			if (successors.empty() || successors.back() != task_idx)
+			{
+				successors.push_back(task_idx);
+				this->_mTasks[task_idx].num_deps++;
+			}
+		}
+		this->_mLastTask[layer] = task_idx;
+	}
+
+	return task_idx;
+}
+
+void TaskGraph::run(int num_threads)
+{
+	// Take the tasks, so that the graph is empty even if an operation fails
+	std::vector<Task> tasks;
+	tasks.swap(this->_mTasks);
+	this->_mLastTask.clear();
+
+	int num_tasks = (int) tasks.size();
+	if (num_tasks == 0)
+		return;
+
+	// The recording order is a valid execution order
+	num_threads = std::max(1, std::min(num_threads, num_tasks));
+	if (num_threads == 1)
+	{
+		for (auto& task : tasks)
+			task.func();
+		return;
+	}
+
+	std::mutex queue_mutex;
+	std::condition_variable queue_cv;
+	std::deque<int> ready;
+	std::vector<int> pending(num_tasks);
+	int remaining = num_tasks;
+	std::exception_ptr first_error;
+
+	for (int i = 0; i < num_tasks; i++)
+	{
+		pending[i] = tasks[i].num_deps;
+		if (pending[i] == 0)
+			ready.push_back(i);
+	}
+
+	// Each worker takes the ready operations and releases their successors when they are finished
+	auto worker = [&]()
+	{
+		std::unique_lock<std::mutex> lock(queue_mutex);
+		while (true)
+		{
+			queue_cv.wait(lock, [&]() { return !ready.empty() || remaining == 0 || first_error; });
+			if (remaining == 0 || first_error)
+				break;
+
+			int task_idx = ready.front();
+			ready.pop_front();
+			lock.unlock();
+
+			std::exception_ptr task_error;
+			try
+			{
+				tasks[task_idx].func();
+			}
+			catch (...)
+			{
+				task_error = std::current_exception();
+			}
+
+			lock.lock();
+			remaining--;
+			if (task_error && !first_error)
+				first_error = task_error;
+			for (auto succ : tasks[task_idx].successors)
+			{
+				if (--pending[succ] == 0)
+					ready.push_back(succ);
+			}
+			queue_cv.notify_all();
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (int t = 0; t < num_threads; t++)
+		workers.push_back(std::thread(worker));
+	for (auto& w : workers)
+		w.join();
+
+	if (first_error)
+		std::rethrow_exception(first_error);
+}
+
+int TaskGraph::size()
+{
+	return (int) this->_mTasks.size();
+}
+
+bool TaskGraph::touches(const Layer* layer)
+{
+	return this->_mLastTask.find(const_cast<Layer*>(layer)) != this->_mLastTask.end();
+}
+
+void TaskGraph::clear()
+{
+	this->_mTasks.clear();
+	this->_mLastTask.clear();
+}
@@ -0,0 +1,81 @@
+#ifndef TASKGRAPH_H
+#define TASKGRAPH_H
+
+#include "APIConfig.h"
+#include "Layer.h"
+#include <functional>
+// Export file is generated by CMake's GenerateExportHeader module
+#include "modelbuilder_export.h"
+
+
+/**
+ * \brief Dependency graph of the deferred ModelBuilder operations.
+ *
+ * Each operation is recorded with the layers it touches. An operation depends on the last recorded operation touching
+ * any of its layers, so the operations on the same layer run in the recording order and the operations on disjoint
+ * layers (e.g. the interfaces 1-2 and 3-4 of a laminate) can run concurrently.
+ */
+class MODELBUILDER_EXPORT TaskGraph
+{
+public:
+
+	/**
+	 * \brief Default constructor.
+	 */
+	TaskGraph();
+
+	/**
+	 * \brief Default destructor.
+	 *
+	 * The pending operations are discarded.
+	 */
+	~TaskGraph();
+
+	/**
+	 * \brief Records an operation.
+	 * \param task operation to be executed
+	 * \param layers layers read or modified by the operation
+	 * \return index of the operation in the graph
+	 */
+	int add(const std::function<void()>& task, delamo::Span<Layer*> layers);
+
+	/**
+	 * \brief Executes all recorded operations and clears the graph.
+	 *
+	 * If an operation throws an exception, the operations which are not started yet are discarded and the first
+	 * exception is rethrown on the calling thread.
+	 * \param num_threads number of worker threads, the operations are executed in the recording order if it is 1
+	 */
+	void run(int num_threads);
+
+	/**
+	 * \brief Gets the number of pending operations.
+	 * \return number of pending operations
+	 */
+	int size();
+
+	/**
+	 * \brief Checks whether a pending operation reads or modifies a layer.
+	 * \param layer layer to be checked
+	 * \return true if a pending operation is recorded with the layer, otherwise false
+	 */
+	bool touches(const Layer* layer);
+
+	/**
+	 * \brief Discards all pending operations.
+	 */
+	void clear();
+
+private:
+	struct Task
+	{
+		std::function<void()> func; /**< Operation to be executed */
+		std::vector<int> successors; /**< Operations waiting for this operation */
+		int num_deps; /**< Number of operations this operation waits for */
+	};
+
+	std::vector<Task> _mTasks; /**< Recorded operations in the recording order */
+	std::unordered_map<Layer*, int> _mLastTask; /**< Last recorded operation touching each layer */
+};
+
+#endif // !TASKGRAPH_H
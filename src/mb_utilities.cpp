@@ -1,7 +1,21 @@
 #include "mb_utilities.h"
+#include "Fingerprint.h"
 
 
 void read_csv_file(const char* file_name, delamo::TPoint3<double>*& ptsarr, int& ptsarr_size)
+{
+	// Read the points into the lanes of a point container
+	delamo::Point3Array<double> output;
+	read_csv_file(file_name, output);
+
+	// Get the size of the array (this is required for new() command)
+	ptsarr_size = (int)output.size();
+	ptsarr = new delamo::TPoint3<double>[ptsarr_size];
+	// Copy the contents of the container into a pointer array
+	output.copy_to(ptsarr);
+}
+
+void read_csv_file(const char* file_name, delamo::Point3Array<double>& pts)
 {
 	// Read the file
 	std::ifstream input;
@@ -15,8 +29,8 @@ void read_csv_file(const char* file_name, delamo::TPoint3<double>*& ptsarr, int&
 		throw std::runtime_error("CAD Model Builder: Operation failed!");
 	}
 
-	// Use a container to store points which are read from the CSV file
-	delamo::List< delamo::TPoint3<double> > output;
+	// The container grows geometrically, so reading N points costs O(N) copies
+	pts.clear();
 	std::string line;
 	std::getline(input, line); // Read first line in the CSV file
 
@@ -38,29 +52,23 @@ void read_csv_file(const char* file_name, delamo::TPoint3<double>*& ptsarr, int&
 		pos = line.find(delim, pos);
 		double z = std::stod(line.substr(i, pos - i));
 
-		// Set point values
-		delamo::TPoint3<double> point;
-		point.x(x);
-		point.y(y);
-		point.z(z);
-
 		// Add it to the container
-		output.push_back(point);
+		pts.push_back(x, y, z);
 	}
 
-	// Get the size of the array (this is required for new() command)
-	ptsarr_size = (int)output.size();
-	ptsarr = new delamo::TPoint3<double>[ptsarr_size];
-	// Copy the contents of the container into a pointer array
-	std::copy(output.begin(), output.end(), ptsarr);
-
-	// We don't need the container anymore, so empty its contents
-	output.clear();
-
 	// Close file handle
 	input.close();
 }
 
+void read_csv_file(const char* file_name, delamo::List< delamo::TPoint3<double> >& pts)
+{
+	delamo::Point3Array<double> output;
+	read_csv_file(file_name, output);
+
+	pts.clear();
+	output.to_list(pts);
+}
+
 void point_array_flip(delamo::TPoint3<double>* ptsin, int ptsin_size, delamo::TPoint3<double>*& ptsout)
 {
 	ptsout = new delamo::TPoint3<double>[ptsin_size];
@@ -72,6 +80,15 @@ void point_array_flip(delamo::TPoint3<double>* ptsin, int ptsin_size, delamo::TP
 	}
 }
 
+delamo::List< delamo::TPoint3<double> > point_array_flip(delamo::Span<const delamo::TPoint3<double>> ptsin)
+{
+	delamo::List< delamo::TPoint3<double> > ptsout;
+	ptsout.reserve(ptsin.size());
+	for (unsigned int i = ptsin.size(); i > 0; i--)
+		ptsout.push_back(ptsin[i - 1]);
+	return ptsout;
+}
+
 bool read_license_file(const char* file_name, char*& unlock_str)
 {
 	std::ifstream license_file(file_name);
@@ -128,6 +145,13 @@ bool read_license_file(const char* file_name, char*& unlock_str)
 
 void find_point_inside_polygon(delamo::TPoint3<double>* ptsarr, int ptsarr_size, delamo::TPoint3<double>& point_inside)
 {
+	find_point_inside_polygon(delamo::Span<const delamo::TPoint3<double>>(ptsarr, ptsarr_size), point_inside);
+}
+
+void find_point_inside_polygon(delamo::Span<const delamo::TPoint3<double>> ptsarr, delamo::TPoint3<double>& point_inside)
+{
+	int ptsarr_size = (int)ptsarr.size();
+
 	// Find the minimum (Pmin) and maximum (Pmax) points using the x-coordinate
 	delamo::TPoint3<double> pt_min = ptsarr[0];
 	delamo::TPoint3<double> pt_max = ptsarr[ptsarr_size - 1];
@@ -152,7 +176,7 @@ void find_point_inside_polygon(delamo::TPoint3<double>* ptsarr, int ptsarr_size,
 	int trials_pmax = 0;
 	while (trials_pmin < trials)
 	{
-		int wn = wn_pnpoly(pt_mid, ptsarr, ptsarr_size);
+		int wn = wn_pnpoly(pt_mid, ptsarr);
 		if (wn != 0)
 		{
 			point_inside = pt_mid;
@@ -168,7 +192,7 @@ void find_point_inside_polygon(delamo::TPoint3<double>* ptsarr, int ptsarr_size,
 	pt_mid = pt_mid_initial;
 	while (trials_pmax < trials)
 	{
-		int wn = wn_pnpoly(pt_mid, ptsarr, ptsarr_size);
+		int wn = wn_pnpoly(pt_mid, ptsarr);
 		if (wn != 0)
 		{
 			point_inside = pt_mid;
@@ -189,26 +213,33 @@ void find_point_inside_polygon(delamo::TPoint3<double>* ptsarr, int ptsarr_size,
 }
 
 int wn_pnpoly(delamo::TPoint3<double>& pt_check, delamo::TPoint3<double>* ptsarr, int ptsarr_size)
+{
+	return wn_pnpoly(pt_check, delamo::Span<const delamo::TPoint3<double>>(ptsarr, ptsarr_size));
+}
+
+int wn_pnpoly(const delamo::TPoint3<double>& pt_check, delamo::Span<const delamo::TPoint3<double>> ptsarr)
 {
 	// The winding number counter
 	int wn = 0;
 
-	// Loop through all polygon points
-	for (int i = 0; i < ptsarr_size; i++)
+	// Loop through all polygon edges, the last edge closes the polygon
+	unsigned int ptsarr_size = ptsarr.size();
+	for (unsigned int i = 0; i < ptsarr_size; i++)
 	{
+		const delamo::TPoint3<double>& pt_next = ptsarr[(i + 1) % ptsarr_size];
 		if (ptsarr[i].y() <= pt_check.y())
 		{
-			if (ptsarr[i + 1].y() > pt_check.y())
+			if (pt_next.y() > pt_check.y())
 			{
-				if (is_left(ptsarr[i], ptsarr[i + 1], pt_check) > 0)
+				if (is_left(ptsarr[i], pt_next, pt_check) > 0)
 					++wn;
 			}
 		}
 		else
 		{
-			if (ptsarr[i + 1].y() <= pt_check.y())
+			if (pt_next.y() <= pt_check.y())
 			{
-				if (is_left(ptsarr[i], ptsarr[i + 1], pt_check) < 0)
+				if (is_left(ptsarr[i], pt_next, pt_check) < 0)
 					--wn;
 			}
 		}
@@ -216,7 +247,60 @@ int wn_pnpoly(delamo::TPoint3<double>& pt_check, delamo::TPoint3<double>* ptsarr
 	return wn;
 }
 
-double is_left(delamo::TPoint3<double>& P0, delamo::TPoint3<double>& P1, delamo::TPoint3<double>& Pcheck)
+double is_left(const delamo::TPoint3<double>& P0, const delamo::TPoint3<double>& P1, const delamo::TPoint3<double>& Pcheck)
 {
 	return (((P1.x() - P0.x()) * (Pcheck.y() - P0.y())) - ((Pcheck.x() - P0.x()) * (P1.y() - P0.y())));
 }
+
+unsigned long long point_array_hash(delamo::Span<const delamo::TPoint3<double>> ptsarr)
+{
+	FingerprintBuilder hash;
+	for (auto& pt : ptsarr)
+	{
+		hash.add(pt.x());
+		hash.add(pt.y());
+		hash.add(pt.z());
+	}
+
+	return hash.value().hash();
+}
+
+int group_disjoint_regions(delamo::Span<const delamo::TPoint3<double>> bbox_min, delamo::Span<const delamo::TPoint3<double>> bbox_max, double tolerance, delamo::List<int>& group_ids)
+{
+	group_ids.clear();
+	int num_groups = 0;
+
+	for (size_t i = 0; i < bbox_min.size(); i++)
+	{
+		// Find the first group which does not contain any overlapping regions
+		int group = 0;
+		for (; group < num_groups; group++)
+		{
+			bool overlaps = false;
+			for (size_t j = 0; j < i && !overlaps; j++)
+			{
+				if (group_ids[j] != group)
+					continue;
+
+				overlaps = true;
+				for (int axis = 0; axis < 3; axis++)
+				{
+					if (bbox_min[i][axis] > bbox_max[j][axis] + tolerance || bbox_min[j][axis] > bbox_max[i][axis] + tolerance)
+					{
+						overlaps = false;
+						break;
+					}
+				}
+			}
+			if (!overlaps)
+				break;
+		}
+
+		// Create a new group if all groups have an overlapping region
+		if (group == num_groups)
+			num_groups++;
+		group_ids.add(group);
+	}
+
+	return num_groups;
+}
@@ -11,6 +11,22 @@
  */
 void read_csv_file(const char* file_name, delamo::TPoint3<double>*& ptsarr, int& ptsarr_size);
 
+/**
+ * \brief Reads the points from a CSV file into a structure-of-arrays point container.
+ *
+ * \param file_name CSV file containing the point data
+ * \param pts point container, existing contents are replaced (OUTPUT)
+ */
+void read_csv_file(const char* file_name, delamo::Point3Array<double>& pts);
+
+/**
+ * \brief Reads the points from a CSV file into a list which owns them.
+ *
+ * \param file_name CSV file containing the point data
+ * \param pts list of points, existing contents are replaced (OUTPUT)
+ */
+void read_csv_file(const char* file_name, delamo::List< delamo::TPoint3<double> >& pts);
+
 /**
  * \brief Flips the input point array upside down.
  *
@@ -20,6 +36,14 @@ void read_csv_file(const char* file_name, delamo::TPoint3<double>*& ptsarr, int&
  */
 void point_array_flip(delamo::TPoint3<double>* ptsin, int ptsin_size, delamo::TPoint3<double>*& ptsout);
 
+/**
+ * \brief Flips the input point array upside down.
+ *
+ * \param[in] ptsin view of the input point array to be flipped upside down
+ * \return flipped point array
+ */
+delamo::List< delamo::TPoint3<double> > point_array_flip(delamo::Span<const delamo::TPoint3<double>> ptsin);
+
 /**
  * \brief Reads ModelBuilder license key
  *
@@ -38,6 +62,14 @@ bool MODELBUILDER_EXPORT read_license_file(const char* file_name, char*& unlock_
  */
 void find_point_inside_polygon(delamo::TPoint3<double>* ptsarr, int ptsarr_size, delamo::TPoint3<double>& point_inside);
 
+/**
+ * \brief Finds a point inside the polygon.
+ *
+ * \param[in] ptsarr view of the points that build up the polygon
+ * \param[out] point_inside point inside the polygon
+ */
+void find_point_inside_polygon(delamo::Span<const delamo::TPoint3<double>> ptsarr, delamo::TPoint3<double>& point_inside);
+
 /**
  * \brief Checks if the point inside the polygon using the winding number method
  *
@@ -49,6 +81,16 @@ void find_point_inside_polygon(delamo::TPoint3<double>* ptsarr, int ptsarr_size,
  */
 int wn_pnpoly(delamo::TPoint3<double>& pt_check, delamo::TPoint3<double>* ptsarr, int ptsarr_size);
 
+/**
+ * \brief Checks if the point inside the polygon using the winding number method
+ *
+ * @see: http://geomalgorithms.com/a03-_inclusion.html
+ * \param[in] pt_check point to be checked
+ * \param[in] ptsarr view of the points that build up the polygon
+ * \return the winding number, =0 when the point is outside
+ */
+int wn_pnpoly(const delamo::TPoint3<double>& pt_check, delamo::Span<const delamo::TPoint3<double>> ptsarr);
+
 /**
  * \brief Checks if the point is left/on/right of an infinite line.
  *
@@ -58,4 +100,25 @@ int wn_pnpoly(delamo::TPoint3<double>& pt_check, delamo::TPoint3<double>* ptsarr
  * \param Pcheck point to be checked
  * \return >0 if the point is on the left, =0 if the point is on the line, <0 if the point is on the right
  */
-double is_left(delamo::TPoint3<double>& P0, delamo::TPoint3<double>& P1, delamo::TPoint3<double>& Pcheck);
+double is_left(const delamo::TPoint3<double>& P0, const delamo::TPoint3<double>& P1, const delamo::TPoint3<double>& Pcheck);
+
+/**
+ * \brief Computes a 64-bit hash of the point coordinates from their Fingerprint.
+ *
+ * The hash only depends on the point coordinates, so it can be used as a cache key for the geometry generated from the points.
+ * \param ptsarr array of points
+ * \return hash value
+ */
+unsigned long long point_array_hash(delamo::Span<const delamo::TPoint3<double>> ptsarr);
+
+/**
+ * \brief Groups the regions so that the bounding boxes of the regions in the same group do not overlap.
+ *
+ * Regions are assigned greedily in the input order, i.e. each region goes to the first group which it does not overlap.
+ * \param bbox_min minimum corners of the region bounding boxes
+ * \param bbox_max maximum corners of the region bounding boxes
+ * \param tolerance boxes closer than the tolerance are considered as overlapping
+ * \param group_ids group index of each region (OUTPUT)
+ * \return number of groups
+ */
+int group_disjoint_regions(delamo::Span<const delamo::TPoint3<double>> bbox_min, delamo::Span<const delamo::TPoint3<double>> bbox_max, double tolerance, delamo::List<int>& group_ids);
@@ -47,6 +47,7 @@
 using namespace delamo;
 
 // Common includes
+#include "src/Fingerprint.h"
 #include "src/MBBody.h"
 #include "src/Layer.h"
 #include "src/LayerBody.h"
@@ -54,6 +55,63 @@ using namespace delamo;
 #include "src/LayerMold.h"
 #include "src/ModelBuilder.h"
 #include "src/ACISModelBuilder.h"
+
+// Converts a face adjacency list to a Python list of dictionaries
+static PyObject* FAL_to_PyList(FaceAdjacency* fal, int fal_size)
+{
+	PyObject* result = PyList_New(fal_size);
+
+	for (int i = 0; i < fal_size; i++)
+	{
+		// Create a new dictionary
+		PyObject* item_dict = PyDict_New();
+		
+		// Copy the names to the dictionary
+#if PY_MAJOR_VERSION == 2
+		PyDict_SetItemString(item_dict, "name1", PyString_FromString(fal[i].name1));
+		PyDict_SetItemString(item_dict, "name2", PyString_FromString(fal[i].name2));
+#else
+		PyDict_SetItemString(item_dict, "name1", PyUnicode_FromString(fal[i].name1));
+		PyDict_SetItemString(item_dict, "name2", PyUnicode_FromString(fal[i].name2));
+#endif
+
+		// Copy the normal and point of the first layer to the dictionary
+		PyObject* point1 = PyList_New(3);
+		PyList_SetItem(point1, 0, PyFloat_FromDouble(fal[i].point1.x()));
+		PyList_SetItem(point1, 1, PyFloat_FromDouble(fal[i].point1.y()));
+		PyList_SetItem(point1, 2, PyFloat_FromDouble(fal[i].point1.z()));
+		PyDict_SetItemString(item_dict, "point1", point1);
+		PyObject* normal1 = PyList_New(3);
+		PyList_SetItem(normal1, 0, PyFloat_FromDouble(fal[i].vector1.x()));
+		PyList_SetItem(normal1, 1, PyFloat_FromDouble(fal[i].vector1.y()));
+		PyList_SetItem(normal1, 2, PyFloat_FromDouble(fal[i].vector1.z()));
+		PyDict_SetItemString(item_dict, "normal1", normal1);
+
+		// Copy the normal and point of the second layer to the dictionary
+		PyObject* point2 = PyList_New(3);
+		PyList_SetItem(point2, 0, PyFloat_FromDouble(fal[i].point2.x()));
+		PyList_SetItem(point2, 1, PyFloat_FromDouble(fal[i].point2.y()));
+		PyList_SetItem(point2, 2, PyFloat_FromDouble(fal[i].point2.z()));
+		PyDict_SetItemString(item_dict, "point2", point2);
+		PyObject* normal2 = PyList_New(3);
+		PyList_SetItem(normal2, 0, PyFloat_FromDouble(fal[i].vector2.x()));
+		PyList_SetItem(normal2, 1, PyFloat_FromDouble(fal[i].vector2.y()));
+		PyList_SetItem(normal2, 2, PyFloat_FromDouble(fal[i].vector2.z()));
+		PyDict_SetItemString(item_dict, "normal2", normal2);
+
+		// Copy bcType to the dictionary
+#if PY_MAJOR_VERSION == 2
+		PyDict_SetItemString(item_dict, "bcType", PyInt_FromSsize_t(fal[i].bcType));
+#else
+		PyDict_SetItemString(item_dict, "bcType", PyLong_FromSsize_t(fal[i].bcType));
+#endif
+
+		// Add the dictionary to the return list
+		PyList_SetItem(result, i, item_dict);
+	}
+
+	return result;
+}
 %}
 
 /*
@@ -103,6 +161,7 @@ using namespace delamo;
 
 
 %include "../APIConfig.h"
+%include "../Fingerprint.h"
 %include "../MBBody.h"
 %include "../Layer.h"
 %include "../LayerBody.h"
@@ -152,4 +211,7 @@ using namespace delamo;
 %template(LayerList) delamo::List<Layer*>;
 %template(MBBodyList) delamo::List<MBBody*>;
 %template(LayerMoldList) delamo::List<LayerMold*>;
+%template(IntList) delamo::List<int>;
+%template(DoubleList) delamo::List<double>;
+%template(InterfaceSpecList) delamo::List<InterfaceSpec>;
  
@@ -49,6 +49,21 @@
 	}
 }
 
+%extend delamo::List< int >
+{
+	int __getitem__(unsigned int idx) throw (std::out_of_range)
+	{
+		if (idx>=self->size())
+			throw std::out_of_range("in IntList::__getitem__()");
+		return (*self)[idx];
+	}
+
+	unsigned int __len__()
+	{
+		return self->size();
+	}
+}
+
 %extend delamo::List< Layer *>
 {
 	Layer *__getitem__(unsigned int idx) throw (std::out_of_range)
@@ -14,11 +14,24 @@
 %rename("$ignore") delamo::List< FaceAdjacency *>::List(std::initializer_list< FaceAdjacency >);
 %rename("$ignore") delamo::List< Layer *>::List(std::initializer_list< Layer >);
 %rename("$ignore") delamo::List< LayerMold *>::List(std::initializer_list< LayerMold >);
+%rename("$ignore") delamo::List< int >::List(std::initializer_list< int >);
+%rename("$ignore") delamo::List< double >::List(std::initializer_list< double >);
+%rename("$ignore") delamo::List< InterfaceSpec >::List(std::initializer_list< InterfaceSpec >);
 
 // Ignore some ModelBuilder functions, as we don't need them on the Python side
 %rename("$ignore") ACISModelBuilder::save(const char* file_name);
-%rename("$ignore") ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset);
-%rename("$ignore") ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name);
-%rename("$ignore") ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, delamo::List< std::string >& file_names);
+%rename("$ignore") ModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset);
+%rename("$ignore") ModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name);
+%rename("$ignore") ModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, delamo::List< std::string >& file_names);
 %rename("$ignore") ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, const char* file_name, delamo::TPoint3<double>& pt_inside);
 %rename("$ignore") ACISModelBuilder::adjacent_layers(Layer *layer_orig, Layer *layer_offset, delamo::List< std::string >& file_names, delamo::List< delamo::TPoint3<double> >& pts_inside);
+%rename("$ignore") ModelBuilder::find_closest_points(delamo::Span< Layer* > layer_list, delamo::TPoint3<double> point_in, delamo::List< delamo::TPoint3<double> >& point_list, delamo::List< delamo::TPoint3<double> >& normal_list, delamo::List< std::string >& name_list);
+%rename("$ignore") ModelBuilder::find_closest_faces_to_points(delamo::Span< Layer* > layer_list, delamo::Span< delamo::TPoint3<double> > points_in, delamo::List< delamo::TPoint3<double> >& point_list, delamo::List< delamo::TPoint3<double> >& normal_list, delamo::List< std::string >& name_list);
+
+// Span-based bulk insertion is only meant for the C++ side
+%rename("$ignore") Layer::add_bodies;
+%rename("$ignore") LayerBody::add_surfaces;
+
+// Deferred point and normal evaluation is handled by the solid modeling kernel
+%rename("$ignore") LayerSurfaceEvaluator;
+%rename("$ignore") LayerSurface::invalidate;
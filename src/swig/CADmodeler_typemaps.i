@@ -119,6 +119,155 @@
 	free($5);
 }
 
+/**
+ * Swig "in" typemap for passing a list of layers to the functions which expect a layer pointer array
+ *
+ * Usage:
+ *	>> point_list, normal_list, name_list = acis.find_closest_points([layer1, layer2, ...], [x, y, z]);
+ */
+%typemap(in) (Layer** layer_list, int layer_list_size)
+{
+	if (!PyList_Check($input))
+	{
+		PyErr_SetString(PyExc_ValueError, "Expecting a list of layers!");
+		return NULL;
+	}
+
+	// Convert the Python list into a layer pointer array
+	$2 = (int)PyList_Size($input);
+	$1 = new Layer*[$2];
+	for (int i = 0; i < $2; i++)
+	{
+		void* layer_ptr = nullptr;
+		if (!SWIG_IsOK(SWIG_ConvertPtr(PyList_GetItem($input, i), &layer_ptr, $descriptor(Layer*), 0)))
+		{
+			delete[] $1;
+			PyErr_SetString(PyExc_ValueError, "Expecting a list of layers!");
+			return NULL;
+		}
+		$1[i] = (Layer*)layer_ptr;
+	}
+}
+
+%typemap(freearg) (Layer** layer_list, int layer_list_size)
+{
+	// Deallocate the layer pointer array allocated by the "in" typemap
+	delete[] $1;
+}
+
+/**
+ * Swig "in" & "argout" typemap combination for the function ACISModelBuilder::find_closest_faces_to_points()
+ *
+ * Usage:
+ *	>> point_list, normal_list, name_list = acis.find_closest_faces_to_points([layer_list], [[x1, y1, z1], [x2, y2, z2], ...]);
+ */
+%typemap(in) (delamo::TPoint3<double>* points_in, int points_in_size)
+{
+	if (!PyList_Check($input))
+	{
+		PyErr_SetString(PyExc_ValueError, "Expecting a list of (x, y, z) coordinates!");
+		return NULL;
+	}
+
+	// Convert each item of the input list into the C++ object, delamo::TPoint3<double>
+	$2 = (int)PyList_Size($input);
+	$1 = new delamo::TPoint3<double>[$2];
+	for (int i = 0; i < $2; i++)
+	{
+		PyObject* pt = PyList_GetItem($input, i);
+		if (!PyList_Check(pt) || PyList_Size(pt) < 3)
+		{
+			delete[] $1;
+			PyErr_SetString(PyExc_ValueError, "Expecting a list of (x, y, z) coordinates!");
+			return NULL;
+		}
+
+		for (int j = 0; j < 3; j++)
+		{
+			PyObject* val = PyList_GetItem(pt, j);
+			if (PyLong_Check(val))
+			{
+				$1[i][j] = (double)PyLong_AsSsize_t(val);
+			}
+			else if (PyFloat_Check(val))
+			{
+				$1[i][j] = PyFloat_AsDouble(val);
+			}
+		}
+	}
+}
+
+%typemap(freearg) (delamo::TPoint3<double>* points_in, int points_in_size)
+{
+	// Deallocate the point array allocated by the "in" typemap
+	delete[] $1;
+}
+
+%typemap(in,numinputs=0) (delamo::TPoint3<double>*& point_list, delamo::TPoint3<double>*& normal_list, char**& name_list, int& list_size)
+{
+	// SWIG converts "**&" to "***" and therefore, it is required to add an additional instantiation and deletion step
+	$1 = ($1_ltype) calloc(1, sizeof(delamo::TPoint3<double>*));
+	$2 = ($2_ltype) calloc(1, sizeof(delamo::TPoint3<double>*));
+	$3 = ($3_ltype) calloc(1, sizeof(char**));
+	$4 = ($4_ltype) calloc(1, sizeof(int));
+}
+
+%typemap(argout) (delamo::TPoint3<double>*& point_list, delamo::TPoint3<double>*& normal_list, char**& name_list, int& list_size)
+{
+	// Blow away any previous result
+	Py_XDECREF($result);
+
+	// We will be returning a list of 3 lists, which these lists have the size of list_size
+	$result = PyList_New(3);
+	PyObject* plist = PyList_New(*$4);
+	PyObject* nlist = PyList_New(*$4);
+	PyObject* names = PyList_New(*$4);
+
+	for (int i = 0; i < *$4; i++)
+	{
+		// Convert the point into a Python list
+		PyObject* point_pyobj = PyList_New(3);
+		PyList_SetItem(point_pyobj, 0, PyFloat_FromDouble($1[0][i].x()));
+		PyList_SetItem(point_pyobj, 1, PyFloat_FromDouble($1[0][i].y()));
+		PyList_SetItem(point_pyobj, 2, PyFloat_FromDouble($1[0][i].z()));
+		PyList_SetItem(plist, i, point_pyobj);
+
+		// Convert the normal into a Python list
+		PyObject* normal_pyobj = PyList_New(3);
+		PyList_SetItem(normal_pyobj, 0, PyFloat_FromDouble($2[0][i].x()));
+		PyList_SetItem(normal_pyobj, 1, PyFloat_FromDouble($2[0][i].y()));
+		PyList_SetItem(normal_pyobj, 2, PyFloat_FromDouble($2[0][i].z()));
+		PyList_SetItem(nlist, i, normal_pyobj);
+
+		// Add the layer body name to the Python list
+		%#if PY_MAJOR_VERSION == 2
+		PyList_SetItem(names, i, PyString_FromString($3[0][i]));
+		%#else
+		PyList_SetItem(names, i, PyUnicode_FromString($3[0][i]));
+		%#endif
+	}
+
+	PyList_SetItem($result, 0, plist);
+	PyList_SetItem($result, 1, nlist);
+	PyList_SetItem($result, 2, names);
+
+	// Deallocate memory which was allocated by "new"
+	delete[] $1[0];
+	delete[] $2[0];
+	for (int i = 0; i < *$4; i++)
+	{
+		// C-style strings can only be deleted by free
+		free((char*)$3[0][i]);
+	}
+	delete[] $3[0];
+
+	// Deallocate memory which was allocated by "calloc"
+	free($1);
+	free($2);
+	free($3);
+	free($4);
+}
+
 /**
  * Swig "in" & "argout" typemap combination for the function ACISModelBuilder::find_closest_face_to_point()
  *
@@ -275,6 +424,11 @@
  * 
  * Example code:
  *	>> fal12 = acis.adjacent_layers(layer1, layer2, delamo.CADwrap.DEFAULT_BC_CONTACT)
+ *
+ * In deferred mode, the call returns an empty list and the FAL is collected after sync():
+ *	>> acis.adjacent_layers(layer1, layer2, delamo.CADwrap.DEFAULT_BC_CONTACT)
+ *	>> ticket12 = acis.deferred_ticket()
+ *	>> fal12 = acis.deferred_result(ticket12)
  */
 %typemap(in) (BCStatus)
 {
@@ -318,61 +472,61 @@
 	Py_XDECREF($result);
 
 	// Convert the FAL to native python list
-	$result = PyList_New(*$2);
-
-	for (int i = 0; i < *$2; i++)
-	{
-		// Create a new dictionary
-		PyObject* item_dict = PyDict_New();
-		
-		// Copy the names to the dictionary
-		%#if PY_MAJOR_VERSION == 2
-			PyDict_SetItemString(item_dict, "name1", PyString_FromString($1[0][i].name1));
-			PyDict_SetItemString(item_dict, "name2", PyString_FromString($1[0][i].name2));
-		%#else
-			PyDict_SetItemString(item_dict, "name1", PyUnicode_FromString($1[0][i].name1));
-			PyDict_SetItemString(item_dict, "name2", PyUnicode_FromString($1[0][i].name2));
-		%#endif
-
-		// Copy the normal and point of the first layer to the dictionary
-		PyObject* point1 = PyList_New(3);
-		PyList_SetItem(point1, 0, PyFloat_FromDouble($1[0][i].point1.x()));
-		PyList_SetItem(point1, 1, PyFloat_FromDouble($1[0][i].point1.y()));
-		PyList_SetItem(point1, 2, PyFloat_FromDouble($1[0][i].point1.z()));
-		PyDict_SetItemString(item_dict, "point1", point1);
-		PyObject* normal1 = PyList_New(3);
-		PyList_SetItem(normal1, 0, PyFloat_FromDouble($1[0][i].vector1.x()));
-		PyList_SetItem(normal1, 1, PyFloat_FromDouble($1[0][i].vector1.y()));
-		PyList_SetItem(normal1, 2, PyFloat_FromDouble($1[0][i].vector1.z()));
-		PyDict_SetItemString(item_dict, "normal1", normal1);
-
-		// Copy the normal and point of the second layer to the dictionary
-		PyObject* point2 = PyList_New(3);
-		PyList_SetItem(point2, 0, PyFloat_FromDouble($1[0][i].point2.x()));
-		PyList_SetItem(point2, 1, PyFloat_FromDouble($1[0][i].point2.y()));
-		PyList_SetItem(point2, 2, PyFloat_FromDouble($1[0][i].point2.z()));
-		PyDict_SetItemString(item_dict, "point2", point2);
-		PyObject* normal2 = PyList_New(3);
-		PyList_SetItem(normal2, 0, PyFloat_FromDouble($1[0][i].vector2.x()));
-		PyList_SetItem(normal2, 1, PyFloat_FromDouble($1[0][i].vector2.y()));
-		PyList_SetItem(normal2, 2, PyFloat_FromDouble($1[0][i].vector2.z()));
-		PyDict_SetItemString(item_dict, "normal2", normal2);
-
-		// Copy bcType to the dictionary
-		%#if PY_MAJOR_VERSION == 2
-			PyDict_SetItemString(item_dict, "bcType", PyInt_FromSsize_t($1[0][i].bcType));
-		%#else
-			PyDict_SetItemString(item_dict, "bcType", PyLong_FromSsize_t($1[0][i].bcType));
-		%#endif
-
-		// Add the dictionary to the return list
-		PyList_SetItem($result, i, item_dict);
-	}
+	$result = FAL_to_PyList($1[0], *$2);
 
 	// Free the memory allocated in the C++ method
 	delete[] $1[0];
 	// Free the memory allocated in the typemap
 	free($1);
+	free($2);
+}
+
+/**
+ * Swig "in" & "argout" typemap combination for the function ModelBuilder::build_laminate()
+ *
+ * The plies are owned by the ModelBuilder, the face adjacency lists are converted like the ones of adjacent_layers().
+ *
+ * Example code:
+ *	>> layers, fals = acis.build_laminate(spec)
+ */
+%typemap(in,numinputs=0) (delamo::List<Layer*>& layers_out, delamo::List<FaceAdjacency*>& fal_out, delamo::List<int>& fal_size_out)
+{
+	$1 = new delamo::List<Layer*>();
+	$2 = new delamo::List<FaceAdjacency*>();
+	$3 = new delamo::List<int>();
+}
+
+%typemap(argout) (delamo::List<Layer*>& layers_out, delamo::List<FaceAdjacency*>& fal_out, delamo::List<int>& fal_size_out)
+{
+	// Blow away any previous result
+	Py_XDECREF($result);
+
+	// The plies are returned as a list of Layer objects
+	PyObject* layer_list = PyList_New($1->size());
+	for (int i = 0; i < (int)$1->size(); i++)
+		PyList_SetItem(layer_list, i, SWIG_NewPointerObj(SWIG_as_voidptr((*$1)[i]), $descriptor(Layer*), 0));
+
+	// One list of dictionaries for each interface
+	PyObject* fal_list = PyList_New($2->size());
+	for (int i = 0; i < (int)$2->size(); i++)
+		PyList_SetItem(fal_list, i, FAL_to_PyList((*$2)[i], (*$3)[i]));
+
+	$result = PyTuple_Pack(2, layer_list, fal_list);
+	Py_DECREF(layer_list);
+	Py_DECREF(fal_list);
+}
+
+%typemap(freearg) (delamo::List<Layer*>& layers_out, delamo::List<FaceAdjacency*>& fal_out, delamo::List<int>& fal_size_out)
+{
+	// Free the face adjacency lists allocated in the C++ method, also if it failed after generating some of them
+	if ($2 != NULL)
+	{
+		for (auto fal : *$2)
+			delete[] fal;
+	}
+	delete $1;
+	delete $2;
+	delete $3;
 }
 
 /**
@@ -0,0 +1,139 @@
+#include "testcase_includes.h"
+
+
+// Reference modeler which cannot restore every other cached body, e.g. a body saved by an incompatible kernel version
+class PartialRestoreModelBuilder : public ReferenceModelBuilder
+{
+protected:
+	bool restore_cache_body(LayerBody* lb, const std::string& blob, delamo::List<DLM_FACEP>& faces)
+	{
+		this->_mNumRestores++;
+		if (this->_mNumRestores % 2 == 0)
+			return false;
+		return ReferenceModelBuilder::restore_cache_body(lb, blob, faces);
+	}
+
+private:
+	int _mNumRestores = 0;
+};
+
+// Builds the layers with the layer cache and compares them with the plain build, returns the number of cache hits
+static bool build_cached(NURBS<double>* mold, double thickness, int layers_len, const std::string& cache_dir, const std::vector<std::string>& delam_files, const char* test_name, int& cache_hits, bool partial_restore = false)
+{
+	// Plain build
+	ModelBuilder* ref_plain = new ReferenceModelBuilder();
+	ref_plain->start();
+
+	Layer* plain_layers = new Layer[layers_len];
+	delamo::List<FaceAdjacency*> plain_fal_list;
+	delamo::List<int> plain_fal_size_list;
+	CreateLayers(ref_plain, mold, thickness, plain_layers, layers_len);
+	BondLayers(ref_plain, plain_layers, layers_len, delam_files, plain_fal_list, plain_fal_size_list);
+
+	// Cached build, the cache should be enabled before creating the first layer
+	ModelBuilder* ref = partial_restore ? new PartialRestoreModelBuilder() : new ReferenceModelBuilder();
+	ref->start();
+	ref->cache_directory(cache_dir.c_str());
+
+	Layer* layers = new Layer[layers_len];
+	delamo::List<FaceAdjacency*> fal_list;
+	delamo::List<int> fal_size_list;
+	CreateLayers(ref, mold, thickness, layers, layers_len);
+	BondLayers(ref, layers, layers_len, delam_files, fal_list, fal_size_list);
+
+	delamo::List< Layer *> layer_list(layers, layers_len);
+	delamo::List< Layer *> plain_layer_list(plain_layers, layers_len);
+	bool passed = CompareFaceCounts(layer_list, plain_layer_list);
+	passed = CompareFingerprints(layer_list, plain_layer_list) && passed;
+	passed = CompareFAL(fal_list, fal_size_list, plain_fal_list, plain_fal_size_list) && passed;
+
+	cache_hits = ref->cache_hits();
+	std::cout << test_name << " with " << cache_hits << " cache hits: " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+	ref->stop();
+	ref_plain->stop();
+	for (auto fal : fal_list)
+		delete[] fal;
+	for (auto fal : plain_fal_list)
+		delete[] fal;
+	delete[] layers;
+	delete[] plain_layers;
+	delete ref;
+	delete ref_plain;
+
+	return passed;
+}
+
+int main(int argc, char** argv)
+{
+	// Cache directory can be changed from the command line, it should exist
+	std::string cache_dir = ".";
+	if (argc > 1)
+		cache_dir = argv[1];
+
+	// Prepare mold as a NURBS surface
+	NURBS<double> mold;
+	if (!ReadPlanarMold(mold))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+
+	/**
+	* REQUIRED VARIABLES
+	*/
+
+	// Define thickness and the number of layers
+	double thickness = 0.2;
+	int layers_len = 8;
+
+	// Define file names, every other interface has a delamination
+	std::string delam_file = "Delamination1_3D.csv";
+	std::string delam_shifted_file = "Delamination1_3D_Shifted.csv";
+	if (!ShiftDelamination(delam_file, delam_shifted_file, 1.5))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+	std::vector<std::string> delam_files(layers_len - 1);
+	for (int i = 0; i < layers_len - 1; i += 2)
+		delam_files[i] = delam_file;
+
+	/**
+	* BUILD WITH THE CACHE
+	*/
+
+	// The first build fills the cache, unless a previous run has already filled it
+	int cold_hits = 0, warm_hits = 0, failed_hits = 0, partial_hits = 0;
+	bool passed = build_cached(&mold, thickness, layers_len, cache_dir, delam_files, "Cold cache build", cold_hits);
+
+	// The second build restores all layers and interfaces from the cache
+	passed = build_cached(&mold, thickness, layers_len, cache_dir, delam_files, "Warm cache build", warm_hits) && passed;
+	if (warm_hits != 2 * layers_len - 1)
+	{
+		std::cout << "Warm cache build restored " << warm_hits << " operations, expected " << 2 * layers_len - 1 << std::endl;
+		passed = false;
+	}
+
+	// Entries which cannot be restored completely leave the layers untouched, and the operations run instead
+	passed = build_cached(&mold, thickness, layers_len, cache_dir, delam_files, "Build with failed restores", failed_hits, true) && passed;
+	if (failed_hits <= 0 || failed_hits >= warm_hits)
+	{
+		std::cout << "Build with failed restores restored " << failed_hits << " operations, expected less than " << warm_hits << std::endl;
+		passed = false;
+	}
+
+	// Changing a delamination outline regenerates its interface and the layers depending on it
+	delam_files[2] = delam_shifted_file;
+	passed = build_cached(&mold, thickness, layers_len, cache_dir, delam_files, "Partially cached build", partial_hits) && passed;
+
+	// A cache directory filled by a previous run has the entries of the changed outline as well
+	bool partial_expected = (cold_hits == 0) ? (partial_hits > 0 && partial_hits < warm_hits) : (partial_hits == warm_hits);
+	if (!partial_expected)
+	{
+		std::cout << "Partially cached build restored " << partial_hits << " operations, expected " << ((cold_hits == 0) ? "less than " : "") << warm_hits << std::endl;
+		passed = false;
+	}
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
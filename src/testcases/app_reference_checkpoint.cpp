@@ -0,0 +1,187 @@
+#include "testcase_includes.h"
+
+
+int main(int argc, char** argv)
+{
+	// Number of layers can be changed from the command line
+	int layers_len = 8;
+	if (argc > 1)
+		layers_len = std::max(2, atoi(argv[1]));
+
+	// Prepare mold as a NURBS surface
+	NURBS<double> mold;
+	if (!ReadPlanarMold(mold))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+
+	/**
+	* REQUIRED VARIABLES
+	*/
+
+	// Define thickness
+	double thickness = 0.2;
+
+	// Define file names, every other interface has a delamination
+	std::string checkpoint_file = "DeLaMo_TC_Reference.ckpt";
+	std::string delam_file = "Delamination1_3D.csv";
+	std::vector<std::string> delam_files(layers_len);
+	for (int i = 0; i < layers_len; i += 2)
+		delam_files[i] = delam_file;
+
+	/**
+	* SAVE A CHECKPOINT
+	*/
+
+	ModelBuilder* ref_saved = new ReferenceModelBuilder();
+	ref_saved->start();
+
+	Layer* saved_layers = new Layer[layers_len];
+	delamo::List<FaceAdjacency*> saved_fal_list;
+	delamo::List<int> saved_fal_size_list;
+	CreateLayers(ref_saved, &mold, thickness, saved_layers, layers_len);
+	BondLayers(ref_saved, saved_layers, layers_len, delam_files, saved_fal_list, saved_fal_size_list);
+	ref_saved->checkpoint(checkpoint_file.c_str());
+
+	// Write errors are reported
+	bool passed = true;
+	try
+	{
+		ref_saved->checkpoint("Missing_Directory/DeLaMo_TC_Reference.ckpt");
+		std::cout << "Checkpoint is saved to a missing directory" << std::endl;
+		passed = false;
+	}
+	catch (std::runtime_error&)
+	{
+	}
+
+	// The layer states are compared after restoring
+	std::vector<std::string> saved_names;
+	std::vector<int> saved_ids;
+	std::vector<Fingerprint> saved_fingerprints;
+	for (int i = 0; i < layers_len; i++)
+	{
+		saved_names.push_back(saved_layers[i].name());
+		saved_ids.push_back(saved_layers[i].id());
+		saved_fingerprints.push_back(saved_layers[i].fingerprint());
+	}
+
+	ref_saved->stop();
+	for (auto fal : saved_fal_list)
+		delete[] fal;
+	delete[] saved_layers;
+	delete ref_saved;
+
+	/**
+	* RESTORE AND CONTINUE
+	*/
+
+	ModelBuilder* ref = new ReferenceModelBuilder();
+	ref->start();
+
+	// A truncated checkpoint is rejected without restoring any layers
+	std::string truncated_file = "DeLaMo_TC_Reference_Truncated.ckpt";
+	{
+		std::ifstream in_file(checkpoint_file.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+		std::string contents((size_t)in_file.tellg() / 2, '\0');
+		in_file.seekg(0);
+		in_file.read(&contents[0], contents.size());
+		std::ofstream out_file(truncated_file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		out_file.write(contents.data(), contents.size());
+	}
+	delamo::List<Layer*> truncated_list;
+	try
+	{
+		ref->restore(truncated_file.c_str(), truncated_list);
+		std::cout << "Truncated checkpoint is restored" << std::endl;
+		passed = false;
+	}
+	catch (std::runtime_error&)
+	{
+	}
+	if (truncated_list.size() != 0)
+	{
+		std::cout << "Truncated checkpoint restored " << truncated_list.size() << " layers" << std::endl;
+		passed = false;
+	}
+
+	// Restored layers are owned by the ModelBuilder
+	delamo::List<Layer*> layer_list;
+	ref->restore(checkpoint_file.c_str(), layer_list);
+
+	// Restored layers have the saved names, IDs and fingerprints
+	for (int i = 0; i < (int)layer_list.size() && i < layers_len; i++)
+	{
+		if (saved_names[i] != layer_list[i]->name() || saved_ids[i] != layer_list[i]->id() || saved_fingerprints[i] != layer_list[i]->fingerprint())
+		{
+			std::cout << "Layer " << i << " is restored as " << layer_list[i]->name() << " with ID " << layer_list[i]->id() << ", expected " << saved_names[i] << " with ID " << saved_ids[i] << std::endl;
+			passed = false;
+		}
+	}
+
+	// Add one more layer on top of the restored ones
+	delamo::List<FaceAdjacency*> fal_list;
+	delamo::List<int> fal_size_list;
+	Layer* top_layer = new Layer();
+	FaceAdjacency* fal = nullptr;
+	int fal_size = 0;
+	if (layer_list.size() == (size_t)layers_len)
+	{
+		ref->create_layer(layer_list[layers_len - 1], Direction::OFFSET, thickness, top_layer);
+		top_layer->name(("Layer_" + std::to_string(layers_len + 1)).c_str());
+		top_layer->layup(0);
+		if (!delam_files[layers_len - 1].empty())
+			ref->adjacent_layers(layer_list[layers_len - 1], top_layer, delam_files[layers_len - 1].c_str(), BCStatus::is_contact, fal, fal_size);
+		else
+			ref->adjacent_layers(layer_list[layers_len - 1], top_layer, BCStatus::is_contact, fal, fal_size);
+		fal_list.add(fal);
+		fal_size_list.add(fal_size);
+	}
+	layer_list.add(top_layer);
+
+	/**
+	* PLAIN BUILD
+	*/
+
+	ModelBuilder* ref_plain = new ReferenceModelBuilder();
+	ref_plain->start();
+
+	Layer* plain_layers = new Layer[layers_len + 1];
+	delamo::List<FaceAdjacency*> plain_fal_list;
+	delamo::List<int> plain_fal_size_list;
+	CreateLayers(ref_plain, &mold, thickness, plain_layers, layers_len + 1);
+	BondLayers(ref_plain, plain_layers, layers_len + 1, delam_files, plain_fal_list, plain_fal_size_list);
+
+	/**
+	* COMPARE
+	*/
+
+	// Only the interface generated after restoring is compared, the others are saved in the checkpoint as layer states
+	delamo::List< Layer *> plain_layer_list(plain_layers, layers_len + 1);
+	delamo::List<FaceAdjacency*> plain_top_fal_list = { plain_fal_list[layers_len - 1] };
+	delamo::List<int> plain_top_fal_size_list = { plain_fal_size_list[layers_len - 1] };
+	passed = CompareFaceCounts(layer_list, plain_layer_list) && passed;
+	passed = CompareFAL(fal_list, fal_size_list, plain_top_fal_list, plain_top_fal_size_list) && passed;
+	std::cout << "Checkpoint and restore: " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+	// Stop the reference modelers and free allocated memory
+	ref->stop();
+	ref_plain->stop();
+
+	// Free FAL memory
+	for (auto fal : fal_list)
+		delete[] fal;
+	for (auto fal : plain_fal_list)
+		delete[] fal;
+
+	// Delete layers, the restored ones are deleted by the ModelBuilder
+	delete top_layer;
+	delete[] plain_layers;
+
+	// Delete ModelBuilder objects
+	delete ref;
+	delete ref_plain;
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
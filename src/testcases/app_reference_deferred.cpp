@@ -0,0 +1,157 @@
+#include "testcase_includes.h"
+
+
+int main(int argc, char** argv)
+{
+	// Number of layers and threads can be changed from the command line
+	int layers_len = 8;
+	int num_threads = 4;
+	if (argc > 1)
+		layers_len = std::max(2, atoi(argv[1]));
+	if (argc > 2)
+		num_threads = std::max(1, atoi(argv[2]));
+
+	// Prepare mold as a NURBS surface
+	NURBS<double> mold;
+	if (!ReadPlanarMold(mold))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+
+	/**
+	* REQUIRED VARIABLES
+	*/
+
+	// Define thickness
+	double thickness = 0.2;
+
+	// Define file names, every other interface has a delamination and the top layer is bonded with one
+	std::string delam_file = "Delamination1_3D.csv";
+	std::vector<std::string> delam_files(layers_len - 1);
+	for (int i = 0; i < layers_len - 1; i += 2)
+		delam_files[i] = delam_file;
+
+	/**
+	* PLAIN BUILD
+	*/
+
+	ModelBuilder* ref_plain = new ReferenceModelBuilder();
+	ref_plain->start();
+
+	Layer* plain_layers = new Layer[layers_len];
+	delamo::List<FaceAdjacency*> plain_fal_list;
+	delamo::List<int> plain_fal_size_list;
+	CreateLayers(ref_plain, &mold, thickness, plain_layers, layers_len);
+	BondLayers(ref_plain, plain_layers, layers_len, delam_files, plain_fal_list, plain_fal_size_list);
+
+	Layer* plain_top_layer = new Layer();
+	ref_plain->create_layer(&plain_layers[layers_len - 1], Direction::OFFSET, thickness, plain_top_layer);
+	plain_top_layer->name(("Layer_" + std::to_string(layers_len + 1)).c_str());
+	ref_plain->adjacent_layers(&plain_layers[layers_len - 1], plain_top_layer, delam_file.c_str());
+
+	/**
+	* DEFERRED BUILD
+	*/
+
+	ModelBuilder* ref = new ReferenceModelBuilder();
+	ref->start();
+
+	// Interfaces are recorded and run concurrently on sync()
+	ref->deferred(true);
+	ref->task_threads(num_threads);
+
+	Layer* layers = new Layer[layers_len];
+	CreateLayers(ref, &mold, thickness, layers, layers_len);
+
+	// The face adjacency lists are collected with the tickets of the recorded calls, the outputs stay empty until then
+	bool passed = true;
+	std::vector<int> tickets;
+	for (int i = 0; i < layers_len - 1; i++)
+	{
+		FaceAdjacency* fal = nullptr;
+		int fal_size = -1;
+		if (!delam_files[i].empty())
+			ref->adjacent_layers(&layers[i], &layers[i + 1], delam_files[i].c_str(), BCStatus::is_contact, fal, fal_size);
+		else
+			ref->adjacent_layers(&layers[i], &layers[i + 1], BCStatus::is_contact, fal, fal_size);
+		if (fal != nullptr || fal_size != 0)
+		{
+			std::cout << "Recorded interface " << i << " returned a face adjacency list of size " << fal_size << std::endl;
+			passed = false;
+		}
+		if (!tickets.empty() && ref->deferred_ticket() <= tickets.back())
+		{
+			std::cout << "Recorded interface " << i << " reused the ticket " << ref->deferred_ticket() << std::endl;
+			passed = false;
+		}
+		tickets.push_back(ref->deferred_ticket());
+	}
+
+	// Operations which are not recorded wait for the recorded ones on the same layers
+	Layer* top_layer = new Layer();
+	ref->create_layer(&layers[layers_len - 1], Direction::OFFSET, thickness, top_layer);
+	ref->adjacent_layers(&layers[layers_len - 1], top_layer, delam_file.c_str());
+	ref->sync();
+
+	delamo::List<FaceAdjacency*> fal_list;
+	delamo::List<int> fal_size_list;
+	for (auto ticket : tickets)
+	{
+		FaceAdjacency* fal = nullptr;
+		int fal_size = 0;
+		ref->deferred_result(ticket, fal, fal_size);
+		fal_list.add(fal);
+		fal_size_list.add(fal_size);
+	}
+
+	// Each result is handed over only once
+	try
+	{
+		FaceAdjacency* fal = nullptr;
+		int fal_size = 0;
+		ref->deferred_result(tickets[0], fal, fal_size);
+		std::cout << "Result of the ticket " << tickets[0] << " is handed over twice" << std::endl;
+		passed = false;
+	}
+	catch (std::runtime_error&)
+	{
+	}
+
+	/**
+	* COMPARE
+	*/
+
+	delamo::List< Layer *> layer_list(layers, layers_len);
+	delamo::List< Layer *> plain_layer_list(plain_layers, layers_len);
+	layer_list.add(top_layer);
+	plain_layer_list.add(plain_top_layer);
+	passed = CompareFaceCounts(layer_list, plain_layer_list) && passed;
+
+	// Layer fingerprints show the operations on each layer run in the recording order
+	passed = CompareFingerprints(layer_list, plain_layer_list) && passed;
+	passed = CompareFAL(fal_list, fal_size_list, plain_fal_list, plain_fal_size_list) && passed;
+	std::cout << "Deferred build with " << num_threads << " threads: " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+	// Stop the reference modelers and free allocated memory
+	ref->stop();
+	ref_plain->stop();
+
+	// Free FAL memory
+	for (auto fal : fal_list)
+		delete[] fal;
+	for (auto fal : plain_fal_list)
+		delete[] fal;
+
+	// Delete layers
+	delete top_layer;
+	delete plain_top_layer;
+	delete[] layers;
+	delete[] plain_layers;
+
+	// Delete ModelBuilder objects
+	delete ref;
+	delete ref_plain;
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
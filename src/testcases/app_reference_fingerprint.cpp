@@ -0,0 +1,169 @@
+#include "testcase_includes.h"
+
+
+// Builds and bonds the layers and returns their fingerprints, the mold fingerprints of each layer are appended after the layer fingerprints
+static std::vector<Fingerprint> build_fingerprints(NURBS<double>* mold, double thickness, int layers_len, const std::vector<std::string>& delam_files, Fingerprint& model_fp)
+{
+	ModelBuilder* ref = new ReferenceModelBuilder();
+	ref->start();
+
+	Layer* layers = new Layer[layers_len];
+	delamo::List<FaceAdjacency*> fal_list;
+	delamo::List<int> fal_size_list;
+	CreateLayers(ref, mold, thickness, layers, layers_len);
+	BondLayers(ref, layers, layers_len, delam_files, fal_list, fal_size_list);
+
+	std::vector<Fingerprint> fingerprints;
+	for (int i = 0; i < layers_len; i++)
+		fingerprints.push_back(ref->fingerprint(&layers[i]));
+	for (int i = 0; i < layers_len; i++)
+	{
+		for (int j = 0; j < layers[i].size_mold(); j++)
+			fingerprints.push_back(ref->fingerprint(layers[i].list_mold()[j]));
+	}
+	delamo::List< Layer *> layer_list(layers, layers_len);
+	model_fp = ref->fingerprint(layer_list);
+
+	ref->stop();
+	for (auto fal : fal_list)
+		delete[] fal;
+	delete[] layers;
+	delete ref;
+
+	return fingerprints;
+}
+
+int main(int argc, char** argv)
+{
+	// Number of layers can be changed from the command line
+	int layers_len = 8;
+	if (argc > 1)
+		layers_len = std::max(4, atoi(argv[1]));
+
+	// Prepare mold as a NURBS surface
+	NURBS<double> mold;
+	if (!ReadPlanarMold(mold))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+
+	/**
+	* REQUIRED VARIABLES
+	*/
+
+	// Define thickness
+	double thickness = 0.2;
+
+	// Define file names, every other interface has a delamination
+	std::string delam_file = "Delamination1_3D.csv";
+	std::string delam_shifted_file = "Delamination1_3D_Shifted.csv";
+	if (!ShiftDelamination(delam_file, delam_shifted_file, 1.5))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+	std::vector<std::string> delam_files(layers_len - 1);
+	for (int i = 0; i < layers_len - 1; i += 2)
+		delam_files[i] = delam_file;
+
+	/**
+	* SURFACE FINGERPRINTS
+	*/
+
+	bool passed = true;
+	ModelBuilder* ref = new ReferenceModelBuilder();
+	ref->start();
+
+	// Round-off below the modeler tolerance does not change the fingerprint, a moved control point does
+	Fingerprint mold_fp = ref->fingerprint(&mold);
+	NURBS<double> noisy_mold(mold);
+	noisy_mold.ctrlpts()[0].x(noisy_mold.ctrlpts()[0].x() + 1e-9);
+	NURBS<double> moved_mold(mold);
+	moved_mold.ctrlpts()[0].x(moved_mold.ctrlpts()[0].x() + 1.0);
+	if (!mold_fp.valid() || mold_fp.hex().size() != 32)
+	{
+		std::cout << "Mold fingerprint is not computed: " << mold_fp.hex() << std::endl;
+		passed = false;
+	}
+	if (ref->fingerprint(&noisy_mold) != mold_fp)
+	{
+		std::cout << "Round-off changes the mold fingerprint" << std::endl;
+		passed = false;
+	}
+	if (ref->fingerprint(&moved_mold) == mold_fp)
+	{
+		std::cout << "Moved control point does not change the mold fingerprint" << std::endl;
+		passed = false;
+	}
+
+	// Layers which are not generated by a ModelBuilder have no fingerprint
+	Layer empty_layer;
+	if (ref->fingerprint(&empty_layer).valid())
+	{
+		std::cout << "Empty layer has a fingerprint" << std::endl;
+		passed = false;
+	}
+
+	ref->stop();
+	delete ref;
+
+	/**
+	* LAYER AND MOLD FINGERPRINTS
+	*/
+
+	// Same inputs generate the same fingerprints in another ModelBuilder
+	Fingerprint model_fp, same_model_fp, thick_model_fp, shifted_model_fp;
+	std::vector<Fingerprint> fingerprints = build_fingerprints(&mold, thickness, layers_len, delam_files, model_fp);
+	std::vector<Fingerprint> same_fingerprints = build_fingerprints(&mold, thickness, layers_len, delam_files, same_model_fp);
+	if (fingerprints != same_fingerprints || model_fp != same_model_fp)
+	{
+		std::cout << "Identical builds have different fingerprints" << std::endl;
+		passed = false;
+	}
+	if ((int)fingerprints.size() <= layers_len)
+	{
+		std::cout << "Molds have no fingerprints" << std::endl;
+		passed = false;
+	}
+	for (int i = 0; i < (int)fingerprints.size(); i++)
+	{
+		if (!fingerprints[i].valid())
+		{
+			std::cout << "Fingerprint " << i << " is not computed" << std::endl;
+			passed = false;
+		}
+	}
+
+	// Thickness changes every layer
+	std::vector<Fingerprint> thick_fingerprints = build_fingerprints(&mold, 2.0 * thickness, layers_len, delam_files, thick_model_fp);
+	for (int i = 0; i < layers_len; i++)
+	{
+		if (thick_fingerprints[i] == fingerprints[i])
+		{
+			std::cout << "Thickness does not change the fingerprint of layer " << i << std::endl;
+			passed = false;
+		}
+	}
+
+	// Delamination outline of the 3rd interface changes its layers and the layers bonded after them, but not the layers bonded before
+	std::vector<std::string> shifted_delam_files = delam_files;
+	shifted_delam_files[2] = delam_shifted_file;
+	std::vector<Fingerprint> shifted_fingerprints = build_fingerprints(&mold, thickness, layers_len, shifted_delam_files, shifted_model_fp);
+	for (int i = 0; i < layers_len; i++)
+	{
+		if ((shifted_fingerprints[i] == fingerprints[i]) != (i < 2))
+		{
+			std::cout << "Delamination outline of the 3rd interface " << ((i < 2) ? "changes" : "does not change") << " the fingerprint of layer " << i << std::endl;
+			passed = false;
+		}
+	}
+	if (thick_model_fp == model_fp || shifted_model_fp == model_fp)
+	{
+		std::cout << "Model fingerprint does not depend on the layers" << std::endl;
+		passed = false;
+	}
+	std::cout << "Fingerprints: " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,167 @@
+#include "testcase_includes.h"
+
+
+// Checks that an invalid laminate specification is rejected without generating any layers
+static bool reject_spec(ModelBuilder* mb, const LaminateSpec& spec, const char* test_name)
+{
+	delamo::List<Layer*> layers;
+	delamo::List<FaceAdjacency*> fal_list;
+	delamo::List<int> fal_size_list;
+	bool rejected = false;
+	try
+	{
+		mb->build_laminate(spec, layers, fal_list, fal_size_list);
+	}
+	catch (std::runtime_error&)
+	{
+		rejected = true;
+	}
+
+	bool passed = rejected && layers.size() == 0 && fal_list.size() == 0;
+	if (!passed)
+		std::cout << test_name << " is not rejected" << std::endl;
+	return passed;
+}
+
+int main(int argc, char** argv)
+{
+	// Number of layers can be changed from the command line
+	int layers_len = 8;
+	if (argc > 1)
+		layers_len = std::max(2, atoi(argv[1]));
+
+	// Prepare mold as a NURBS surface
+	NURBS<double> mold;
+	if (!ReadPlanarMold(mold))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+
+	/**
+	* REQUIRED VARIABLES
+	*/
+
+	// Define thickness and layup
+	double thickness = 0.2;
+	int layup_angles[4] = { 0, 45, -45, 90 };
+
+	// Define file names, every other interface has a delamination
+	std::string delam_file = "Delamination1_3D.csv";
+	std::vector<std::string> delam_files(layers_len - 1);
+	for (int i = 0; i < layers_len - 1; i += 2)
+		delam_files[i] = delam_file;
+
+	/**
+	* PLAIN BUILD
+	*/
+
+	ModelBuilder* ref_plain = new ReferenceModelBuilder();
+	ref_plain->start();
+
+	Layer* plain_layers = new Layer[layers_len];
+	delamo::List<FaceAdjacency*> plain_fal_list;
+	delamo::List<int> plain_fal_size_list;
+	CreateLayers(ref_plain, &mold, thickness, plain_layers, layers_len);
+	BondLayers(ref_plain, plain_layers, layers_len, delam_files, plain_fal_list, plain_fal_size_list);
+
+	/**
+	* LAMINATE BUILD
+	*/
+
+	ModelBuilder* ref = new ReferenceModelBuilder();
+	ref->start();
+
+	// The interfaces without a delamination use the default boundary conditions
+	LaminateSpec spec;
+	spec.mold = &mold;
+	spec.direction = Direction::OFFSET;
+	for (int i = 0; i < layers_len; i++)
+	{
+		spec.thickness.add(thickness);
+		spec.layup.add(layup_angles[i % 4]);
+		spec.names.add("Layer_" + std::to_string(i + 1));
+	}
+	for (int i = 0; i < layers_len - 1; i++)
+	{
+		InterfaceSpec ispec;
+		if (!delam_files[i].empty())
+			ispec.delam_files.add(delam_files[i]);
+		spec.interfaces.add(ispec);
+	}
+
+	// Generated layers are owned by the ModelBuilder
+	delamo::List<Layer*> layer_list;
+	delamo::List<FaceAdjacency*> fal_list;
+	delamo::List<int> fal_size_list;
+	ref->build_laminate(spec, layer_list, fal_list, fal_size_list);
+
+	/**
+	* COMPARE
+	*/
+
+	// Layers are named and oriented by the specification
+	bool passed = true;
+	for (int i = 0; i < (int)layer_list.size() && i < layers_len; i++)
+	{
+		if (spec.names[i] != layer_list[i]->name() || layer_list[i]->layup() != spec.layup[i])
+		{
+			std::cout << "Layer " << i << " is generated as " << layer_list[i]->name() << " with layup " << layer_list[i]->layup() << ", expected " << spec.names[i] << " with layup " << spec.layup[i] << std::endl;
+			passed = false;
+		}
+	}
+
+	delamo::List< Layer *> plain_layer_list(plain_layers, layers_len);
+	passed = CompareFaceCounts(layer_list, plain_layer_list) && passed;
+	passed = CompareFAL(fal_list, fal_size_list, plain_fal_list, plain_fal_size_list) && passed;
+
+	// Unnamed plies are named after their positions
+	LaminateSpec unnamed_spec;
+	unnamed_spec.mold = &mold;
+	unnamed_spec.thickness.add(thickness);
+	unnamed_spec.thickness.add(thickness);
+	delamo::List<Layer*> unnamed_list;
+	delamo::List<FaceAdjacency*> unnamed_fal_list;
+	delamo::List<int> unnamed_fal_size_list;
+	ref->build_laminate(unnamed_spec, unnamed_list, unnamed_fal_list, unnamed_fal_size_list);
+	if (unnamed_list.size() != 2 || std::string(unnamed_list[1]->name()) != "Layer_2" || unnamed_list[1]->layup() != 0 || unnamed_fal_list.size() != 1)
+	{
+		std::cout << "Unnamed laminate is not generated with the default names and layup" << std::endl;
+		passed = false;
+	}
+
+	// Invalid specifications
+	LaminateSpec no_mold_spec(unnamed_spec);
+	no_mold_spec.mold = nullptr;
+	passed = reject_spec(ref, no_mold_spec, "Laminate without a mold") && passed;
+	LaminateSpec names_spec(unnamed_spec);
+	names_spec.names.add("Layer_1");
+	passed = reject_spec(ref, names_spec, "Laminate with missing ply names") && passed;
+	LaminateSpec interfaces_spec(unnamed_spec);
+	interfaces_spec.interfaces.add(InterfaceSpec());
+	interfaces_spec.interfaces.add(InterfaceSpec());
+	passed = reject_spec(ref, interfaces_spec, "Laminate with too many interfaces") && passed;
+
+	std::cout << "Laminate build: " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+	// Stop the reference modelers and free allocated memory
+	ref->stop();
+	ref_plain->stop();
+
+	// Free FAL memory
+	for (auto fal : fal_list)
+		delete[] fal;
+	for (auto fal : unnamed_fal_list)
+		delete[] fal;
+	for (auto fal : plain_fal_list)
+		delete[] fal;
+
+	// Delete layers, the generated ones are deleted by the ModelBuilder
+	delete[] plain_layers;
+
+	// Delete ModelBuilder objects
+	delete ref;
+	delete ref_plain;
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,158 @@
+#include "testcase_includes.h"
+#include <iterator>
+#include <thread>
+
+
+// Results of a laminate built by its own ModelBuilder
+struct MultiResult
+{
+	ModelBuilder* mb;
+	Layer* layers;
+	delamo::List<FaceAdjacency*> fal_list;
+	delamo::List<int> fal_size_list;
+	std::string model_fingerprint;
+	std::string cad_file;
+};
+
+// Builds a laminate variant, the variants differ in thickness and the even ones start from the shared mold
+static void build_variant(int variant, NURBS<double>* mold, LayerMold* shared_mold, int layers_len, const std::vector<std::string>& delam_files, const std::string& cad_prefix, MultiResult& result)
+{
+	ModelBuilder* ref = new ReferenceModelBuilder();
+	ref->start();
+	result.mb = ref;
+
+	double thickness = 0.2 + 0.05 * (variant % 4);
+	result.layers = new Layer[layers_len];
+	if (variant % 2 == 0)
+	{
+		ref->create_layer(shared_mold, Direction::OFFSET, thickness, &result.layers[0]);
+		result.layers[0].name("Layer_1");
+		for (int i = 1; i < layers_len; i++)
+		{
+			ref->create_layer(&result.layers[i - 1], Direction::OFFSET, thickness, &result.layers[i]);
+			result.layers[i].name(("Layer_" + std::to_string(i + 1)).c_str());
+		}
+	}
+	else
+		CreateLayers(ref, mold, thickness, result.layers, layers_len);
+	BondLayers(ref, result.layers, layers_len, delam_files, result.fal_list, result.fal_size_list);
+
+	delamo::List< Layer *> layer_list(result.layers, layers_len);
+	result.model_fingerprint = ref->fingerprint(layer_list).hex();
+
+	// Save to a separate file for each variant
+	delamo::List< std::string > body_names;
+	result.cad_file = cad_prefix + std::to_string(variant) + ".stl";
+	ref->save(result.cad_file.c_str(), layer_list, body_names);
+}
+
+int main(int argc, char** argv)
+{
+	// Number of layers and threads can be changed from the command line
+	int layers_len = 6;
+	int num_threads = 6;
+	if (argc > 1)
+		layers_len = std::max(2, atoi(argv[1]));
+	if (argc > 2)
+		num_threads = std::max(1, atoi(argv[2]));
+
+	// Prepare mold as a NURBS surface
+	NURBS<double> mold;
+	if (!ReadPlanarMold(mold))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+
+	/**
+	* REQUIRED VARIABLES
+	*/
+
+	// Define file names, every other interface has a delamination
+	std::string delam_file = "Delamination1_3D.csv";
+	std::vector<std::string> delam_files(layers_len - 1);
+	for (int i = 0; i < layers_len - 1; i += 2)
+		delam_files[i] = delam_file;
+
+	// The mold generated by a base instance is shared read-only by the other instances
+	ModelBuilder* ref_base = new ReferenceModelBuilder();
+	ref_base->start();
+	Layer base_layer;
+	ref_base->create_layer(&mold, Direction::OFFSET, 0.2, &base_layer);
+	LayerMold* shared_mold = base_layer.list_mold()[0];
+
+	/**
+	* PARALLEL AND SEQUENTIAL BUILDS
+	*/
+
+	// One ModelBuilder per thread
+	std::vector<MultiResult> results(num_threads);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < num_threads; i++)
+		threads.emplace_back(build_variant, i, &mold, shared_mold, layers_len, std::cref(delam_files), std::string("DeLaMo_TC_Reference_Multi_"), std::ref(results[i]));
+	for (auto& t : threads)
+		t.join();
+
+	// Same variants one after the other
+	std::vector<MultiResult> plain_results(num_threads);
+	for (int i = 0; i < num_threads; i++)
+		build_variant(i, &mold, shared_mold, layers_len, delam_files, "DeLaMo_TC_Reference_Multi_Plain_", plain_results[i]);
+
+	/**
+	* COMPARE
+	*/
+
+	bool passed = true;
+	for (int i = 0; i < num_threads; i++)
+	{
+		if (results[i].model_fingerprint != plain_results[i].model_fingerprint)
+		{
+			std::cout << "Variant " << i << " has the fingerprint " << results[i].model_fingerprint << ", expected " << plain_results[i].model_fingerprint << std::endl;
+			passed = false;
+		}
+		delamo::List< Layer *> layer_list(results[i].layers, layers_len);
+		delamo::List< Layer *> plain_layer_list(plain_results[i].layers, layers_len);
+		passed = CompareFaceCounts(layer_list, plain_layer_list) && passed;
+		passed = CompareFAL(results[i].fal_list, results[i].fal_size_list, plain_results[i].fal_list, plain_results[i].fal_size_list) && passed;
+	}
+
+	// Saved files should be identical
+	auto read_file = [](const std::string& file_name) {
+		std::ifstream in_file(file_name.c_str(), std::ios::in | std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(in_file), std::istreambuf_iterator<char>());
+	};
+	for (int i = 0; i < num_threads; i++)
+	{
+		std::string contents = read_file(results[i].cad_file);
+		if (contents.empty() || contents != read_file(plain_results[i].cad_file))
+		{
+			std::cout << results[i].cad_file << " differs from " << plain_results[i].cad_file << std::endl;
+			passed = false;
+		}
+	}
+
+	// Variants with different thicknesses should not be mixed up
+	if (num_threads > 1 && results[0].model_fingerprint == results[1].model_fingerprint)
+	{
+		std::cout << "Different variants have the same fingerprint" << std::endl;
+		passed = false;
+	}
+	std::cout << "Multiple instances on " << num_threads << " threads: " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+	// Stop the reference modelers and free allocated memory
+	results.insert(results.end(), plain_results.begin(), plain_results.end());
+	for (auto& result : results)
+	{
+		result.mb->stop();
+		for (auto fal : result.fal_list)
+			delete[] fal;
+		delete[] result.layers;
+		delete result.mb;
+	}
+
+	// Stop the base modeler after the others stopped using its mold
+	ref_base->stop();
+	delete ref_base;
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
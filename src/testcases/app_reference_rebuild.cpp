@@ -0,0 +1,142 @@
+#include "testcase_includes.h"
+
+
+int main(int argc, char** argv)
+{
+	// Number of layers can be changed from the command line
+	int layers_len = 8;
+	if (argc > 1)
+		layers_len = std::max(4, atoi(argv[1]));
+
+	// Prepare mold as a NURBS surface
+	NURBS<double> mold;
+	if (!ReadPlanarMold(mold))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+
+	/**
+	* REQUIRED VARIABLES
+	*/
+
+	// Define thickness
+	double thickness = 0.2;
+
+	// Define file names, every other interface has a delamination and the 3rd one gets a different outline later
+	std::string delam_file = "Delamination1_3D.csv";
+	std::string delam_trial_file = "Delamination1_3D_Trial.csv";
+	std::string delam_shifted_file = "Delamination1_3D_Shifted.csv";
+	if (!ShiftDelamination(delam_file, delam_trial_file, 0.0) || !ShiftDelamination(delam_file, delam_shifted_file, 1.5))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+	std::vector<std::string> delam_files(layers_len - 1);
+	for (int i = 0; i < layers_len - 1; i += 2)
+		delam_files[i] = delam_file;
+	delam_files[2] = delam_trial_file;
+
+	/**
+	* INCREMENTAL BUILD
+	*/
+
+	ModelBuilder* ref = new ReferenceModelBuilder();
+	ref->start();
+
+	// Operations are recorded with their input files
+	ref->incremental(true);
+
+	Layer* layers = new Layer[layers_len];
+	delamo::List<FaceAdjacency*> fal_list;
+	delamo::List<int> fal_size_list;
+	CreateLayers(ref, &mold, thickness, layers, layers_len);
+	BondLayers(ref, layers, layers_len, delam_files, fal_list, fal_size_list);
+
+	// Nothing is replayed without a modified input, the face adjacency lists are returned as they are
+	delamo::List<FaceAdjacency*> noop_fal_list;
+	delamo::List<int> noop_fal_size_list;
+	int num_noop_replaced = ref->replace_input("Delamination_Unused.csv", delam_shifted_file.c_str());
+	int num_noop_replayed = ref->rebuild(noop_fal_list, noop_fal_size_list);
+	bool passed = (num_noop_replaced == 0 && num_noop_replayed == 0);
+	if (!passed)
+		std::cout << "Unmodified inputs: " << num_noop_replaced << " replaced inputs, " << num_noop_replayed << " replayed operations" << std::endl;
+	passed = CompareFAL(noop_fal_list, noop_fal_size_list, fal_list, fal_size_list) && passed;
+	for (auto fal : noop_fal_list)
+		delete[] fal;
+	for (auto fal : fal_list)
+		delete[] fal;
+	fal_list.clear();
+	fal_size_list.clear();
+
+	// Fingerprints show which layers are regenerated by the rebuild
+	std::vector<Fingerprint> fingerprints;
+	for (int i = 0; i < layers_len; i++)
+		fingerprints.push_back(layers[i].fingerprint());
+
+	// Only the interface using the replaced outline and the operations after it on the same layers are replayed
+	int num_replaced = ref->replace_input(delam_trial_file.c_str(), delam_shifted_file.c_str());
+	int num_replayed = ref->rebuild(fal_list, fal_size_list);
+	std::cout << "Replaced inputs: " << num_replaced << ", replayed operations: " << num_replayed << std::endl;
+
+	/**
+	* PLAIN BUILD
+	*/
+
+	ModelBuilder* ref_plain = new ReferenceModelBuilder();
+	ref_plain->start();
+
+	delam_files[2] = delam_shifted_file;
+	Layer* plain_layers = new Layer[layers_len];
+	delamo::List<FaceAdjacency*> plain_fal_list;
+	delamo::List<int> plain_fal_size_list;
+	CreateLayers(ref_plain, &mold, thickness, plain_layers, layers_len);
+	BondLayers(ref_plain, plain_layers, layers_len, delam_files, plain_fal_list, plain_fal_size_list);
+
+	/**
+	* COMPARE
+	*/
+
+	delamo::List< Layer *> layer_list(layers, layers_len);
+	delamo::List< Layer *> plain_layer_list(plain_layers, layers_len);
+	passed = (num_replaced == 1 && num_replayed > 0 && num_replayed <= layers_len - 3) && passed;
+	passed = CompareFaceCounts(layer_list, plain_layer_list) && passed;
+
+	// The layers of the modified interface are regenerated, the outline does not change the layers above them
+	for (int i = 0; i < layers_len; i++)
+	{
+		bool regenerated = (i == 2 || i == 3);
+		if (regenerated && layers[i].fingerprint() != plain_layers[i].fingerprint())
+		{
+			std::cout << "Layer " << i << " is not regenerated as in the plain build" << std::endl;
+			passed = false;
+		}
+		if (!regenerated && layers[i].fingerprint() != fingerprints[i])
+		{
+			std::cout << "Layer " << i << " is regenerated by the rebuild" << std::endl;
+			passed = false;
+		}
+	}
+	passed = CompareFAL(fal_list, fal_size_list, plain_fal_list, plain_fal_size_list) && passed;
+	std::cout << "Incremental rebuild: " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+	// Stop the reference modelers and free allocated memory
+	ref->stop();
+	ref_plain->stop();
+
+	// Free FAL memory
+	for (auto fal : fal_list)
+		delete[] fal;
+	for (auto fal : plain_fal_list)
+		delete[] fal;
+
+	// Delete layers
+	delete[] layers;
+	delete[] plain_layers;
+
+	// Delete ModelBuilder objects
+	delete ref;
+	delete ref_plain;
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,184 @@
+#include "testcase_includes.h"
+
+
+// Tries a delamination outline at the 3rd interface in a transaction and compares the result with the plain build
+static bool build_transaction(NURBS<double>* mold, double thickness, int layers_len, const std::vector<std::string>& delam_files, const std::string& trial_file, bool keep)
+{
+	// Transaction build
+	ModelBuilder* ref = new ReferenceModelBuilder();
+	ref->start();
+
+	Layer* layers = new Layer[layers_len];
+	delamo::List<FaceAdjacency*> fal_list;
+	delamo::List<int> fal_size_list;
+	CreateLayers(ref, mold, thickness, layers, layers_len);
+
+	// Bond the first two interfaces
+	BondLayers(ref, layers, 3, delam_files, fal_list, fal_size_list);
+
+	// Rollback restores the original objects, so the references to them stay valid
+	std::vector<Fingerprint> fingerprints;
+	for (int i = 0; i < layers_len; i++)
+		fingerprints.push_back(layers[i].fingerprint());
+	LayerBody* trial_body = layers[2].at(0);
+	std::vector<LayerSurface*> trial_surfaces;
+	for (auto ls : *trial_body)
+		trial_surfaces.push_back(ls);
+
+	// Try the outline, the transaction also creates a layer which is released by the rollback
+	bool passed = true;
+	ref->begin_transaction();
+	try
+	{
+		ref->begin_transaction();
+		std::cout << "Nested transaction is started" << std::endl;
+		passed = false;
+	}
+	catch (std::runtime_error&)
+	{
+	}
+	FaceAdjacency* trial_fal = nullptr;
+	int trial_fal_size = 0;
+	ref->adjacent_layers(&layers[2], &layers[3], trial_file.c_str(), BCStatus::is_contact, trial_fal, trial_fal_size);
+	Layer* trial_layer = new Layer();
+	ref->create_layer(&layers[1], Direction::ORIG, thickness, trial_layer);
+
+	int num_restored = 0;
+	if (keep)
+	{
+		ref->commit();
+		fal_list.add(trial_fal);
+		fal_size_list.add(trial_fal_size);
+	}
+	else
+	{
+		num_restored = ref->rollback();
+		delete[] trial_fal;
+
+		// Only the layers modified by the transaction are restored, i.e. the 3rd and 4th layers and the new layer
+		if (num_restored != 3)
+		{
+			std::cout << "Rollback restored " << num_restored << " layers, expected 3" << std::endl;
+			passed = false;
+		}
+		bool same_objects = (layers[2].at(0) == trial_body && trial_body->size() == (int)trial_surfaces.size());
+		for (int i = 0; same_objects && i < trial_body->size(); i++)
+			same_objects = (trial_body->at(i) == trial_surfaces[i]);
+		if (!same_objects)
+		{
+			std::cout << "Rollback replaced the bodies or the surfaces of the layer" << std::endl;
+			passed = false;
+		}
+		for (int i = 0; i < layers_len; i++)
+		{
+			if (layers[i].fingerprint() != fingerprints[i])
+			{
+				std::cout << "Layer " << i << " is not restored to its state before the transaction" << std::endl;
+				passed = false;
+			}
+		}
+
+		// Bond the 3rd interface again with the original outline
+		FaceAdjacency* fal = nullptr;
+		int fal_size = 0;
+		if (!delam_files[2].empty())
+			ref->adjacent_layers(&layers[2], &layers[3], delam_files[2].c_str(), BCStatus::is_contact, fal, fal_size);
+		else
+			ref->adjacent_layers(&layers[2], &layers[3], BCStatus::is_contact, fal, fal_size);
+		fal_list.add(fal);
+		fal_size_list.add(fal_size);
+	}
+
+	// Bond the remaining interfaces
+	for (int i = 3; i < layers_len - 1; i++)
+	{
+		FaceAdjacency* fal = nullptr;
+		int fal_size = 0;
+		if (!delam_files[i].empty())
+			ref->adjacent_layers(&layers[i], &layers[i + 1], delam_files[i].c_str(), BCStatus::is_contact, fal, fal_size);
+		else
+			ref->adjacent_layers(&layers[i], &layers[i + 1], BCStatus::is_contact, fal, fal_size);
+		fal_list.add(fal);
+		fal_size_list.add(fal_size);
+	}
+
+	// Plain build, the kept outline is used from the start
+	ModelBuilder* ref_plain = new ReferenceModelBuilder();
+	ref_plain->start();
+
+	std::vector<std::string> plain_delam_files = delam_files;
+	if (keep)
+		plain_delam_files[2] = trial_file;
+	Layer* plain_layers = new Layer[layers_len];
+	delamo::List<FaceAdjacency*> plain_fal_list;
+	delamo::List<int> plain_fal_size_list;
+	CreateLayers(ref_plain, mold, thickness, plain_layers, layers_len);
+	BondLayers(ref_plain, plain_layers, layers_len, plain_delam_files, plain_fal_list, plain_fal_size_list);
+
+	// The rolled back layer should be empty
+	delamo::List< Layer *> layer_list(layers, layers_len);
+	delamo::List< Layer *> plain_layer_list(plain_layers, layers_len);
+	passed = !ref->in_transaction() && (keep || (trial_layer->size() == 0 && trial_layer->size_mold() == 0)) && passed;
+	passed = CompareFaceCounts(layer_list, plain_layer_list) && passed;
+	passed = CompareFingerprints(layer_list, plain_layer_list) && passed;
+	passed = CompareFAL(fal_list, fal_size_list, plain_fal_list, plain_fal_size_list) && passed;
+	std::cout << (keep ? "Committed transaction: " : "Rolled back transaction: ") << (passed ? "PASSED" : "FAILED") << std::endl;
+
+	ref->stop();
+	ref_plain->stop();
+	for (auto fal : fal_list)
+		delete[] fal;
+	for (auto fal : plain_fal_list)
+		delete[] fal;
+	delete trial_layer;
+	delete[] layers;
+	delete[] plain_layers;
+	delete ref;
+	delete ref_plain;
+
+	return passed;
+}
+
+int main(int argc, char** argv)
+{
+	// Number of layers can be changed from the command line
+	int layers_len = 8;
+	if (argc > 1)
+		layers_len = std::max(4, atoi(argv[1]));
+
+	// Prepare mold as a NURBS surface
+	NURBS<double> mold;
+	if (!ReadPlanarMold(mold))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+
+	/**
+	* REQUIRED VARIABLES
+	*/
+
+	// Define thickness
+	double thickness = 0.2;
+
+	// Define file names, every other interface has a delamination
+	std::string delam_file = "Delamination1_3D.csv";
+	std::string delam_shifted_file = "Delamination1_3D_Shifted.csv";
+	if (!ShiftDelamination(delam_file, delam_shifted_file, 1.5))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+	std::vector<std::string> delam_files(layers_len - 1);
+	for (int i = 0; i < layers_len - 1; i += 2)
+		delam_files[i] = delam_file;
+
+	/**
+	* TRANSACTIONS
+	*/
+
+	bool passed = build_transaction(&mold, thickness, layers_len, delam_files, delam_shifted_file, false);
+	passed = build_transaction(&mold, thickness, layers_len, delam_files, delam_shifted_file, true) && passed;
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
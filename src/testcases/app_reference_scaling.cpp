@@ -0,0 +1,134 @@
+#include "testcase_includes.h"
+#include <chrono>
+
+
+int main(int argc, char** argv)
+{
+	// Number of layers can be changed from the command line to measure scaling
+	int layers_len = 8;
+	if (argc > 1)
+		layers_len = std::max(2, atoi(argv[1]));
+
+	// Prepare mold as a NURBS surface
+	NURBS<double> mold;
+
+	int degree_u = 3;
+	int degree_v = 3;
+
+	std::string cpfile = "CP_Planar1.txt";
+	delamo::List<double> knot_vector_u = { 0, 0, 0, 0, 1, 2, 3, 3, 3, 3 };
+	delamo::List<double> knot_vector_v = { 0, 0, 0, 0, 1, 2, 3, 3, 3, 3 };
+
+	// Check if we can read the control points file
+	if (!mold.read_ctrlpts(cpfile.c_str()))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+
+	// Knot vectors
+	mold.knotvector_u(&knot_vector_u[0], (int)knot_vector_u.size());
+	mold.knotvector_v(&knot_vector_v[0], (int)knot_vector_v.size());
+
+	// Degrees
+	mold.degree_u(degree_u);
+	mold.degree_v(degree_v);
+
+	/**
+	* REQUIRED VARIABLES
+	*/
+
+	// Define thickness
+	double thickness = 0.2;
+
+	// Define file names
+	std::string cad_file = "DeLaMo_TC_Reference.stl";
+	std::string fal_debug_file = "Debug_FAL_Reference.txt";
+	std::string delam_file = "Delamination1_3D.csv";
+
+	/**
+	* START CAD MODEL BUILDER
+	*/
+
+	// Use the kernel-free reference backend, no license is required
+	ModelBuilder* ref = new ReferenceModelBuilder();
+
+	// Start the reference modeler
+	ref->start();
+
+	// Instantiate the Layer pointer array
+	Layer* layers = new Layer[layers_len];
+
+	/**
+	* GENERATE LAYERS
+	*/
+
+	auto time_start = std::chrono::steady_clock::now();
+
+	// Create 1st layer from the NURBS surface
+	ref->create_layer(&mold, Direction::OFFSET, thickness, &layers[0]);
+	layers[0].name("Layer_1");
+	layers[0].layup(0);
+
+	// Create the remaining layers on top of each other
+	for (int i = 1; i < layers_len; i++)
+	{
+		ref->create_layer(&layers[i - 1], Direction::OFFSET, thickness, &layers[i]);
+		layers[i].name(("Layer_" + std::to_string(i + 1)).c_str());
+		layers[i].layup(0);
+	}
+
+	auto time_layers = std::chrono::steady_clock::now();
+
+	// Imprint layers to each other with FAL, every other interface has a delamination
+	delamo::List<FaceAdjacency*> fal_list;
+	delamo::List<int> fal_size_list;
+	for (int i = 0; i < layers_len - 1; i++)
+	{
+		FaceAdjacency* fal = nullptr;
+		int fal_size;
+		if (i % 2 == 0)
+			ref->adjacent_layers(&layers[i], &layers[i + 1], delam_file.c_str(), BCStatus::is_contact, fal, fal_size);
+		else
+			ref->adjacent_layers(&layers[i], &layers[i + 1], BCStatus::is_contact, fal, fal_size);
+		fal_list.add(fal);
+		fal_size_list.add(fal_size);
+	}
+
+	auto time_adjacency = std::chrono::steady_clock::now();
+
+	// Display the timings
+	std::cout << "Layers: " << layers_len << std::endl;
+	std::cout << "create_layer: " << std::chrono::duration<double, std::milli>(time_layers - time_start).count() << " ms" << std::endl;
+	std::cout << "adjacent_layers: " << std::chrono::duration<double, std::milli>(time_adjacency - time_layers).count() << " ms" << std::endl;
+
+	// Truncate the text file
+	std::ofstream outFile;
+	outFile.open(fal_debug_file.c_str(), std::ios::out);
+	outFile.close();
+
+	// Write FAL info to the text file
+	for (int i = 0; i < (int)fal_list.size(); i++)
+		WriteFAL(fal_debug_file.c_str(), fal_list[i], fal_size_list[i]);
+
+	// Testing save functionality
+	delamo::List< std::string > body_names;
+	delamo::List< Layer *> layer_list(layers, layers_len);
+	ref->save(cad_file.c_str(), layer_list, body_names);
+	layer_list.clear();
+
+	// Stop the reference modeler and free allocated memory
+	ref->stop();
+
+	// Free FAL memory
+	for (auto fal : fal_list)
+		delete[] fal;
+
+	// Delete layers
+	delete[] layers;
+
+	// Delete ModelBuilder object
+	delete ref;
+
+	return EXIT_SUCCESS;
+}
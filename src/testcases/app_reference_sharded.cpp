@@ -0,0 +1,164 @@
+#include "testcase_includes.h"
+
+
+int main(int argc, char** argv)
+{
+	// Number of layers and threads can be changed from the command line
+	int layers_len = 8;
+	int num_threads = 4;
+	if (argc > 1)
+		layers_len = std::max(2, atoi(argv[1]));
+	if (argc > 2)
+		num_threads = std::max(1, atoi(argv[2]));
+
+	// Prepare mold as a NURBS surface
+	NURBS<double> mold;
+	if (!ReadPlanarMold(mold))
+	{
+		pause();
+		return EXIT_FAILURE;
+	}
+
+	/**
+	* REQUIRED VARIABLES
+	*/
+
+	// Define thickness
+	double thickness = 0.2;
+
+	// Define file names, every other interface has a delamination
+	std::string cad_file = "DeLaMo_TC_Reference.stl";
+	std::string manifest_file = "DeLaMo_TC_Reference_Sharded.json";
+	std::string delam_file = "Delamination1_3D.csv";
+	std::vector<std::string> delam_files(layers_len - 1);
+	for (int i = 0; i < layers_len - 1; i += 2)
+		delam_files[i] = delam_file;
+
+	/**
+	* BUILD AND SAVE
+	*/
+
+	ModelBuilder* ref = new ReferenceModelBuilder();
+	ref->start();
+	ref->task_threads(num_threads);
+
+	Layer* layers = new Layer[layers_len];
+	delamo::List<FaceAdjacency*> fal_list;
+	delamo::List<int> fal_size_list;
+	CreateLayers(ref, &mold, thickness, layers, layers_len);
+	BondLayers(ref, layers, layers_len, delam_files, fal_list, fal_size_list);
+
+	// Plain save returns the body names
+	delamo::List< std::string > body_names;
+	delamo::List< Layer *> layer_list(layers, layers_len);
+	ref->save(cad_file.c_str(), layer_list, body_names);
+
+	// One shard per body
+	int num_shards = ref->save_sharded(manifest_file.c_str(), layer_list, 1);
+
+	/**
+	* COMPARE
+	*/
+
+	bool passed = (num_shards == (int)body_names.size());
+	if (!passed)
+		std::cout << "Number of shards: " << num_shards << ", expected " << body_names.size() << std::endl;
+
+	// Each shard should be saved next to the manifest with its own body, the shards together have all facets of the plain save
+	auto count_facets = [](const std::string& file_name, std::vector<std::string>& solids) {
+		std::ifstream stl_file(file_name.c_str(), std::ios::in);
+		std::string stl_line;
+		int num_facets = 0;
+		while (std::getline(stl_file, stl_line))
+		{
+			if (stl_line.compare(0, 6, "solid ") == 0)
+				solids.push_back(stl_line.substr(6));
+			else if (stl_line.compare(0, 6, "facet ") == 0)
+				num_facets++;
+		}
+		return num_facets;
+	};
+	std::vector<std::string> plain_solids;
+	int plain_num_facets = count_facets(cad_file, plain_solids);
+	int shard_num_facets = 0;
+	for (int i = 0; i < num_shards; i++)
+	{
+		std::string shard_file = "DeLaMo_TC_Reference_Sharded." + std::to_string(i) + ".stl";
+		std::vector<std::string> shard_solids;
+		shard_num_facets += count_facets(shard_file, shard_solids);
+		if (shard_solids.size() != 1 || i >= (int)body_names.size() || shard_solids[0] != body_names[i])
+		{
+			std::cout << "Shard " << shard_file << " does not contain only the body " << ((i < (int)body_names.size()) ? body_names[i] : "") << std::endl;
+			passed = false;
+		}
+	}
+	if (shard_num_facets != plain_num_facets)
+	{
+		std::cout << "Shards have " << shard_num_facets << " facets, expected " << plain_num_facets << std::endl;
+		passed = false;
+	}
+
+	// The manifest should list all saved bodies, and the faces of each interface should match its FAL
+	std::ifstream manifest(manifest_file.c_str(), std::ios::in);
+	std::string manifest_line;
+	std::string manifest_contents;
+	std::vector<int> interface_faces;
+	while (std::getline(manifest, manifest_line))
+	{
+		manifest_contents += manifest_line;
+		if (manifest_line.find("\"body_pairs\"") == std::string::npos)
+			continue;
+		int num_faces = 0;
+		std::string faces_key = "\"faces\": ";
+		for (size_t pos = manifest_line.find(faces_key); pos != std::string::npos; pos = manifest_line.find(faces_key, pos + 1))
+			num_faces += atoi(manifest_line.c_str() + pos + faces_key.size());
+		interface_faces.push_back(num_faces);
+	}
+	for (auto& body_name : body_names)
+	{
+		if (manifest_contents.find("\"" + body_name + "\"") == std::string::npos)
+		{
+			std::cout << "Body is not in the manifest: " << body_name << std::endl;
+			passed = false;
+		}
+	}
+
+	// Layers are listed with their fingerprints, so the readers can detect the modified layers
+	for (int i = 0; i < layers_len; i++)
+	{
+		if (manifest_contents.find("\"fingerprint\": \"" + layers[i].fingerprint().hex() + "\"") == std::string::npos)
+		{
+			std::cout << "Fingerprint of " << layers[i].name() << " is not in the manifest" << std::endl;
+			passed = false;
+		}
+	}
+	if (interface_faces.size() != fal_size_list.size())
+	{
+		std::cout << "Number of interfaces: " << interface_faces.size() << ", expected " << fal_size_list.size() << std::endl;
+		passed = false;
+	}
+	for (int i = 0; i < (int)interface_faces.size() && i < (int)fal_size_list.size(); i++)
+	{
+		if (interface_faces[i] != fal_size_list[i])
+		{
+			std::cout << "Interface " << i << ": " << interface_faces[i] << " face pairs, expected " << fal_size_list[i] << std::endl;
+			passed = false;
+		}
+	}
+	std::cout << "Sharded save with " << num_threads << " threads: " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+	// Stop the reference modeler and free allocated memory
+	ref->stop();
+
+	// Free FAL memory
+	for (auto fal : fal_list)
+		delete[] fal;
+
+	// Delete layers
+	delete[] layers;
+
+	// Delete ModelBuilder object
+	delete ref;
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
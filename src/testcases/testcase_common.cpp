@@ -59,3 +59,165 @@ void WritePoints(std::string fileName, delamo::List<delamo::TPoint3<double>> poi
 
 	outFile.close();
 }
+
+bool ReadPlanarMold(delamo::NURBS<double>& mold)
+{
+	std::string cpfile = "CP_Planar1.txt";
+	delamo::List<double> knot_vector_u = { 0, 0, 0, 0, 1, 2, 3, 3, 3, 3 };
+	delamo::List<double> knot_vector_v = { 0, 0, 0, 0, 1, 2, 3, 3, 3, 3 };
+
+	// Check if we can read the control points file
+	if (!mold.read_ctrlpts(cpfile.c_str()))
+		return false;
+
+	// Knot vectors
+	mold.knotvector_u(&knot_vector_u[0], (int)knot_vector_u.size());
+	mold.knotvector_v(&knot_vector_v[0], (int)knot_vector_v.size());
+
+	// Degrees
+	mold.degree_u(3);
+	mold.degree_v(3);
+
+	return true;
+}
+
+void CreateLayers(ModelBuilder* mb, delamo::NURBS<double>* mold, double thickness, Layer* layers, int layers_len)
+{
+	// Create 1st layer from the NURBS surface
+	mb->create_layer(mold, Direction::OFFSET, thickness, &layers[0]);
+	layers[0].name("Layer_1");
+	layers[0].layup(0);
+
+	// Create the remaining layers on top of each other
+	for (int i = 1; i < layers_len; i++)
+	{
+		mb->create_layer(&layers[i - 1], Direction::OFFSET, thickness, &layers[i]);
+		layers[i].name(("Layer_" + std::to_string(i + 1)).c_str());
+		layers[i].layup(0);
+	}
+}
+
+void BondLayers(ModelBuilder* mb, Layer* layers, int layers_len, const std::vector<std::string>& delam_files, delamo::List<FaceAdjacency*>& fal_list, delamo::List<int>& fal_size_list)
+{
+	for (int i = 0; i < layers_len - 1; i++)
+	{
+		FaceAdjacency* fal = nullptr;
+		int fal_size = 0;
+		if (i < (int)delam_files.size() && !delam_files[i].empty())
+			mb->adjacent_layers(&layers[i], &layers[i + 1], delam_files[i].c_str(), BCStatus::is_contact, fal, fal_size);
+		else
+			mb->adjacent_layers(&layers[i], &layers[i + 1], BCStatus::is_contact, fal, fal_size);
+		fal_list.add(fal);
+		fal_size_list.add(fal_size);
+	}
+}
+
+bool ShiftDelamination(std::string inFileName, std::string outFileName, double dx)
+{
+	std::ifstream inFile(inFileName.c_str(), std::ios::in);
+	if (!inFile.is_open())
+		return false;
+
+	std::ofstream outFile(outFileName.c_str(), std::ios::out | std::ios::trunc);
+
+	// Keep the header line
+	std::string line;
+	std::getline(inFile, line);
+	outFile << line << std::endl;
+
+	while (std::getline(inFile, line))
+	{
+		double x, y, z;
+		char sep;
+		std::istringstream values(line);
+		if (!(values >> x >> sep >> y >> sep >> z))
+			continue;
+		outFile << std::setprecision(10) << x + dx << "," << y << "," << z << std::endl;
+	}
+
+	outFile.close();
+	return (bool)outFile;
+}
+
+bool CompareFaceCounts(delamo::List<Layer*>& layers, delamo::List<Layer*>& expected_layers)
+{
+	if (layers.size() != expected_layers.size())
+	{
+		std::cout << "Number of layers: " << layers.size() << ", expected " << expected_layers.size() << std::endl;
+		return false;
+	}
+
+	bool equal = true;
+	for (int i = 0; i < (int)layers.size(); i++)
+	{
+		int num_faces = 0, expected_num_faces = 0;
+		for (auto lb : *layers[i])
+			num_faces += lb->size();
+		for (auto lb : *expected_layers[i])
+			expected_num_faces += lb->size();
+
+		if (layers[i]->size() != expected_layers[i]->size() || num_faces != expected_num_faces)
+		{
+			std::cout << "Layer " << i << ": " << layers[i]->size() << " bodies with " << num_faces << " faces, expected " << expected_layers[i]->size() << " bodies with " << expected_num_faces << " faces" << std::endl;
+			equal = false;
+		}
+	}
+	return equal;
+}
+
+bool CompareFAL(delamo::List<FaceAdjacency*>& fal_list, delamo::List<int>& fal_size_list, delamo::List<FaceAdjacency*>& expected_fal_list, delamo::List<int>& expected_fal_size_list)
+{
+	if (fal_size_list.size() != expected_fal_size_list.size())
+	{
+		std::cout << "Number of FALs: " << fal_size_list.size() << ", expected " << expected_fal_size_list.size() << std::endl;
+		return false;
+	}
+
+	auto name_str = [](const char* name) { return std::string((name == nullptr) ? "" : name); };
+
+	bool equal = true;
+	for (int i = 0; i < (int)fal_size_list.size(); i++)
+	{
+		if (fal_size_list[i] != expected_fal_size_list[i])
+		{
+			std::cout << "FAL " << i << ": " << fal_size_list[i] << " face pairs, expected " << expected_fal_size_list[i] << std::endl;
+			equal = false;
+			continue;
+		}
+
+		// Face pairs are listed in the same order
+		for (int j = 0; j < fal_size_list[i]; j++)
+		{
+			FaceAdjacency& fa = fal_list[i][j];
+			FaceAdjacency& expected_fa = expected_fal_list[i][j];
+			if (name_str(fa.name1) != name_str(expected_fa.name1) || name_str(fa.name2) != name_str(expected_fa.name2) || fa.bcType != expected_fa.bcType)
+			{
+				std::cout << "FAL " << i << " face pair " << j << ": " << name_str(fa.name1) << " - " << name_str(fa.name2) << ", expected " << name_str(expected_fa.name1) << " - " << name_str(expected_fa.name2) << std::endl;
+				equal = false;
+				break;
+			}
+		}
+	}
+	return equal;
+}
+
+bool CompareFingerprints(delamo::List<Layer*>& layers, delamo::List<Layer*>& expected_layers)
+{
+	if (layers.size() != expected_layers.size())
+	{
+		std::cout << "Number of layers: " << layers.size() << ", expected " << expected_layers.size() << std::endl;
+		return false;
+	}
+
+	// Fingerprints depend on the geometry and on the order of the operations on each layer
+	bool equal = true;
+	for (int i = 0; i < (int)layers.size(); i++)
+	{
+		if (layers[i]->fingerprint() != expected_layers[i]->fingerprint())
+		{
+			std::cout << "Layer " << i << ": fingerprint " << layers[i]->fingerprint().hex() << ", expected " << expected_layers[i]->fingerprint().hex() << std::endl;
+			equal = false;
+		}
+	}
+	return equal;
+}
@@ -1,10 +1,15 @@
 // CPP includes
 #include <iostream>
 #include <iomanip>
+#include <vector>
 
 // ModelBuilder API
 #include "../Layer.h"
+#ifdef ACISOBJ
 #include "../ACISModelBuilder.h"
+#else
+#include "../ReferenceModelBuilder.h"
+#endif
 
 // Pauses the command line messages
 void pause();
@@ -13,4 +18,21 @@ void pause();
 void WriteFAL(std::string fileName, FaceAdjacency* fal, int fal_size);
 void WritePoints(std::string fileName, delamo::List<delamo::TPoint3<double>> points_list);
 
+// Reads the planar mold used by the reference apps
+bool ReadPlanarMold(delamo::NURBS<double>& mold);
+
+// Creates a stack of layers on the mold
+void CreateLayers(ModelBuilder* mb, delamo::NURBS<double>* mold, double thickness, Layer* layers, int layers_len);
+
+// Bonds the neighbouring layers, an empty file name means no delamination at the interface
+void BondLayers(ModelBuilder* mb, Layer* layers, int layers_len, const std::vector<std::string>& delam_files, delamo::List<FaceAdjacency*>& fal_list, delamo::List<int>& fal_size_list);
+
+// Copies a delamination outline moved along the x-axis
+bool ShiftDelamination(std::string inFileName, std::string outFileName, double dx);
+
+// Compare the results of a test with a plain build
+bool CompareFaceCounts(delamo::List<Layer*>& layers, delamo::List<Layer*>& expected_layers);
+bool CompareFAL(delamo::List<FaceAdjacency*>& fal_list, delamo::List<int>& fal_size_list, delamo::List<FaceAdjacency*>& expected_fal_list, delamo::List<int>& expected_fal_size_list);
+bool CompareFingerprints(delamo::List<Layer*>& layers, delamo::List<Layer*>& expected_layers);
+
 using namespace delamo;